@@ -441,6 +441,7 @@ License type: BSD\n
 #include "sgct/Engine.h"
 #include "sgct/SharedData.h"
 #include "sgct/TextureManager.h"
+#include "sgct/ImageSequencePlayer.h"
 #if INCLUDE_SGCT_TEXT
 	#include "sgct/FontManager.h"
 	#include "sgct/freetype.h"
@@ -450,6 +451,8 @@ License type: BSD\n
 #include "sgct/MessageHandler.h"
 #include "sgct/ShaderManager.h"
 #include "sgct/SGCTSettings.h"
+#include "sgct/SGCTTrace.h"
+#include "sgct/SGCTMemoryRegistry.h"
 #include "sgct/SGCTVersion.h"
 #include "sgct/ogl_headers.h"
 
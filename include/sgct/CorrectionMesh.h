@@ -9,6 +9,19 @@
 #define _CORRECTION_MESH_H_
 
 #include "ogl_headers.h"
+#include <string>
+#include <vector>
+#include "helpers/SGCTCPPEleven.h"
+
+namespace sgct
+{
+    class SGCTWindow;
+}
+
+namespace sgct_helpers
+{
+    class SGCTMappedFile;
+}
 
 namespace sgct_core
 {
@@ -21,20 +34,60 @@ namespace sgct_core
         
         //ATI performs better using sizes of power of two
     };
+
+    /*!
+     Compact vertex used when packed vertices are enabled in SGCTSettings (12 bytes).
+     Positions are signed and texture coordinates unsigned normalized 16-bit integers.
+     */
+    struct CorrectionMeshPackedVertex
+    {
+        short x, y;              //Vertex 4
+        unsigned short s, t;     //Texcoord0 4
+        unsigned char r, g, b, a; //color 4
+    };
+
+    /*!
+     Vertex with packed color used by the fixed pipeline (20 bytes), since
+     the legacy vertex and texture coordinate arrays can't be normalized.
+     */
+    struct CorrectionMeshColorPackedVertex
+    {
+        float x, y;              //Vertex 8
+        float s, t;              //Texcoord0 8
+        unsigned char r, g, b, a; //color 4
+    };
+    
+    /*!
+     Correction grid of a MPCDI warp file (PFM format) with the x and y offsets of
+     each grid point in raster-scan order. The error channel of the file is not kept.
+     */
+    struct MpcdiWarpGrid
+    {
+        MpcdiWarpGrid() : numberOfCols(0), numberOfRows(0) {}
+
+        unsigned int numberOfCols;
+        unsigned int numberOfRows;
+        std::vector<float> correctionX;
+        std::vector<float> correctionY;
+    };
     
     class CorrectionMeshGeometry
     {
     public:
+        enum VertexFormat { FLOAT_VERTEX = 0, PACKED_VERTEX, COLOR_PACKED_VERTEX };
+
         CorrectionMeshGeometry();
         ~CorrectionMeshGeometry();
         
         GLenum mGeometryType;
+        VertexFormat mVertexFormat;
         unsigned int mNumberOfVertices;
         unsigned int mNumberOfIndices;
         unsigned int mMeshData[3];
     };
     
     class Viewport;
+    class WarpMapBaker;
     
     /*!
      Helper class for reading and rendering a correction mesh.
@@ -43,14 +96,32 @@ namespace sgct_core
     class CorrectionMesh
     {
     public:
-        enum MeshType { QUAD_MESH = 0, WARP_MESH, MASK_MESH, LAST_MESH };
+        enum MeshType { QUAD_MESH = 0, WARP_MESH, MASK_MESH, WARP_MAP_MESH, LAST_MESH };
         enum MeshHint { NO_HINT = 0, DOMEPROJECTION_HINT, SCALEABLE_HINT, SCISS_HINT, SIMCAD_HINT, SKYSKAN_HINT, PAULBOURKE_HINT, OBJ_HINT, MPCDI_HINT};
+        enum WarpMapFormat { NO_WARP_MAP = 0, RG16_WARP_MAP, RG32F_WARP_MAP };
         
         CorrectionMesh();
         ~CorrectionMesh();
         bool readAndGenerateMesh(std::string meshPath, Viewport * parent, MeshHint hint = NO_HINT);
+        bool readMesh(std::string meshPath, Viewport * parent, sgct::SGCTWindow * window, MeshHint hint = NO_HINT);
+        void generateMesh(Viewport * parent);
         void render(const MeshType & mt);
         static MeshHint parseHint(const std::string & hintStr);
+        static WarpMapFormat parseWarpMapFormat(const std::string & formatStr);
+
+        bool hasWarpMap(int resolutionX, int resolutionY) const;
+        //! \returns the texture of the baked warp map, 0 if there is none
+        inline unsigned int getWarpMapTexture() const { return mWarpMapTexture; }
+        //! \returns the geometry of a mesh type, its parsed data is available until generateMesh uploads it
+        inline const CorrectionMeshGeometry * getGeometry(const MeshType & mt) const { return &mGeometries[mt]; }
+        //! \returns the parsed vertices of a mesh type or NULL if there are none or they have been uploaded
+        inline const CorrectionMeshVertex * getParsedVertices(const MeshType & mt) const { return mPendingVertices[mt]; }
+        //! \returns the parsed indices of a mesh type or NULL if there are none or they have been uploaded
+        inline const unsigned int * getParsedIndices(const MeshType & mt) const { return mPendingIndices[mt]; }
+
+        //! Reads size bytes into dst, returns false if fewer bytes are available
+        typedef sgct_cppxeleven::function<bool(void * dst, std::size_t size)> ReadFunction;
+        static bool readMpcdiWarpGrid(const ReadFunction & read, MpcdiWarpGrid & grid);
         
     private:
         enum MeshFormat { NO_FMT = 0, DOMEPROJECTION_FMT, SCALEABLE_FMT, SCISS_FMT, SIMCAD_FMT, SKYSKAN_FMT, PAULBOURKE_FMT, OBJ_FMT, MPCDI_FMT};
@@ -60,14 +131,22 @@ namespace sgct_core
         bool readAndGenerateScissMesh(const std::string & meshPath, Viewport * parent);
         bool readAndGenerateSimCADMesh(const std::string & meshPath, Viewport * parent);
         bool readAndGenerateSkySkanMesh(const std::string & meshPath, Viewport * parent);
-        bool readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent);
+        bool readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent, float windowAspectRatio);
         bool readAndGenerateOBJMesh(const std::string & meshPath, Viewport * parent);
         bool readAndGenerateMpcdiMesh(const std::string & meshPath, Viewport* parent);
-        bool readMeshBuffer(float* dest, unsigned int& idx, char* src,
-                            const size_t srcSize_bytes, const int readSize_bytes);
         void setupSimpleMesh(CorrectionMeshGeometry * geomPtr, Viewport * parent);
         void setupMaskMesh(Viewport * parent, bool flip_x, bool flip_y);
         void createMesh(CorrectionMeshGeometry * geomPtr);
+        void releasePendingMesh(std::size_t index);
+        void uploadMesh(CorrectionMeshGeometry * geomPtr, const CorrectionMeshVertex * vertices, const unsigned int * indices);
+        static bool canPackVertices(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices);
+        static void setVertexPointers(CorrectionMeshGeometry::VertexFormat format, bool fixedPipeline);
+        std::string getMeshCacheFilename(const std::string & meshPath, Viewport * parent, MeshFormat fmt);
+        bool readMeshCache(const std::string & meshPath, Viewport * parent, MeshFormat fmt, const int * resolution);
+        void writeMeshCache(const std::string & meshPath, Viewport * parent, MeshFormat fmt, const int * resolution);
+        void optimizeMesh(const int * resolution);
+        void bakeWarpMap(WarpMapFormat format, const int * resolution);
+        void uploadWarpMap();
         void exportMesh(const std::string & exportMeshPath);
         void cleanUp();
         inline void clamp(float & val, const float max, const float min);
@@ -77,7 +156,17 @@ namespace sgct_core
         CorrectionMeshVertex * mTempVertices;
         unsigned int * mTempIndices;
         
-        CorrectionMeshGeometry mGeometries[3];
+        CorrectionMeshGeometry mGeometries[LAST_MESH];
+
+        //mesh data that is parsed but not yet uploaded to the GPU, a cached warp mesh points into the mapped cache file
+        const CorrectionMeshVertex * mPendingVertices[LAST_MESH];
+        const unsigned int * mPendingIndices[LAST_MESH];
+        sgct_helpers::SGCTMappedFile * mMeshCacheFile;
+        WarpMapBaker * mPendingWarpMap;
+        bool mUpdateFisheyeProjection;
+
+        unsigned int mWarpMapTexture;
+        int mWarpMapResolution[2];
     };
     
 } //sgct_core
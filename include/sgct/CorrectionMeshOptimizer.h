@@ -0,0 +1,89 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _CORRECTION_MESH_OPTIMIZER_H_
+#define _CORRECTION_MESH_OPTIMIZER_H_
+
+#include <vector>
+#include "CorrectionMesh.h"
+
+namespace sgct_core
+{
+
+/*!
+    Post-processing of indexed triangle lists used as warping meshes.
+
+    simplify() removes vertices in nearly linear regions of the mesh by collapsing edges as long as the
+    texture coordinates, interpolated by the simplified mesh, stay within a tolerance (in pixels) of the original
+    values at every removed vertex and where the new edges cross the original edges. Outer borders are only simplified
+    where they are straight within the tolerance.
+
+    optimizeVertexCache() reorders the triangles using Tom Forsyth's linear-speed vertex cache optimization and
+    the vertices in order of first use.
+*/
+class CorrectionMeshOptimizer
+{
+public:
+    CorrectionMeshOptimizer(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices, const unsigned int * indices, unsigned int numberOfIndices);
+
+    void simplify(float pixelTolerance, int resolutionX, int resolutionY, float colorTolerance = 1.0f / 255.0f);
+    void optimizeVertexCache();
+
+    //! \returns the vertices of the processed mesh
+    inline const std::vector<CorrectionMeshVertex> & getVertices() const { return mVertices; }
+    //! \returns the triangle indices of the processed mesh
+    inline const std::vector<unsigned int> & getIndices() const { return mIndices; }
+    //! \returns the largest texture coordinate error in pixels introduced by simplify
+    inline float getMaxError() const { return mMaxError; }
+
+    static float calculateACMR(const unsigned int * indices, unsigned int numberOfIndices, unsigned int cacheSize = 32);
+
+private:
+    struct PointLocation
+    {
+        std::size_t triangle;
+        double weights[3];
+        double distance;
+    };
+
+    bool tryCollapse(unsigned int from, unsigned int to);
+    bool locatePoint(unsigned int point, const std::vector<std::size_t> & triangles, PointLocation & location);
+    float evaluateError(unsigned int point, const PointLocation & location, float & colorError);
+    float evaluateCrossingError(unsigned int a, unsigned int b, unsigned int p, unsigned int q, float & colorError);
+    double signedArea(unsigned int v0, unsigned int v1, unsigned int v2);
+    double distanceToEdge(unsigned int vertex, unsigned int p, unsigned int q);
+    void getNeighbors(unsigned int vertex, std::vector<unsigned int> & neighbors, std::vector<unsigned int> & counts);
+    void removeVertexTriangle(unsigned int vertex, std::size_t triangle);
+    void compact();
+
+private:
+    std::vector<CorrectionMeshVertex> mVertices;
+    std::vector<unsigned int> mIndices;
+
+    //simplification state
+    std::vector< std::vector<std::size_t> > mVertexTriangles;
+    std::vector< std::vector<unsigned int> > mTrianglePoints; //removed vertices inside each triangle
+    std::vector<float> mPointErrors;
+    std::vector<unsigned char> mTriangleRemoved;
+    std::vector<unsigned char> mVertexLocked;
+    std::vector<unsigned char> mVertexRemoved;
+    std::vector<unsigned char> mVertexBorder;
+    std::vector<unsigned char> mVertexDirty;
+    std::vector<std::size_t> mOriginalNeighborOffsets;
+    std::vector<unsigned int> mOriginalNeighbors;
+
+    double mScaleX;
+    double mScaleY;
+    double mMaxOriginalEdgeLength;
+    float mTolerance;
+    float mColorTolerance;
+    float mMaxError;
+};
+
+}
+
+#endif
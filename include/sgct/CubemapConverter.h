@@ -0,0 +1,76 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _CUBEMAP_CONVERTER_H_
+#define _CUBEMAP_CONVERTER_H_
+
+#include "FisheyeProjection.h"
+#include "Image.h"
+
+namespace sgct_core
+{
+
+/*!
+    Resamples the six faces of a cube map into a fisheye or equirectangular image on the CPU, without an OpenGL context.
+
+    The faces are expected in the cube space used by FisheyeProjection, in the order of its sub viewports (+X, -X, +Y, -Y, +Z, -Z),
+    like the images used by the stitcher. With the four face method the faces are right (+X), bottom (+Y), top (-Y) and left (+Z).
+    Faces that are not needed by the projection can be NULL and pixels mapping to missing faces get the background color.
+    The FOV, crop factors, offset and rendering method have the same meaning as in FisheyeProjection. The tilt is applied on top of
+    the orientation the faces were rendered with, so faces rendered by a tilted FisheyeProjection should be converted with zero tilt.
+
+    Each row is converted in batches: the face coordinates of all pixels in a row are computed first and each face is then sampled
+    using Image::sampleBatch. The rows are split between threads.
+*/
+class CubemapConverter
+{
+public:
+    enum OutputType { Fisheye = 0, Equirectangular };
+    enum CubeFace { PositiveX = 0, NegativeX, PositiveY, NegativeY, PositiveZ, NegativeZ, NumberOfFaces };
+
+    CubemapConverter();
+
+    void setOutputType(OutputType type);
+    void setFOV(float angle);
+    void setTilt(float angle);
+    void setCropFactors(float left, float right, float bottom, float top);
+    void setOffset(float x, float y, float z = 0.0f);
+    void setRenderingMethod(FisheyeProjection::FisheyeMethod method);
+    void setInterpolationMode(NonLinearProjection::InterpolationMode im);
+    void setBackgroundColor(float red, float green, float blue, float alpha = 1.0f);
+
+    inline OutputType getOutputType() const { return mOutputType; }
+    inline NonLinearProjection::InterpolationMode getInterpolationMode() const { return mInterpolationMode; }
+
+    bool convert(Image * const faces[NumberOfFaces], Image & output, unsigned int numberOfThreads = 1) const;
+
+private:
+    struct FaceInfo
+    {
+        const Image * image;
+        int width;
+        int height;
+    };
+
+    void convertRows(const FaceInfo * faces, Image & output, std::size_t firstRow, std::size_t lastRow) const;
+    void calculateFaceCoordinates(std::size_t row, std::size_t width, std::size_t height, int * face, float * x, float * y, const FaceInfo * faces) const;
+
+private:
+    OutputType mOutputType;
+    NonLinearProjection::InterpolationMode mInterpolationMode;
+    FisheyeProjection::FisheyeMethod mMethod;
+
+    float mFOV;
+    float mTilt;
+    float mCropFactors[4];
+    float mOffset[3];
+    float mBackgroundColor[4];
+};
+
+}
+
+#endif
@@ -91,9 +91,9 @@ private:
     enum SyncStage { PreStage = 0, PostStage };
     enum BufferMode { BackBuffer = 0, BackBufferBlack, RenderToTexture };
     enum ViewportSpace { ScreenSpace = 0, FBOSpace };
-    enum ShaderIndexes { FBOQuadShader = 0, FXAAShader, OverlayShader };
+    enum ShaderIndexes { FBOQuadShader = 0, FXAAShader, OverlayShader, WarpMapShader };
     enum ShaderLocIndexes { MonoTex = 0,
-            OverlayTex,
+            OverlayTex, WarpMapTex, WarpMapFrameTex,
             SizeX, SizeY, FXAA_SUBPIX_TRIM, FXAA_SUBPIX_OFFSET, FXAA_Texture };
 
 public:
@@ -116,6 +116,11 @@ public:
     const double getAvgDt();
     const double getDrawTime();
     const double getSyncTime();
+    void getNodeStatistics(std::vector<std::string> & nodeNames, std::vector<sgct_core::StatisticsRecord> & records);
+    bool getNodeStartupRecords(std::vector<sgct_core::StartupRecord> & records);
+    void getNodeSyncLatencies(std::vector<std::string> & nodeNames, std::vector<sgct_core::SyncLatencySummary> & summaries);
+    std::string getSyncLatencyReport();
+    void printSyncLatencyReport();
 
     /*!
         \returns the clear color as 4 floats (RGBA)
@@ -135,6 +140,8 @@ public:
     void setEyeSeparation(float eyeSeparation);
     void setClearColor(float red, float green, float blue, float alpha);
     void setExitKey(int key);
+    void setTraceKey(int key);
+    bool saveTrace();
     void setExitWaitTime(double time);
     void updateFrustums();
     void addPostFX( PostFX & fx );
@@ -243,6 +250,7 @@ public:
     void sendMessageToExternalControl(const void * data, int length);
     void sendMessageToExternalControl(const std::string& msg);
     bool isExternalControlConnected();
+    void sendStatisticsToExternalControl();
     void setExternalControlBufferSize(unsigned int newSize);
     void invokeDecodeCallbackForExternalControl(const char * receivedData, int receivedlength, int clientId);
     void invokeUpdateCallbackForExternalControl(bool connected);
@@ -411,13 +419,16 @@ private:
     void parseArguments( std::vector<std::string>& arg );
     void renderDisplayInfo();
     void printNodeInfo(unsigned int nodeId);
+    bool printStartupReport();
     void enterCurrentViewport();
     void updateAAInfo(std::size_t winIndex);
     void updateDrawBufferResolutions();
+    std::string getTraceFilename(bool addFrameNumber);
 
     void draw();
     void drawOverlays();
     void renderFBOTexture();
+    void renderWarpedViewports(SGCTWindow * win, sgct_core::CorrectionMesh::MeshType mt, int xSize, int ySize);
     void renderPostFX(TextureIndexes ti );
     void renderViewports(TextureIndexes ti);
     void render2D();
@@ -538,6 +549,8 @@ private:
     sgct_core::ReadConfig        * mConfig;
     sgct_core::Statistics        * mStatistics;
     sgct_core::SGCTNode            * mThisNode;
+    sgct_core::StartupRecord    mStartupRecord;
+    sgct_core::SyncLatencyStatistics mSyncLatency; //age of the shared data on the master
 
     std::thread * mThreadPtr;
 
@@ -545,6 +558,7 @@ private:
     std::string mLogfilePath;
     int mRunning;
     bool mInitialized;
+    bool mStartupReportPrinted;
     std::string mAAInfo;
 
     unsigned int mFrameCounter;
@@ -563,6 +577,8 @@ private:
     RunMode mRunMode;
     std::string mGLSLVersion;
     int mExitKey;
+    int mTraceKey;
+    bool mTraceKeyPressed;
 };
 
 }
@@ -104,6 +104,7 @@ private:
 	FT_Face	mFace;
 	FT_Library mFTLibrary;
 	FT_Fixed mStrokeSize;
+	std::size_t mGlyphTextureSize; // Estimated size of the glyph textures in bytes
 	sgct_cppxeleven::unordered_map<wchar_t, FontFaceData> mFontFaceDataMap;
 };
 
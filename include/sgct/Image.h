@@ -16,14 +16,32 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 #include <string>
 
+namespace sgct_helpers
+{
+    class SGCTMappedFile;
+}
+
 namespace sgct_core
 {
 
+/*!
+    Interface for custom image data allocation, for example a pool of reusable buffers.
+*/
+class ImageAllocator
+{
+public:
+    virtual ~ImageAllocator() {}
+    virtual unsigned char * allocate(std::size_t size) = 0;
+    virtual void deallocate(unsigned char * ptr, std::size_t size) = 0;
+};
+
 class Image
 {
 public:
     enum ChannelType { Blue = 0, Green, Red, Alpha };
-    enum FormatType { FORMAT_PNG = 0, FORMAT_JPEG, FORMAT_TGA, UNKNOWN_FORMAT };
+    enum FormatType { FORMAT_PNG = 0, FORMAT_JPEG, FORMAT_TGA, FORMAT_PFM, FORMAT_HDR, UNKNOWN_FORMAT };
+    enum SampleFilter { SAMPLE_BILINEAR = 0, SAMPLE_BICUBIC };
+    enum SampleEdgeMode { SAMPLE_CLAMP_TO_EDGE = 0, SAMPLE_CLAMP_TO_BORDER };
     
     Image();
     ~Image();
@@ -36,16 +54,32 @@ public:
     bool loadJPEG(unsigned char * data, std::size_t len);
     bool loadTGA(std::string filename);
     bool loadTGA(unsigned char * data, std::size_t len);
+    bool loadPFM(std::string filename);
+    bool loadPFM(unsigned char * data, std::size_t len);
+    bool loadHDR(std::string filename);
+    bool loadHDR(unsigned char * data, std::size_t len);
     bool save();
     bool savePNG(std::string filename, int compressionLevel = -1);
     bool savePNG(int compressionLevel = -1);
     bool saveJPEG(int quality = 100);
+    bool saveJPEGFromYUV420(unsigned char * yuvData, int quality = 100);
+    bool encodeJPEG(unsigned char ** jpegBuf, std::size_t * jpegSize, int quality = 100);
+    bool encodeJPEGFromYUV420(unsigned char * yuvData, unsigned char ** jpegBuf, std::size_t * jpegSize, int quality = 100);
+    static std::size_t getYUV420Size(std::size_t width, std::size_t height);
     bool saveTGA();
+    bool savePFM();
+    bool saveHDR();
+    bool convertToHalfFloat();
+    bool convertToFloat();
     void setFilename(std::string filename);
     void setPreferBGRExport(bool state);
 	void setPreferBGRImport(bool state);
 	bool getPreferBGRExport() const;
 	bool getPreferBGRImport() const;
+    void setHalfFloatImport(bool state);
+    bool getHalfFloatImport() const;
+    void setFloatData(bool state);
+    bool isFloatData() const;
 
     unsigned char * getData();
     unsigned char * getDataAt(std::size_t x, std::size_t y);
@@ -62,9 +96,14 @@ public:
     unsigned char getSampleAt(std::size_t x, std::size_t y, ChannelType c);
     void setSampleAt(unsigned char val, std::size_t x, std::size_t y, ChannelType c);
     float getInterpolatedSampleAt(float x, float y, ChannelType c);
+    bool sampleBatch(std::size_t count, const float * x, const float * y, float * dst,
+        SampleFilter filter = SAMPLE_BILINEAR, SampleEdgeMode edgeMode = SAMPLE_CLAMP_TO_EDGE) const;
     
 
-    void setDataPtr(unsigned char * dPtr);
+    void setDataPtr(unsigned char * dPtr, std::size_t capacity = 0);
+    void setAllocator(ImageAllocator * allocator);
+    std::size_t getBufferSize() const;
+    void releaseData();
     void setSize(std::size_t width, std::size_t height);
     void setChannels(std::size_t channels);
     void setBytesPerChannel(std::size_t bpc);
@@ -73,9 +112,18 @@ public:
 private:
     void cleanup();
     bool allocateRowPtrs();
+    bool mapFile(sgct_helpers::SGCTMappedFile & file, const char * formatName);
+    bool decodePNG(unsigned char * data, std::size_t len);
+    bool decodeTGA(unsigned char * data, std::size_t len);
+    bool decodeJPEG(unsigned char * data, std::size_t len);
+    bool decodePFM(unsigned char * data, std::size_t len);
+    bool decodeHDR(unsigned char * data, std::size_t len);
+    void storeFloatRow(float * src, std::size_t y);
+    void readFloatRow(std::size_t y, float * dst);
+    bool prepareJPEGCompression(int subsamp);
+    bool writeBufferToFile(const unsigned char * buffer, std::size_t size, const char * formatName);
     FormatType getFormatType(const std::string & filename);
     bool isTGAPackageRLE(unsigned char * row, std::size_t pos);
-    bool decodeTGARLE(FILE * fp);
     bool decodeTGARLE(unsigned char * data, std::size_t len);
     std::size_t getTGAPackageLength(unsigned char * row, std::size_t pos, bool rle);
     
@@ -85,12 +133,23 @@ private:
     std::size_t mSize_x;
     std::size_t mSize_y;
     std::size_t mDataSize;
+    std::size_t mBufferSize;
     std::size_t mBytesPerChannel;
     std::string mFilename;
     unsigned char * mData;
     png_bytep * mRowPtrs;
+    std::size_t mRowPtrsSize;
+    ImageAllocator * mAllocator;
     bool mPreferBGRForExport;
 	bool mPreferBGRForImport;
+    bool mHalfFloatImport;
+    bool mFloatData; //2 bytes per channel = half float, 4 bytes per channel = float
+
+    //TurboJPEG handles and output buffer, reused between calls
+    void * mJPEGCompressor;
+    void * mJPEGDecompressor;
+    unsigned char * mJPEGBuffer;
+    unsigned long mJPEGBufferSize;
 };
 
 }
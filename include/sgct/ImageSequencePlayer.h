@@ -0,0 +1,123 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _IMAGE_SEQUENCE_PLAYER_H_
+#define _IMAGE_SEQUENCE_PLAYER_H_
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#include "Image.h"
+
+namespace sgct_core
+{
+class SGCTThreadPool;
+}
+
+namespace sgct
+{
+
+/*!
+    Plays back a sequence of image files (PNG, JPEG, TGA, PFM or HDR) as a texture. The frames ahead of the current frame are decoded
+    in parallel by a pool of worker threads into a bounded set of reusable image buffers and streamed to the texture through
+    pixel unpack buffers.
+
+    The frame to show is given to update() which should be called from the post-sync-pre-draw callback using a frame index that is
+    synchronized by the master (for example a sgct::SharedUInt64), so that all nodes show the same frame.
+*/
+class ImageSequencePlayer
+{
+public:
+    ImageSequencePlayer();
+    ~ImageSequencePlayer();
+
+    bool open(const std::vector<std::string> & filenames);
+    bool open(const std::string & pattern, std::size_t first, std::size_t count);
+    void close();
+    void update(std::size_t frameIndex);
+
+    void setReadAhead(std::size_t frames);
+    void setMemoryBudget(std::size_t bytes);
+    void setNumberOfThreads(unsigned int count);
+    void setLoop(bool state);
+    void setWaitForFrames(bool state);
+    void setInterpolate(bool state);
+    std::size_t getMemoryUsage();
+
+    //! \returns the openGL texture id containing the current frame, 0 if no frame has been uploaded yet
+    inline unsigned int getTextureId() const { return mTexId; }
+    //! \returns the index of the frame currently in the texture
+    inline std::size_t getCurrentFrame() const { return mCurrentFrame; }
+    //! \returns the number of frames in the sequence
+    inline std::size_t getNumberOfFrames() const { return mFilenames.size(); }
+    //! \returns the number of times update was called before the requested frame was decoded (only when not waiting for frames)
+    inline std::size_t getNumberOfLateFrames() const { return mLateFrames; }
+    //! \returns the width of the current frame
+    inline int getWidth() const { return mTexWidth; }
+    //! \returns the height of the current frame
+    inline int getHeight() const { return mTexHeight; }
+
+private:
+    enum SlotState { Slot_Free = 0, Slot_Decoding, Slot_Ready, Slot_Failed };
+
+    class FrameSlot
+    {
+    public:
+        FrameSlot();
+        sgct_core::Image mImage;
+        std::size_t mFrame;
+        SlotState mState;
+    };
+
+    std::size_t wrapFrame(std::size_t frameIndex) const;
+    void updateUsableSlots();
+    std::size_t getHeldBytes() const;
+    FrameSlot * findSlot(std::size_t frame);
+    void scheduleFrames(std::size_t frameIndex);
+    void decodeFrame(FrameSlot * slot);
+    bool uploadFrame(FrameSlot * slot);
+    void releaseGLData();
+
+    // Don't implement these, should give compile warning if used
+    ImageSequencePlayer(const ImageSequencePlayer & isp);
+    const ImageSequencePlayer & operator=(const ImageSequencePlayer & rhs);
+
+private:
+    std::vector<std::string> mFilenames;
+    std::vector<FrameSlot *> mSlots;
+    sgct_core::SGCTThreadPool * mDecoderPool;
+    std::mutex mSlotMutex;
+    std::condition_variable mSlotCondition;
+
+    std::size_t mReadAhead;
+    std::size_t mMemoryBudget;
+    std::size_t mUsableSlots;
+    std::size_t mFrameSize;
+    std::size_t mCurrentFrame;
+    std::size_t mLateFrames;
+    unsigned int mNumberOfThreads;
+    bool mLoop;
+    bool mWaitForFrames;
+    bool mInterpolate;
+    bool mBudgetWarning;
+
+    unsigned int mTexId;
+    unsigned int mPBO[2];
+    std::size_t mPBOSize;
+    std::size_t mPBOIndex;
+    int mTexWidth;
+    int mTexHeight;
+    int mTexChannels;
+    int mTexBytesPerChannel;
+    bool mTexFloat;
+};
+
+}
+
+#endif
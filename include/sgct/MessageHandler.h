@@ -10,18 +10,34 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 #include <stddef.h> //get definition for NULL
 #include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
 #include <vector>
 #include <string>
 #include "helpers/SGCTCPPEleven.h"
 
 #include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #define TIME_BUFFER_SIZE 9
 #define LOG_FILENAME_BUFFER_SIZE 1024 //include path
+#define LOG_QUEUE_LENGTH 2048 //number of messages, must be a power of two
+#define LOG_MESSAGE_SIZE 232 //longer messages are allocated on the heap
+#define LOG_SERVER_BUFFER_SIZE 1048576 //default limit of messages waiting to be sent to the server
 
 namespace sgct //simple graphics cluster toolkit
 {
 
+/*!
+    Prints messages to the console, a log file and a callback, and sends them to the master if enabled.
+
+    Messages are formatted by the calling thread into a lock-free queue and written by a background thread,
+    which also invokes the callback. The log file is kept open and can be rotated by size. If the queue is full
+    new messages are dropped and counted. The queue is flushed at exit and, if enabled by setFlushOnCrash, on crashes.
+*/
 class MessageHandler
 {
 public:
@@ -59,6 +75,8 @@ public:
     void sendMessageToServer(const char *fmt);
     void setSendFeedbackToServer(bool state);
     void clearBuffer();
+    void setServerMessageBufferSize(std::size_t size);
+    bool getServerMessages(std::vector<char> & messages, uint32_t & droppedMessages);
     void setNotifyLevel( NotifyLevel nl );
     NotifyLevel getNotifyLevel();
     void setShowTime( bool state );
@@ -67,14 +85,16 @@ public:
     void setLogToFile( bool state );
     void setLogPath(const char * path, int nodeId = -1);
     void setLogToCallback( bool state );
+    void setLogFileRotation(std::size_t maxFileSize, unsigned int maxNumberOfFiles);
+    void setFlushOnCrash(bool state);
     void setLogCallback(void(*fnPtr)(const char *));
 #ifdef __LOAD_CPP11_FUN__
     void setLogCallback(sgct_cppxeleven::function<void(const char *)> fn);
 #endif
     const char * getTimeOfDayStr();
-    inline std::size_t getDataSize() { return mBuffer.size(); }
-
-    char * getMessage();
+    void flush();
+    //! \returns the number of messages dropped because the queue was full
+    inline uint64_t getNumberOfDroppedMessages() const { return mDroppedMessages.load(); }
 
 private:
     MessageHandler(void);
@@ -84,7 +104,20 @@ private:
     MessageHandler( const MessageHandler & tm );
     const MessageHandler & operator=(const MessageHandler & rhs );
     void printv(const char *fmt, va_list ap);
-    void logToFile(const char * buffer);
+
+    //writer thread
+    static void writerThreadStarter(void * arg);
+    void writerThread();
+    std::size_t processMessages();
+    void writeMessage(const char * message, std::size_t length, time_t timeStamp, bool showTime, std::string & consoleBatch);
+    void logToFile(const char * buffer, std::size_t length);
+    void openLogFile();
+    void closeLogFile();
+    static int getDescriptor(FILE * file);
+    void rotateLogFiles();
+    std::string getRotatedFilename(unsigned int index);
+    static void flushAtExit();
+    static void crashHandler(int signal);
 
 private:
 #ifdef __LOAD_CPP11_FUN__
@@ -95,12 +128,50 @@ private:
 
     static MessageHandler * mInstance;
 
-    char * mParseBuffer;
-    char * mCombinedBuffer;
-    
-    std::vector<char> mBuffer;
-    std::vector<char> mRecBuffer;
-    unsigned char  * headerSpace;
+    struct Message
+    {
+        std::atomic<uint64_t> mSequence;
+        time_t mTime;
+        bool mShowTime;
+        uint32_t mLength;
+        char * mLongText; //allocated if the message doesn't fit in mText
+        char mText[LOG_MESSAGE_SIZE];
+    };
+
+    //bounded multi-producer single-consumer queue
+    Message * mQueue;
+    std::atomic<uint64_t> mEnqueuePos;
+    std::atomic<uint64_t> mDequeuePos;
+    std::atomic<uint64_t> mDroppedMessages;
+    uint64_t mReportedDroppedMessages;
+    std::atomic_flag mConsumerLock; //held by the thread emptying the queue
+
+    std::thread * mWriterThread;
+    std::thread::id mWriterThreadId;
+    std::atomic<bool> mRunning;
+    std::atomic<bool> mWriterWaiting;
+    std::mutex mWriterMutex;
+    std::condition_variable mWriterCondition;
+    std::condition_variable mFlushCondition;
+
+    //only used by the writer
+    FILE * mFile;
+    std::atomic<int> mFileDescriptor; //read by the crash handler
+    std::string mOpenFilename;
+    std::size_t mFileSize;
+    std::string mWriterLine;
+    time_t mWriterTime;
+    char mWriterTimeBuffer[TIME_BUFFER_SIZE];
+
+    std::mutex mFilenameMutex;
+    std::atomic<std::size_t> mMaxFileSize;
+    std::atomic<unsigned int> mMaxNumberOfFiles;
+
+    //messages waiting to be sent to the server, not protected by the sync mutex to not delay the acknowledge
+    std::vector<char> mServerMessages;
+    std::size_t mServerMessageBufferSize;
+    uint32_t mDroppedServerMessages;
+    std::mutex mServerMessagesMutex;
 
     std::atomic<int> mLevel;
     std::atomic<bool> mLocal;
@@ -110,10 +181,10 @@ private:
     std::atomic<bool> mLogToCallback;
 
     MessageCallbackFn mMessageCallback;
+    MessageCallbackFn mWriterCallback; //copy used by the writer
+    std::mutex mCallbackMutex;
     char mTimeBuffer[TIME_BUFFER_SIZE];
     std::string mFilename;
-    size_t mMaxMessageSize;
-    size_t mCombinedMessageSize;
 };
 
 }
@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #define _OFF_SCREEN_BUFFER
 
 #include "ogl_headers.h"
+#include "SGCTMemoryRegistry.h"
 
 namespace sgct_core
 {
@@ -23,6 +24,7 @@ public:
     void createFBO(int width, int height, int samples = 1);
     void resizeFBO(int width, int height, int samples = 1);
     void setInternalColorFormat(GLint internalFormat);
+    void setMemorySubsystem(sgct::SGCTMemoryRegistry::Subsystem subsystem);
     void attachColorTexture(unsigned int texId, GLenum attachment = GL_COLOR_ATTACHMENT0);
     void attachDepthTexture(unsigned int texId);
     void attachCubeMapTexture(unsigned int texId, unsigned int face, GLenum attachment = GL_COLOR_ATTACHMENT0);
@@ -52,6 +54,7 @@ private:
     unsigned int mPositionBuffer;
     unsigned int mDepthBuffer;
     int mInternalColorFormat;
+    sgct::SGCTMemoryRegistry::Subsystem mMemorySubsystem;
 
     int mWidth;
     int mHeight;
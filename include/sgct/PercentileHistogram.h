@@ -0,0 +1,52 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _PERCENTILE_HISTOGRAM_H_
+#define _PERCENTILE_HISTOGRAM_H_
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace sgct_core
+{
+
+/*!
+    Log-linear histogram of times over a sliding window, used to get percentiles like p99 without sorting.
+
+    Times are stored in microseconds. Values below 64 us get their own bucket and every power of two above is split in 64 buckets,
+    so a percentile is within about 1.6% of the real value. Times above about 35 minutes end up in the last bucket.
+    Adding a value is constant time, the oldest value is removed from its bucket when the window is full.
+*/
+class PercentileHistogram
+{
+public:
+    PercentileHistogram(std::size_t windowLength = 1024);
+
+    void setWindowLength(std::size_t windowLength);
+    void add(float seconds);
+    void clear();
+    float getPercentile(float percentile) const;
+    void getPercentiles(const float * percentiles, float * values, std::size_t count) const;
+
+    //! \returns the number of values in the window
+    inline std::size_t getCount() const { return mCount; }
+
+private:
+    static std::size_t getBucketIndex(uint32_t microseconds);
+    static float getBucketValue(std::size_t index);
+
+private:
+    std::vector<uint32_t> mCounts;
+    std::vector<uint16_t> mWindow; //bucket index of the latest values, oldest at mHead when full
+    std::size_t mHead;
+    std::size_t mCount;
+};
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_MEMORY_REGISTRY_H_
+#define _SGCT_MEMORY_REGISTRY_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <stddef.h>
+
+namespace sgct
+{
+
+/*!
+    This singleton class keeps estimates of the memory allocated by SGCT, per subsystem and per object.
+
+    Every allocation is identified by its owner (the object that holds it) and a name, setting an allocation again
+    replaces the previous estimate. GPU sizes are estimated from the dimensions and internal formats of textures,
+    render buffers and buffer objects, the driver might use more due to alignment and padding.
+
+    The registry can be queried at any time from any thread. It is created in Engine::init and destroyed by Engine::clean,
+    allocations are only recorded while it exists() so that headless tools and objects released after the engine
+    don't create it again.
+*/
+class SGCTMemoryRegistry
+{
+public:
+    enum Subsystem { WindowBuffers = 0, NonLinearProjectionBuffers, CorrectionMeshes, ScreenCaptureBuffers, Images, Fonts, Textures, NumberOfSubsystems };
+    enum MemoryType { CPU = 0, GPU, NumberOfMemoryTypes };
+
+    struct Allocation
+    {
+        Subsystem mSubsystem;
+        MemoryType mType;
+        const void * mOwner;
+        std::string mName;
+        std::size_t mSize;
+    };
+
+    /*! Get the SGCTMemoryRegistry instance */
+    static SGCTMemoryRegistry * instance()
+    {
+        if( mInstance == NULL )
+        {
+            mInstance = new SGCTMemoryRegistry();
+        }
+
+        return mInstance;
+    }
+
+    /*! Destroy the SGCTMemoryRegistry instance */
+    static void destroy()
+    {
+        if( mInstance != NULL )
+        {
+            delete mInstance;
+            mInstance = NULL;
+        }
+    }
+
+    //! \returns true if the instance is created, use before removing allocations in destructors
+    static inline bool exists() { return mInstance != NULL; }
+
+    void setAllocation(Subsystem subsystem, MemoryType type, const void * owner, const std::string & name, std::size_t size);
+    void removeAllocation(const void * owner, const std::string & name);
+    void removeAllocations(const void * owner);
+
+    std::size_t getSize(Subsystem subsystem, MemoryType type);
+    std::size_t getTotalSize(MemoryType type);
+    void getAllocations(std::vector<Allocation> & allocations);
+    std::string getReport(bool perObject);
+    void printReport(bool perObject);
+
+    static const char * getSubsystemName(Subsystem subsystem);
+    static std::size_t getTextureSize(int width, int height, int internalFormat, int samples = 1, bool mipmaps = false);
+
+private:
+    SGCTMemoryRegistry();
+
+    // Don't implement these, should give compile warning if used
+    SGCTMemoryRegistry( const SGCTMemoryRegistry & registry );
+    const SGCTMemoryRegistry & operator=(const SGCTMemoryRegistry & registry );
+
+    static std::size_t getBytesPerTexel(int internalFormat, bool & compressed);
+
+private:
+    static SGCTMemoryRegistry * mInstance;
+
+    std::mutex mMutex;
+    std::map< std::pair<const void *, std::string>, Allocation > mAllocations;
+    std::size_t mSizes[NumberOfSubsystems][NumberOfMemoryTypes];
+};
+
+}
+
+#endif
@@ -24,33 +24,17 @@
 namespace sgct_core //simple graphics cluster toolkit
 {
 
-struct MpcdiSubFiles {
-    enum mpcdiSubFileTypes {
-        mpcdiXml = 0,
-        mpcdiPfm,
-        mpcdi_nRequiredFiles //Leave at end
-    };
-    bool hasFound[mpcdi_nRequiredFiles];
-    std::string extension[mpcdi_nRequiredFiles];
-    std::string filename[mpcdi_nRequiredFiles];
-    int size[mpcdi_nRequiredFiles];
-    char* buffer[mpcdi_nRequiredFiles];
-
-    MpcdiSubFiles() {
-        for (int i = 0; i < mpcdi_nRequiredFiles; ++i) {
-            hasFound[i] = false;
-            buffer[i] = nullptr;
-        }
-		extension[mpcdiXml] = "xml";
-		extension[mpcdiPfm] = "pfm";
-    }
+//! Location of a file inside the MPCDI archive, so that it can be decompressed later on
+struct MpcdiZipEntry {
+    std::string filename;
+    unz_file_pos position;
+    unsigned long size;
+};
 
-    ~MpcdiSubFiles() {
-        for (int i = 0; i < mpcdi_nRequiredFiles; ++i) {
-            if( buffer[i] != nullptr )
-                delete buffer[i];
-        }
-    }
+//! A viewport waiting for its warp file to be decompressed
+struct MpcdiWarpRequest {
+    Viewport* viewport;
+    std::size_t pfmEntry;
 };
 
 struct MpcdiRegion {
@@ -80,7 +64,9 @@ public:
              sgct::SGCTWindow& tmpWin);
 
 private:
-    bool readAndParseXMLString(SGCTNode& tmpNode, sgct::SGCTWindow& tmpWin);
+    bool readXMLFile(unzFile* zipfile, std::vector<char>& buffer);
+    bool readAndParseXMLString(std::vector<char>& buffer, SGCTNode& tmpNode, sgct::SGCTWindow& tmpWin);
+    bool readWarpFiles(const std::string& filenameMpcdi);
     bool readAndParseXML_mpcdi(tinyxml2::XMLDocument& xmlDoc, SGCTNode tmpNode,
              sgct::SGCTWindow& tmpWin);
     bool readAndParseXML_display(tinyxml2::XMLElement* element[], const char* val[],
@@ -94,7 +80,7 @@ private:
     bool readAndParseXML_geoWarpFile(tinyxml2::XMLElement* element[],
              const char* val[], sgct::SGCTWindow& tmpWin,
              std::string filesetRegionId);
-    bool openZipFile(FILE* cfgFile, const std::string cfgFilePath, unzFile* zipfile);
+    bool openZipFile(const std::string cfgFilePath, unzFile* zipfile);
     bool processSubFiles(std::string filename, unzFile* zipfile,
              unz_file_info& file_info);
     bool doesStringHaveSuffix(const std::string &str, const std::string &suffix);
@@ -103,7 +89,10 @@ private:
              const std::string expectedTag);
     void unsupportedFeatureCheck(std::string tag, std::string featureName);
 
-    MpcdiSubFiles mMpcdiSubFileContents;
+    bool mHasXmlEntry;
+    MpcdiZipEntry mXmlEntry;
+    std::vector<MpcdiZipEntry> mPfmEntries;
+    std::vector<MpcdiWarpRequest> mWarpRequests;
     std::vector<MpcdiRegion*> mBufferRegions;
     std::vector<MpcdiWarp*> mWarp;
     std::string mErrorMsg;
@@ -10,14 +10,27 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 #define SGCT_NUMBER_OF_MUTEXES 6
 
+#include "SGCTConfig.h"
 #include <mutex>
+#include <string>
+#include <map>
+#include <utility>
 #include <stddef.h>
+#include <stdint.h>
+#include "PercentileHistogram.h"
 
 namespace sgct
 {
 
+class SGCTProfiledMutex;
+
 /*!
     This singleton class manages SGCTs mutexes
+
+    When SGCT is built with the SGCT_MUTEX_PROFILING CMake option (INCLUDE_SGCT_MUTEX_PROFILING in SGCTConfig.h) every lock
+    through lockMutex records the time spent waiting for the mutex and the time it was held, per mutex and call site.
+    The mutexes of the shared data types are recorded as a single mutex. Locks taken through getMutexPtr, like the condition
+    waits of the render loop, are not recorded. Use printReport or getReport to see the result, the report is also printed at exit.
 */
 class SGCTMutexManager
 {
@@ -45,10 +58,17 @@ public:
         }
     }
 
-    void lockMutex(MutexIndexes mi);
+    void lockMutex(MutexIndexes mi, const char * callSite = NULL);
     void unlockMutex(MutexIndexes mi);
     std::mutex * getMutexPtr(MutexIndexes mi);
 
+    std::string getReport();
+    void printReport();
+    void resetStatistics();
+
+    //! \returns true if SGCT is built with mutex profiling
+    static inline bool isProfilingEnabled() { return INCLUDE_SGCT_MUTEX_PROFILING != 0; }
+
 private:
     SGCTMutexManager();
     ~SGCTMutexManager();
@@ -57,10 +77,82 @@ private:
     SGCTMutexManager( const SGCTMutexManager & settings );
     const SGCTMutexManager & operator=(const SGCTMutexManager & settings );
 
+    struct LockStatistics
+    {
+        LockStatistics();
+
+        const char * mMutexName;
+        const char * mCallSite;
+        uint64_t mCount;
+        uint64_t mContendedCount;
+        double mTotalWaitTime;
+        double mTotalHoldTime;
+        sgct_core::PercentileHistogram mWaitTimes;
+        sgct_core::PercentileHistogram mHoldTimes;
+    };
+
+    //a lock in progress, kept by the holder and recorded after the mutex is unlocked
+    struct LockRecord
+    {
+        LockRecord() : mCallSite(NULL), mContended(false), mWaitTime(0), mLockTime(0) {}
+
+        const char * mCallSite;
+        bool mContended;
+        int64_t mWaitTime;
+        int64_t mLockTime;
+    };
+
+    void addLock(const char * mutexName, const LockRecord & record, int64_t holdTime);
+    static int64_t getTime();
+    static bool compareWaitTime(const LockStatistics * a, const LockStatistics * b);
+
+    friend class SGCTProfiledMutex;
+
 private:
     static SGCTMutexManager * mInstance;
     std::mutex mInternalMutexes[SGCT_NUMBER_OF_MUTEXES];
+
+    //only written by the thread holding the mutex
+    LockRecord mHolderRecords[SGCT_NUMBER_OF_MUTEXES];
+
+    std::mutex mStatisticsMutex;
+    std::map< std::pair<const char *, const char *>, LockStatistics * > mStatistics;
 };
+
+/*!
+    Mutex that records its lock statistics in the SGCTMutexManager when SGCT is built with mutex profiling, used by the shared data types.
+    Has the same interface as std::mutex so that it can be used in its place.
+*/
+class SGCTProfiledMutex
+{
+public:
+    explicit SGCTProfiledMutex(const char * name = "SharedDataTypes") : mName(name), mRecorded(false) {}
+
+    void lock();
+    void unlock();
+    bool try_lock();
+
+private:
+    // Don't implement these, should give compile warning if used
+    SGCTProfiledMutex( const SGCTProfiledMutex & mutex );
+    const SGCTProfiledMutex & operator=(const SGCTProfiledMutex & mutex );
+
+    std::mutex mMutex;
+    const char * mName;
+    SGCTMutexManager::LockRecord mRecord;
+    bool mRecorded;
+};
+
 }
 
+#define SGCT_MUTEX_STRINGIFY_IMPL(x) #x
+#define SGCT_MUTEX_STRINGIFY(x) SGCT_MUTEX_STRINGIFY_IMPL(x)
+
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    //! The file and line passed to SGCTMutexManager::lockMutex to identify the call site
+    #define SGCT_MUTEX_CALL_SITE __FILE__ ":" SGCT_MUTEX_STRINGIFY(__LINE__)
+#else
+    #define SGCT_MUTEX_CALL_SITE NULL
+#endif
+
 #endif
\ No newline at end of file
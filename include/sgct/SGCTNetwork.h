@@ -31,6 +31,12 @@ typedef int _ssize_t;
 namespace sgct_core //small graphics cluster toolkit
 {
 
+struct StatisticsRecord;
+struct StartupRecord;
+struct SyncLatencyRecord;
+struct SyncLatencySummary;
+class SyncLatencyStatistics;
+
 /*!
 SGCTNetwork manages peer-to-peer tcp connections.
 */
@@ -38,11 +44,12 @@ class SGCTNetwork
 {
 public:
     //ASCII device control chars = 17, 18, 19 & 20
-    enum PackageHeaderId { DefaultId = 0, Ack = 6, DataId = 17, ConnectedId = 18, DisconnectId = 19, CompressedDataId = 21 };
+    enum PackageHeaderId { DefaultId = 0, Ack = 6, DataId = 17, ConnectedId = 18, DisconnectId = 19, CompressedDataId = 21, LogId = 22, StartupId = 23 };
     enum ConnectionTypes { SyncConnection = 0, ExternalASCIIConnection, ExternalRawConnection, DataTransfer };
     enum ReceivedIndex { Current = 0, Previous };
 
     SGCTNetwork();
+    ~SGCTNetwork();
     void init(const std::string port, const std::string address, bool _isServer, ConnectionTypes serverType);
     void closeNetwork(bool forced);
     void initShutdown();
@@ -77,7 +84,12 @@ public:
     static int32_t parseInt32(char * str);
     static uint32_t parseUInt32(char * str);
     int iterateFrameCounter();
-    void pushClientMessage();
+    void pushClientMessage(const StatisticsRecord * record = NULL, const SyncLatencyRecord * latency = NULL);
+    bool getClientStatistics(StatisticsRecord & record);
+    bool getClientSyncLatency(SyncLatencySummary & summary);
+    void pushClientLog(bool force = false);
+    void pushStartupRecord(const StartupRecord & record);
+    bool getClientStartupRecord(StartupRecord & record);
     void enableNaglesAlgorithmInDataTransfer();
     std::string getPort();
     std::string getAddress();
@@ -137,6 +149,17 @@ private:
 
     char * mRecvBuf;
     char * mUncompressBuf;
+    std::vector<char> mClientStatistics; //latest encoded record from the client, empty if none received
+    std::mutex mClientStatisticsMutex;
+    std::vector<char> mClientStartupRecord; //encoded start-up times from the client, empty if none received
+    SyncLatencyStatistics * mClientSyncLatency;
+    //the latest acknowledge on the server, read by the connection thread when the record of the acknowledge arrives
+    double mAckSendTime;
+    double mAckReceiveTime;
+    bool mAckInSync;
+    std::vector<char> mClientLog;
+    std::vector<char> mClientLogCompressed;
+    double mClientLogTime;
     char mHeaderId;
 
     bool mUseNaglesAlgorithmInDataTransfer;
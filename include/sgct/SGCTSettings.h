@@ -62,6 +62,9 @@ public:
     void setBufferFloatPrecision(BufferFloatPrecision bfp);
     void setUseFBO(bool state);
     void setNumberOfCaptureThreads(int count);
+    void setNumberOfTextureLoadingThreads(int count);
+    void setTextureUploadSizeBudget(std::size_t bytes);
+    void setTextureUploadTimeBudget(float ms);
     void setPNGCompressionLevel(int level);
     void setJPEGQuality(int quality);
     void setCapturePath(std::string path, CapturePathIndex cpi = Mono);
@@ -69,6 +72,15 @@ public:
     void setCaptureFormat(const char * format);
     void setCaptureFromBackBuffer(bool state);
     void setExportWarpingMeshes(bool state);
+    void setUseWarpingMeshCache(bool state);
+    void setWarpingMeshCachePath(std::string path);
+    void setWarpingMeshSimplificationTolerance(float pixels);
+    void setUseWarpingMeshVertexCacheOptimization(bool state);
+    void setUseWarpingMeshPackedVertices(bool state);
+    void setUseWarpMaps(bool state);
+    void setTracePath(std::string path);
+    void setTraceBufferSize(std::size_t numberOfEvents);
+    void setSaveTraceOnExit(bool state);
     void setFXAASubPixTrim(float val);
     void setFXAASubPixOffset(float val);
     void setOSDTextXOffset(float val);
@@ -120,6 +132,30 @@ public:
     inline bool        useFBO() { return mUseFBO; }
     //! Get the number of capture threads (for screenshot recording)
     inline int        getNumberOfCaptureThreads() { return mNumberOfCaptureThreads; }
+    //! Get the number of threads decoding asynchronously loaded textures
+    inline int        getNumberOfTextureLoadingThreads() { return mNumberOfTextureLoadingThreads; }
+    //! Get the maximum number of bytes of asynchronously loaded textures that are uploaded per frame
+    inline std::size_t getTextureUploadSizeBudget() { return mTextureUploadSizeBudget; }
+    //! Get the maximum time in milliseconds spent uploading asynchronously loaded textures per frame
+    inline float    getTextureUploadTimeBudget() { return mTextureUploadTimeBudget; }
+    //! Returns true if parsed warping meshes are cached in a binary format for faster loading
+    inline bool        getUseWarpingMeshCache() { return mUseWarpingMeshCache; }
+    //! Get the directory where warping mesh caches are stored, empty if stored beside the source meshes
+    inline const std::string & getWarpingMeshCachePath() { return mWarpingMeshCachePath; }
+    //! Get the maximum error in pixels allowed when simplifying warping meshes, zero if simplification is disabled
+    inline float    getWarpingMeshSimplificationTolerance() { return mWarpingMeshSimplificationTolerance; }
+    //! Returns true if the triangles of warping meshes are reordered for better vertex cache utilization
+    inline bool        getUseWarpingMeshVertexCacheOptimization() { return mUseWarpingMeshVertexCacheOptimization; }
+    //! Returns true if warping mesh vertices are stored in a compact format using normalized integers
+    inline bool        getUseWarpingMeshPackedVertices() { return mUseWarpingMeshPackedVertices; }
+    //! Returns true if viewports with baked warp maps are warped using the maps instead of their meshes
+    inline bool        getUseWarpMaps() { return mUseWarpMaps; }
+    //! Get the path and base name of saved traces, the node id and ".json" are appended
+    inline const std::string & getTracePath() { return mTracePath; }
+    //! Get the number of trace events stored per thread
+    inline std::size_t getTraceBufferSize() { return mTraceBufferSize; }
+    //! Returns true if the trace is saved when SGCT exits
+    inline bool        getSaveTraceOnExit() { return mSaveTraceOnExit; }
     //! The relative On-Screen-Display text x-offset in range [0, 1]
     inline float    getOSDTextXOffset() { return mOSDTextOffset[0]; }
     //! The relative On-Screen-Display text y-offset in range [0, 1]
@@ -148,6 +184,7 @@ private:
     int mSwapInterval;
     int mRefreshRate;
     int mNumberOfCaptureThreads;
+    int mNumberOfTextureLoadingThreads;
     int mPNGCompressionLevel;
     int mJPEGQuality;
     int mDefaultNumberOfAASamples;
@@ -165,12 +202,24 @@ private:
     bool mCaptureBackBuffer;
     bool mTryMaintainAspectRatio;
     bool mExportWarpingMeshes;
+    bool mUseWarpingMeshCache;
+    bool mUseWarpingMeshVertexCacheOptimization;
+    bool mUseWarpingMeshPackedVertices;
+    bool mUseWarpMaps;
+    bool mSaveTraceOnExit;
 
     float mOSDTextOffset[2];
     float mFXAASubPixTrim;
     float mFXAASubPixOffset;
+    float mTextureUploadTimeBudget;
+    float mWarpingMeshSimplificationTolerance;
+
+    std::size_t mTextureUploadSizeBudget;
+    std::size_t mTraceBufferSize;
 
     std::string mCapturePath[3];
+    std::string mWarpingMeshCachePath;
+    std::string mTracePath;
 
     //fontdata
     std::string mFontName;
@@ -0,0 +1,64 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_THREAD_POOL_H_
+#define _SGCT_THREAD_POOL_H_
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "helpers/SGCTCPPEleven.h"
+
+namespace sgct_core
+{
+
+/*!
+    A small fixed size pool of worker threads executing tasks in the order they were added.
+    Used internally by SGCT for work that can be done in parallel without an OpenGL context,
+    like decoding images or parsing files.
+*/
+class SGCTThreadPool
+{
+public:
+    typedef sgct_cppxeleven::function<void(void)> Task;
+
+    SGCTThreadPool();
+    ~SGCTThreadPool();
+
+    void start(unsigned int numberOfThreads);
+    void stop();
+    void addTask(Task task);
+    void waitUntilIdle();
+
+    std::size_t getNumberOfPendingTasks();
+    //! \returns the number of worker threads
+    inline std::size_t getNumberOfThreads() const { return mThreads.size(); }
+    //! \returns true if the worker threads are running
+    inline bool isRunning() const { return !mThreads.empty(); }
+
+private:
+    void worker();
+
+    // Don't implement these, should give compile warning if used
+    SGCTThreadPool(const SGCTThreadPool & tp);
+    const SGCTThreadPool & operator=(const SGCTThreadPool & rhs);
+
+private:
+    std::vector<std::thread *> mThreads;
+    std::deque<Task> mTasks;
+    std::mutex mMutex;
+    std::condition_variable mTaskCondition;
+    std::condition_variable mIdleCondition;
+    std::size_t mActiveTasks;
+    bool mTerminate;
+};
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_TRACE_H_
+#define _SGCT_TRACE_H_
+
+#include "SGCTConfig.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace sgct
+{
+
+/*!
+    This singleton class records timing markers from all threads and saves them in the Chrome trace event format,
+    which can be opened in chrome://tracing or https://ui.perfetto.dev.
+
+    Markers are added using the SGCT_TRACE_SCOPE macro, which records the time spent until the end of the enclosing scope.
+    The macros compile to nothing unless SGCT is built with the SGCT_TRACE CMake option (INCLUDE_SGCT_TRACE in SGCTConfig.h).
+
+    Every thread writes its events to its own ring buffer without locking. When a buffer is full the oldest events are
+    overwritten, so a saved trace contains the latest events of each thread. Buffers of threads that have exited are reused
+    by new threads. Event names are stored as pointers and must be string literals or otherwise outlive the trace.
+
+    The instance must be created before any threads record events and destroyed after they have stopped, this is done by the Engine.
+*/
+class SGCTTrace
+{
+public:
+    /*! Get the SGCTTrace instance */
+    static SGCTTrace * instance()
+    {
+        if( mInstance == NULL )
+        {
+            mInstance = new SGCTTrace();
+        }
+
+        return mInstance;
+    }
+
+    /*! Destroy the SGCTTrace instance */
+    static void destroy();
+
+    //! \returns true if the instance is created, events recorded after destroy() must not create it again
+    static inline bool exists() { return mInstance != NULL; }
+
+    void setBufferSize(std::size_t numberOfEvents);
+    void setThreadName(const std::string & name);
+    void setProcessName(const std::string & name, int id);
+    void addCompleteEvent(const char * name, int64_t startTime, int64_t endTime);
+    void addInstantEvent(const char * name);
+    bool save(const std::string & filename);
+
+    static int64_t getTime();
+
+    //! \returns the number of events stored per thread
+    inline std::size_t getBufferSize() const { return mBufferSize; }
+    //! \returns true if SGCT is built with trace markers
+    static inline bool isEnabled() { return INCLUDE_SGCT_TRACE != 0; }
+
+private:
+    SGCTTrace();
+    ~SGCTTrace();
+
+    // Don't implement these, should give compile warning if used
+    SGCTTrace( const SGCTTrace & trace );
+    const SGCTTrace & operator=(const SGCTTrace & trace );
+
+    struct Event
+    {
+        const char * mName;
+        int64_t mStartTime;
+        int64_t mDuration; //negative for instant events
+        uint32_t mThreadId;
+    };
+
+    struct ThreadBuffer
+    {
+        std::vector<Event> mEvents;
+        std::atomic<uint64_t> mHead; //total number of events written
+        std::atomic<bool> mInUse;
+        uint32_t mThreadId;
+    };
+
+    ThreadBuffer * getThreadBuffer();
+    void addEvent(const char * name, int64_t startTime, int64_t duration);
+
+    //releases the buffer when its thread exits
+    friend struct SGCTTraceThreadHandle;
+
+private:
+    static SGCTTrace * mInstance;
+
+    std::mutex mMutex; //protects the buffer list and names, not taken when recording
+    std::vector<ThreadBuffer *> mBuffers;
+    std::vector<std::string> mThreadNames;
+    std::string mProcessName;
+    int mProcessId;
+    std::size_t mBufferSize;
+    int64_t mStartTime;
+};
+
+/*!
+    Records a complete event from construction to destruction, use the SGCT_TRACE_SCOPE macro instead of this class.
+*/
+class SGCTTraceScope
+{
+public:
+    explicit SGCTTraceScope(const char * name) : mName(name), mStartTime(SGCTTrace::getTime()) {}
+    ~SGCTTraceScope()
+    {
+        if( SGCTTrace::exists() )
+            SGCTTrace::instance()->addCompleteEvent(mName, mStartTime, SGCTTrace::getTime());
+    }
+
+private:
+    // Don't implement these, should give compile warning if used
+    SGCTTraceScope( const SGCTTraceScope & scope );
+    const SGCTTraceScope & operator=(const SGCTTraceScope & scope );
+
+    const char * mName;
+    int64_t mStartTime;
+};
+
+}
+
+#if INCLUDE_SGCT_TRACE
+    #define SGCT_TRACE_CONCAT_IMPL(a, b) a##b
+    #define SGCT_TRACE_CONCAT(a, b) SGCT_TRACE_CONCAT_IMPL(a, b)
+    //! Records the time until the end of the enclosing scope
+    #define SGCT_TRACE_SCOPE(name) sgct::SGCTTraceScope SGCT_TRACE_CONCAT(sgctTraceScope, __LINE__)(name)
+    //! Records a single point in time
+    #define SGCT_TRACE_INSTANT(name) do { if( sgct::SGCTTrace::exists() ) sgct::SGCTTrace::instance()->addInstantEvent(name); } while(0)
+    //! Names the calling thread in the trace
+    #define SGCT_TRACE_THREAD_NAME(name) do { if( sgct::SGCTTrace::exists() ) sgct::SGCTTrace::instance()->setThreadName(name); } while(0)
+#else
+    #define SGCT_TRACE_SCOPE(name)
+    #define SGCT_TRACE_INSTANT(name)
+    #define SGCT_TRACE_THREAD_NAME(name)
+#endif
+
+#endif
@@ -31,13 +31,13 @@ public:
 
 /*!
     This class is used internally by SGCT and is called when using the takeScreenshot function from the Engine.
-    Screenshots are saved as PNG or TGA images and and can also be used for movie recording.
+    Screenshots are saved as PNG, TGA or JPEG images (PFM or HDR for floating point frame buffers) and and can also be used for movie recording.
 */
 class ScreenCapture
 {
 public:
     //! The different file formats supported
-    enum CaptureFormat { NOT_SET = -1, PNG = 0, TGA, JPEG };
+    enum CaptureFormat { NOT_SET = -1, PNG = 0, TGA, JPEG, PFM, HDR };
     enum CaputeSrc { CAPTURE_TEXTURE = 0, CAPTURE_BACK_BUFFER = GL_BACK, CAPTURE_LEFT_BACK_BUFFER = GL_BACK_LEFT, CAPTURE_RIGHT_BACK_BUFFER = GL_BACK_RIGHT};
     enum EyeIndex { MONO = 0, STEREO_LEFT, STEREO_RIGHT};
 
@@ -66,6 +66,7 @@ private:
     void updateDownloadFormat();
     void checkImageBuffer(const CaputeSrc & CapSrc);
     Image * prepareImage(int index);
+    bool isFloatDownload() const;
 
     std::mutex mMutex;
     ScreenCaptureThreadInfo * mSCTIPtrs;
@@ -30,6 +30,9 @@ namespace sgct //simple graphics cluster toolkit
 This class shares application data between nodes in a cluster where the master encodes and transmits the data and the slaves receives and decode the data.
 If a large number of strings are used for the synchronization then the data can be compressed using the setCompression function.
 The process of synchronization is serial which means that the order of encoding must be the same as in decoding.
+
+Every frame starts with a frame id and the master's pre-sync time, written before the user data and read by decode,
+which the slaves use to measure the age of the data they render.
 */
 class SharedData
 {
@@ -113,6 +116,11 @@ public:
 
     void encode();
     void decode(const char * receivedData, int receivedlength, int clientIndex);
+    void setSyncTime(double time);
+    void getSyncStamp(uint32_t & frame, double & masterTime, double & decodeTime);
+
+    //! size in bytes of the frame id and master time at the start of the data
+    static const std::size_t mSyncStampSize = sizeof(uint32_t) + sizeof(double);
 
     std::size_t getUserDataSize();
     inline unsigned char * getDataBlock() { return &dataBlock[0]; }
@@ -149,6 +157,10 @@ private:
     int mCompressionLevel;
     float mCompressionRatio;
     bool mUseCompression;
+
+    uint32_t mSyncFrame;
+    double mSyncTime;
+    double mDecodeTime;
 };
 
 template <class T>
@@ -156,7 +168,7 @@ void SharedData::writeObj( SharedObject<T> * sobj )
 {
     T val = sobj->getVal();
     
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(T));
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::DataSyncMutex);
@@ -165,7 +177,7 @@ void SharedData::writeObj( SharedObject<T> * sobj )
 template<class T>
 void SharedData::readObj(SharedObject<T> * sobj)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     T val = (*(reinterpret_cast<T*>(&dataBlock[pos])));
     pos += sizeof(T);
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::DataSyncMutex);
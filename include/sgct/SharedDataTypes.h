@@ -12,9 +12,17 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <stdint.h>
 #include <string>
 #include <vector>
+#include "SGCTMutexManager.h"
 
 namespace sgct //simple graphics cluster toolkit
-{    
+{
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    //the locks of all shared data types are recorded as a single mutex in the SGCTMutexManager
+    typedef SGCTProfiledMutex SharedDataMutex;
+#else
+    typedef std::mutex SharedDataMutex;
+#endif
+    
     /*!
     Mutex protected float for multi-thread data sharing
     */
@@ -51,7 +59,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         float mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -90,7 +98,7 @@ namespace sgct //simple graphics cluster toolkit
         
     private:
         double mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -129,7 +137,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         int64_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -168,7 +176,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         int32_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -207,7 +215,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         int16_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -246,7 +254,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         int8_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -285,7 +293,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         uint64_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -324,7 +332,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         uint32_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -363,7 +371,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         uint16_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -402,7 +410,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         uint8_t mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     //backwards compability
@@ -424,7 +432,7 @@ namespace sgct //simple graphics cluster toolkit
         SharedUChar( const SharedUChar & suc );
         const SharedUChar & operator=(const SharedUChar & suc );
         unsigned char mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -448,7 +456,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         bool mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -470,7 +478,7 @@ namespace sgct //simple graphics cluster toolkit
 
     private:
         std::string mStr;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
 	/*!
@@ -492,7 +500,7 @@ namespace sgct //simple graphics cluster toolkit
 
 	private:
 		std::wstring mStr;
-		std::mutex mMutex;
+		SharedDataMutex mMutex;
 	};
 
     /*!
@@ -525,7 +533,7 @@ namespace sgct //simple graphics cluster toolkit
         SharedObject( const SharedObject & so );
         const SharedObject & operator=(const SharedObject & so );
         T mVal;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 
     /*!
@@ -597,7 +605,7 @@ namespace sgct //simple graphics cluster toolkit
         SharedVector( const SharedVector & sv );
         const SharedVector & operator=(const SharedVector & sv );
         std::vector<T> mVector;
-        std::mutex mMutex;
+        SharedDataMutex mMutex;
     };
 }
 
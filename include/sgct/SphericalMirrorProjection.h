@@ -14,6 +14,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 namespace sgct_core
 {
+    class SGCTThreadPool;
+
     /*!
     This class manages and renders non linear fisheye projections
     */
@@ -31,6 +33,7 @@ namespace sgct_core
 
         void setTilt(float angle);
         void setMeshPath(MeshFace mf, const char * str);
+        void readMeshes(SGCTThreadPool & pool, Viewport * parent, sgct::SGCTWindow * window);
 
     private:
         void initTextures();
@@ -55,6 +58,7 @@ namespace sgct_core
         //mesh data
         CorrectionMesh mMeshes[4];
         std::string mMeshPaths[4];
+        bool mMeshesRead;
 
         //shader locations
         int mTexLoc;
@@ -13,8 +13,11 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #define VERT_SCALE 5000.0f
 #define STATS_NUMBER_OF_DYNAMIC_OBJS 5
 #define STATS_NUMBER_OF_STATIC_OBJS 3
+#define STATS_PERCENTILE_WINDOW_LENGTH 1024
+#define STATS_CLOCK_SAMPLE_WINDOW_LENGTH 64
 
 #include "ShaderProgram.h"
+#include "PercentileHistogram.h"
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -26,6 +29,111 @@ struct StatsVertex
 namespace sgct_core
 {
 
+/*!
+Percentiles of the frame, draw and sync times of a node in seconds. Clients send it to the master with every acknowledge message.
+*/
+struct StatisticsRecord
+{
+    enum Metric { FrameTime = 0, DrawTime, SyncTime, NumberOfMetrics };
+    enum Percentile { P50 = 0, P95, P99, Max, NumberOfPercentiles };
+
+    //! size of the encoded record in bytes
+    static const std::size_t mEncodedSize = NumberOfMetrics * NumberOfPercentiles * sizeof(float);
+
+    void encode(char * dst) const;
+    void decode(const char * src);
+
+    float mValues[NumberOfMetrics][NumberOfPercentiles];
+};
+
+/*!
+Time in seconds spent in each phase of Engine::init on a node. Clients send it to the master once when init is done.
+*/
+struct StartupRecord
+{
+    enum Phase { ReadConfig = 0, InitNetwork, OpenWindows, WaitForNodes, InitOpenGL, LoadShaders, InitCallback, LoadViewportData, Total, NumberOfPhases };
+
+    //! size of the encoded record in bytes
+    static const std::size_t mEncodedSize = sizeof(int32_t) + NumberOfPhases * sizeof(float);
+
+    StartupRecord();
+    void encode(char * dst) const;
+    void decode(const char * src);
+    static const char * getPhaseName(Phase phase);
+
+    int32_t mNodeId;
+    float mTimes[NumberOfPhases];
+};
+
+/*!
+Timestamps of one frame on a node together with the master's pre-sync time of the shared data it rendered. The times of
+the node are in seconds of its own clock. Clients send the record of their previous frame with every acknowledge
+message, together with the decode time of the acknowledged data and the time of the acknowledge, which the master uses
+to estimate the clock offset of the client.
+*/
+struct SyncLatencyRecord
+{
+    enum Stage { Decode = 0, PostSyncPreDraw, Draw, Swap, NumberOfStages };
+
+    //! size of the encoded record in bytes
+    static const std::size_t mEncodedSize = sizeof(uint32_t) + (3 + NumberOfStages) * sizeof(double);
+
+    SyncLatencyRecord();
+    void encode(char * dst) const;
+    void decode(const char * src);
+    static const char * getStageName(Stage stage);
+
+    //! \returns false if the node hasn't rendered any shared data yet
+    inline bool isValid() const { return mMasterTime >= 0.0; }
+
+    uint32_t mFrame; //shared data frame id
+    double mMasterTime; //pre-sync time of the master
+    double mTimes[NumberOfStages];
+    double mAckDecodeTime; //decode time of the acknowledged data
+    double mAckTime;
+};
+
+/*!
+Percentiles in seconds of the age of the shared data at each stage of the frame on a node, measured from the master's
+pre-sync, and of the round trip of the data and acknowledge messages excluding the time the client holds the data.
+*/
+struct SyncLatencySummary
+{
+    float mValues[SyncLatencyRecord::NumberOfStages][StatisticsRecord::NumberOfPercentiles];
+    float mRoundTripTimes[StatisticsRecord::NumberOfPercentiles];
+    double mClockOffset; //client clock minus master clock in seconds
+    std::size_t mCount;
+};
+
+/*!
+Collects the sync latency records of a node and converts them to the master's clock.
+
+The clock offset is estimated like NTP from the send time of the data on the master, the decode and acknowledge times
+on the client and the receive time of the acknowledge on the master, assuming that the network delay is the same in
+both directions. The sample with the shortest round trip of the latest STATS_CLOCK_SAMPLE_WINDOW_LENGTH is used since
+it has the smallest error, which is at most half the round trip.
+*/
+class SyncLatencyStatistics
+{
+public:
+    SyncLatencyStatistics();
+    void addClockSample(double masterSendTime, double clientDecodeTime, double clientAckTime, double masterReceiveTime);
+    void addRecord(const SyncLatencyRecord & record);
+    void clear();
+    void getSummary(SyncLatencySummary & summary) const;
+
+    //! \returns the estimated client clock minus master clock in seconds, 0 before any clock sample is added
+    inline double getClockOffset() const { return mClockOffset; }
+
+private:
+    PercentileHistogram mHistograms[SyncLatencyRecord::NumberOfStages];
+    PercentileHistogram mRoundTripTimes;
+    double mClockOffsets[STATS_CLOCK_SAMPLE_WINDOW_LENGTH];
+    double mClockRoundTrips[STATS_CLOCK_SAMPLE_WINDOW_LENGTH];
+    std::size_t mClockSamples;
+    double mClockOffset;
+};
+
 /*!
 Helper class for measuring application statistics
 */
@@ -46,6 +154,10 @@ public:
     void setLoopTime(float min, float max);
     void addSyncTime(float t);
     void update();
+    void getRecord(StatisticsRecord & record) const;
+    float getPercentile(StatisticsRecord::Metric metric, float percentile) const;
+    void setSyncLatencyRecord(const SyncLatencyRecord & record);
+    void getSyncLatencyRecord(SyncLatencyRecord & record) const;
     void draw(float lineWidth);
 
     const float getAvgFPS() { return mAvgFPS; }
@@ -79,6 +191,14 @@ private:
     int mMVPLoc, mColLoc;
 
     std::vector<float> mStaticVerts;
+
+    //frame, draw and sync times of the latest frames, the sync time of the current frame is added when the next frame starts
+    PercentileHistogram mHistograms[StatisticsRecord::NumberOfMetrics];
+    float mPendingSyncTime;
+    bool mHasPendingSyncTime;
+
+    //timestamps of the latest rendered frame, sent to the master with the next acknowledge
+    SyncLatencyRecord mSyncLatencyRecord;
 };
 
 } //sgct_core
@@ -9,6 +9,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #define _TEXTURE_MANAGER_H_
 
 #include <string>
+#include <deque>
+#include <mutex>
 
 #include "Image.h"
 #include "helpers/SGCTCPPEleven.h"
@@ -28,6 +30,9 @@ public:
     int mHeight;
     int mChannels;
 };
+
+class SGCTThreadPool;
+class AsyncTextureRequest;
 }
 
 namespace sgct //simple graphics cluster toolkit
@@ -43,6 +48,16 @@ public:
         The compression mode modes. For more info about texute compression look here: <a href="http://en.wikipedia.org/wiki/S3_Texture_Compression">S3 Texture compression</a>
     */
     enum CompressionMode { No_Compression = 0, Generic, S3TC_DXT };
+    /*!
+        The states of a texture loaded using loadTextureAsync.
+    */
+    enum AsyncTextureState { Async_Not_Found = 0, Async_Decoding, Async_Uploading, Async_Ready, Async_Failed };
+
+    /*!
+        Callback called from the render thread when an asynchronous texture load is finished.
+        Arguments: texture name, openGL texture id (0 if failed) and success.
+    */
+    typedef sgct_cppxeleven::function<void(const std::string &, unsigned int, bool)> AsyncTextureCallbackFn;
 
     /*! Get the TextureManager instance */
     static TextureManager * instance()
@@ -86,12 +101,26 @@ public:
     bool loadTexture(const std::string name, const std::string filename, bool interpolate, int mipmapLevels = 8);
     bool loadTexture(const std::string name, sgct_core::Image * imgPtr, bool interpolate, int mipmapLevels = 8);
     bool loadUnManagedTexture(unsigned int & texID, const std::string filename, bool interpolate, int mipmapLevels = 8);
+    bool loadUnManagedTexture(unsigned int & texID, sgct_core::Image * imgPtr, bool interpolate, int mipmapLevels = 8);
+    unsigned int loadTextureAsync(const std::string name, const std::string filename, bool interpolate, int mipmapLevels = 8, AsyncTextureCallbackFn callback = AsyncTextureCallbackFn());
+    AsyncTextureState getAsyncTextureState(unsigned int handle);
+    void processAsyncUploads();
+
+    //! \returns true if there are asynchronous texture loads that are not finished
+    inline bool hasPendingAsyncTextures() const { return !mAsyncRequests.empty(); }
 
 private:
     TextureManager();
     ~TextureManager();
     bool updateTexture(const std::string & name, unsigned int * texPtr, bool * reload);
-    bool uploadImage(sgct_core::Image * imgPtr, unsigned int * texPtr);
+    bool uploadImage(sgct_core::Image * imgPtr, unsigned int * texPtr, std::size_t * memorySize = NULL);
+    bool getTextureFormats(sgct_core::Image * imgPtr, int & textureType, int & internalFormat, unsigned int & format);
+    void setTextureParameters(bool interpolate, int mipmapLevels);
+
+    void decodeAsyncTexture(sgct_core::AsyncTextureRequest * request);
+    bool beginAsyncUpload(sgct_core::AsyncTextureRequest * request);
+    std::size_t uploadAsyncRows(sgct_core::AsyncTextureRequest * request, std::size_t maxBytes);
+    void finishAsyncUpload(sgct_core::AsyncTextureRequest * request, bool success);
 
     void freeTextureData();
 
@@ -110,6 +139,17 @@ private:
     sgct_cppxeleven::unordered_map<std::string, sgct_core::TextureData> mTextures;
     int mMipmapLevels;
     int mWarpMode[2];
+
+    //asynchronous loading
+    sgct_core::SGCTThreadPool * mLoaderPool;
+    sgct_cppxeleven::unordered_map<unsigned int, sgct_core::AsyncTextureRequest *> mAsyncRequests;
+    sgct_cppxeleven::unordered_map<unsigned int, AsyncTextureState> mFinishedAsyncStates; //loads without a callback
+    std::deque<sgct_core::AsyncTextureRequest *> mDecodedTextures; //protected by mDecodedMutex
+    std::mutex mDecodedMutex;
+    sgct_core::AsyncTextureRequest * mCurrentUpload;
+    unsigned int mNextAsyncHandle;
+    unsigned int mUploadPBO;
+    std::size_t mUploadPBOSize;
 };
 
 }
@@ -51,6 +51,9 @@ struct FrustumData {
 /*!
     This class holds and manages viewportdata and calculates frustums
 */
+class SGCTThreadPool;
+class Image;
+
 class Viewport : public BaseViewport
 {
 public:
@@ -64,8 +67,10 @@ public:
     void setBlendMaskTexture(const char * texturePath);
     void setBlackLevelMaskTexture(const char * texturePath);
     void setCorrectionMesh(const char * meshPath);
-    void setMpcdiWarpMesh(const char* meshData, size_t size);
+    void setMpcdiWarpMesh(MpcdiWarpGrid * grid);
+    void setWarpMapFormat(CorrectionMesh::WarpMapFormat format);
     void setTracked(bool state);
+    void readData(SGCTThreadPool & pool, sgct::SGCTWindow * window);
     void loadData();
 
     void renderMesh(CorrectionMesh::MeshType mt);
@@ -74,6 +79,8 @@ public:
     inline bool hasBlendMaskTexture() { return mBlendMaskTextureIndex != GL_FALSE; }
     inline bool hasBlackLevelMaskTexture() { return mBlackLevelMaskTextureIndex != GL_FALSE; }
     inline bool hasSubViewports() { return mNonLinearProjection != NULL; }
+    //! \returns true if a blend or black level mask is set, the textures might not be loaded yet
+    inline bool hasMaskTextureFiles() { return !mBlendMaskFilename.empty() || !mBlackLevelMaskFilename.empty(); }
 
     inline const bool & hasCorrectionMesh() { return mCorrectionMesh; }
     inline const bool & isTracked() { return mTracked; }
@@ -81,10 +88,11 @@ public:
     inline const unsigned int & getBlendMaskTextureIndex() { return mBlendMaskTextureIndex; }
     inline const unsigned int & getBlackLevelMaskTextureIndex() { return mBlackLevelMaskTextureIndex; }
     inline CorrectionMesh * getCorrectionMeshPtr() { return &mCM; }
+    //! \returns the format of the warp map baked from the correction mesh, NO_WARP_MAP if the mesh is drawn
+    inline CorrectionMesh::WarpMapFormat getWarpMapFormat() const { return mWarpMapFormat; }
     inline NonLinearProjection * getNonLinearProjectionPtr() { return mNonLinearProjection; }
-
-    char* mMpcdiWarpMeshData = nullptr;
-    size_t mMpcdiWarpMeshSize = 0;
+    //! \returns the MPCDI correction grid or NULL if the mesh isn't from a MPCDI package or is already generated
+    inline const MpcdiWarpGrid * getMpcdiWarpGrid() const { return mMpcdiWarpGrid; }
 
 private:
     void reset(float x, float y, float xSize, float ySize);
@@ -96,6 +104,9 @@ private:
                                  float& target);
     bool parseFrustumElement(FrustumData& frustum, FrustumData::elemIdx elemIndex,
         tinyxml2::XMLElement* elem, const char* frustumTag);
+    void readCorrectionMesh(sgct::SGCTWindow * window);
+    static Image * readTexture(const std::string & filename);
+    static void uploadTexture(unsigned int & texID, Image * & imgPtr, const std::string & filename);
 private:
     CorrectionMesh mCM;
     std::string mOverlayFilename;
@@ -103,6 +114,7 @@ private:
     std::string mBlackLevelMaskFilename;
     std::string mMeshFilename;
     std::string mMeshHint;
+    CorrectionMesh::WarpMapFormat mWarpMapFormat;
     bool mCorrectionMesh;
     bool mTracked;
     bool mIsMeshStoredInFile = false;
@@ -110,6 +122,15 @@ private:
     unsigned int mBlendMaskTextureIndex;
     unsigned int mBlackLevelMaskTextureIndex;
 
+    //decoded by readData, uploaded by loadData
+    Image * mOverlayImage;
+    Image * mBlendMaskImage;
+    Image * mBlackLevelMaskImage;
+    bool mDataRead;
+
+    //owned until the correction mesh is generated
+    MpcdiWarpGrid * mMpcdiWarpGrid;
+
     NonLinearProjection * mNonLinearProjection;
 };
 
@@ -0,0 +1,68 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _WARP_MAP_BAKER_H_
+#define _WARP_MAP_BAKER_H_
+
+#include <vector>
+#include "CorrectionMesh.h"
+
+namespace sgct_core
+{
+
+/*!
+    Rasterizes a warping mesh on the CPU into a per-pixel lookup map, so that the warp can be applied by a single
+    full-screen pass with a dependent texture fetch instead of drawing a dense mesh every frame.
+
+    Each texel holds the interpolated texture coordinate (s, t) into the rendered frame, the blend intensity and a
+    coverage flag (zero where the mesh doesn't cover the pixel). The map only covers the bounding box of the mesh in
+    window pixels and is rasterized in parallel tiles. Overlapping triangles are resolved in draw order, like when the mesh
+    is rendered without depth test.
+*/
+class WarpMapBaker
+{
+public:
+    WarpMapBaker(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices, const unsigned int * indices, unsigned int numberOfIndices);
+
+    bool bake(int resolutionX, int resolutionY, CorrectionMesh::WarpMapFormat format, unsigned int numberOfThreads);
+
+    static bool canBake(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices);
+
+    //! \returns the format of the baked map, RG16_WARP_MAP falls back to RG32F_WARP_MAP if the texture coordinates are outside [0, 1]
+    inline CorrectionMesh::WarpMapFormat getFormat() const { return mFormat; }
+    //! \returns the window resolution the map was baked for
+    inline const int * getResolution() const { return mResolution; }
+    //! \returns the area covered by the map as x, y, width and height in window pixels
+    inline const int * getRect() const { return mRect; }
+    //! \returns the texels (RGBA of 16-bit unsigned normalized integers or 32-bit floats), bottom row first
+    inline const std::vector<unsigned char> & getData() const { return mData; }
+
+private:
+    void rasterizeTile(std::size_t tileX, std::size_t tileY);
+    void storeTexel(std::size_t index, float s, float t, float intensity);
+
+private:
+    const CorrectionMeshVertex * mVertices;
+    const unsigned int * mIndices;
+    unsigned int mNumberOfVertices;
+    unsigned int mNumberOfIndices;
+
+    //vertex positions in window pixels
+    std::vector<double> mPositions;
+    //triangles overlapping each tile
+    std::vector< std::vector<unsigned int> > mTileTriangles;
+    std::size_t mNumberOfTiles[2];
+
+    CorrectionMesh::WarpMapFormat mFormat;
+    int mResolution[2];
+    int mRect[4];
+    std::vector<unsigned char> mData;
+};
+
+}
+
+#endif
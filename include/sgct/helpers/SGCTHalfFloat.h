@@ -0,0 +1,179 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_HALF_FLOAT
+#define _SGCT_HALF_FLOAT
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__F16C__) || defined(__AVX2__)
+    #include <immintrin.h>
+    #define SGCT_HALF_FLOAT_F16C
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SGCT_HALF_FLOAT_SSE2
+#endif
+
+namespace sgct_helpers
+{
+
+/*!
+    Convert a 32-bit float to a 16-bit half float (round to nearest even). Values outside of the half float range become infinity.
+*/
+static inline unsigned short floatToHalf(float value)
+{
+    unsigned int f;
+    memcpy(&f, &value, sizeof(f));
+
+    unsigned int sign = f & 0x80000000u;
+    f ^= sign;
+
+    unsigned short h;
+    if (f >= ((127u + 16u) << 23)) //inf or nan
+        h = (f > (255u << 23)) ? 0x7e00 : 0x7c00;
+    else if (f < (113u << 23)) //subnormal or zero
+    {
+        const unsigned int denormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        float tmp;
+        memcpy(&tmp, &f, sizeof(tmp));
+        float magic;
+        memcpy(&magic, &denormMagic, sizeof(magic));
+        tmp += magic;
+        memcpy(&f, &tmp, sizeof(f));
+        h = static_cast<unsigned short>(f - denormMagic);
+    }
+    else
+    {
+        unsigned int mantOdd = (f >> 13) & 1u;
+        f += (static_cast<unsigned int>(15 - 127) << 23) + 0xfffu;
+        f += mantOdd;
+        h = static_cast<unsigned short>(f >> 13);
+    }
+
+    return static_cast<unsigned short>(h | (sign >> 16));
+}
+
+/*!
+    Convert a 16-bit half float to a 32-bit float.
+*/
+static inline float halfToFloat(unsigned short value)
+{
+    const unsigned int magicBits = (254u - 15u) << 23;
+    float magic;
+    memcpy(&magic, &magicBits, sizeof(magic));
+
+    unsigned int expMant = value & 0x7fffu;
+    unsigned int f = expMant << 13;
+    float result;
+    memcpy(&result, &f, sizeof(result));
+    result *= magic; //rebias the exponent, also handles subnormals
+
+    memcpy(&f, &result, sizeof(f));
+    if (expMant > 0x7bffu) //inf or nan
+        f |= 255u << 23;
+    f |= static_cast<unsigned int>(value & 0x8000u) << 16;
+    memcpy(&result, &f, sizeof(result));
+
+    return result;
+}
+
+/*!
+    Convert an array of 32-bit floats to half floats using SIMD instructions if available.
+    The conversion can be done in place (dst == src) since the output never overtakes the input.
+*/
+static inline void convertFloatToHalf(const float * src, unsigned short * dst, size_t count)
+{
+    size_t i = 0;
+
+#if defined(SGCT_HALF_FLOAT_F16C)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 f = _mm256_loadu_ps(src + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_cvtps_ph(f, 0)); //0 = round to nearest even
+    }
+#elif defined(SGCT_HALF_FLOAT_SSE2)
+    const __m128i maskSign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i f16Max = _mm_set1_epi32((127 + 16) << 23);
+    const __m128i nanBit = _mm_set1_epi32(0x200);
+    const __m128i infinity = _mm_set1_epi32(0x7c00);
+    const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+    const __m128i subnormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i normalBias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 f = _mm_loadu_ps(src + i);
+        __m128 justSign = _mm_and_ps(_mm_castsi128_ps(maskSign), f);
+        __m128 absF = _mm_xor_ps(f, justSign);
+        __m128i absFInt = _mm_castps_si128(absF);
+
+        __m128 isNan = _mm_cmpunord_ps(absF, absF);
+        __m128i isRegular = _mm_cmpgt_epi32(f16Max, absFInt);
+        __m128i infOrNan = _mm_or_si128(_mm_and_si128(_mm_castps_si128(isNan), nanBit), infinity);
+        __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, absFInt);
+
+        //subnormal results
+        __m128 subnorm1 = _mm_add_ps(absF, _mm_castsi128_ps(subnormMagic));
+        __m128i subnorm2 = _mm_sub_epi32(_mm_castps_si128(subnorm1), subnormMagic);
+
+        //normal results
+        __m128i mantOdd = _mm_srai_epi32(_mm_slli_epi32(absFInt, 31 - 13), 31);
+        __m128i rounded = _mm_sub_epi32(_mm_add_epi32(absFInt, normalBias), mantOdd);
+        __m128i normal = _mm_srli_epi32(rounded, 13);
+
+        __m128i nonSpecial = _mm_or_si128(_mm_and_si128(subnorm2, isSubnormal), _mm_andnot_si128(isSubnormal, normal));
+        __m128i joined = _mm_or_si128(_mm_and_si128(nonSpecial, isRegular), _mm_andnot_si128(isRegular, infOrNan));
+        __m128i result = _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(justSign), 16));
+
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(result, result));
+    }
+#endif
+
+    for (; i < count; i++)
+        dst[i] = floatToHalf(src[i]);
+}
+
+/*!
+    Convert an array of half floats to 32-bit floats using SIMD instructions if available. Can't be done in place.
+*/
+static inline void convertHalfToFloat(const unsigned short * src, float * dst, size_t count)
+{
+    size_t i = 0;
+
+#if defined(SGCT_HALF_FLOAT_F16C)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+#elif defined(SGCT_HALF_FLOAT_SSE2)
+    const __m128i maskNoSign = _mm_set1_epi32(0x7fff);
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+    const __m128i wasInfNan = _mm_set1_epi32(0x7bff);
+    const __m128 expInfNan = _mm_castsi128_ps(_mm_set1_epi32(255 << 23));
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), zero);
+        __m128i expMant = _mm_and_si128(maskNoSign, h);
+        __m128i justSign = _mm_xor_si128(h, expMant);
+        __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMant, 13)), magic);
+        __m128 infNanExp = _mm_and_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(expMant, wasInfNan)), expInfNan);
+        __m128 signInf = _mm_or_ps(_mm_castsi128_ps(_mm_slli_epi32(justSign, 16)), infNanExp);
+        _mm_storeu_ps(dst + i, _mm_or_ps(scaled, signInf));
+    }
+#endif
+
+    for (; i < count; i++)
+        dst[i] = halfToFloat(src[i]);
+}
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_MAPPED_FILE
+#define _SGCT_MAPPED_FILE
+
+#include <stddef.h>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace sgct_helpers
+{
+
+/*!
+    This class maps a file read-only into memory so that it can be parsed or decoded in place without
+    being copied into an intermediate buffer. The mapping is released when the object is destroyed.
+*/
+class SGCTMappedFile
+{
+public:
+    SGCTMappedFile()
+    {
+        mData = NULL;
+        mSize = 0;
+#ifdef _WIN32
+        mFile = INVALID_HANDLE_VALUE;
+        mMapping = NULL;
+#endif
+    }
+
+    ~SGCTMappedFile()
+    {
+        close();
+    }
+
+    /*!
+        Map the file into memory. Returns false if the file can't be opened, is empty or can't be mapped.
+    */
+    bool open(const char * filename)
+    {
+        close();
+
+#ifdef _WIN32
+        mFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (mFile == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFile, &size) || size.QuadPart <= 0)
+        {
+            close();
+            return false;
+        }
+        mSize = static_cast<size_t>(size.QuadPart);
+
+        mMapping = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mMapping == NULL)
+        {
+            close();
+            return false;
+        }
+
+        mData = reinterpret_cast<unsigned char *>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+        if (mData == NULL)
+        {
+            close();
+            return false;
+        }
+#else
+        int fd = ::open(filename, O_RDONLY);
+        if (fd == -1)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        mSize = static_cast<size_t>(st.st_size);
+
+        void * ptr = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); //the mapping keeps its own reference to the file
+        if (ptr == MAP_FAILED)
+        {
+            mSize = 0;
+            return false;
+        }
+
+    #ifdef MADV_SEQUENTIAL
+        madvise(ptr, mSize, MADV_SEQUENTIAL);
+    #endif
+        mData = reinterpret_cast<unsigned char *>(ptr);
+#endif
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMapping)
+            CloseHandle(mMapping);
+        if (mFile != INVALID_HANDLE_VALUE)
+            CloseHandle(mFile);
+        mMapping = NULL;
+        mFile = INVALID_HANDLE_VALUE;
+#else
+        if (mData)
+            munmap(mData, mSize);
+#endif
+        mData = NULL;
+        mSize = 0;
+    }
+
+    inline unsigned char * getData() const { return mData; }
+    inline size_t getSize() const { return mSize; }
+    inline bool isOpen() const { return mData != NULL; }
+
+private:
+    // Don't implement these, the mapping can't be shared
+    SGCTMappedFile(const SGCTMappedFile & mf);
+    const SGCTMappedFile & operator=(const SGCTMappedFile & mf);
+
+    unsigned char * mData;
+    size_t mSize;
+#ifdef _WIN32
+    HANDLE mFile;
+    HANDLE mMapping;
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,302 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_TEXT_TOKENIZER
+#define _SGCT_TEXT_TOKENIZER
+
+#include <stddef.h>
+#include <math.h>
+
+namespace sgct_helpers
+{
+
+/*!
+    A line based tokenizer for parsing numeric text files (like warping meshes) that are read into memory in one go.
+    The buffer doesn't need to be null terminated. Numbers are parsed without sscanf/strtod so the parsing is fast
+    and independent of the current locale (the decimal separator is always a dot).
+
+    Typical usage:
+    \code
+    sgct_helpers::SGCTTextTokenizer tokenizer(data, size);
+    while (tokenizer.nextLine())
+    {
+        float x, y;
+        if (tokenizer.match("v ") && tokenizer.readFloat(x) && tokenizer.readFloat(y))
+            ...
+    }
+    \endcode
+*/
+class SGCTTextTokenizer
+{
+public:
+    SGCTTextTokenizer(const char * data, size_t size)
+    {
+        mPos = data;
+        mEnd = data + size;
+        mLineEnd = data;
+        mNextLine = data;
+    }
+
+    /*!
+        Move to the beginning of the next line. Handles both LF and CRLF line endings.
+        \returns false if there are no more lines
+    */
+    bool nextLine()
+    {
+        if (mNextLine >= mEnd)
+            return false;
+
+        mPos = mNextLine;
+        mLineEnd = mPos;
+        while (mLineEnd < mEnd && *mLineEnd != '\n')
+            mLineEnd++;
+
+        mNextLine = mLineEnd < mEnd ? mLineEnd + 1 : mEnd;
+        if (mLineEnd > mPos && *(mLineEnd - 1) == '\r')
+            mLineEnd--;
+
+        return true;
+    }
+
+    //! Skip spaces and tabs
+    inline void skipWhitespace()
+    {
+        while (mPos < mLineEnd && (*mPos == ' ' || *mPos == '\t'))
+            mPos++;
+    }
+
+    //! \returns true if only white space remains on the current line
+    inline bool atLineEnd()
+    {
+        skipWhitespace();
+        return mPos >= mLineEnd;
+    }
+
+    //! \returns the next non white space character on the line without consuming it, or '\0' at the end of the line
+    inline char peek()
+    {
+        skipWhitespace();
+        return mPos < mLineEnd ? *mPos : '\0';
+    }
+
+    /*!
+        Consume the pattern if the line continues with it. Like in scanf a space in the pattern matches any amount of
+        white space (including none). Nothing is consumed if the pattern doesn't match.
+    */
+    bool match(const char * pattern)
+    {
+        const char * p = mPos;
+        while (*pattern != '\0')
+        {
+            if (*pattern == ' ')
+            {
+                while (p < mLineEnd && (*p == ' ' || *p == '\t'))
+                    p++;
+            }
+            else if (p >= mLineEnd || *p != *pattern)
+                return false;
+            else
+                p++;
+
+            pattern++;
+        }
+
+        mPos = p;
+        return true;
+    }
+
+    //! Skip white space and consume the character c if it is next on the line
+    inline bool expect(char c)
+    {
+        skipWhitespace();
+        if (mPos < mLineEnd && *mPos == c)
+        {
+            mPos++;
+            return true;
+        }
+        return false;
+    }
+
+    //! Skip white space followed by a token of non white space characters
+    bool skipToken()
+    {
+        skipWhitespace();
+        const char * start = mPos;
+        while (mPos < mLineEnd && *mPos != ' ' && *mPos != '\t')
+            mPos++;
+        return mPos > start;
+    }
+
+    /*!
+        Read a token of word characters (letters, digits and underscore) into dst (null terminated).
+    */
+    bool readWord(char * dst, size_t dstSize)
+    {
+        skipWhitespace();
+        size_t i = 0;
+        while (mPos < mLineEnd && i + 1 < dstSize && isWordChar(*mPos))
+            dst[i++] = *mPos++;
+        dst[i] = '\0';
+        return i > 0;
+    }
+
+    //! Skip white space and read an unsigned integer
+    bool readUInt(unsigned int & val)
+    {
+        skipWhitespace();
+        const char * p = mPos;
+        if (p < mLineEnd && *p == '+')
+            p++;
+        if (p >= mLineEnd || !isDigit(*p))
+            return false;
+
+        unsigned int v = 0;
+        while (p < mLineEnd && isDigit(*p))
+            v = v * 10 + static_cast<unsigned int>(*p++ - '0');
+
+        val = v;
+        mPos = p;
+        return true;
+    }
+
+    //! Skip white space and read a signed integer
+    bool readInt(int & val)
+    {
+        skipWhitespace();
+        const char * p = mPos;
+        bool negative = false;
+        if (p < mLineEnd && (*p == '-' || *p == '+'))
+            negative = (*p++ == '-');
+        if (p >= mLineEnd || !isDigit(*p))
+            return false;
+
+        int v = 0;
+        while (p < mLineEnd && isDigit(*p))
+            v = v * 10 + static_cast<int>(*p++ - '0');
+
+        val = negative ? -v : v;
+        mPos = p;
+        return true;
+    }
+
+    //! Skip white space and read a floating point number
+    inline bool readFloat(float & val)
+    {
+        double d;
+        if (!readDouble(d))
+            return false;
+        val = static_cast<float>(d);
+        return true;
+    }
+
+    /*!
+        Skip white space and read a floating point number in decimal or scientific notation.
+        Up to 19 significant digits are used which gives the same result as strtod for all
+        practical mesh data.
+    */
+    bool readDouble(double & val)
+    {
+        skipWhitespace();
+        const char * p = mPos;
+
+        bool negative = false;
+        if (p < mLineEnd && (*p == '-' || *p == '+'))
+            negative = (*p++ == '-');
+
+        unsigned long long mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool hasDigits = false;
+
+        while (p < mLineEnd && isDigit(*p))
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + static_cast<unsigned long long>(*p - '0');
+                if (mantissa != 0)
+                    digits++;
+            }
+            else
+                exponent++; //ignore insignificant digits
+            hasDigits = true;
+            p++;
+        }
+
+        if (p < mLineEnd && *p == '.')
+        {
+            p++;
+            while (p < mLineEnd && isDigit(*p))
+            {
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + static_cast<unsigned long long>(*p - '0');
+                    if (mantissa != 0)
+                        digits++;
+                    exponent--;
+                }
+                hasDigits = true;
+                p++;
+            }
+        }
+
+        if (!hasDigits)
+            return false;
+
+        if (p < mLineEnd && (*p == 'e' || *p == 'E'))
+        {
+            const char * e = p + 1;
+            bool negativeExp = false;
+            if (e < mLineEnd && (*e == '-' || *e == '+'))
+                negativeExp = (*e++ == '-');
+
+            if (e < mLineEnd && isDigit(*e)) //otherwise the 'e' isn't part of the number
+            {
+                int exp = 0;
+                while (e < mLineEnd && isDigit(*e))
+                {
+                    if (exp < 10000)
+                        exp = exp * 10 + (*e - '0');
+                    e++;
+                }
+                exponent += negativeExp ? -exp : exp;
+                p = e;
+            }
+        }
+
+        double d = static_cast<double>(mantissa);
+        if (mantissa != 0 && exponent != 0)
+        {
+            //powers of ten up to 1e22 are exact in double precision
+            static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+            if (exponent < 0 && exponent >= -22)
+                d /= powersOfTen[-exponent];
+            else if (exponent > 0 && exponent <= 22)
+                d *= powersOfTen[exponent];
+            else
+                d *= pow(10.0, static_cast<double>(exponent));
+        }
+
+        val = negative ? -d : d;
+        mPos = p;
+        return true;
+    }
+
+private:
+    static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    static inline bool isWordChar(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || isDigit(c) || c == '_'; }
+
+    const char * mPos;
+    const char * mLineEnd;
+    const char * mNextLine;
+    const char * mEnd;
+};
+
+}
+
+#endif
@@ -76,6 +76,37 @@ namespace sgct_core
                 Color = texture(Tex, UV);\n\
             }\n";
 
+        const std::string WarpMap_Vert_Shader = "\
+            **glsl_version**\n\
+            \n\
+            layout (location = 0) in vec2 Position;\n\
+            layout (location = 1) in vec2 TexCoords;\n\
+            \n\
+            out vec2 UV;\n\
+            \n\
+            void main()\n\
+            {\n\
+               gl_Position = vec4(Position, 0.0, 1.0);\n\
+               UV = TexCoords;\n\
+            }\n";
+
+        const std::string WarpMap_Frag_Shader = "\
+            **glsl_version**\n\
+            \n\
+            in vec2 UV;\n\
+            out vec4 Color;\n\
+            \n\
+            uniform sampler2D Tex;\n\
+            uniform sampler2D WarpMap;\n\
+            \n\
+            void main()\n\
+            {\n\
+                vec4 warp = texture(WarpMap, UV);\n\
+                if (warp.a < 0.5)\n\
+                    discard;\n\
+                Color = vec4(warp.bbb, 1.0) * texture(Tex, warp.rg);\n\
+            }\n";
+
         const std::string Anaglyph_Vert_Shader = "\
             **glsl_version**\n\
             \n\
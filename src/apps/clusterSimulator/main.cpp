@@ -0,0 +1,431 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include "sgct.h"
+#include "sgct/ClusterManager.h"
+#include "sgct/NetworkManager.h"
+#include "sgct/SGCTNetwork.h"
+#include "sgct/SGCTMutexManager.h"
+#include "sgct/Statistics.h"
+#include "sgct/PercentileHistogram.h"
+
+/*
+    Simulates a master and a number of client nodes in one process without windows, for measuring sync throughput and latency:
+
+    clusterSimulator [-nodes <count>] [-frames <count>] [-payload <bytes>] [-compression] [-latency <ms>] [-jitter <ms>]
+                     [-draw <ms>] [-slow <node index> <ms>] [-loose] [-port <first port>]
+
+    The master uses the NetworkManager and SharedData like the engine does, with a sync connection per client node on
+    consecutive ports starting at the given port. Each client node is a client SGCTNetwork connection and a thread running
+    the client side of the frame lock: wait for the sync data, acknowledge it and draw.
+
+    -payload      size of the synchronized data in addition to a timestamp and the frame number
+    -latency      delay added to the delivery of the sync data at every client node, plus a random delay of up to -jitter
+    -draw         time every node, including the master, spends drawing a frame
+    -slow         extra draw time for a node, node 0 is the master and the client nodes start at 1, can be repeated
+    -loose        loose sync, the master doesn't wait for the acknowledgements (firm sync is the default here)
+
+    Ack latency is the time from the master starting to send a frame until it sees the acknowledgement of a node.
+    In loose sync the acknowledgements are only checked when the next frame is sent, so the latency is an upper bound, and
+    only frames that a node acknowledges before the next one arrives are counted.
+*/
+
+struct SimulatedNode
+{
+    SimulatedNode() : mReceivedFrames(0), mDrawTime(0.0), mSendTime(0.0), mAcked(true) {}
+
+    sgct_core::SGCTNetwork * mConnection;
+    std::thread * mThread;
+    std::atomic<int> mReceivedFrames;
+    double mDrawTime;
+    std::mt19937 mRandom;
+
+    //written by the connection thread
+    std::mutex mMutex;
+    sgct_core::PercentileHistogram mDeliveryTimes;
+    std::vector<char> mData;
+
+    //master side of the connection
+    double mSendTime;
+    bool mAcked;
+    sgct_core::PercentileHistogram mAckTimes;
+};
+
+std::vector<SimulatedNode *> gNodes;
+std::atomic<bool> gRunning(true);
+
+unsigned int gNumberOfNodes = 3;
+unsigned int gNumberOfFrames = 1000;
+std::size_t gPayloadSize = 1024;
+bool gCompression = false;
+double gLatency = 0.0;
+double gJitter = 0.0;
+double gDrawTime = 0.0;
+bool gFirmSync = true;
+int gFirstPort = 20401;
+std::vector< std::pair<unsigned int, double> > gSlowNodes;
+
+sgct::SharedDouble gTimestamp(0.0);
+sgct::SharedInt gFrameNumber(0);
+sgct::SharedVector<unsigned char> gPayload;
+
+double getSeconds()
+{
+    //glfw isn't initialized so the engine timer can't be used
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void sleepSeconds(double seconds)
+{
+    if (seconds > 0.0)
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+void myEncodeFun()
+{
+    sgct::SharedData::instance()->writeDouble(&gTimestamp);
+    sgct::SharedData::instance()->writeInt32(&gFrameNumber);
+    sgct::SharedData::instance()->writeVector(&gPayload);
+}
+
+/*
+    Replaces SharedData::decode on the client nodes since the shared data belongs to the master in this process.
+    Runs in the connection thread of the node, which is blocked while the injected latency passes.
+*/
+void receiveSyncData(SimulatedNode * node, const char * receivedData, int receivedLength)
+{
+    double delay = gLatency;
+    if (gJitter > 0.0)
+        delay += std::uniform_real_distribution<double>(0.0, gJitter)(node->mRandom);
+    sleepSeconds(delay);
+
+    //the timestamp is written first by the master, after the sync stamp of the shared data
+    double timestamp = 0.0;
+    if (receivedLength >= static_cast<int>(sgct::SharedData::mSyncStampSize + sizeof(double)))
+        memcpy(&timestamp, receivedData + sgct::SharedData::mSyncStampSize, sizeof(double));
+
+    node->mMutex.lock();
+    node->mData.assign(receivedData, receivedData + receivedLength);
+    node->mDeliveryTimes.add(static_cast<float>(getSeconds() - timestamp));
+    node->mMutex.unlock();
+
+    node->mReceivedFrames++;
+    sgct_core::NetworkManager::gCond.notify_all();
+}
+
+/*
+    The client side of Engine::frameLock and the render loop with the drawing replaced by a sleep.
+*/
+void runClientNode(SimulatedNode * node)
+{
+    sgct_core::Statistics statistics;
+    sgct_core::StatisticsRecord record;
+    int processedFrames = 0;
+    double previousFrameTime = getSeconds();
+
+    while (gRunning)
+    {
+        double t0 = getSeconds();
+        {
+            std::unique_lock<std::mutex> lock(*sgct::SGCTMutexManager::instance()->getMutexPtr(sgct::SGCTMutexManager::FrameSyncMutex));
+            while (gRunning && node->mReceivedFrames.load() == processedFrames)
+                sgct_core::NetworkManager::gCond.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        if (!gRunning)
+            break;
+
+        //like the engine, frames that arrived while drawing are acknowledged once
+        processedFrames = node->mReceivedFrames.load();
+        statistics.getRecord(record);
+        node->mConnection->pushClientMessage(&record);
+        statistics.setSyncTime(static_cast<float>(getSeconds() - t0));
+
+        double drawStart = getSeconds();
+        sleepSeconds(node->mDrawTime);
+        statistics.setDrawTime(static_cast<float>(getSeconds() - drawStart));
+
+        double now = getSeconds();
+        statistics.setFrameTime(static_cast<float>(now - previousFrameTime));
+        previousFrameTime = now;
+    }
+}
+
+/*
+    Record the ack latency of the nodes that have acknowledged the latest frame.
+
+    \returns true if all nodes have acknowledged it
+*/
+bool checkAcks(sgct_core::NetworkManager * networkManager)
+{
+    double now = getSeconds();
+    bool allAcked = true;
+    for (std::size_t i = 0; i < gNodes.size(); i++)
+    {
+        SimulatedNode * node = gNodes[i];
+        sgct_core::SGCTNetwork * connection = networkManager->getSyncConnectionByIndex(static_cast<unsigned int>(i));
+        if (!node->mAcked && connection->getRecvFrame(sgct_core::SGCTNetwork::Current) == connection->getSendFrame())
+        {
+            node->mAckTimes.add(static_cast<float>(now - node->mSendTime));
+            node->mAcked = true;
+        }
+        allAcked = allAcked && node->mAcked;
+    }
+    return allAcked;
+}
+
+void printTimes(const char * name, const sgct_core::PercentileHistogram & histogram)
+{
+    const float percentiles[] = { 50.0f, 99.0f, 100.0f };
+    float values[3];
+    histogram.getPercentiles(percentiles, values, 3);
+    fprintf(stdout, "  %-22s p50 %8.3f ms   p99 %8.3f ms   max %8.3f ms   (%u samples)\n", name,
+        values[0] * 1000.0f, values[1] * 1000.0f, values[2] * 1000.0f, static_cast<unsigned int>(histogram.getCount()));
+}
+
+bool runSimulation()
+{
+    //the master and the client nodes are all local, addresses are only used to tell them apart
+    sgct_core::ClusterManager * cm = sgct_core::ClusterManager::instance();
+    for (unsigned int i = 0; i <= gNumberOfNodes; i++)
+    {
+        char address[32];
+        char port[16];
+        sprintf(address, "127.0.2.%u", i + 1);
+        sprintf(port, "%d", gFirstPort + static_cast<int>(i) - 1);
+
+        sgct_core::SGCTNode node;
+        node.setAddress(address);
+        if (i > 0)
+            node.setSyncPort(port);
+        cm->addNode(node);
+    }
+    cm->setMasterAddress("127.0.2.1");
+    cm->setThisNodeId(0);
+    cm->setNetworkMode(sgct_core::NetworkManager::LocalServer);
+    cm->setFirmFrameLockSyncStatus(gFirmSync);
+
+    sgct_core::NetworkManager * networkManager = NULL;
+    try
+    {
+        networkManager = new sgct_core::NetworkManager(sgct_core::NetworkManager::LocalServer);
+    }
+    catch (const char * err)
+    {
+        fprintf(stderr, "Initiating network connections failed! Error: '%s'\n", err);
+        return false;
+    }
+
+    bool success = networkManager->init();
+    //random bytes so that compression doesn't get an easy job
+    std::vector<unsigned char> payload(gPayloadSize);
+    std::mt19937 random(0);
+    for (std::size_t i = 0; i < payload.size(); i++)
+        payload[i] = static_cast<unsigned char>(random() & 0xFF);
+    gPayload.setVal(payload);
+    sgct::SharedData::instance()->setEncodeFunction(myEncodeFun);
+    sgct::SharedData::instance()->setCompression(gCompression);
+
+    for (unsigned int i = 0; i < gNumberOfNodes && success; i++)
+    {
+        SimulatedNode * node = new SimulatedNode();
+        node->mConnection = new sgct_core::SGCTNetwork();
+        node->mThread = NULL;
+        node->mDrawTime = gDrawTime;
+        node->mRandom.seed(i + 1);
+        node->mDeliveryTimes.setWindowLength(gNumberOfFrames);
+        node->mAckTimes.setWindowLength(gNumberOfFrames);
+        gNodes.push_back(node);
+
+        for (std::size_t j = 0; j < gSlowNodes.size(); j++)
+            if (gSlowNodes[j].first == i + 1)
+                node->mDrawTime += gSlowNodes[j].second;
+
+        char port[16];
+        sprintf(port, "%d", gFirstPort + static_cast<int>(i));
+        node->mConnection->setDecodeFunction([node](const char * receivedData, int receivedLength, int) {
+            receiveSyncData(node, receivedData, receivedLength);
+        });
+
+        try
+        {
+            node->mConnection->init(port, "127.0.0.1", false, sgct_core::SGCTNetwork::SyncConnection);
+        }
+        catch (const char * err)
+        {
+            fprintf(stderr, "Node %u failed to connect! Error: '%s'\n", i + 1, err);
+            success = false;
+        }
+    }
+
+    //wait for the connected message to reach the nodes
+    double t0 = getSeconds();
+    while (success && !networkManager->areAllNodesConnected())
+    {
+        if (getSeconds() - t0 > 10.0)
+        {
+            fprintf(stderr, "Timeout while waiting for the nodes to connect!\n");
+            success = false;
+        }
+        sleepSeconds(0.001);
+    }
+
+    for (std::size_t i = 0; i < gNodes.size() && success; i++)
+        gNodes[i]->mThread = new std::thread(runClientNode, gNodes[i]);
+
+    double masterDrawTime = gDrawTime;
+    for (std::size_t j = 0; j < gSlowNodes.size(); j++)
+        if (gSlowNodes[j].first == 0)
+            masterDrawTime += gSlowNodes[j].second;
+
+    sgct_core::Statistics statistics;
+    sgct_core::PercentileHistogram frameTimes(gNumberOfFrames);
+    sgct_core::PercentileHistogram encodeTimes(gNumberOfFrames);
+    sgct_core::PercentileHistogram sendTimes(gNumberOfFrames);
+    sgct_core::PercentileHistogram waitTimes(gNumberOfFrames);
+
+    double startTime = getSeconds();
+    unsigned int frame = 0;
+    for (; frame < gNumberOfFrames && success; frame++)
+    {
+        double frameStart = getSeconds();
+
+        //pre sync, the master's part of Engine::frameLock
+        if (!gFirmSync)
+            checkAcks(networkManager);
+
+        gTimestamp.setVal(frameStart);
+        gFrameNumber.setVal(static_cast<int>(frame));
+        sgct::SharedData::instance()->encode();
+        double sendStart = getSeconds();
+        encodeTimes.add(static_cast<float>(sendStart - frameStart));
+
+        for (std::size_t i = 0; i < gNodes.size(); i++)
+        {
+            gNodes[i]->mSendTime = sendStart;
+            gNodes[i]->mAcked = false;
+        }
+        networkManager->sync(sgct_core::NetworkManager::SendDataToClients, &statistics);
+        sendTimes.add(static_cast<float>(getSeconds() - sendStart));
+
+        sleepSeconds(masterDrawTime);
+
+        //post sync, wait for the nodes to acknowledge
+        double waitStart = getSeconds();
+        std::unique_lock<std::mutex> lock(*sgct::SGCTMutexManager::instance()->getMutexPtr(sgct::SGCTMutexManager::FrameSyncMutex));
+        while (gFirmSync && networkManager->isRunning() && !networkManager->isSyncComplete())
+        {
+            checkAcks(networkManager);
+            if (getSeconds() - waitStart > 10.0)
+            {
+                fprintf(stderr, "No sync signal from all nodes after 10 seconds in frame %u!\n", frame);
+                success = false;
+                break;
+            }
+            sgct_core::NetworkManager::gCond.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        lock.unlock();
+        if (gFirmSync)
+            checkAcks(networkManager);
+        waitTimes.add(static_cast<float>(getSeconds() - waitStart));
+
+        frameTimes.add(static_cast<float>(getSeconds() - frameStart));
+    }
+    double elapsedTime = getSeconds() - startTime;
+
+    if (frame > 0)
+    {
+        fprintf(stdout, "%u nodes, %u frames, %u bytes%s, %s sync, latency %.2f ms, jitter %.2f ms, draw %.2f ms\n",
+            gNumberOfNodes, frame, static_cast<unsigned int>(sgct::SharedData::instance()->getDataSize()),
+            gCompression ? " (compressed)" : "", gFirmSync ? "firm" : "loose", gLatency * 1000.0, gJitter * 1000.0, gDrawTime * 1000.0);
+        fprintf(stdout, "Master: %.1f frames per second\n", static_cast<double>(frame) / elapsedTime);
+        printTimes("frame time", frameTimes);
+        printTimes("encode time", encodeTimes);
+        printTimes("send time", sendTimes);
+        printTimes("wait for nodes", waitTimes);
+
+        for (std::size_t i = 0; i < gNodes.size(); i++)
+        {
+            fprintf(stdout, "Node %u: draw %.2f ms\n", static_cast<unsigned int>(i + 1), gNodes[i]->mDrawTime * 1000.0);
+            gNodes[i]->mMutex.lock();
+            printTimes("delivery latency", gNodes[i]->mDeliveryTimes);
+            gNodes[i]->mMutex.unlock();
+            printTimes("ack latency", gNodes[i]->mAckTimes);
+        }
+    }
+
+    //shut down the nodes before the master like a cluster would
+    gRunning = false;
+    sgct_core::NetworkManager::gCond.notify_all();
+    for (std::size_t i = 0; i < gNodes.size(); i++)
+        if (gNodes[i]->mThread != NULL)
+        {
+            gNodes[i]->mThread->join();
+            delete gNodes[i]->mThread;
+        }
+
+    for (std::size_t i = 0; i < gNodes.size(); i++)
+        gNodes[i]->mConnection->initShutdown();
+    sleepSeconds(0.25);
+    for (std::size_t i = 0; i < gNodes.size(); i++)
+    {
+        gNodes[i]->mConnection->closeNetwork(false);
+        delete gNodes[i]->mConnection;
+        delete gNodes[i];
+    }
+    gNodes.clear();
+
+    delete networkManager;
+    return success;
+}
+
+int main( int argc, char* argv[] )
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-nodes") == 0 && argc > (i + 1))
+            gNumberOfNodes = static_cast<unsigned int>(std::min(std::max(1, atoi(argv[++i])), 254));
+        else if (strcmp(argv[i], "-frames") == 0 && argc > (i + 1))
+            gNumberOfFrames = static_cast<unsigned int>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "-payload") == 0 && argc > (i + 1))
+            gPayloadSize = static_cast<std::size_t>(std::max(0, atoi(argv[++i])));
+        else if (strcmp(argv[i], "-compression") == 0)
+            gCompression = true;
+        else if (strcmp(argv[i], "-latency") == 0 && argc > (i + 1))
+            gLatency = atof(argv[++i]) / 1000.0;
+        else if (strcmp(argv[i], "-jitter") == 0 && argc > (i + 1))
+            gJitter = atof(argv[++i]) / 1000.0;
+        else if (strcmp(argv[i], "-draw") == 0 && argc > (i + 1))
+            gDrawTime = atof(argv[++i]) / 1000.0;
+        else if (strcmp(argv[i], "-slow") == 0 && argc > (i + 2))
+        {
+            unsigned int index = static_cast<unsigned int>(std::max(0, atoi(argv[i + 1])));
+            gSlowNodes.push_back(std::make_pair(index, atof(argv[i + 2]) / 1000.0));
+            i += 2;
+        }
+        else if (strcmp(argv[i], "-loose") == 0)
+            gFirmSync = false;
+        else if (strcmp(argv[i], "-port") == 0 && argc > (i + 1))
+            gFirstPort = atoi(argv[++i]);
+    }
+
+    //only errors, the network prints every connection change
+    sgct::MessageHandler::instance()->setNotifyLevel(sgct::MessageHandler::NOTIFY_IMPORTANT);
+
+    bool success = runSimulation();
+
+    if (sgct::SGCTMutexManager::isProfilingEnabled())
+        fprintf(stdout, "%s", sgct::SGCTMutexManager::instance()->getReport().c_str());
+
+    sgct::SharedData::destroy();
+    sgct_core::ClusterManager::destroy();
+    sgct::MessageHandler::destroy();
+    sgct::SGCTMutexManager::destroy();
+
+    exit( success ? EXIT_SUCCESS : EXIT_FAILURE );
+}
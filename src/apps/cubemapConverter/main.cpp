@@ -0,0 +1,221 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include "sgct.h"
+#include <sgct/CubemapConverter.h>
+#include <sgct/SGCTThreadPool.h>
+
+/*
+    Converts cube map faces into fisheye or equirectangular images on the CPU, without a window or a GPU.
+
+    Example, a 4k fisheye from the four faces used by the stitcher:
+    cubemapConverter -right right.png -bottom bottom.png -top top.png -left left.png -res 4096 -out fisheye.png
+
+    Image sequences are converted by replacing a run of '#' in the paths with the zero padded frame number:
+    cubemapConverter -right right_####.png ... -seq 1 250 -out fisheye_####.png
+
+    Single images are converted using all threads on the rows, sequences convert one frame per thread.
+*/
+
+std::string facePaths[sgct_core::CubemapConverter::NumberOfFaces];
+std::string outputPath;
+int resolution[2] = { 2048, 0 };
+int startFrame = 0;
+int stopFrame = -1;
+unsigned int numberOfThreads = 0;
+
+std::atomic<int> numberOfFailedFrames(0);
+
+void printUsage();
+std::string getFramePath(const std::string & path, int frame);
+void convertFrame(const sgct_core::CubemapConverter * converter, int frame, unsigned int threads);
+
+int main( int argc, char* argv[] )
+{
+    sgct_core::CubemapConverter converter;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-right") == 0 || strcmp(argv[i], "-posx") == 0) && argc > (i + 1))
+            facePaths[sgct_core::CubemapConverter::PositiveX] = argv[++i];
+        else if (strcmp(argv[i], "-negx") == 0 && argc > (i + 1))
+            facePaths[sgct_core::CubemapConverter::NegativeX] = argv[++i];
+        else if ((strcmp(argv[i], "-bottom") == 0 || strcmp(argv[i], "-posy") == 0) && argc > (i + 1))
+            facePaths[sgct_core::CubemapConverter::PositiveY] = argv[++i];
+        else if ((strcmp(argv[i], "-top") == 0 || strcmp(argv[i], "-negy") == 0) && argc > (i + 1))
+            facePaths[sgct_core::CubemapConverter::NegativeY] = argv[++i];
+        else if ((strcmp(argv[i], "-left") == 0 || strcmp(argv[i], "-posz") == 0) && argc > (i + 1))
+            facePaths[sgct_core::CubemapConverter::PositiveZ] = argv[++i];
+        else if (strcmp(argv[i], "-negz") == 0 && argc > (i + 1))
+            facePaths[sgct_core::CubemapConverter::NegativeZ] = argv[++i];
+        else if (strcmp(argv[i], "-out") == 0 && argc > (i + 1))
+            outputPath = argv[++i];
+        else if (strcmp(argv[i], "-seq") == 0 && argc > (i + 2))
+        {
+            startFrame = atoi(argv[i + 1]);
+            stopFrame = atoi(argv[i + 2]);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "-res") == 0 && argc > (i + 1))
+        {
+            //optional height, equirectangular images default to 2:1
+            resolution[0] = atoi(argv[++i]);
+            if (argc > (i + 1) && argv[i + 1][0] != '-')
+                resolution[1] = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-type") == 0 && argc > (i + 1))
+        {
+            i++;
+            converter.setOutputType(strcmp(argv[i], "equirectangular") == 0 || strcmp(argv[i], "latlon") == 0 ?
+                sgct_core::CubemapConverter::Equirectangular : sgct_core::CubemapConverter::Fisheye);
+        }
+        else if (strcmp(argv[i], "-fov") == 0 && argc > (i + 1))
+            converter.setFOV(static_cast<float>(atof(argv[++i])));
+        else if (strcmp(argv[i], "-tilt") == 0 && argc > (i + 1))
+            converter.setTilt(static_cast<float>(atof(argv[++i])));
+        else if (strcmp(argv[i], "-crop") == 0 && argc > (i + 4))
+        {
+            converter.setCropFactors(static_cast<float>(atof(argv[i + 1])), static_cast<float>(atof(argv[i + 2])),
+                static_cast<float>(atof(argv[i + 3])), static_cast<float>(atof(argv[i + 4])));
+            i += 4;
+        }
+        else if (strcmp(argv[i], "-offset") == 0 && argc > (i + 3))
+        {
+            converter.setOffset(static_cast<float>(atof(argv[i + 1])), static_cast<float>(atof(argv[i + 2])), static_cast<float>(atof(argv[i + 3])));
+            i += 3;
+        }
+        else if (strcmp(argv[i], "-method") == 0 && argc > (i + 1))
+        {
+            i++;
+            if (strcmp(argv[i], "five_face_cube") == 0)
+                converter.setRenderingMethod(sgct_core::FisheyeProjection::FiveFaceCube);
+            else if (strcmp(argv[i], "six_face_cube") == 0)
+                converter.setRenderingMethod(sgct_core::FisheyeProjection::SixFaceCube);
+            else
+                converter.setRenderingMethod(sgct_core::FisheyeProjection::FourFaceCube);
+        }
+        else if (strcmp(argv[i], "-cubic") == 0 && argc > (i + 1))
+            converter.setInterpolationMode(strcmp(argv[++i], "1") == 0 ? sgct_core::NonLinearProjection::Cubic : sgct_core::NonLinearProjection::Linear);
+        else if (strcmp(argv[i], "-bg") == 0 && argc > (i + 4))
+        {
+            converter.setBackgroundColor(static_cast<float>(atof(argv[i + 1])), static_cast<float>(atof(argv[i + 2])),
+                static_cast<float>(atof(argv[i + 3])), static_cast<float>(atof(argv[i + 4])));
+            i += 4;
+        }
+        else if (strcmp(argv[i], "-threads") == 0 && argc > (i + 1))
+            numberOfThreads = static_cast<unsigned int>(atoi(argv[++i]));
+        else
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "Unknown argument: %s\n", argv[i]);
+        }
+    }
+
+    if (outputPath.empty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    if (resolution[1] <= 0)
+        resolution[1] = converter.getOutputType() == sgct_core::CubemapConverter::Equirectangular ? resolution[0] / 2 : resolution[0];
+
+    if (numberOfThreads == 0)
+        numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    //glfw isn't initialized so the engine timer can't be used
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    int numberOfFrames = 1;
+    if (stopFrame < startFrame)
+        convertFrame(&converter, startFrame, numberOfThreads);
+    else
+    {
+        //one frame per thread, frames are independent
+        numberOfFrames = stopFrame - startFrame + 1;
+        sgct_core::SGCTThreadPool pool;
+        pool.start(std::min(numberOfThreads, static_cast<unsigned int>(numberOfFrames)));
+        for (int frame = startFrame; frame <= stopFrame; frame++)
+            pool.addTask([&converter, frame]() { convertFrame(&converter, frame, 1); });
+        pool.waitUntilIdle();
+        pool.stop();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    sgct::MessageHandler::instance()->print("Converted %d frame(s) in %.2f s (%.2f frames/s, %u threads)\n",
+        numberOfFrames - numberOfFailedFrames.load(), seconds, seconds > 0.0 ? static_cast<double>(numberOfFrames) / seconds : 0.0, numberOfThreads);
+
+    exit( numberOfFailedFrames.load() == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+void printUsage()
+{
+    sgct::MessageHandler::instance()->print(
+        "Usage: cubemapConverter [faces] -out <path> [options]\n"
+        "Faces: -right|-posx, -negx, -bottom|-posy, -top|-negy, -left|-posz, -negz <path>\n"
+        "Options:\n"
+        "  -type fisheye|equirectangular\n"
+        "  -res <width> [height]\n"
+        "  -fov <degrees>, -tilt <degrees>, -crop <left> <right> <bottom> <top>, -offset <x> <y> <z>\n"
+        "  -method four_face_cube|five_face_cube|six_face_cube\n"
+        "  -cubic 0|1, -bg <r> <g> <b> <a>\n"
+        "  -seq <start> <stop> (replaces '#' in paths with the frame number)\n"
+        "  -threads <count>\n");
+}
+
+/*
+    Replace the last run of '#' in the path with the zero padded frame number.
+*/
+std::string getFramePath(const std::string & path, int frame)
+{
+    std::size_t last = path.find_last_of('#');
+    if (last == std::string::npos)
+        return path;
+
+    std::size_t first = last;
+    while (first > 0 && path[first - 1] == '#')
+        first--;
+
+    char digits[32];
+    #if (_MSC_VER >= 1400)
+    sprintf_s(digits, 32, "%0*d", static_cast<int>(last - first + 1), frame);
+    #else
+    sprintf(digits, "%0*d", static_cast<int>(last - first + 1), frame);
+    #endif
+
+    return path.substr(0, first) + digits + path.substr(last + 1);
+}
+
+void convertFrame(const sgct_core::CubemapConverter * converter, int frame, unsigned int threads)
+{
+    sgct_core::Image faces[sgct_core::CubemapConverter::NumberOfFaces];
+    sgct_core::Image * facePtrs[sgct_core::CubemapConverter::NumberOfFaces];
+    for (std::size_t i = 0; i < sgct_core::CubemapConverter::NumberOfFaces; i++)
+    {
+        facePtrs[i] = NULL;
+        if (facePaths[i].empty())
+            continue;
+
+        if (!faces[i].load(getFramePath(facePaths[i], frame)))
+        {
+            numberOfFailedFrames++;
+            return;
+        }
+        facePtrs[i] = &faces[i];
+    }
+
+    sgct_core::Image output;
+    output.setSize(resolution[0], resolution[1]);
+    output.setFilename(getFramePath(outputPath, frame));
+    if (!converter->convert(facePtrs, output, threads) || !output.save())
+    {
+        numberOfFailedFrames++;
+        return;
+    }
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Saved %s\n", output.getFilename());
+}
@@ -0,0 +1,133 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+#include "sgct.h"
+
+/*
+    Compares Image::getInterpolatedSampleAt, called once per channel and position, with Image::sampleBatch.
+    Runs without a window. Uses a generated 8-bit RGBA image unless an image is given:
+
+    imageSamplingBenchmark [-image <path>] [-samples <count>]
+
+    Two access patterns are measured: random positions (cache bound) and a slightly rotated and scaled
+    scan over the image, similar to CPU resampling and calibration loops.
+*/
+
+double getSeconds()
+{
+    //glfw isn't initialized so the engine timer can't be used
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void runBenchmark(sgct_core::Image & image, const char * pattern, const std::vector<float> & xs, const std::vector<float> & ys)
+{
+    std::size_t count = xs.size();
+    std::size_t channels = image.getChannels();
+    std::vector<float> perSample(count * channels);
+    std::vector<float> batch(count * channels);
+
+    //getInterpolatedSampleAt only supports 8-bit images and doesn't clamp at the edges
+    bool comparePerSample = image.getBytesPerChannel() == 1;
+    double perSampleTime = 0.0;
+    if (comparePerSample)
+    {
+        double t0 = getSeconds();
+        for (std::size_t i = 0; i < count; i++)
+            for (std::size_t c = 0; c < channels; c++)
+                perSample[i * channels + c] = image.getInterpolatedSampleAt(xs[i], ys[i], static_cast<sgct_core::Image::ChannelType>(c));
+        perSampleTime = getSeconds() - t0;
+    }
+
+    double t0 = getSeconds();
+    image.sampleBatch(count, &xs[0], &ys[0], &batch[0]);
+    double bilinearTime = getSeconds() - t0;
+
+    float maxDifference = 0.0f;
+    if (comparePerSample)
+        for (std::size_t i = 0; i < count * channels; i++)
+            maxDifference = std::max(maxDifference, fabsf(perSample[i] - batch[i]));
+
+    t0 = getSeconds();
+    image.sampleBatch(count, &xs[0], &ys[0], &batch[0], sgct_core::Image::SAMPLE_BICUBIC);
+    double bicubicTime = getSeconds() - t0;
+
+    double toNs = 1.0e9 / static_cast<double>(count);
+    if (comparePerSample)
+        fprintf(stdout, "%-8s per sample: %7.2f ns  batch bilinear: %7.2f ns (%.1fx, max diff %g)  batch bicubic: %7.2f ns\n",
+            pattern, perSampleTime * toNs, bilinearTime * toNs, perSampleTime / bilinearTime, maxDifference, bicubicTime * toNs);
+    else
+        fprintf(stdout, "%-8s batch bilinear: %7.2f ns  batch bicubic: %7.2f ns\n", pattern, bilinearTime * toNs, bicubicTime * toNs);
+}
+
+int main( int argc, char* argv[] )
+{
+    const char * imagePath = NULL;
+    std::size_t numberOfSamples = 1 << 22;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-image") == 0 && argc > (i + 1))
+            imagePath = argv[++i];
+        else if (strcmp(argv[i], "-samples") == 0 && argc > (i + 1))
+            numberOfSamples = static_cast<std::size_t>(atol(argv[++i]));
+    }
+
+    sgct_core::Image image;
+    if (imagePath != NULL)
+    {
+        if (!image.load(imagePath))
+            return EXIT_FAILURE;
+    }
+    else
+    {
+        image.setSize(2048, 2048);
+        image.setChannels(4);
+        image.setBytesPerChannel(1);
+        if (!image.allocateOrResizeData())
+            return EXIT_FAILURE;
+
+        srand(1);
+        for (std::size_t i = 0; i < image.getDataSize(); i++)
+            image.getData()[i] = static_cast<unsigned char>(rand() & 0xff);
+    }
+
+    //stay one pixel inside so that getInterpolatedSampleAt doesn't read outside the image
+    float maxX = static_cast<float>(image.getWidth()) - 2.0f;
+    float maxY = static_cast<float>(image.getHeight()) - 2.0f;
+
+    std::vector<float> xs(numberOfSamples);
+    std::vector<float> ys(numberOfSamples);
+
+    srand(2);
+    for (std::size_t i = 0; i < numberOfSamples; i++)
+    {
+        xs[i] = maxX * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+        ys[i] = maxY * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+    }
+
+    fprintf(stdout, "%ux%u image, %u channels, %u bytes per channel, %u samples\n",
+        static_cast<unsigned int>(image.getWidth()), static_cast<unsigned int>(image.getHeight()),
+        static_cast<unsigned int>(image.getChannels()), static_cast<unsigned int>(image.getBytesPerChannel()),
+        static_cast<unsigned int>(numberOfSamples));
+
+    runBenchmark(image, "random", xs, ys);
+
+    //rotated by 5 degrees and scaled by 0.9 around the center
+    std::size_t rowLength = static_cast<std::size_t>(sqrt(static_cast<double>(numberOfSamples)));
+    float cosAngle = 0.9f * cosf(0.0872665f);
+    float sinAngle = 0.9f * sinf(0.0872665f);
+    for (std::size_t i = 0; i < numberOfSamples; i++)
+    {
+        float u = (static_cast<float>(i % rowLength) / static_cast<float>(rowLength) - 0.5f) * maxX;
+        float v = (static_cast<float>(i / rowLength) / static_cast<float>(rowLength) - 0.5f) * maxY;
+        xs[i] = std::min(maxX, std::max(0.0f, 0.5f * maxX + cosAngle * u - sinAngle * v));
+        ys[i] = std::min(maxY, std::max(0.0f, 0.5f * maxY + sinAngle * u + cosAngle * v));
+    }
+
+    runBenchmark(image, "scan", xs, ys);
+
+    exit( EXIT_SUCCESS );
+}
@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "sgct.h"
+#include "sgct/Viewport.h"
+#include "sgct/CorrectionMesh.h"
+
+/*
+    Round-trip test of the text warping mesh parsers without a window:
+
+    meshParserTest [-path <directory with the meshes>]
+
+    Each mesh is parsed with CorrectionMesh::readMesh and the parsed vertex and index buffers are compared
+    with <mesh>.ref. The reference files were written by the sscanf based parsers that SGCTTextTokenizer
+    replaced, for a viewport covering the whole window and a window aspect ratio of one. The meshes use
+    fixed, %g and %e notation, CRLF line endings (DomeProjection), comments and normals (OBJ) and masked
+    vertices (SkySkan).
+
+    Reference format: "<vertices> <indices>", one line per vertex with the bit patterns of x y s t r g b a
+    in hexadecimal so that the comparison is exact, and one line per triangle.
+*/
+
+struct TestMesh
+{
+    const char * mFilename;
+    const char * mFormat;
+};
+
+const TestMesh gMeshes[] = {
+    { "domeprojection.csv", "DomeProjection" },
+    { "scalable.ol", "Scalable" },
+    { "skyskan.skyskan", "SkySkan" },
+    { "paulbourke.data", "Paul Bourke" },
+    { "obj.obj", "OBJ" }
+};
+
+struct Reference
+{
+    std::vector<uint32_t> mVertexBits;
+    std::vector<unsigned int> mIndices;
+};
+
+bool readReference(const std::string & filename, Reference & ref)
+{
+    FILE * file = fopen(filename.c_str(), "r");
+    if (file == NULL)
+        return false;
+
+    unsigned int numberOfVertices = 0;
+    unsigned int numberOfIndices = 0;
+    bool success = fscanf(file, "%u %u", &numberOfVertices, &numberOfIndices) == 2;
+
+    ref.mVertexBits.resize(numberOfVertices * 8);
+    for (std::size_t i = 0; success && i < ref.mVertexBits.size(); i++)
+    {
+        unsigned int bits;
+        success = fscanf(file, "%x", &bits) == 1;
+        ref.mVertexBits[i] = static_cast<uint32_t>(bits);
+    }
+
+    ref.mIndices.resize(numberOfIndices);
+    for (std::size_t i = 0; success && i < ref.mIndices.size(); i++)
+        success = fscanf(file, "%u", &ref.mIndices[i]) == 1;
+
+    fclose(file);
+    return success;
+}
+
+bool testMesh(const TestMesh & mesh, const std::string & path)
+{
+    std::string filename = path + mesh.mFilename;
+
+    Reference ref;
+    if (!readReference(filename + ".ref", ref))
+    {
+        fprintf(stderr, "%s: Failed to read '%s.ref'!\n", mesh.mFormat, filename.c_str());
+        return false;
+    }
+
+    sgct::SGCTWindow window(0);
+    sgct_core::Viewport viewport(0.0f, 0.0f, 1.0f, 1.0f);
+    sgct_core::CorrectionMesh correctionMesh;
+    if (!correctionMesh.readMesh(filename, &viewport, &window))
+    {
+        fprintf(stderr, "%s: Failed to parse '%s'!\n", mesh.mFormat, filename.c_str());
+        return false;
+    }
+
+    const sgct_core::CorrectionMeshGeometry * geometry = correctionMesh.getGeometry(sgct_core::CorrectionMesh::WARP_MESH);
+    const sgct_core::CorrectionMeshVertex * vertices = correctionMesh.getParsedVertices(sgct_core::CorrectionMesh::WARP_MESH);
+    const unsigned int * indices = correctionMesh.getParsedIndices(sgct_core::CorrectionMesh::WARP_MESH);
+
+    if (geometry->mGeometryType != GL_TRIANGLES ||
+        geometry->mNumberOfVertices * 8 != ref.mVertexBits.size() ||
+        geometry->mNumberOfIndices != ref.mIndices.size() ||
+        vertices == NULL || indices == NULL)
+    {
+        fprintf(stderr, "%s: Parsed %u vertices and %u indices, expected %u and %u!\n", mesh.mFormat,
+            geometry->mNumberOfVertices, geometry->mNumberOfIndices,
+            static_cast<unsigned int>(ref.mVertexBits.size() / 8), static_cast<unsigned int>(ref.mIndices.size()));
+        return false;
+    }
+
+    for (unsigned int i = 0; i < geometry->mNumberOfVertices; i++)
+    {
+        uint32_t bits[8];
+        memcpy(bits, &vertices[i], sizeof(bits));
+        if (memcmp(bits, &ref.mVertexBits[i * 8], sizeof(bits)) != 0)
+        {
+            fprintf(stderr, "%s: Vertex %u differs, parsed %f %f %f %f!\n", mesh.mFormat, i,
+                vertices[i].x, vertices[i].y, vertices[i].s, vertices[i].t);
+            return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < geometry->mNumberOfIndices; i++)
+        if (indices[i] != ref.mIndices[i])
+        {
+            fprintf(stderr, "%s: Index %u is %u, expected %u!\n", mesh.mFormat, i, indices[i], ref.mIndices[i]);
+            return false;
+        }
+
+    return true;
+}
+
+int main( int argc, char* argv[] )
+{
+    std::string path;
+    for (int i = 1; i < argc; i++)
+        if (strcmp(argv[i], "-path") == 0 && argc > (i + 1))
+        {
+            path = argv[++i];
+            if (!path.empty() && path[path.size() - 1] != '/' && path[path.size() - 1] != '\\')
+                path.push_back('/');
+        }
+
+    sgct::MessageHandler::instance()->setNotifyLevel(sgct::MessageHandler::NOTIFY_ERROR);
+
+    //compare the parser output, not the cache or the optimized mesh
+    sgct::SGCTSettings::instance()->setUseWarpingMeshCache(false);
+    sgct::SGCTSettings::instance()->setUseWarpingMeshVertexCacheOptimization(false);
+    sgct::SGCTSettings::instance()->setWarpingMeshSimplificationTolerance(0.0f);
+
+    unsigned int failed = 0;
+    const std::size_t numberOfMeshes = sizeof(gMeshes) / sizeof(TestMesh);
+    for (std::size_t i = 0; i < numberOfMeshes; i++)
+    {
+        bool success = testMesh(gMeshes[i], path);
+        fprintf(stdout, "%-20s %s\n", gMeshes[i].mFormat, success ? "passed" : "FAILED");
+        if (!success)
+            failed++;
+    }
+
+    sgct::MessageHandler::instance()->flush();
+    fprintf(stdout, "%u of %u meshes passed\n", static_cast<unsigned int>(numberOfMeshes) - failed, static_cast<unsigned int>(numberOfMeshes));
+    exit( failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
@@ -0,0 +1,624 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "sgct.h"
+#include "sgct/SGCTNetwork.h"
+#include "sgct/NetworkManager.h"
+#include "sgct/SGCTMutexManager.h"
+#include "sgct/Image.h"
+#include "sgct/Viewport.h"
+#include "sgct/CorrectionMesh.h"
+
+/*
+    Benchmarks of SGCT's CPU hot paths using fixed synthetic inputs, for tracking performance across versions:
+
+    sgct_bench [-filter <text>] [-iterations <count>] [-nodes <count>] [-port <first port>] [-output <json file>] [-nofont]
+
+    shared_data  SharedData encode and decode of a float vector, with and without compression
+    network      loopback sync between a master and client nodes in this process using SGCTNetwork, one frame and ack per iteration
+    image        PNG, JPEG and TGA encode and decode of a generated image in memory (PNG and TGA are encoded to a file)
+    mesh         DomeProjection, Scalable, SkySkan, OBJ and Paul Bourke warping mesh parsers on generated meshes
+    font         glyph creation of the default font, needs an OpenGL context so a hidden window is opened
+
+    Only benchmarks whose name contains the filter text are run. All benchmarks except font run without a window.
+    Results are printed as a table and written as JSON if an output file is given. Times are per iteration in microseconds.
+*/
+
+struct BenchmarkResult
+{
+    std::string mName;
+    std::size_t mIterations;
+    double mMin;
+    double mMedian;
+    double mP99;
+    double mMean;
+    double mBytesPerIteration;
+};
+
+std::vector<BenchmarkResult> gResults;
+std::string gFilter;
+std::size_t gIterations = 50;
+unsigned int gNumberOfNodes = 3;
+int gFirstPort = 20500;
+
+double getSeconds()
+{
+    //glfw isn't initialized so the engine timer can't be used
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool isSelected(const std::string & name)
+{
+    return gFilter.empty() || name.find(gFilter) != std::string::npos;
+}
+
+/*
+    Runs the function once to warm up and then the given number of times, recording the time of each call.
+    The function returns false on failure, which stops the benchmark without a result.
+*/
+template <class Function>
+void runBenchmark(const std::string & name, std::size_t bytesPerIteration, std::size_t iterations, Function fn)
+{
+    if (!isSelected(name))
+        return;
+
+    if (!fn())
+    {
+        fprintf(stderr, "%s failed!\n", name.c_str());
+        return;
+    }
+
+    std::vector<double> times;
+    times.reserve(iterations);
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        double t0 = getSeconds();
+        if (!fn())
+        {
+            fprintf(stderr, "%s failed!\n", name.c_str());
+            return;
+        }
+        times.push_back((getSeconds() - t0) * 1.0e6);
+    }
+
+    double sum = 0.0;
+    for (std::size_t i = 0; i < times.size(); i++)
+        sum += times[i];
+    std::sort(times.begin(), times.end());
+
+    BenchmarkResult result;
+    result.mName = name;
+    result.mIterations = iterations;
+    result.mMin = times.front();
+    result.mMedian = times[times.size() / 2];
+    result.mP99 = times[std::min(times.size() - 1, static_cast<std::size_t>(ceil(0.99 * static_cast<double>(times.size()))) - 1)];
+    result.mMean = sum / static_cast<double>(times.size());
+    result.mBytesPerIteration = static_cast<double>(bytesPerIteration);
+    gResults.push_back(result);
+
+    double throughput = result.mBytesPerIteration / result.mMedian; //bytes per us = MB/s
+    fprintf(stdout, "%-40s %12.2f %12.2f %12.2f %12.2f %10.1f\n",
+        name.c_str(), result.mMin, result.mMedian, result.mP99, result.mMean, throughput);
+    fflush(stdout);
+}
+
+/*
+    SharedData
+*/
+sgct::SharedVector<float> gSharedFloats;
+sgct::SharedDouble gSharedTime(0.0);
+sgct::SharedBool gSharedFlag(false);
+sgct::SharedString gSharedString;
+
+void myEncodeFun()
+{
+    sgct::SharedData::instance()->writeDouble(&gSharedTime);
+    sgct::SharedData::instance()->writeBool(&gSharedFlag);
+    sgct::SharedData::instance()->writeString(&gSharedString);
+    sgct::SharedData::instance()->writeVector(&gSharedFloats);
+}
+
+void myDecodeFun()
+{
+    sgct::SharedData::instance()->readDouble(&gSharedTime);
+    sgct::SharedData::instance()->readBool(&gSharedFlag);
+    sgct::SharedData::instance()->readString(&gSharedString);
+    sgct::SharedData::instance()->readVector(&gSharedFloats);
+}
+
+void benchmarkSharedData()
+{
+    sgct::SharedData * sd = sgct::SharedData::instance();
+    sd->setEncodeFunction(myEncodeFun);
+    sd->setDecodeFunction(myDecodeFun);
+    gSharedString.setVal("sgct_bench shared data");
+
+    const std::size_t sizes[] = { 1024, 64 * 1024, 1024 * 1024 };
+    for (std::size_t s = 0; s < 3; s++)
+    {
+        std::size_t size = sizes[s];
+        std::vector<float> floats(size / sizeof(float));
+        for (std::size_t i = 0; i < floats.size(); i++)
+            floats[i] = sinf(static_cast<float>(i) * 0.01f);
+        gSharedFloats.setVal(floats);
+
+        char name[64];
+        sd->setCompression(false);
+        sprintf(name, "shared_data/encode/%uKB", static_cast<unsigned int>(size / 1024));
+        runBenchmark(name, size, gIterations, [&]() { sd->encode(); return true; });
+
+        //the data after the header is what the clients decode
+        sd->encode();
+        std::vector<char> encoded(sd->getDataBlock() + sgct_core::SGCTNetwork::mHeaderSize, sd->getDataBlock() + sd->getDataSize());
+        sprintf(name, "shared_data/decode/%uKB", static_cast<unsigned int>(size / 1024));
+        runBenchmark(name, size, gIterations, [&]() {
+            sd->decode(&encoded[0], static_cast<int>(encoded.size()), 0);
+            return gSharedFloats.getSize() == floats.size();
+        });
+
+        sd->setCompression(true, 1);
+        sprintf(name, "shared_data/encode_compressed/%uKB", static_cast<unsigned int>(size / 1024));
+        runBenchmark(name, size, gIterations, [&]() { sd->encode(); return true; });
+        sd->setCompression(false);
+    }
+
+    sd->setEncodeFunction(NULL);
+    sd->setDecodeFunction(NULL);
+}
+
+/*
+    Loopback sync using the same framing as NetworkManager, one frame to every client and one ack back per iteration
+*/
+bool waitForAcks(std::vector<sgct_core::SGCTNetwork *> & connections, double timeout)
+{
+    double t0 = getSeconds();
+    std::unique_lock<std::mutex> lock(*sgct::SGCTMutexManager::instance()->getMutexPtr(sgct::SGCTMutexManager::FrameSyncMutex));
+    while (true)
+    {
+        bool done = true;
+        for (std::size_t i = 0; i < connections.size(); i++)
+            done = done && connections[i]->isUpdated();
+        if (done)
+            return true;
+        if (getSeconds() - t0 > timeout)
+            return false;
+
+        //the notification can be missed between the check and the wait
+        sgct_core::NetworkManager::gCond.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+void benchmarkNetwork()
+{
+    if (!isSelected("network"))
+        return;
+
+    std::vector<sgct_core::SGCTNetwork *> servers;
+    std::vector<sgct_core::SGCTNetwork *> clients;
+    std::vector< std::vector<char> > clientData(gNumberOfNodes);
+
+    try
+    {
+        for (unsigned int i = 0; i < gNumberOfNodes; i++)
+        {
+            char port[16];
+            sprintf(port, "%d", gFirstPort + static_cast<int>(i));
+
+            sgct_core::SGCTNetwork * server = new sgct_core::SGCTNetwork();
+            servers.push_back(server);
+            //the server only wakes the waiting master when a decoder is set
+            server->setDecodeFunction([](const char *, int, int) {});
+            server->init(port, "127.0.0.1", true, sgct_core::SGCTNetwork::SyncConnection);
+
+            sgct_core::SGCTNetwork * client = new sgct_core::SGCTNetwork();
+            clients.push_back(client);
+            std::vector<char> * data = &clientData[i];
+            client->setDecodeFunction([client, data](const char * receivedData, int length, int) {
+                data->assign(receivedData, receivedData + length);
+                client->pushClientMessage();
+            });
+            client->init(port, "127.0.0.1", false, sgct_core::SGCTNetwork::SyncConnection);
+        }
+    }
+    catch (const char * err)
+    {
+        fprintf(stderr, "network: %s\n", err);
+    }
+
+    bool connected = servers.size() == gNumberOfNodes;
+    double t0 = getSeconds();
+    while (connected)
+    {
+        bool done = true;
+        for (std::size_t i = 0; i < servers.size(); i++)
+            done = done && servers[i]->isConnected() && clients[i]->isConnected();
+        if (done)
+            break;
+        if (getSeconds() - t0 > 10.0)
+        {
+            fprintf(stderr, "network: Timeout while connecting!\n");
+            connected = false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const std::size_t sizes[] = { 64, 16 * 1024, 1024 * 1024 };
+    for (std::size_t s = 0; s < 3 && connected; s++)
+    {
+        std::size_t size = sizes[s];
+        std::vector<char> message(sgct_core::SGCTNetwork::mHeaderSize + size);
+        for (std::size_t i = 0; i < size; i++)
+            message[sgct_core::SGCTNetwork::mHeaderSize + i] = static_cast<char>(i * 7);
+
+        char name[64];
+        sprintf(name, "network/loopback_sync/%unodes/%uB", gNumberOfNodes, static_cast<unsigned int>(size));
+        runBenchmark(name, size * gNumberOfNodes, gIterations, [&]() {
+            for (std::size_t i = 0; i < servers.size(); i++)
+            {
+                int32_t frame = servers[i]->iterateFrameCounter();
+                uint32_t dataSize = static_cast<uint32_t>(size);
+                uint32_t uncompressedSize = 0;
+                message[0] = sgct_core::SGCTNetwork::DataId;
+                memcpy(&message[1], &frame, 4);
+                memcpy(&message[5], &dataSize, 4);
+                memcpy(&message[9], &uncompressedSize, 4);
+                servers[i]->sendData(&message[0], static_cast<int>(message.size()));
+            }
+            return waitForAcks(servers, 10.0);
+        });
+    }
+
+    for (std::size_t i = 0; i < clients.size(); i++)
+        clients[i]->initShutdown();
+    for (std::size_t i = 0; i < servers.size(); i++)
+        servers[i]->initShutdown();
+
+    //wait for the connection threads to see the shutdown
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+    for (std::size_t i = 0; i < clients.size(); i++)
+    {
+        clients[i]->closeNetwork(false);
+        delete clients[i];
+    }
+    for (std::size_t i = 0; i < servers.size(); i++)
+    {
+        servers[i]->closeNetwork(false);
+        delete servers[i];
+    }
+}
+
+/*
+    Image codecs
+*/
+bool readFile(const char * filename, std::vector<unsigned char> & data)
+{
+    FILE * file = fopen(filename, "rb");
+    if (file == NULL)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data.resize(size > 0 ? static_cast<std::size_t>(size) : 0);
+    bool success = size > 0 && fread(&data[0], 1, data.size(), file) == data.size();
+    fclose(file);
+    return success;
+}
+
+void benchmarkImage()
+{
+    if (!isSelected("image"))
+        return;
+
+    //smooth gradients with some detail so that the codecs see something like a photo
+    sgct_core::Image image;
+    image.setSize(1024, 1024);
+    image.setChannels(4);
+    image.setBytesPerChannel(1);
+    if (!image.allocateOrResizeData())
+        return;
+
+    unsigned char * data = image.getData();
+    for (std::size_t y = 0; y < 1024; y++)
+        for (std::size_t x = 0; x < 1024; x++)
+        {
+            unsigned char * p = data + 4 * (y * 1024 + x);
+            p[0] = static_cast<unsigned char>(x / 4);
+            p[1] = static_cast<unsigned char>(y / 4);
+            p[2] = static_cast<unsigned char>(127.5f + 127.5f * sinf(static_cast<float>(x * y) * 0.0001f));
+            p[3] = 255;
+        }
+
+    std::size_t size = image.getDataSize();
+    std::vector<unsigned char> encoded;
+
+    runBenchmark("image/png/encode", size, gIterations, [&]() { return image.savePNG("sgct_bench.png", 1); });
+    if (readFile("sgct_bench.png", encoded))
+        runBenchmark("image/png/decode", size, gIterations, [&]() {
+            sgct_core::Image decoded;
+            return decoded.loadPNG(&encoded[0], encoded.size());
+        });
+    remove("sgct_bench.png");
+
+    unsigned char * jpeg = NULL;
+    std::size_t jpegSize = 0;
+    runBenchmark("image/jpeg/encode", size, gIterations, [&]() { return image.encodeJPEG(&jpeg, &jpegSize, 90); });
+    if (image.encodeJPEG(&jpeg, &jpegSize, 90))
+    {
+        encoded.assign(jpeg, jpeg + jpegSize);
+        runBenchmark("image/jpeg/decode", size, gIterations, [&]() {
+            sgct_core::Image decoded;
+            return decoded.loadJPEG(&encoded[0], encoded.size());
+        });
+    }
+
+    image.setFilename("sgct_bench.tga");
+    runBenchmark("image/tga/encode", size, gIterations, [&]() { return image.saveTGA(); });
+    if (readFile("sgct_bench.tga", encoded))
+        runBenchmark("image/tga/decode", size, gIterations, [&]() {
+            sgct_core::Image decoded;
+            return decoded.loadTGA(&encoded[0], encoded.size());
+        });
+    remove("sgct_bench.tga");
+}
+
+/*
+    Warping mesh parsers
+*/
+const unsigned int MeshResolution = 256;
+
+void writeMeshes()
+{
+    float n = static_cast<float>(MeshResolution - 1);
+
+    FILE * file = fopen("sgct_bench_mesh.csv", "w");
+    if (file != NULL)
+    {
+        for (unsigned int r = 0; r < MeshResolution; r++)
+            for (unsigned int c = 0; c < MeshResolution; c++)
+                fprintf(file, "%f;%f;%f;%f;%u;%u\n", c / n, r / n, 0.98f * c / n + 0.01f, 0.98f * r / n + 0.01f, c, r);
+        fclose(file);
+    }
+
+    file = fopen("sgct_bench_mesh.ol", "w");
+    if (file != NULL)
+    {
+        fprintf(file, "VERTICES %u\nFACES %u\n", MeshResolution * MeshResolution, (MeshResolution - 1) * (MeshResolution - 1) * 2);
+        fprintf(file, "ORTHO_LEFT 0\nORTHO_RIGHT 1920\nORTHO_BOTTOM 0\nORTHO_TOP 1080\nNATIVEXRES 1920\nNATIVEYRES 1080\n");
+        for (unsigned int r = 0; r < MeshResolution; r++)
+            for (unsigned int c = 0; c < MeshResolution; c++)
+                fprintf(file, "%f %f %u %f %f\n", 1920.0f * c / n, 1080.0f * r / n, (c * 7 + r * 3) % 256, r / n, c / n);
+        for (unsigned int r = 0; r + 1 < MeshResolution; r++)
+            for (unsigned int c = 0; c + 1 < MeshResolution; c++)
+            {
+                unsigned int i0 = r * MeshResolution + c;
+                unsigned int i1 = i0 + 1;
+                unsigned int i2 = i1 + MeshResolution;
+                unsigned int i3 = i0 + MeshResolution;
+                fprintf(file, "[ %u %u %u ]\n[ %u %u %u ]\n", i0, i1, i2, i0, i2, i3);
+            }
+        fclose(file);
+    }
+
+    file = fopen("sgct_bench_mesh.skyskan", "w");
+    if (file != NULL)
+    {
+        fprintf(file, "Dome Azimuth=0\nDome Elevation=30\nHorizontal FOV=90\nVertical FOV=60\n%u %u\n", MeshResolution, MeshResolution);
+        for (unsigned int r = 0; r < MeshResolution; r++)
+            for (unsigned int c = 0; c < MeshResolution; c++)
+                fprintf(file, "%f %f %f %f\n", 0.98f * c / n + 0.01f, 0.98f * r / n + 0.01f, c / n, r / n);
+        fclose(file);
+    }
+
+    file = fopen("sgct_bench_mesh.obj", "w");
+    if (file != NULL)
+    {
+        for (unsigned int r = 0; r < MeshResolution; r++)
+            for (unsigned int c = 0; c < MeshResolution; c++)
+                fprintf(file, "v %f %f 0.0\n", 2.0f * c / n - 1.0f, 2.0f * r / n - 1.0f);
+        for (unsigned int r = 0; r < MeshResolution; r++)
+            for (unsigned int c = 0; c < MeshResolution; c++)
+                fprintf(file, "vt %f %f\n", c / n, r / n);
+        for (unsigned int r = 0; r + 1 < MeshResolution; r++)
+            for (unsigned int c = 0; c + 1 < MeshResolution; c++)
+            {
+                unsigned int i0 = r * MeshResolution + c + 1;
+                unsigned int i1 = i0 + 1;
+                unsigned int i2 = i1 + MeshResolution;
+                unsigned int i3 = i0 + MeshResolution;
+                fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i0, i0, i0, i1, i1, i1, i2, i2, i2);
+                fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i0, i0, i0, i2, i2, i2, i3, i3, i3);
+            }
+        fclose(file);
+    }
+
+    file = fopen("sgct_bench_mesh.data", "w");
+    if (file != NULL)
+    {
+        fprintf(file, "2\n%u %u\n", MeshResolution, MeshResolution);
+        for (unsigned int r = 0; r < MeshResolution; r++)
+            for (unsigned int c = 0; c < MeshResolution; c++)
+                fprintf(file, "%f %f %f %f %f\n", 2.0f * c / n - 1.0f, 2.0f * r / n - 1.0f, c / n, r / n, 1.0f);
+        fclose(file);
+    }
+}
+
+void benchmarkMesh()
+{
+    if (!isSelected("mesh"))
+        return;
+
+    writeMeshes();
+
+    //the cache would skip the parsers
+    sgct::SGCTSettings::instance()->setUseWarpingMeshCache(false);
+
+    sgct::SGCTWindow window(0);
+    sgct_core::Viewport viewport(0.0f, 0.0f, 1.0f, 1.0f);
+
+    const char * files[] = { "sgct_bench_mesh.csv", "sgct_bench_mesh.ol", "sgct_bench_mesh.skyskan", "sgct_bench_mesh.obj", "sgct_bench_mesh.data" };
+    const char * names[] = { "mesh/domeprojection", "mesh/scalable", "mesh/skyskan", "mesh/obj", "mesh/paulbourke" };
+    for (std::size_t i = 0; i < sizeof(files) / sizeof(const char *); i++)
+    {
+        std::vector<unsigned char> data;
+        std::size_t size = readFile(files[i], data) ? data.size() : 0;
+
+        runBenchmark(names[i], size, gIterations, [&]() {
+            sgct_core::CorrectionMesh mesh;
+            return mesh.readMesh(files[i], &viewport, &window);
+        });
+        remove(files[i]);
+    }
+}
+
+/*
+    Font glyphs
+*/
+bool benchmarkFont()
+{
+#if INCLUDE_SGCT_TEXT
+    if (!isSelected("font"))
+        return true;
+
+    const char * configFilename = "sgct_bench_config.xml";
+    FILE * file = fopen(configFilename, "w");
+    if (file == NULL)
+        return false;
+    fprintf(file,
+        "<?xml version=\"1.0\" ?>\n"
+        "<Cluster masterAddress=\"localhost\">\n"
+        "\t<Node address=\"localhost\" port=\"%d\">\n"
+        "\t\t<Window fullScreen=\"false\" hidden=\"true\">\n"
+        "\t\t\t<Size x=\"64\" y=\"64\" />\n"
+        "\t\t\t<Viewport>\n"
+        "\t\t\t\t<Pos x=\"0.0\" y=\"0.0\" />\n"
+        "\t\t\t\t<Size x=\"1.0\" y=\"1.0\" />\n"
+        "\t\t\t\t<Projectionplane>\n"
+        "\t\t\t\t\t<Pos x=\"-1.0\" y=\"-1.0\" z=\"0.0\" />\n"
+        "\t\t\t\t\t<Pos x=\"-1.0\" y=\"1.0\" z=\"0.0\" />\n"
+        "\t\t\t\t\t<Pos x=\"1.0\" y=\"1.0\" z=\"0.0\" />\n"
+        "\t\t\t\t</Projectionplane>\n"
+        "\t\t\t</Viewport>\n"
+        "\t\t</Window>\n"
+        "\t</Node>\n"
+        "\t<User eyeSeparation=\"0.06\">\n"
+        "\t\t<Pos x=\"0.0\" y=\"0.0\" z=\"4.0\" />\n"
+        "\t</User>\n"
+        "</Cluster>\n", gFirstPort + static_cast<int>(gNumberOfNodes));
+    fclose(file);
+
+    std::vector<std::string> arguments;
+    arguments.push_back("-config");
+    arguments.push_back(configFilename);
+    sgct::Engine * engine = new sgct::Engine(arguments);
+
+    bool success = engine->init(sgct::Engine::OpenGL_3_3_Core_Profile);
+    remove(configFilename);
+    if (success)
+    {
+        sgct::MessageHandler::instance()->setNotifyLevel(sgct::MessageHandler::NOTIFY_IMPORTANT);
+
+        //every iteration uses a new height so that all glyphs are created again
+        const unsigned int firstHeight = 12;
+        const unsigned int numberOfChars = 95;
+        unsigned int height = firstHeight;
+        runBenchmark("font/glyphs/95chars", 0, std::min<std::size_t>(gIterations, 100), [&]() {
+            sgct_text::Font * font = sgct_text::FontManager::instance()->getDefaultFont(height++);
+            if (font == NULL)
+                return false;
+            for (unsigned int c = 0; c < numberOfChars; c++)
+                font->getFontFaceData(static_cast<wchar_t>(32 + c));
+            return font->getNumberOfLoadedChars() >= numberOfChars;
+        });
+    }
+    else
+        fprintf(stderr, "font: Failed to open a window, skipping the font benchmark.\n");
+
+    delete engine;
+    return success;
+#else
+    return true;
+#endif
+}
+
+bool writeJSON(const char * filename)
+{
+    FILE * file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Failed to write '%s'!\n", filename);
+        return false;
+    }
+
+    fprintf(file, "{\n\t\"sgct_version\": \"%s\",\n\t\"unit\": \"us\",\n\t\"benchmarks\": [", sgct::getSGCTVersion().c_str());
+    for (std::size_t i = 0; i < gResults.size(); i++)
+    {
+        const BenchmarkResult & r = gResults[i];
+        fprintf(file, "%s\n\t\t{ \"name\": \"%s\", \"iterations\": %u, \"min\": %.3f, \"median\": %.3f, \"p99\": %.3f, \"mean\": %.3f, \"bytes_per_iteration\": %.0f }",
+            i > 0 ? "," : "", r.mName.c_str(), static_cast<unsigned int>(r.mIterations), r.mMin, r.mMedian, r.mP99, r.mMean, r.mBytesPerIteration);
+    }
+    fprintf(file, "\n\t]\n}\n");
+
+    bool success = ferror(file) == 0;
+    fclose(file);
+    return success;
+}
+
+int main( int argc, char* argv[] )
+{
+    const char * outputFilename = NULL;
+    bool runFont = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-filter") == 0 && argc > (i + 1))
+            gFilter = argv[++i];
+        else if (strcmp(argv[i], "-iterations") == 0 && argc > (i + 1))
+            gIterations = static_cast<std::size_t>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "-nodes") == 0 && argc > (i + 1))
+            gNumberOfNodes = static_cast<unsigned int>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "-port") == 0 && argc > (i + 1))
+            gFirstPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-output") == 0 && argc > (i + 1))
+            outputFilename = argv[++i];
+        else if (strcmp(argv[i], "-nofont") == 0)
+            runFont = false;
+    }
+
+#if defined(__WIN32__)
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        return EXIT_FAILURE;
+#endif
+
+    //only errors, the parsers print every file they read
+    sgct::MessageHandler::instance()->setNotifyLevel(sgct::MessageHandler::NOTIFY_IMPORTANT);
+
+    fprintf(stdout, "%s\n", sgct::getSGCTVersion().c_str());
+    fprintf(stdout, "%-40s %12s %12s %12s %12s %10s\n", "benchmark (us)", "min", "median", "p99", "mean", "MB/s");
+
+    benchmarkSharedData();
+    benchmarkNetwork();
+    benchmarkImage();
+    benchmarkMesh();
+
+#if defined(__WIN32__)
+    WSACleanup();
+#endif
+
+    //the engine destroys the shared singletons so the font benchmark runs last
+    if (runFont)
+        benchmarkFont();
+
+    if (outputFilename != NULL && !writeJSON(outputFilename))
+        return EXIT_FAILURE;
+
+    exit( EXIT_SUCCESS );
+}
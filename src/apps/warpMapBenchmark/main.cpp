@@ -0,0 +1,104 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "sgct.h"
+
+/*
+    Compares the cost of warping viewports using their meshes with the cost of using baked warp maps.
+    Run with a configuration where the viewports use warping meshes and warpMap="rg16" (or "rg32f"), for example:
+
+    <Viewport warpMap="rg16" mesh="..." />
+
+    The benchmark alternates between the two methods and prints the average frame time of each method.
+    Vertical sync is disabled so that the frame time reflects the rendering cost.
+*/
+
+sgct::Engine * gEngine;
+
+void myDrawFun();
+void myPostDrawFun();
+
+//number of frames rendered with each method before switching
+const unsigned int FramesPerRun = 500;
+//frames skipped after switching before measuring
+const unsigned int WarmupFrames = 50;
+
+unsigned int frameInRun = 0;
+double accumulatedTime[2] = { 0.0, 0.0 };
+unsigned int measuredFrames[2] = { 0, 0 };
+bool useWarpMaps = true;
+
+int main( int argc, char* argv[] )
+{
+    gEngine = new sgct::Engine( argc, argv );
+
+    gEngine->setDrawFunction( myDrawFun );
+    gEngine->setPostDrawFunction( myPostDrawFun );
+
+    sgct::SGCTSettings::instance()->setSwapInterval(0);
+
+    if( !gEngine->init( sgct::Engine::OpenGL_3_3_Core_Profile ) )
+    {
+        delete gEngine;
+        return EXIT_FAILURE;
+    }
+
+    std::size_t numberOfWarpMaps = 0;
+    for (std::size_t i = 0; i < gEngine->getNumberOfWindows(); i++)
+    {
+        sgct::SGCTWindow * winPtr = gEngine->getWindowPtr(i);
+        for (std::size_t j = 0; j < winPtr->getNumberOfViewports(); j++)
+            if (winPtr->getViewport(j)->getCorrectionMeshPtr()->getWarpMapTexture() != GL_FALSE)
+                numberOfWarpMaps++;
+    }
+
+    if (numberOfWarpMaps == 0)
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING,
+            "No viewport has a warp map, both methods will draw the warping meshes.\n");
+    else
+        sgct::MessageHandler::instance()->print("%u viewport(s) with warp maps.\n", static_cast<unsigned int>(numberOfWarpMaps));
+
+    sgct::SGCTSettings::instance()->setUseWarpMaps(useWarpMaps);
+
+    gEngine->render();
+
+    for (int i = 0; i < 2; i++)
+        if (measuredFrames[i] > 0)
+            sgct::MessageHandler::instance()->print("%s: %.3f ms per frame (%u frames)\n",
+                i == 0 ? "Warping meshes" : "Warp maps",
+                1000.0 * accumulatedTime[i] / static_cast<double>(measuredFrames[i]), measuredFrames[i]);
+
+    delete gEngine;
+
+    exit( EXIT_SUCCESS );
+}
+
+void myDrawFun()
+{
+    //the scene is left empty so that the final warping pass dominates the frame time
+}
+
+void myPostDrawFun()
+{
+    int method = useWarpMaps ? 1 : 0;
+
+    //the time of the previous frame was spent using the current method
+    if (frameInRun > WarmupFrames)
+    {
+        accumulatedTime[method] += gEngine->getDt();
+        measuredFrames[method]++;
+    }
+
+    frameInRun++;
+    if (frameInRun == FramesPerRun)
+    {
+        if (measuredFrames[method] > 0)
+            sgct::MessageHandler::instance()->print("%s: %.3f ms per frame\n",
+                useWarpMaps ? "Warp maps" : "Warping meshes",
+                1000.0 * accumulatedTime[method] / static_cast<double>(measuredFrames[method]));
+
+        //the toggle only affects the local node, all nodes switch at the same frame
+        useWarpMaps = !useWarpMaps;
+        sgct::SGCTSettings::instance()->setUseWarpMaps(useWarpMaps);
+        frameInRun = 0;
+    }
+}
@@ -5,7 +5,6 @@ All rights reserved.
 For conditions of distribution and use, see copyright notice in sgct.h
 *************************************************************************/
 
-#define MAX_LINE_LENGTH 1024
 #define CONVERT_SCISS_TO_DOMEPROJECTION 0
 #define CONVERT_SIMCAD_TO_DOMEPROJECTION_AND_SGC 0
 
@@ -15,16 +14,25 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <iomanip>
 #include <sgct/ogl_headers.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/SGCTMemoryRegistry.h>
 #include <sgct/CorrectionMesh.h>
 #include <sgct/ClusterManager.h>
 #include <sgct/Engine.h>
 #include <sgct/Viewport.h>
 #include <sgct/SGCTSettings.h>
-#include <sgct/helpers/SGCTStringFunctions.h>
+#include <sgct/CorrectionMeshOptimizer.h>
+#include <sgct/WarpMapBaker.h>
+#include <sgct/SGCTTrace.h>
+#include <sgct/helpers/SGCTMappedFile.h>
+#include <sgct/helpers/SGCTTextTokenizer.h>
 #include <string>
 #include <cstring>
 #include <algorithm>
 #include <sstream>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <mutex>
+#include <thread>
 
 #if (_MSC_VER >= 1400) //visual studio 2005 or later
     #define _sscanf sscanf_s
@@ -58,6 +66,100 @@ struct SCISSViewData
 
 enum SCISSDistortionType { MESHTYPE_PLANAR, MESHTYPE_CUBE };
 
+//meshes can be parsed in parallel, parsers that update the user or the viewport frustums must hold this lock
+static std::mutex frustumUpdateMutex;
+
+//names of the buffer objects in the memory report, same order as MeshType
+static const char * meshNames[] = { "quad mesh", "warp mesh", "mask mesh", "warp map mesh" };
+
+//increase if the generated meshes change so that old caches are discarded
+#define MESH_CACHE_VERSION 2
+
+/*
+    Header of a binary warping mesh cache file. The header is followed by the path of the source mesh
+    (padded to four bytes), the vertices and the indices as they are uploaded to the GPU.
+*/
+struct MeshCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexSize;
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    uint64_t sourceHash;
+    float viewport[4];
+    uint32_t format;
+    uint32_t geometryType;
+    uint32_t numberOfVertices;
+    uint32_t numberOfIndices;
+    uint32_t pathLength;
+    float simplificationTolerance;
+    uint32_t vertexCacheOptimized;
+    int32_t resolution[2]; //only set if the mesh is simplified
+    uint32_t reserved;
+};
+
+//store the optimization settings that the cached mesh depends on
+static void setMeshCacheOptimization(MeshCacheHeader & header, const int * resolution)
+{
+    header.simplificationTolerance = sgct::SGCTSettings::instance()->getWarpingMeshSimplificationTolerance();
+    header.vertexCacheOptimized = sgct::SGCTSettings::instance()->getUseWarpingMeshVertexCacheOptimization() ? 1 : 0;
+    header.resolution[0] = header.simplificationTolerance > 0.0f ? resolution[0] : 0;
+    header.resolution[1] = header.simplificationTolerance > 0.0f ? resolution[1] : 0;
+}
+
+static const char meshCacheMagic[8] = { 'S', 'G', 'C', 'T', 'M', 'S', 'H', '\0' };
+
+//64-bit FNV-1a
+static uint64_t hashMeshData(const unsigned char * data, std::size_t size, uint64_t hash = 14695981039346656037ULL)
+{
+    for (std::size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool getMeshSourceInfo(const std::string & path, uint64_t & size, int64_t & modified)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return false;
+
+    size = static_cast<uint64_t>(st.st_size);
+    modified = static_cast<int64_t>(st.st_mtime);
+    return true;
+}
+
+/*
+    Read one vertex of an OBJ face (v, v/vt, v//vn or v/vt/vn) and return the vertex index.
+*/
+static bool readOBJFaceIndex(sgct_helpers::SGCTTextTokenizer & tokenizer, int & index)
+{
+    if (!tokenizer.readInt(index))
+        return false;
+
+    int tmp;
+    if (tokenizer.match("/"))
+    {
+        tokenizer.readInt(tmp);
+        if (tokenizer.match("/"))
+            tokenizer.readInt(tmp);
+    }
+    return true;
+}
+
+static bool hashMeshSource(const std::string & path, uint64_t & hash)
+{
+    sgct_helpers::SGCTMappedFile file;
+    if (!file.open(path.c_str()))
+        return false;
+
+    hash = hashMeshData(file.getData(), file.getSize());
+    return true;
+}
+
 sgct_core::CorrectionMeshGeometry::CorrectionMeshGeometry()
 {
     mMeshData[0] = GL_FALSE;
@@ -65,6 +167,7 @@ sgct_core::CorrectionMeshGeometry::CorrectionMeshGeometry()
     mMeshData[2] = GL_FALSE;
 
     mGeometryType = GL_TRIANGLE_STRIP;
+    mVertexFormat = FLOAT_VERTEX;
     mNumberOfVertices = 0;
     mNumberOfIndices = 0;
 }
@@ -97,17 +200,34 @@ sgct_core::CorrectionMesh::CorrectionMesh()
 {
     mTempVertices = NULL;
     mTempIndices = NULL;
+    mPendingWarpMap = NULL;
+    mMeshCacheFile = NULL;
+    mUpdateFisheyeProjection = false;
+    mWarpMapTexture = GL_FALSE;
+    mWarpMapResolution[0] = 0;
+    mWarpMapResolution[1] = 0;
 
     for (int i = 0; i < LAST_MESH; i++)
     {
         mGeometries[i].mNumberOfVertices = 0;
         mGeometries[i].mNumberOfIndices = 0;
+        mPendingVertices[i] = NULL;
+        mPendingIndices[i] = NULL;
     }
 }
 
 sgct_core::CorrectionMesh::~CorrectionMesh()
 {    
-    
+    cleanUp();
+    for (std::size_t i = 0; i < LAST_MESH; i++)
+        releasePendingMesh(i);
+    delete mPendingWarpMap;
+
+    if (mWarpMapTexture)
+        glDeleteTextures(1, &mWarpMapTexture);
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->removeAllocations(this);
 }
 
 /*!
@@ -121,13 +241,33 @@ This function finds a suitible parser for warping meshes and loads them into mem
 bool sgct_core::CorrectionMesh::readAndGenerateMesh(std::string meshPath, sgct_core::Viewport * parent,
 		                                            MeshHint hint)
 {    
+    bool loadStatus = readMesh(meshPath, parent, sgct::Engine::instance()->getCurrentWindowPtr(), hint);
+    generateMesh(parent);
+    return loadStatus;
+}
+
+/*!
+Parse a warping mesh without creating any OpenGL data so that several meshes can be read in parallel.
+The parsed meshes are uploaded to the GPU by generateMesh which must be called from the thread owning the OpenGL context.
+
+@param meshPath the path to the mesh data
+@param parent the pointer to parent viewport
+@param window the window containing the parent viewport
+@param hint a hint to pass to the parser selector
+@return true if mesh found and loaded successfully
+*/
+bool sgct_core::CorrectionMesh::readMesh(std::string meshPath, sgct_core::Viewport * parent, sgct::SGCTWindow * window,
+                                         MeshHint hint)
+{
+    SGCT_TRACE_SCOPE("CorrectionMesh::readMesh");
+
     //generate unwarped mask
     setupSimpleMesh(&mGeometries[QUAD_MESH], parent);
     createMesh(&mGeometries[QUAD_MESH]);
     cleanUp();
     
     //generate unwarped mesh for mask
-    if(parent->hasBlendMaskTexture() || parent->hasBlackLevelMaskTexture())
+    if(parent->hasMaskTextureFiles())
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Creating mask mesh\n");
         
@@ -195,44 +335,63 @@ bool sgct_core::CorrectionMesh::readAndGenerateMesh(std::string meshPath, sgct_c
             meshFmt = SIMCAD_FMT;
     }
 
-    //select parser
+    //use the binary cache if it is still valid for the source mesh. MPCDI meshes are already in memory,
+    //SCISS and SkySkan files also set up the viewport frustum and Paul Bourke meshes depend on the window
+    //aspect ratio and update the fisheye projection, so they are always parsed.
+    bool useCache = sgct::SGCTSettings::instance()->getUseWarpingMeshCache() &&
+        (meshFmt == DOMEPROJECTION_FMT || meshFmt == SCALEABLE_FMT || meshFmt == SIMCAD_FMT || meshFmt == OBJ_FMT);
     bool loadStatus = false;
-    switch (meshFmt)
+    bool cached = false;
+    int resolution[] = { window->getXFramebufferResolution(), window->getYFramebufferResolution() };
+    if (useCache && !sgct::SGCTSettings::instance()->getExportWarpingMeshes())
+        cached = loadStatus = readMeshCache(meshPath, parent, meshFmt, resolution);
+
+    //select parser
+    if (!cached)
     {
-    case DOMEPROJECTION_FMT:
-        loadStatus = readAndGenerateDomeProjectionMesh(meshPath, parent);
-        break;
+        switch (meshFmt)
+        {
+        case DOMEPROJECTION_FMT:
+            loadStatus = readAndGenerateDomeProjectionMesh(meshPath, parent);
+            break;
 
-    case SCALEABLE_FMT:
-        loadStatus = readAndGenerateScalableMesh(meshPath, parent);
-        break;
+        case SCALEABLE_FMT:
+            loadStatus = readAndGenerateScalableMesh(meshPath, parent);
+            break;
 
-    case SCISS_FMT:
-        loadStatus = readAndGenerateScissMesh(meshPath, parent);
-        break;
+        case SCISS_FMT:
+            loadStatus = readAndGenerateScissMesh(meshPath, parent);
+            break;
 
-    case SIMCAD_FMT:
-        loadStatus = readAndGenerateSimCADMesh(meshPath, parent);
-        break;
+        case SIMCAD_FMT:
+            loadStatus = readAndGenerateSimCADMesh(meshPath, parent);
+            break;
 
-    case SKYSKAN_FMT:
-        loadStatus = readAndGenerateSkySkanMesh(meshPath, parent);
-        break;
+        case SKYSKAN_FMT:
+            loadStatus = readAndGenerateSkySkanMesh(meshPath, parent);
+            break;
 
-    case PAULBOURKE_FMT:
-        loadStatus = readAndGeneratePaulBourkeMesh(meshPath, parent);
-        break;
+        case PAULBOURKE_FMT:
+            loadStatus = readAndGeneratePaulBourkeMesh(meshPath, parent, window->getAspectRatio());
+            break;
 
-    case OBJ_FMT:
-        loadStatus = readAndGenerateOBJMesh(meshPath, parent);
-        break;
+        case OBJ_FMT:
+            loadStatus = readAndGenerateOBJMesh(meshPath, parent);
+            break;
 
-    case MPCDI_FMT:
-        loadStatus = readAndGenerateMpcdiMesh("", parent);
-        break;
+        case MPCDI_FMT:
+            loadStatus = readAndGenerateMpcdiMesh("", parent);
+            break;
             
-    case NO_FMT:
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh error: Loading mesh '%s' failed!\n", meshPath.c_str());
+        case NO_FMT:
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh error: Loading mesh '%s' failed!\n", meshPath.c_str());
+        }
+
+        if (loadStatus)
+            optimizeMesh(resolution);
+
+        if (loadStatus && useCache)
+            writeMeshCache(meshPath, parent, meshFmt, resolution);
     }
 
     //export
@@ -245,6 +404,15 @@ bool sgct_core::CorrectionMesh::readAndGenerateMesh(std::string meshPath, sgct_c
             exportMesh(filename);
         }
     }
+
+    //bake a lookup map of the final mesh for viewports that use warp maps
+    if (loadStatus && parent->getWarpMapFormat() != NO_WARP_MAP)
+    {
+        int outputResolution[] = {
+            static_cast<int>(ceilf(window->getXScale() * static_cast<float>(window->getXResolution()))),
+            static_cast<int>(ceilf(window->getYScale() * static_cast<float>(window->getYResolution()))) };
+        bakeWarpMap(parent->getWarpMapFormat(), outputResolution);
+    }
     cleanUp();
 
     if( !loadStatus )
@@ -260,6 +428,39 @@ bool sgct_core::CorrectionMesh::readAndGenerateMesh(std::string meshPath, sgct_c
     return true;
 }
 
+/*!
+Upload the meshes parsed by readMesh to the GPU and release the parsed data.
+*/
+void sgct_core::CorrectionMesh::generateMesh(sgct_core::Viewport * parent)
+{
+    SGCT_TRACE_SCOPE("CorrectionMesh::generateMesh");
+
+    for (std::size_t i = 0; i < LAST_MESH; i++)
+        if (mPendingVertices[i] != NULL && mPendingIndices[i] != NULL)
+        {
+            uploadMesh(&mGeometries[i], mPendingVertices[i], mPendingIndices[i]);
+            releasePendingMesh(i);
+        }
+
+    if (mPendingWarpMap != NULL)
+    {
+        uploadWarpMap();
+        delete mPendingWarpMap;
+        mPendingWarpMap = NULL;
+    }
+
+    //force regeneration of dome render quad
+    if (mUpdateFisheyeProjection)
+    {
+        if (FisheyeProjection* fishPrj = dynamic_cast<FisheyeProjection*>(parent->getNonLinearProjectionPtr()))
+        {
+            fishPrj->setIgnoreAspectRatio(true);
+            fishPrj->update(1.0f, 1.0f);
+        }
+        mUpdateFisheyeProjection = false;
+    }
+}
+
 /*!
 Parse data from domeprojection's camera based calibration system. Domeprojection.com
 */
@@ -268,23 +469,14 @@ bool sgct_core::CorrectionMesh::readAndGenerateDomeProjectionMesh(const std::str
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
         "CorrectionMesh: Reading DomeProjection mesh data from '%s'.\n", meshPath.c_str());
 
-    FILE * meshFile = NULL;
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&meshFile, meshPath.c_str(), "r") != 0 || !meshFile)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
-        return false;
-    }
-#else
-    meshFile = fopen(meshPath.c_str(), "r");
-    if (meshFile == NULL)
+    sgct_helpers::SGCTMappedFile meshFile;
+    if (!meshFile.open(meshPath.c_str()))
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
         return false;
     }
-#endif
+    sgct_helpers::SGCTTextTokenizer tokenizer(reinterpret_cast<const char *>(meshFile.getData()), meshFile.getSize());
 
-    char lineBuffer[MAX_LINE_LENGTH];
     float x, y, u, v;
     unsigned int col, row;
     unsigned int numberOfCols = 0;
@@ -299,52 +491,52 @@ bool sgct_core::CorrectionMesh::readAndGenerateDomeProjectionMesh(const std::str
     vertex.b = 1.0f;
     vertex.a = 1.0f;
 
-    while (!feof(meshFile))
+    //each line is x;y;u;v;column;row
+    while (tokenizer.nextLine())
     {
-        if (fgets(lineBuffer, MAX_LINE_LENGTH, meshFile) != NULL)
+        if (tokenizer.readFloat(x) && tokenizer.expect(';') &&
+            tokenizer.readFloat(y) && tokenizer.expect(';') &&
+            tokenizer.readFloat(u) && tokenizer.expect(';') &&
+            tokenizer.readFloat(v) && tokenizer.expect(';') &&
+            tokenizer.readUInt(col) && tokenizer.expect(';') &&
+            tokenizer.readUInt(row))
         {
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            if (sscanf_s(lineBuffer, "%f;%f;%f;%f;%u;%u", &x, &y, &u, &v, &col, &row) == 6)
-#else
-            if (sscanf(lineBuffer, "%f;%f;%f;%f;%u;%u", &x, &y, &u, &v, &col, &row) == 6)
-#endif
-            {
-                //find dimensions of meshdata
-                if (col > numberOfCols)
-                    numberOfCols = col;
+            //find dimensions of meshdata
+            if (col > numberOfCols)
+                numberOfCols = col;
 
-                if (row > numberOfRows)
-                    numberOfRows = row;
+            if (row > numberOfRows)
+                numberOfRows = row;
 
-                //clamp
-                clamp(x, 1.0f, 0.0f);
-                clamp(y, 1.0f, 0.0f);
-                //clamp(u, 1.0f, 0.0f);
-                //clamp(v, 1.0f, 0.0f);
+            //clamp
+            clamp(x, 1.0f, 0.0f);
+            clamp(y, 1.0f, 0.0f);
+            //clamp(u, 1.0f, 0.0f);
+            //clamp(v, 1.0f, 0.0f);
 
-                //convert to [-1, 1]
-                vertex.x = 2.0f * (x * parent->getXSize() + parent->getX()) - 1.0f;
-                vertex.y = 2.0f * ((1.0f-y) * parent->getYSize() + parent->getY()) - 1.0f;
+            //convert to [-1, 1]
+            vertex.x = 2.0f * (x * parent->getXSize() + parent->getX()) - 1.0f;
+            vertex.y = 2.0f * ((1.0f-y) * parent->getYSize() + parent->getY()) - 1.0f;
 
-                //scale to viewport coordinates
-                vertex.s = u * parent->getXSize() + parent->getX();
-                vertex.t = (1.0f-v) * parent->getYSize() + parent->getY();
+            //scale to viewport coordinates
+            vertex.s = u * parent->getXSize() + parent->getX();
+            vertex.t = (1.0f-v) * parent->getYSize() + parent->getY();
 
-                vertices.push_back(vertex);
-            }
-            
+            vertices.push_back(vertex);
         }
-
     }
 
-    fclose(meshFile);
-
     //add one to actually store the dimensions instread of largest index
     numberOfCols++;
     numberOfRows++;
 
     //copy vertices
     unsigned int numberOfVertices = numberOfCols * numberOfRows;
+    if (vertices.size() < numberOfVertices)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Incorrect mesh data geometry!\n");
+        return false;
+    }
     mTempVertices = new CorrectionMeshVertex[numberOfVertices];
     memcpy(mTempVertices, vertices.data(), numberOfVertices * sizeof(CorrectionMeshVertex));
     mGeometries[WARP_MESH].mNumberOfVertices = numberOfVertices;
@@ -406,21 +598,13 @@ bool sgct_core::CorrectionMesh::readAndGenerateScalableMesh(const std::string &
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
         "CorrectionMesh: Reading scalable mesh data from '%s'.\n", meshPath.c_str());
 
-    FILE * meshFile = NULL;
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if( fopen_s(&meshFile, meshPath.c_str(), "r") != 0 || !meshFile )
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
-        return false;
-    }
-#else
-    meshFile = fopen(meshPath.c_str(), "r");
-    if( meshFile == NULL )
+    sgct_helpers::SGCTMappedFile meshFile;
+    if (!meshFile.open(meshPath.c_str()))
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
         return false;
     }
-#endif
+    sgct_helpers::SGCTTextTokenizer tokenizer(reinterpret_cast<const char *>(meshFile.getData()), meshFile.getSize());
 
     float x,y,s,t;
     unsigned int intensity;
@@ -442,39 +626,15 @@ bool sgct_core::CorrectionMesh::readAndGenerateScalableMesh(const std::string &
 
     CorrectionMeshVertex * vertexPtr;
 
-    char lineBuffer[MAX_LINE_LENGTH];
-    while( !feof( meshFile ) )
+    char keyword[16];
+    while (tokenizer.nextLine())
     {
-        if( fgets(lineBuffer, MAX_LINE_LENGTH, meshFile ) != NULL )
+        char first = tokenizer.peek();
+        if (first == '[') //face: [ a b c ]
         {
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            if( sscanf_s(lineBuffer, "%f %f %u %f %f", &x, &y, &intensity, &s, &t) == 5 )
-#else
-            if( sscanf(lineBuffer, "%f %f %u %f %f", &x, &y, &intensity, &s, &t) == 5 )
-#endif
-            {
-                if( mTempVertices != NULL && resolution[0] != 0 && resolution[1] != 0 )
-                {
-                    vertexPtr = &mTempVertices[numOfVerticesRead];
-                    vertexPtr->x = (x / static_cast<float>(resolution[0])) * parent->getXSize() + parent->getX();
-                    vertexPtr->y = (y / static_cast<float>(resolution[1])) * parent->getYSize() + parent->getY();
-                    vertexPtr->r = static_cast<float>(intensity)/255.0f;
-                    vertexPtr->g = static_cast<float>(intensity)/255.0f;
-                    vertexPtr->b = static_cast<float>(intensity)/255.0f;
-                    vertexPtr->a = 1.0f;
-                    vertexPtr->s = (1.0f - t) * parent->getXSize() + parent->getX();
-                    vertexPtr->t = (1.0f - s) * parent->getYSize() + parent->getY();
-
-                    numOfVerticesRead++;
-                }
-            }
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if( sscanf_s(lineBuffer, "[ %u %u %u ]", &a, &b, &c) == 3 )
-#else
-            else if( sscanf(lineBuffer, "[ %u %u %u ]", &a, &b, &c) == 3 )
-#endif
+            if (tokenizer.expect('[') && tokenizer.readUInt(a) && tokenizer.readUInt(b) && tokenizer.readUInt(c) && tokenizer.expect(']'))
             {
-                if (mTempIndices != NULL)
+                if (mTempIndices != NULL && numOfFacesRead < numberOfFaces)
                 {
                     mTempIndices[numOfFacesRead * 3] = a;
                     mTempIndices[numOfFacesRead * 3 + 1] = b;
@@ -483,68 +643,64 @@ bool sgct_core::CorrectionMesh::readAndGenerateScalableMesh(const std::string &
 
                 numOfFacesRead++;
             }
-            else
+        }
+        else if ((first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.') //vertex: x y intensity s t
+        {
+            if (tokenizer.readFloat(x) && tokenizer.readFloat(y) && tokenizer.readUInt(intensity) && tokenizer.readFloat(s) && tokenizer.readFloat(t))
             {
-                char tmpString[16];
-                tmpString[0] = '\0';
-                double tmpD = 0.0;
-                unsigned int tmpUI = 0;
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-                if( sscanf_s(lineBuffer, "VERTICES %u", &numberOfVertices) == 1 )
-#else
-                if( sscanf(lineBuffer, "VERTICES %u", &numberOfVertices) == 1 )
-#endif
-                {
-                    mTempVertices = new CorrectionMeshVertex[ numberOfVertices ];
-                    memset(mTempVertices, 0, numberOfVertices * sizeof(CorrectionMeshVertex));
-                }
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-                else if( sscanf_s(lineBuffer, "FACES %u", &numberOfFaces) == 1 )
-#else
-                else if (sscanf(lineBuffer, "FACES %u", &numberOfFaces) == 1)
-#endif
+                if( mTempVertices != NULL && resolution[0] != 0 && resolution[1] != 0 )
                 {
-                    numberOfIndices = numberOfFaces * 3;
-                    mTempIndices = new unsigned int[numberOfIndices];
-                    memset(mTempIndices, 0, numberOfIndices * sizeof(unsigned int));
-                }
+                    if (numOfVerticesRead < numberOfVertices)
+                    {
+                        vertexPtr = &mTempVertices[numOfVerticesRead];
+                        vertexPtr->x = (x / static_cast<float>(resolution[0])) * parent->getXSize() + parent->getX();
+                        vertexPtr->y = (y / static_cast<float>(resolution[1])) * parent->getYSize() + parent->getY();
+                        vertexPtr->r = static_cast<float>(intensity)/255.0f;
+                        vertexPtr->g = static_cast<float>(intensity)/255.0f;
+                        vertexPtr->b = static_cast<float>(intensity)/255.0f;
+                        vertexPtr->a = 1.0f;
+                        vertexPtr->s = (1.0f - t) * parent->getXSize() + parent->getX();
+                        vertexPtr->t = (1.0f - s) * parent->getYSize() + parent->getY();
+                    }
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-                else if( sscanf_s(lineBuffer, "ORTHO_%s %lf", tmpString, 16, &tmpD) == 2 )
-#else
-                else if( sscanf(lineBuffer, "ORTHO_%s %lf", tmpString, &tmpD) == 2 )
-#endif
-                {
-                    if( strcmp(tmpString, "LEFT") == 0 )
-                        orthoCoords[0] = tmpD;
-                    else if( strcmp(tmpString, "RIGHT") == 0 )
-                        orthoCoords[1] = tmpD;
-                    else if( strcmp(tmpString, "BOTTOM") == 0 )
-                        orthoCoords[2] = tmpD;
-                    else if( strcmp(tmpString, "TOP") == 0 )
-                        orthoCoords[3] = tmpD;
+                    numOfVerticesRead++;
                 }
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-                else if( sscanf_s(lineBuffer, "NATIVEXRES %u", &tmpUI) == 1 )
-#else
-                else if( sscanf(lineBuffer, "NATIVEXRES %u", &tmpUI) == 1 )
-#endif
-                    resolution[0] = tmpUI;
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-                else if( sscanf_s(lineBuffer, "NATIVEYRES %u", &tmpUI) == 1 )
-#else
-                else if( sscanf(lineBuffer, "NATIVEYRES %u", &tmpUI) == 1 )
-#endif
-                    resolution[1] = tmpUI;
             }
-
-            //fprintf(stderr, "Row text: %s", lineBuffer);
         }
+        else if (tokenizer.readWord(keyword, sizeof(keyword)))
+        {
+            double tmpD = 0.0;
+            unsigned int tmpUI = 0;
 
+            if (strcmp(keyword, "VERTICES") == 0 && tokenizer.readUInt(numberOfVertices))
+            {
+                delete[] mTempVertices;
+                mTempVertices = new CorrectionMeshVertex[ numberOfVertices ];
+                memset(mTempVertices, 0, numberOfVertices * sizeof(CorrectionMeshVertex));
+            }
+            else if (strcmp(keyword, "FACES") == 0 && tokenizer.readUInt(numberOfFaces))
+            {
+                numberOfIndices = numberOfFaces * 3;
+                delete[] mTempIndices;
+                mTempIndices = new unsigned int[numberOfIndices];
+                memset(mTempIndices, 0, numberOfIndices * sizeof(unsigned int));
+            }
+            else if (strncmp(keyword, "ORTHO_", 6) == 0 && tokenizer.readDouble(tmpD))
+            {
+                if( strcmp(keyword + 6, "LEFT") == 0 )
+                    orthoCoords[0] = tmpD;
+                else if( strcmp(keyword + 6, "RIGHT") == 0 )
+                    orthoCoords[1] = tmpD;
+                else if( strcmp(keyword + 6, "BOTTOM") == 0 )
+                    orthoCoords[2] = tmpD;
+                else if( strcmp(keyword + 6, "TOP") == 0 )
+                    orthoCoords[3] = tmpD;
+            }
+            else if (strcmp(keyword, "NATIVEXRES") == 0 && tokenizer.readUInt(tmpUI))
+                resolution[0] = tmpUI;
+            else if (strcmp(keyword, "NATIVEYRES") == 0 && tokenizer.readUInt(tmpUI))
+                resolution[1] = tmpUI;
+        }
     }
 
     if (numberOfVertices != numOfVerticesRead || numberOfFaces != numOfFacesRead)
@@ -570,8 +726,6 @@ bool sgct_core::CorrectionMesh::readAndGenerateScalableMesh(const std::string &
         mTempVertices[i].y = yVal * 2.0f - 1.0f;
     }
 
-    fclose( meshFile );
-
     mGeometries[WARP_MESH].mNumberOfVertices = numberOfVertices;
     mGeometries[WARP_MESH].mNumberOfIndices = numberOfIndices;
     mGeometries[WARP_MESH].mGeometryType = GL_TRIANGLES;
@@ -775,6 +929,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateScissMesh(const std::string & mes
 
     fclose(meshFile);
 
+    frustumUpdateMutex.lock();
     parent->getUser()->setPos(
         viewData.x, viewData.y, viewData.z);
 
@@ -787,6 +942,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateScissMesh(const std::string & mes
         );
 
     sgct::Engine::instance()->updateFrustums();
+    frustumUpdateMutex.unlock();
 
     CorrectionMeshVertex * vertexPtr;
     SCISSTexturedVertex * scissVertexPtr;
@@ -897,6 +1053,43 @@ bool sgct_core::CorrectionMesh::readAndGenerateScissMesh(const std::string & mes
     return true;
 }
 
+/*
+    Parse the white space separated values of a SimCAD parameter element in place and append them divided by range.
+    The values are counted first so that the vector is only allocated once.
+    \returns false if the text contains something that isn't a number
+*/
+static bool readSimCADCorrections(const char * text, float range, std::vector<float> & corrections)
+{
+    if (text == NULL)
+        return true;
+
+    std::size_t size = 0;
+    std::size_t count = 0;
+    bool inValue = false;
+    for (const char * p = text; *p != '\0'; p++, size++)
+    {
+        bool whitespace = (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r');
+        if (!whitespace && !inValue)
+            count++;
+        inValue = !whitespace;
+    }
+    corrections.reserve(corrections.size() + count);
+
+    sgct_helpers::SGCTTextTokenizer tokenizer(text, size);
+    float value;
+    while (tokenizer.nextLine())
+    {
+        while (!tokenizer.atLineEnd())
+        {
+            if (!tokenizer.readFloat(value))
+                return false;
+            corrections.push_back(value / range);
+        }
+    }
+
+    return true;
+}
+
 bool sgct_core::CorrectionMesh::readAndGenerateSimCADMesh(const std::string & meshPath, sgct_core::Viewport * parent)
 {
     /*During projector alignment, a 33x33 matrix is used.
@@ -951,26 +1144,20 @@ bool sgct_core::CorrectionMesh::readAndGenerateSimCADMesh(const std::string & me
                     
                     if (strcmp("X-FlatParameters", val[1]) == 0)
                     { 
-                        if (element[1]->QueryFloatAttribute("range", &xrange) == tinyxml2::XML_NO_ERROR)
+                        if (element[1]->QueryFloatAttribute("range", &xrange) == tinyxml2::XML_NO_ERROR &&
+                            !readSimCADCorrections(element[1]->GetText(), xrange, xcorrections))
                         {
-                            std::string xcoordstr(element[1]->GetText());
-                            std::vector<std::string> xcoords = sgct_helpers::split(xcoordstr, ' ');
-                            for (auto &x : xcoords)
-                            {
-                                xcorrections.push_back(std::stof(x)/xrange);
-                            } 
+                            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Invalid X-FlatParameters in SimCAD file!\n");
+                            return false;
                         }
                     }
                     else if (strcmp("Y-FlatParameters", val[1]) == 0)
                     {
-                        if (element[1]->QueryFloatAttribute("range", &yrange) == tinyxml2::XML_NO_ERROR)
+                        if (element[1]->QueryFloatAttribute("range", &yrange) == tinyxml2::XML_NO_ERROR &&
+                            !readSimCADCorrections(element[1]->GetText(), yrange, ycorrections))
                         {
-                            std::string ycoordstr(element[1]->GetText());
-                            std::vector<std::string> ycoords = sgct_helpers::split(ycoordstr, ' ');
-                            for (auto &y : ycoords)
-                            {
-                                ycorrections.push_back(std::stof(y)/yrange);
-                            }
+                            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Invalid Y-FlatParameters in SimCAD file!\n");
+                            return false;
                         }
                     }
 
@@ -1023,7 +1210,9 @@ bool sgct_core::CorrectionMesh::readAndGenerateSimCADMesh(const std::string & me
     viewData.qy = rotation.y;
     viewData.qz = rotation.z;
 
+    frustumUpdateMutex.lock();
     glm::vec3 position = parent->getUser()->getPos();
+    frustumUpdateMutex.unlock();
     viewData.x = position.x;
     viewData.y = position.y;
     viewData.z = position.z;
@@ -1116,18 +1305,19 @@ bool sgct_core::CorrectionMesh::readAndGenerateSimCADMesh(const std::string & me
     outMeshFile << std::setprecision(6);
 #endif
 
-    CorrectionMeshVertex vertex;
-    std::vector<CorrectionMeshVertex> vertices;
     SCISSTexturedVertex scissVertex;
 
-    //init to max intensity (opaque white)
-    vertex.r = 1.0f;
-    vertex.g = 1.0f;
-    vertex.b = 1.0f;
-    vertex.a = 1.0f;
+    //the vertices are written directly to the mesh data
+    unsigned int numberOfVertices = numberOfCols * numberOfRows;
+    mTempVertices = new CorrectionMeshVertex[numberOfVertices];
+    mGeometries[WARP_MESH].mNumberOfVertices = numberOfVertices;
 
     float x, y, u, v;
     size_t i = 0;
+    float viewportX = parent->getX();
+    float viewportY = parent->getY();
+    float viewportXSize = parent->getXSize();
+    float viewportYSize = parent->getYSize();
 
     for (unsigned int r = 0; r < numberOfRows; r++)
     {
@@ -1140,15 +1330,21 @@ bool sgct_core::CorrectionMesh::readAndGenerateSimCADMesh(const std::string & me
             x = u + xcorrections[i];
             y = v - ycorrections[i];
 
+            CorrectionMeshVertex & vertex = mTempVertices[i];
+
             //convert to [-1, 1]
-            vertex.x = 2.0f * (x * parent->getXSize() + parent->getX()) - 1.0f;
-            vertex.y = 2.0f * (y * parent->getYSize() + parent->getY()) - 1.0f;
+            vertex.x = 2.0f * (x * viewportXSize + viewportX) - 1.0f;
+            vertex.y = 2.0f * (y * viewportYSize + viewportY) - 1.0f;
 
             //scale to viewport coordinates
-            vertex.s = u * parent->getXSize() + parent->getX();
-            vertex.t = v * parent->getYSize() + parent->getY();
+            vertex.s = u * viewportXSize + viewportX;
+            vertex.t = v * viewportYSize + viewportY;
 
-            vertices.push_back(vertex);
+            //max intensity (opaque white)
+            vertex.r = 1.0f;
+            vertex.g = 1.0f;
+            vertex.b = 1.0f;
+            vertex.a = 1.0f;
 
             i++;
 
@@ -1172,15 +1368,9 @@ bool sgct_core::CorrectionMesh::readAndGenerateSimCADMesh(const std::string & me
 
     }
 
-    //copy vertices
-    unsigned int numberOfVertices = numberOfCols * numberOfRows;
-    mTempVertices = new CorrectionMeshVertex[numberOfVertices];
-    memcpy(mTempVertices, vertices.data(), numberOfVertices * sizeof(CorrectionMeshVertex));
-    mGeometries[WARP_MESH].mNumberOfVertices = numberOfVertices;
-    vertices.clear();
-
     // Make a triangle strip index list
     std::vector<unsigned int> indices_trilist;
+    indices_trilist.reserve(numberOfRows * numberOfCols * 2);
     for (unsigned int r = 0; r<numberOfRows - 1; r++) {
         if ((r & 1) == 0) { // even rows
             for (unsigned int c = 0; c < numberOfCols; c++) {
@@ -1262,21 +1452,13 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
         "CorrectionMesh: Reading SkySkan mesh data from '%s'.\n", meshPath.c_str());
 
-    FILE * meshFile = NULL;
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&meshFile, meshPath.c_str(), "r") != 0 || !meshFile)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
-        return false;
-    }
-#else
-    meshFile = fopen(meshPath.c_str(), "r");
-    if (meshFile == NULL)
+    sgct_helpers::SGCTMappedFile meshFile;
+    if (!meshFile.open(meshPath.c_str()))
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
         return false;
     }
-#endif
+    sgct_helpers::SGCTTextTokenizer tokenizer(reinterpret_cast<const char *>(meshFile.getData()), meshFile.getSize());
 
     float azimuth = 0.0f;
     float elevation = 0.0f;
@@ -1294,130 +1476,61 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
     unsigned int size[2];
     unsigned int counter = 0;
 
-    char lineBuffer[MAX_LINE_LENGTH];
-    while (!feof(meshFile))
-    {
-        if (fgets(lineBuffer, MAX_LINE_LENGTH, meshFile) != NULL)
+    while (tokenizer.nextLine())
+    {
+        if (tokenizer.match("Dome Azimuth="))
+            azimuthSet = tokenizer.readFloat(azimuth);
+        else if (tokenizer.match("Dome Elevation="))
+            elevationSet = tokenizer.readFloat(elevation);
+        else if (tokenizer.match("Horizontal FOV="))
+            hFovSet = tokenizer.readFloat(horizontal_fov);
+        else if (tokenizer.match("Vertical FOV="))
+            vFovSet = tokenizer.readFloat(vertical_fov);
+        else if (tokenizer.match("Horizontal Tweek="))
+            tokenizer.readFloat(fovTweeks[0]);
+        else if (tokenizer.match("Vertical Tweek="))
+            tokenizer.readFloat(fovTweeks[1]);
+        else if (tokenizer.match("U Tweek="))
+            tokenizer.readFloat(UVTweeks[0]);
+        else if (tokenizer.match("V Tweek="))
+            tokenizer.readFloat(UVTweeks[1]);
+        else if (!dimensionsSet)
         {
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            if (sscanf_s(lineBuffer, "Dome Azimuth=%f", &azimuth) == 1)
-#else
-            if (sscanf(lineBuffer, "Dome Azimuth=%f", &azimuth) == 1)
-#endif
-            {
-                azimuthSet = true;
-            }
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (sscanf_s(lineBuffer, "Dome Elevation=%f", &elevation) == 1)
-#else
-            else if (sscanf(lineBuffer, "Dome Elevation=%f", &elevation) == 1)
-#endif
+            if (tokenizer.readUInt(size[0]) && tokenizer.readUInt(size[1]))
             {
-                elevationSet = true;
+                dimensionsSet = true;
+                mTempVertices = new CorrectionMeshVertex[size[0] * size[1]];
+                mGeometries[WARP_MESH].mNumberOfVertices = size[0] * size[1];
             }
+        }
+        else if (tokenizer.readFloat(x) && tokenizer.readFloat(y) && tokenizer.readFloat(u) && tokenizer.readFloat(v))
+        {
+            if (counter >= mGeometries[WARP_MESH].mNumberOfVertices)
+                continue;
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (sscanf_s(lineBuffer, "Horizontal FOV=%f", &horizontal_fov) == 1)
-#else
-            else if (sscanf(lineBuffer, "Horizontal FOV=%f", &horizontal_fov) == 1)
-#endif
-            {
-                hFovSet = true;
-            }
+            if (UVTweeks[0] > -1.0f)
+                u *= UVTweeks[0];
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (sscanf_s(lineBuffer, "Vertical FOV=%f", &vertical_fov) == 1)
-#else
-            else if (sscanf(lineBuffer, "Vertical FOV=%f", &vertical_fov) == 1)
-#endif
-            {
-                vFovSet = true;
-            }
+            if (UVTweeks[1] > -1.0f)
+                v *= UVTweeks[1];
+            
+            mTempVertices[counter].x = x;
+            mTempVertices[counter].y = y;
+            mTempVertices[counter].s = u;
+            //mTempVertices[counter].t = v;
+            //mTempVertices[counter].s = 1.0f - u;
+            mTempVertices[counter].t = 1.0f - v;
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (sscanf_s(lineBuffer, "Horizontal Tweek=%f", &fovTweeks[0]) == 1)
-#else
-            else if (sscanf(lineBuffer, "Horizontal Tweek=%f", &fovTweeks[0]) == 1)
-#endif
-            {
-                ;
-            }
+            mTempVertices[counter].r = 1.0f;
+            mTempVertices[counter].g = 1.0f;
+            mTempVertices[counter].b = 1.0f;
+            mTempVertices[counter].a = 1.0f;
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (sscanf_s(lineBuffer, "Vertical Tweek=%f", &fovTweeks[1]) == 1)
-#else
-            else if (sscanf(lineBuffer, "Vertical Tweek=%f", &fovTweeks[1]) == 1)
-#endif
-            {
-                ;
-            }
+            //fprintf(stderr, "Adding vertex: %u %.3f %.3f %.3f %.3f\n", counter, x, y, u, v);
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (sscanf_s(lineBuffer, "U Tweek=%f", &UVTweeks[0]) == 1)
-#else
-            else if (sscanf(lineBuffer, "U Tweek=%f", &UVTweeks[0]) == 1)
-#endif
-            {
-                ;
-            }
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (sscanf_s(lineBuffer, "V Tweek=%f", &UVTweeks[1]) == 1)
-#else
-            else if (sscanf(lineBuffer, "V Tweek=%f", &UVTweeks[1]) == 1)
-#endif
-            {
-                ;
-            }
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (!dimensionsSet && sscanf_s(lineBuffer, "%u %u", &size[0], &size[1]) == 2)
-#else
-            else if (!dimensionsSet && sscanf(lineBuffer, "%u %u", &size[0], &size[1]) == 2)
-#endif
-            {
-                dimensionsSet = true;
-                mTempVertices = new CorrectionMeshVertex[size[0] * size[1]];
-                mGeometries[WARP_MESH].mNumberOfVertices = size[0] * size[1];
-            }
-
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            else if (dimensionsSet && sscanf_s(lineBuffer, "%f %f %f %f", &x, &y, &u, &v) == 4)
-#else
-            else if (dimensionsSet && sscanf(lineBuffer, "%f %f %f %f", &x, &y, &u, &v) == 4)
-#endif
-            {
-                if (UVTweeks[0] > -1.0f)
-                    u *= UVTweeks[0];
-
-                if (UVTweeks[1] > -1.0f)
-                    v *= UVTweeks[1];
-                
-                mTempVertices[counter].x = x;
-                mTempVertices[counter].y = y;
-                mTempVertices[counter].s = u;
-                //mTempVertices[counter].t = v;
-                //mTempVertices[counter].s = 1.0f - u;
-                mTempVertices[counter].t = 1.0f - v;
-
-                mTempVertices[counter].r = 1.0f;
-                mTempVertices[counter].g = 1.0f;
-                mTempVertices[counter].b = 1.0f;
-                mTempVertices[counter].a = 1.0f;
-
-                //fprintf(stderr, "Adding vertex: %u %.3f %.3f %.3f %.3f\n", counter, x, y, u, v);
-
-                counter++;
-            }
-
-            //fprintf(stderr, "Row text: %s", lineBuffer);
-        }
-
-    }
-
-    fclose(meshFile);
+            counter++;
+        }
+    }
 
     if (!dimensionsSet ||
         !azimuthSet ||
@@ -1458,6 +1571,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
     rotQuat = glm::rotate(rotQuat, glm::radians(-azimuth), glm::vec3(0.0f, 1.0f, 0.0f));
     rotQuat = glm::rotate(rotQuat, glm::radians(elevation), glm::vec3(1.0f, 0.0f, 0.0f));
 
+    frustumUpdateMutex.lock();
     parent->getUser()->setPos(0.0f, 0.0f, 0.0f);
     parent->setViewPlaneCoordsUsingFOVs(
         vertical_fov / 2.0f,
@@ -1466,8 +1580,11 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
         horizontal_fov / 2.0f,
         rotQuat
         );
-    
-    sgct::Engine::instance()->updateFrustums();
+
+    //there is no engine when meshes are parsed by headless tools
+    if (sgct::Engine::instance() != NULL)
+        sgct::Engine::instance()->updateFrustums();
+    frustumUpdateMutex.unlock();
 
     std::vector<unsigned int> indices;
     unsigned int i0, i1, i2, i3;
@@ -1565,50 +1682,43 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
     return true;
 }
 
-bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent)
+bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent, float windowAspectRatio)
 {
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
         "CorrectionMesh: Reading Paul Bourke spherical mirror mesh data from '%s'.\n", meshPath.c_str());
 
-    FILE * meshFile = NULL;
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&meshFile, meshPath.c_str(), "r") != 0 || !meshFile)
+    sgct_helpers::SGCTMappedFile meshFile;
+    if (!meshFile.open(meshPath.c_str()))
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
         return false;
     }
-#else
-    meshFile = fopen(meshPath.c_str(), "r");
-    if (meshFile == NULL)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
-        return false;
-    }
-#endif
+    sgct_helpers::SGCTTextTokenizer tokenizer(reinterpret_cast<const char *>(meshFile.getData()), meshFile.getSize());
 
     //variables
     int mappingType = -1;
     int size[2] = {-1, -1};
     unsigned int counter = 0;
     float x, y, s, t, intensity;
-    char lineBuffer[MAX_LINE_LENGTH];
 
     //get the fist line containing the mapping type id
-    if (fgets(lineBuffer, MAX_LINE_LENGTH, meshFile) != NULL)
+    if (tokenizer.nextLine())
     {
         int tmpi;
-        if(_sscanf(lineBuffer, "%d", &tmpi) == 1)
+        if (tokenizer.readInt(tmpi))
             mappingType = tmpi;
     }
 
     //get the mesh dimensions
-    if (fgets(lineBuffer, MAX_LINE_LENGTH, meshFile) != NULL)
+    if (tokenizer.nextLine())
     {
-        if (_sscanf(lineBuffer, "%d %d", &size[0], &size[1]) == 2)
+        if (tokenizer.readInt(size[0]) && tokenizer.readInt(size[1]) && size[0] > 0 && size[1] > 0)
         {
             mTempVertices = new CorrectionMeshVertex[size[0] * size[1]];
             mGeometries[WARP_MESH].mNumberOfVertices = static_cast<unsigned int>(size[0] * size[1]);
         }
+        else
+            size[0] = size[1] = -1;
     }
 
     //check if everyting useful is set
@@ -1619,27 +1729,24 @@ bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string
     }
 
     //get all data
-    while (!feof(meshFile))
+    while (tokenizer.nextLine() && counter < mGeometries[WARP_MESH].mNumberOfVertices)
     {
-        if (fgets(lineBuffer, MAX_LINE_LENGTH, meshFile) != NULL)
+        if (tokenizer.readFloat(x) && tokenizer.readFloat(y) && tokenizer.readFloat(s) && tokenizer.readFloat(t) && tokenizer.readFloat(intensity))
         {
-            if (_sscanf(lineBuffer, "%f %f %f %f %f", &x, &y, &s, &t, &intensity) == 5)
-            {
-                mTempVertices[counter].x = x;
-                mTempVertices[counter].y = y;
-                mTempVertices[counter].s = s;
-                mTempVertices[counter].t = t;
+            mTempVertices[counter].x = x;
+            mTempVertices[counter].y = y;
+            mTempVertices[counter].s = s;
+            mTempVertices[counter].t = t;
 
-                mTempVertices[counter].r = intensity;
-                mTempVertices[counter].g = intensity;
-                mTempVertices[counter].b = intensity;
-                mTempVertices[counter].a = 1.0f;
+            mTempVertices[counter].r = intensity;
+            mTempVertices[counter].g = intensity;
+            mTempVertices[counter].b = intensity;
+            mTempVertices[counter].a = 1.0f;
 
-                //if(counter <= 100)
-                //    fprintf(stderr, "Adding vertex: %u %.3f %.3f %.3f %.3f %.3f\n", counter, x, y, s, t, intensity);
+            //if(counter <= 100)
+            //    fprintf(stderr, "Adding vertex: %u %.3f %.3f %.3f %.3f %.3f\n", counter, x, y, s, t, intensity);
 
-                counter++;
-            }
+            counter++;
         }
     }
 
@@ -1680,8 +1787,7 @@ bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string
             indices.push_back(i3);
         }
 
-    float aspect = sgct::Engine::instance()->getCurrentWindowPtr()->getAspectRatio() * 
-        (parent->getXSize() / parent->getYSize());
+    float aspect = windowAspectRatio * (parent->getXSize() / parent->getYSize());
     
     for (unsigned int i = 0; i < mGeometries[WARP_MESH].mNumberOfVertices; i++)
     {
@@ -1707,12 +1813,8 @@ bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string
     mGeometries[WARP_MESH].mGeometryType = GL_TRIANGLES;
     createMesh(&mGeometries[WARP_MESH]);
 
-    //force regeneration of dome render quad
-    if (FisheyeProjection* fishPrj = dynamic_cast<FisheyeProjection*>(parent->getNonLinearProjectionPtr()))
-    {
-        fishPrj->setIgnoreAspectRatio(true);
-        fishPrj->update(1.0f, 1.0f);
-    }
+    //the dome render quad is regenerated by generateMesh
+    mUpdateFisheyeProjection = true;
 
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Correction mesh read successfully! Vertices=%u, Indices=%u.\n", mGeometries[WARP_MESH].mNumberOfVertices, mGeometries[WARP_MESH].mNumberOfIndices);
     return true;
@@ -1723,55 +1825,52 @@ bool sgct_core::CorrectionMesh::readAndGenerateOBJMesh(const std::string & meshP
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
         "CorrectionMesh: Reading Maya Wavefront OBJ mesh data from '%s'.\n", meshPath.c_str());
 
-    FILE * meshFile = NULL;
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&meshFile, meshPath.c_str(), "r") != 0 || !meshFile)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
-        return false;
-    }
-#else
-    meshFile = fopen(meshPath.c_str(), "r");
-    if (meshFile == NULL)
+    sgct_helpers::SGCTMappedFile meshFile;
+    if (!meshFile.open(meshPath.c_str()))
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Failed to open warping mesh file!\n");
         return false;
     }
-#endif
+    sgct_helpers::SGCTTextTokenizer tokenizer(reinterpret_cast<const char *>(meshFile.getData()), meshFile.getSize());
 
     //variables
     int i0, i1, i2;
     unsigned int counter = 0;
-    char lineBuffer[MAX_LINE_LENGTH];
     CorrectionMeshVertex tmpVert;
     std::vector<CorrectionMeshVertex> verts;
     std::vector<unsigned int> indices;
 
-    //get all data
-    while (!feof(meshFile))
+    tmpVert.r = 1.0f;
+    tmpVert.g = 1.0f;
+    tmpVert.b = 1.0f;
+    tmpVert.a = 1.0f;
+
+    //get all data, dispatch on the line prefix
+    while (tokenizer.nextLine())
     {
-        if (fgets(lineBuffer, MAX_LINE_LENGTH, meshFile) != NULL)
+        if (tokenizer.match("vt "))
         {
-            if (_sscanf(lineBuffer, "v %f %f %*f", &tmpVert.x, &tmpVert.y) == 2)
-            {
-                tmpVert.r = 1.0f;
-                tmpVert.g = 1.0f;
-                tmpVert.b = 1.0f;
-                tmpVert.a = 1.0f;
-
-                verts.push_back(tmpVert);
-            }
-            else if (_sscanf(lineBuffer, "vt %f %f %*f", &tmpVert.s, &tmpVert.t) == 2)
+            float s, t;
+            if (tokenizer.readFloat(s) && tokenizer.readFloat(t))
             {
                 if (counter < verts.size())
                 {
-                    verts[counter].s = tmpVert.s;
-                    verts[counter].t = tmpVert.t;
+                    verts[counter].s = s;
+                    verts[counter].t = t;
                 }
-                
+
                 counter++;
             }
-            else if (_sscanf(lineBuffer, "f %d/%*d/%*d %d/%*d/%*d %d/%*d/%*d", &i0, &i1, &i2) == 3)
+        }
+        else if (tokenizer.match("v "))
+        {
+            if (tokenizer.readFloat(tmpVert.x) && tokenizer.readFloat(tmpVert.y))
+                verts.push_back(tmpVert);
+        }
+        else if (tokenizer.match("f "))
+        {
+            //faces are stored as v/vt/vn, only the vertex index is used
+            if (readOBJFaceIndex(tokenizer, i0) && readOBJFaceIndex(tokenizer, i1) && readOBJFaceIndex(tokenizer, i2))
             {
                 //indexes starts at 1 in OBJ
                 indices.push_back(i0-1);
@@ -1804,242 +1903,204 @@ bool sgct_core::CorrectionMesh::readAndGenerateOBJMesh(const std::string & meshP
     return true;
 }
 
-int numberOfDigitsInInt(int number)
-{
-    int i = 0;
-    while (number > pow(10, i))
-        i++;
-    return i;
-}
-
-bool sgct_core::CorrectionMesh::readAndGenerateMpcdiMesh(const std::string & meshPath, Viewport* parent)
+/*!
+    Decodes a MPCDI warp file (PFM format) into a correction grid. The data is pulled through the read
+    function so that it can be decompressed straight from a MPCDI package without an intermediate copy.
+*/
+bool sgct_core::CorrectionMesh::readMpcdiWarpGrid(const ReadFunction & read, MpcdiWarpGrid & grid)
 {
-    bool isReadingFile = ( meshPath.length() > 0 ) ? true : false;
-    unsigned int srcIdx = 0;
-    char* srcBuff;
-    size_t srcSize_bytes;
-    const int MaxHeaderLineLength = 100;
-    FILE * meshFile = nullptr;
-
-    if( isReadingFile )
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
-            "CorrectionMesh: Reading MPCDI mesh (PFM format) data from '%s'.\n", meshPath.c_str());
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-        if (fopen_s(&meshFile, meshPath.c_str(), "r") != 0 || !meshFile)
+    //the header is three text lines: the "PF" type, the grid size and the scale/endianness
+    const std::size_t MaxHeaderLength = 128;
+    char header[MaxHeaderLength];
+    std::size_t headerLength = 0;
+    int numberOfNewlines = 0;
+    while (numberOfNewlines < 3)
+    {
+        if (headerLength == MaxHeaderLength || !read(&header[headerLength], 1))
         {
             sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                "CorrectionMesh: Failed to open warping mesh file!\n");
+                "CorrectionMesh: Invalid header syntax.\n");
             return false;
         }
-#else
-        meshFile = fopen(meshPath.c_str(), "rb");
-        if (meshFile == NULL)
-        {
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                "CorrectionMesh: Failed to open warping mesh file!\n");
-            return false;
-        }
-#endif
+        if (header[headerLength++] == '\n')
+            numberOfNewlines++;
     }
-    else
+
+    sgct_helpers::SGCTTextTokenizer tokenizer(header, headerLength);
+    unsigned int numberOfCols = 0;
+    unsigned int numberOfRows = 0;
+    float endiannessIndicator = 0.0f;
+    bool headerValid = tokenizer.nextLine() && tokenizer.match("PF") && tokenizer.atLineEnd();
+    if (!headerValid)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
-            "CorrectionMesh: Reading MPCDI mesh (PFM format) from buffer.\n", meshPath.c_str());
-        srcBuff = parent->mMpcdiWarpMeshData;
-        srcSize_bytes = parent->mMpcdiWarpMeshSize;
+        //The 'Pf' header is invalid because PFM grayscale type is not supported.
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "CorrectionMesh: Incorrect file type.\n");
+        return false;
+    }
+    headerValid = tokenizer.nextLine() && tokenizer.readUInt(numberOfCols) && tokenizer.readUInt(numberOfRows) &&
+        tokenizer.nextLine() && tokenizer.readFloat(endiannessIndicator);
+    if (!headerValid || numberOfCols < 2 || numberOfRows < 2)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "CorrectionMesh: Invalid header syntax.\n");
+        return false;
     }
 
-    size_t retval;
-    char headerChar;
-    char headerBuffer[MaxHeaderLineLength];
-    int index = 0;
-    int nNewlines = 0;
-    const int read3lines = 3;
-
-    do {
-        if( isReadingFile )
+    //a negative scale means little endian data
+    const uint16_t endiannessTest = 1;
+    bool hostIsLittleEndian = *reinterpret_cast<const unsigned char *>(&endiannessTest) == 1;
+    bool swapBytes = (endiannessIndicator < 0.0f) != hostIsLittleEndian;
+
+    std::size_t numCorrectionValues = static_cast<std::size_t>(numberOfCols) * numberOfRows;
+    grid.numberOfCols = numberOfCols;
+    grid.numberOfRows = numberOfRows;
+    grid.correctionX.resize(numCorrectionValues);
+    grid.correctionY.resize(numCorrectionValues);
+
+    //MPCDI uses the PFM format for correction grid. PFM format is designed for 3 RGB
+    // values. However MPCDI substitutes Red for X correction, Green for Y
+    // correction, and Blue for correction error. This will be NaN for no error value
+    const std::size_t PixelsPerChunk = 4096;
+    std::vector<float> chunk(PixelsPerChunk * 3);
+    for (std::size_t pixel = 0; pixel < numCorrectionValues; pixel += PixelsPerChunk)
+    {
+        std::size_t count = std::min(PixelsPerChunk, numCorrectionValues - pixel);
+        if (!read(chunk.data(), count * 3 * sizeof(float)))
         {
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-            retval = fread_s(&headerChar, sizeof(char)*1, sizeof(char), 1, meshFile);
-#else
-            retval = fread(&headerChar, sizeof(char), 1, meshFile);
-#endif
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+                "CorrectionMesh: Error reading all correction values!\n");
+            return false;
         }
-        else
+
+        if (swapBytes)
         {
-            if( srcIdx == srcSize_bytes )
-                retval = -1;
-            else
+            unsigned char * bytes = reinterpret_cast<unsigned char *>(chunk.data());
+            for (std::size_t i = 0; i < count * 3 * sizeof(float); i += sizeof(float))
             {
-                headerChar = srcBuff[srcIdx++];
-                retval = 1;
+                std::swap(bytes[i], bytes[i + 3]);
+                std::swap(bytes[i + 1], bytes[i + 2]);
             }
         }
-        if (retval != 1) {
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                                                    "CorrectionMesh: Error reading from file.\n");
-            fclose(meshFile);
-            return false;
-        }
-        headerBuffer[index++] = headerChar;
-        if( headerChar == '\n' )
-            nNewlines++;
-    } while (nNewlines < read3lines);
 
-    char fileFormatHeader[2];
-    unsigned int numberOfCols = 0;
-    unsigned int numberOfRows = 0;
-    float endiannessIndicator = 0;
-
-#ifdef __WIN32__
-    _sscanf(&headerBuffer[0], "%2c\n", &fileFormatHeader, static_cast<unsigned int>(sizeof(fileFormatHeader)));
-    //Read header past the 2 character start
-    _sscanf(&headerBuffer[3], "%d %d\n", &numberOfCols, &numberOfRows);
-    int indexForEndianness = 3 + numberOfDigitsInInt(numberOfCols)
-        + numberOfDigitsInInt(numberOfRows) + 2;
-    _sscanf(&headerBuffer[indexForEndianness], "%f\n", &endiannessIndicator);
-#else
-    if (_sscanf(headerBuffer, "%2c %d %d %f", fileFormatHeader,
-                &numberOfCols, &numberOfRows, &endiannessIndicator) != 4)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-            "CorrectionMesh: Invalid header syntax.\n");
-        if (isReadingFile)
-            fclose(meshFile);
-        return false;
+        const float * src = chunk.data();
+        for (std::size_t i = 0; i < count; i++, src += 3)
+        {
+            grid.correctionX[pixel + i] = src[0];
+            grid.correctionY[pixel + i] = src[1];
+        }
     }
-#endif
 
-    if (fileFormatHeader[0] != 'P' || fileFormatHeader[1] != 'F') {
-        //The 'Pf' header is invalid because PFM grayscale type is not supported.
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                                                "CorrectionMesh: Incorrect file type.\n");
-    }
-    int numCorrectionValues = numberOfCols * numberOfRows;
-    float* correctionGridX = new float[numCorrectionValues];
-    float* correctionGridY = new float[numCorrectionValues];
-    float  errorPosition;
-    const int value32bit = 4;
+    return true;
+}
 
-    if( isReadingFile )
+bool sgct_core::CorrectionMesh::readAndGenerateMpcdiMesh(const std::string & meshPath, Viewport* parent)
+{
+    MpcdiWarpGrid fileGrid;
+    const MpcdiWarpGrid * grid = parent->getMpcdiWarpGrid();
+
+    if( meshPath.length() > 0 )
     {
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
- #define SGCT_READ fread_s
-#else
- #define SGCT_READ fread
-#endif
-        for (int i = 0; i < numCorrectionValues; ++i)
-        {
-#ifdef __WIN32__
-            retval = SGCT_READ(correctionGridX + i, numCorrectionValues, value32bit, 1, meshFile);
-            retval = SGCT_READ(correctionGridY + i, numCorrectionValues, value32bit, 1, meshFile);
-            //MPCDI uses the PFM format for correction grid. PFM format is designed for 3 RGB
-            // values. However MPCDI substitutes Red for X correction, Green for Y
-            // correction, and Blue for correction error. This will be NaN for no error value
-            retval = SGCT_READ(&errorPosition, numCorrectionValues, value32bit, 1, meshFile);
-#else
-            retval = SGCT_READ(correctionGridX + i, value32bit, 1, meshFile);
-            retval = SGCT_READ(correctionGridY + i, value32bit, 1, meshFile);
-            retval = SGCT_READ(&errorPosition,      value32bit, 1, meshFile);
-#endif
-        }
-        fclose(meshFile);
-        if (retval != value32bit)
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
+            "CorrectionMesh: Reading MPCDI mesh (PFM format) data from '%s'.\n", meshPath.c_str());
+
+        sgct_helpers::SGCTMappedFile meshFile;
+        if (!meshFile.open(meshPath.c_str()))
         {
             sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                "CorrectionMesh: Error reading all correction values!\n");
+                "CorrectionMesh: Failed to open warping mesh file!\n");
             return false;
         }
+
+        const unsigned char * data = meshFile.getData();
+        std::size_t remaining = meshFile.getSize();
+        if (!readMpcdiWarpGrid([&data, &remaining](void * dst, std::size_t size)
+            {
+                if (size > remaining)
+                    return false;
+                memcpy(dst, data, size);
+                data += size;
+                remaining -= size;
+                return true;
+            }, fileGrid))
+            return false;
+        grid = &fileGrid;
     }
     else
     {
-        bool readErr = false;
-        for (int i = 0; i < numCorrectionValues; ++i)
-        {
-//#define TEST_FLAT_MESH
-
-#ifdef TEST_FLAT_MESH
-            correctionGridX[i] = (float)(i%32) / 32.0;
-            correctionGridY[i] = 1.0 - (float)i * 32.0 / 32.0;
-#else
-            if( !readMeshBuffer(&correctionGridX[i], srcIdx, srcBuff, srcSize_bytes, value32bit) )
-                readErr = true;
-            else if( !readMeshBuffer(&correctionGridY[i], srcIdx, srcBuff, srcSize_bytes, value32bit) )
-                readErr = true;
-            else if( !readMeshBuffer(&errorPosition, srcIdx, srcBuff, srcSize_bytes, value32bit) )
-                readErr = true;
-
-            if( readErr ) {
-                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                    "CorrectionMesh: Error reading mpcdi correction value at index %d\n", i);
-            }
-#endif
-        }
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
+            "CorrectionMesh: Reading MPCDI mesh (PFM format) from buffer.\n");
     }
 
-    int   gridIndex_column, gridIndex_row;
-    float* smoothPos_x = new float[numCorrectionValues];
-    float* smoothPos_y = new float[numCorrectionValues];
-    float* warpedPos_x = new float[numCorrectionValues];
-    float* warpedPos_y = new float[numCorrectionValues];
-
-    for (int i = 0; i < numCorrectionValues; ++i) {
-        gridIndex_column = i % numberOfCols;
-        gridIndex_row = i / numberOfCols;
-        //Compute XY positions for each point based on a normalized 0,0 to 1,1 grid,
-        // add the correction offsets to each warp point
-        smoothPos_x[i] = (float)gridIndex_column / (float)(numberOfCols - 1);
-        //Reverse the y position because the values from pfm file are given in raster-scan
-        // order, which is left to right but starts at upper-left rather than lower-left.
-        smoothPos_y[i] = 1.0f - ((float)gridIndex_row    / (float)(numberOfRows - 1));
-        warpedPos_x[i] = smoothPos_x[i] + correctionGridX[i];
-        warpedPos_y[i] = smoothPos_y[i] + correctionGridY[i];
+    if (grid == nullptr || grid->numberOfCols < 2 || grid->numberOfRows < 2 ||
+        grid->correctionX.size() < static_cast<std::size_t>(grid->numberOfCols) * grid->numberOfRows)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh: Incorrect mesh data geometry!\n");
+        return false;
     }
 
+    unsigned int numberOfCols = grid->numberOfCols;
+    unsigned int numberOfRows = grid->numberOfRows;
+    unsigned int numberOfVertices = numberOfCols * numberOfRows;
+    const float * correctionGridX = grid->correctionX.data();
+    const float * correctionGridY = grid->correctionY.data();
+
 #ifdef NORMALIZE_CORRECTION_MESH
-    float maxX = *std::max_element(warpedPos_x, warpedPos_x + numCorrectionValues);
-    float minX = *std::min_element(warpedPos_x, warpedPos_x + numCorrectionValues);
+    float minX = 0.0f, maxX = 0.0f, minY = 0.0f, maxY = 0.0f;
+    for (unsigned int i = 0; i < numberOfVertices; ++i) {
+        float warpedPos_x = static_cast<float>(i % numberOfCols) / static_cast<float>(numberOfCols - 1) + correctionGridX[i];
+        float warpedPos_y = 1.0f - (static_cast<float>(i / numberOfCols) / static_cast<float>(numberOfRows - 1)) + correctionGridY[i];
+        minX = (i == 0 || warpedPos_x < minX) ? warpedPos_x : minX;
+        maxX = (i == 0 || warpedPos_x > maxX) ? warpedPos_x : maxX;
+        minY = (i == 0 || warpedPos_y < minY) ? warpedPos_y : minY;
+        maxY = (i == 0 || warpedPos_y > maxY) ? warpedPos_y : maxY;
+    }
     float scaleRangeX = maxX - minX;
-    float maxY = *std::max_element(warpedPos_y, warpedPos_y + numCorrectionValues);
-    float minY = *std::min_element(warpedPos_y, warpedPos_y + numCorrectionValues);
     float scaleRangeY = maxY - minY;
     float scaleFactor = (scaleRangeX >= scaleRangeY) ? scaleRangeX : scaleRangeY;
-    //Scale all positions to fit within 0,0 to 1,1
-    for (int i = 0; i < numCorrectionValues; ++i) {
-        warpedPos_x[i] = (warpedPos_x[i] - minX) / scaleFactor;
-        warpedPos_y[i] = (warpedPos_y[i] - minY) / scaleFactor;
-    }
 #endif //NORMALIZE_CORRECTION_MESH
 
+    mTempVertices = new CorrectionMeshVertex[numberOfVertices];
+    mGeometries[WARP_MESH].mNumberOfVertices = numberOfVertices;
+
     CorrectionMeshVertex vertex;
-    std::vector<CorrectionMeshVertex> vertices;
     //init to max intensity (opaque white)
     vertex.r = 1.0f;
     vertex.g = 1.0f;
     vertex.b = 1.0f;
     vertex.a = 1.0f;
-    for (int i = 0; i < numCorrectionValues; ++i) {
-        vertex.s = smoothPos_x[i];
-        vertex.t = smoothPos_y[i];
-        //scale to viewport coordinates
-        vertex.x = 2.0f * warpedPos_x[i] - 1.0f;
-        vertex.y = 2.0f * warpedPos_y[i] - 1.0f;
-        vertices.push_back(vertex);
-    }
-    delete[] warpedPos_x;
-    delete[] warpedPos_y;
-    delete[] smoothPos_x;
-    delete[] smoothPos_y;
+    unsigned int i = 0;
+    for (unsigned int r = 0; r < numberOfRows; r++)
+    {
+        //Reverse the y position because the values from pfm file are given in raster-scan
+        // order, which is left to right but starts at upper-left rather than lower-left.
+        float smoothPos_y = 1.0f - (static_cast<float>(r) / static_cast<float>(numberOfRows - 1));
+        for (unsigned int c = 0; c < numberOfCols; c++, i++)
+        {
+            //Compute XY positions for each point based on a normalized 0,0 to 1,1 grid,
+            // add the correction offsets to each warp point
+            float smoothPos_x = static_cast<float>(c) / static_cast<float>(numberOfCols - 1);
+            float warpedPos_x = smoothPos_x + correctionGridX[i];
+            float warpedPos_y = smoothPos_y + correctionGridY[i];
 
-    //copy vertices
-    unsigned int numberOfVertices = numberOfCols * numberOfRows;
-    mTempVertices = new CorrectionMeshVertex[numberOfVertices];
-    memcpy(mTempVertices, vertices.data(), numberOfVertices * sizeof(CorrectionMeshVertex));
-    mGeometries[WARP_MESH].mNumberOfVertices = numberOfVertices;
-    vertices.clear();
+#ifdef NORMALIZE_CORRECTION_MESH
+            //Scale all positions to fit within 0,0 to 1,1
+            warpedPos_x = (warpedPos_x - minX) / scaleFactor;
+            warpedPos_y = (warpedPos_y - minY) / scaleFactor;
+#endif //NORMALIZE_CORRECTION_MESH
 
-    std::vector<unsigned int> indices;
+            vertex.s = smoothPos_x;
+            vertex.t = smoothPos_y;
+            //scale to viewport coordinates
+            vertex.x = 2.0f * warpedPos_x - 1.0f;
+            vertex.y = 2.0f * warpedPos_y - 1.0f;
+            mTempVertices[i] = vertex;
+        }
+    }
+
+    mGeometries[WARP_MESH].mNumberOfIndices = (numberOfCols - 1) * (numberOfRows - 1) * 6;
+    mTempIndices = new unsigned int[mGeometries[WARP_MESH].mNumberOfIndices];
+    unsigned int * indexPtr = mTempIndices;
     unsigned int i0, i1, i2, i3;
     for (unsigned int c = 0; c < (numberOfCols -1); c++)
         for (unsigned int r = 0; r < (numberOfRows-1); r++)
@@ -2049,8 +2110,6 @@ bool sgct_core::CorrectionMesh::readAndGenerateMpcdiMesh(const std::string & mes
             i2 = (r + 1) * numberOfCols + (c + 1);
             i3 = (r + 1) * numberOfCols + c;
 
-            //fprintf(stderr, "Indexes: %u %u %u %u\n", i0, i1, i2, i3);
-
             /*
 
             3      2
@@ -2065,22 +2124,16 @@ bool sgct_core::CorrectionMesh::readAndGenerateMpcdiMesh(const std::string & mes
             */
 
             //triangle 1
-            indices.push_back(i0);
-            indices.push_back(i1);
-            indices.push_back(i2);
+            *indexPtr++ = i0;
+            *indexPtr++ = i1;
+            *indexPtr++ = i2;
 
             //triangle 2
-            indices.push_back(i0);
-            indices.push_back(i2);
-            indices.push_back(i3);
+            *indexPtr++ = i0;
+            *indexPtr++ = i2;
+            *indexPtr++ = i3;
         }
 
-    //allocate and copy indices
-    mGeometries[WARP_MESH].mNumberOfIndices = static_cast<unsigned int>(indices.size());
-    mTempIndices = new unsigned int[mGeometries[WARP_MESH].mNumberOfIndices];
-    memcpy(mTempIndices, indices.data(), mGeometries[WARP_MESH].mNumberOfIndices * sizeof(unsigned int));
-    indices.clear();
-
     mGeometries[WARP_MESH].mGeometryType = GL_TRIANGLES;
 
     createMesh(&mGeometries[WARP_MESH]);
@@ -2090,24 +2143,6 @@ bool sgct_core::CorrectionMesh::readAndGenerateMpcdiMesh(const std::string & mes
     return true;
 }
 
-bool sgct_core::CorrectionMesh::readMeshBuffer(float* dest, unsigned int& idx,
-                                               char* src,
-                                               const size_t srcSize_bytes,
-                                               const int readSize_bytes)
-{
-    float val;
-    if( (idx + readSize_bytes) > srcSize_bytes )
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-            "CorrectionMesh: Reached EOF in mesh buffer!\n");
-        return false;
-    }
-    memcpy(&val, &src[idx], readSize_bytes);
-    *dest = val;
-    idx += readSize_bytes;
-    return true;
-}
-
 void sgct_core::CorrectionMesh::setupSimpleMesh(CorrectionMeshGeometry * geomPtr, Viewport * parent)
 {
     unsigned int numberOfVertices = 4;
@@ -2222,7 +2257,210 @@ void sgct_core::CorrectionMesh::setupMaskMesh(Viewport * parent, bool flip_x, bo
     mTempVertices[3].y = 2.0f*(1.0f * parent->getYSize() + parent->getY()) - 1.0f;
 }
 
+/*!
+Simplify the parsed warping mesh and reorder it for the vertex cache as configured in SGCTSettings.
+Only triangle lists are processed.
+*/
+void sgct_core::CorrectionMesh::optimizeMesh(const int * resolution)
+{
+    SGCT_TRACE_SCOPE("CorrectionMesh::optimizeMesh");
+    float tolerance = sgct::SGCTSettings::instance()->getWarpingMeshSimplificationTolerance();
+    bool vertexCache = sgct::SGCTSettings::instance()->getUseWarpingMeshVertexCacheOptimization();
+    CorrectionMeshGeometry & geometry = mGeometries[WARP_MESH];
+
+    if ((tolerance <= 0.0f && !vertexCache) || mTempVertices == NULL || mTempIndices == NULL)
+        return;
+
+    if (geometry.mGeometryType != GL_TRIANGLES)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Mesh optimization skipped, only triangle lists are supported.\n");
+        return;
+    }
+
+    double t0 = sgct::Engine::getTime();
+    unsigned int numberOfTriangles = geometry.mNumberOfIndices / 3;
+    unsigned int numberOfVertices = geometry.mNumberOfVertices;
+    float acmr = CorrectionMeshOptimizer::calculateACMR(mTempIndices, geometry.mNumberOfIndices);
+
+    CorrectionMeshOptimizer optimizer(mTempVertices, geometry.mNumberOfVertices, mTempIndices, geometry.mNumberOfIndices);
+    if (tolerance > 0.0f)
+        optimizer.simplify(tolerance, resolution[0], resolution[1]);
+    if (vertexCache)
+        optimizer.optimizeVertexCache();
+
+    if (optimizer.getIndices().empty())
+        return;
+
+    //replace the parsed data, createMesh releases the old buffers
+    geometry.mNumberOfVertices = static_cast<unsigned int>(optimizer.getVertices().size());
+    geometry.mNumberOfIndices = static_cast<unsigned int>(optimizer.getIndices().size());
+    mTempVertices = new CorrectionMeshVertex[geometry.mNumberOfVertices];
+    memcpy(mTempVertices, optimizer.getVertices().data(), geometry.mNumberOfVertices * sizeof(CorrectionMeshVertex));
+    mTempIndices = new unsigned int[geometry.mNumberOfIndices];
+    memcpy(mTempIndices, optimizer.getIndices().data(), geometry.mNumberOfIndices * sizeof(unsigned int));
+    createMesh(&geometry);
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
+        "CorrectionMesh: Optimized mesh in %.2f ms. Triangles: %u -> %u, vertices: %u -> %u, max error: %.3f px (tolerance %.3f px), ACMR: %.2f -> %.2f.\n",
+        (sgct::Engine::getTime() - t0)*1000.0, numberOfTriangles, geometry.mNumberOfIndices / 3, numberOfVertices, geometry.mNumberOfVertices,
+        optimizer.getMaxError(), tolerance, acmr, CorrectionMeshOptimizer::calculateACMR(mTempIndices, geometry.mNumberOfIndices));
+}
+
+/*!
+Rasterize the warping mesh into a lookup map for the given window resolution and set up the quad
+that applies it. The map is uploaded by generateMesh.
+*/
+void sgct_core::CorrectionMesh::bakeWarpMap(WarpMapFormat format, const int * resolution)
+{
+    SGCT_TRACE_SCOPE("CorrectionMesh::bakeWarpMap");
+    CorrectionMeshGeometry & geometry = mGeometries[WARP_MESH];
+    const CorrectionMeshVertex * vertices = mPendingVertices[WARP_MESH];
+    const unsigned int * indices = mPendingIndices[WARP_MESH];
+
+    if (sgct::Engine::instance()->isOGLPipelineFixed())
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Warp maps require the programmable pipeline, using the warping mesh.\n");
+        return;
+    }
+
+    if (vertices == NULL || indices == NULL || geometry.mGeometryType != GL_TRIANGLES)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Warp maps can only be baked from triangle lists, using the warping mesh.\n");
+        return;
+    }
+
+    if (!WarpMapBaker::canBake(vertices, geometry.mNumberOfVertices))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Warp maps only support gray and opaque blending, using the warping mesh.\n");
+        return;
+    }
+
+    double t0 = sgct::Engine::getTime();
+    WarpMapBaker * baker = new WarpMapBaker(vertices, geometry.mNumberOfVertices, indices, geometry.mNumberOfIndices);
+    if (!baker->bake(resolution[0], resolution[1], format, std::thread::hardware_concurrency()))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Warping mesh doesn't cover the window, no warp map baked.\n");
+        delete baker;
+        return;
+    }
+
+    //quad covering the map area, texture coordinates address the map
+    const int * rect = baker->getRect();
+    float x0 = 2.0f * static_cast<float>(rect[0]) / static_cast<float>(resolution[0]) - 1.0f;
+    float y0 = 2.0f * static_cast<float>(rect[1]) / static_cast<float>(resolution[1]) - 1.0f;
+    float x1 = 2.0f * static_cast<float>(rect[0] + rect[2]) / static_cast<float>(resolution[0]) - 1.0f;
+    float y1 = 2.0f * static_cast<float>(rect[1] + rect[3]) / static_cast<float>(resolution[1]) - 1.0f;
+
+    CorrectionMeshGeometry * geomPtr = &mGeometries[WARP_MAP_MESH];
+    geomPtr->mNumberOfVertices = 4;
+    geomPtr->mNumberOfIndices = 4;
+    geomPtr->mGeometryType = GL_TRIANGLE_STRIP;
+
+    mTempVertices = new CorrectionMeshVertex[4];
+    mTempIndices = new unsigned int[4];
+    const float corners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        mTempVertices[i].x = corners[i][0] == 0.0f ? x0 : x1;
+        mTempVertices[i].y = corners[i][1] == 0.0f ? y0 : y1;
+        mTempVertices[i].s = corners[i][0];
+        mTempVertices[i].t = corners[i][1];
+        mTempVertices[i].r = 1.0f;
+        mTempVertices[i].g = 1.0f;
+        mTempVertices[i].b = 1.0f;
+        mTempVertices[i].a = 1.0f;
+    }
+    mTempIndices[0] = 0;
+    mTempIndices[1] = 3;
+    mTempIndices[2] = 1;
+    mTempIndices[3] = 2;
+    createMesh(geomPtr);
+
+    delete mPendingWarpMap;
+    mPendingWarpMap = baker;
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
+        "CorrectionMesh: Baked %s warp map of %dx%d pixels from %u triangles in %.2f ms.\n",
+        baker->getFormat() == RG16_WARP_MAP ? "RG16" : "RG32F", rect[2], rect[3], geometry.mNumberOfIndices / 3, (sgct::Engine::getTime() - t0)*1000.0);
+}
+
+void sgct_core::CorrectionMesh::uploadWarpMap()
+{
+    if (mWarpMapTexture)
+        glDeleteTextures(1, &mWarpMapTexture);
+
+    const int * rect = mPendingWarpMap->getRect();
+    bool floatMap = mPendingWarpMap->getFormat() == RG32F_WARP_MAP;
+
+    glGenTextures(1, &mWarpMapTexture);
+    glBindTexture(GL_TEXTURE_2D, mWarpMapTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, floatMap ? GL_RGBA32F : GL_RGBA16, rect[2], rect[3], 0,
+        GL_RGBA, floatMap ? GL_FLOAT : GL_UNSIGNED_SHORT, mPendingWarpMap->getData().data());
+
+    //one texel per pixel, lookups must not be filtered
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, GL_FALSE);
+
+    mWarpMapResolution[0] = mPendingWarpMap->getResolution()[0];
+    mWarpMapResolution[1] = mPendingWarpMap->getResolution()[1];
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::CorrectionMeshes, sgct::SGCTMemoryRegistry::GPU, this, "warp map",
+            sgct::SGCTMemoryRegistry::getTextureSize(rect[2], rect[3], floatMap ? GL_RGBA32F : GL_RGBA16));
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Generating warp map texture: %d\n", mWarpMapTexture);
+}
+
+/*!
+\returns true if a warp map baked for the given output resolution is available
+*/
+bool sgct_core::CorrectionMesh::hasWarpMap(int resolutionX, int resolutionY) const
+{
+    return mWarpMapTexture != GL_FALSE && mWarpMapResolution[0] == resolutionX && mWarpMapResolution[1] == resolutionY;
+}
+
+/*!
+Hand over the parsed vertices and indices of a geometry. The data is uploaded by generateMesh.
+*/
 void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * geomPtr)
+{
+    std::size_t index = static_cast<std::size_t>(geomPtr - mGeometries);
+    if (index == WARP_MESH && mMeshCacheFile != NULL)
+        releasePendingMesh(index);
+    if (mPendingVertices[index] != mTempVertices)
+        delete[] mPendingVertices[index];
+    if (mPendingIndices[index] != mTempIndices)
+        delete[] mPendingIndices[index];
+
+    mPendingVertices[index] = mTempVertices;
+    mPendingIndices[index] = mTempIndices;
+}
+
+/*!
+Release the parsed data of a geometry. A warp mesh loaded from the cache only unmaps the cache file.
+*/
+void sgct_core::CorrectionMesh::releasePendingMesh(std::size_t index)
+{
+    if (index == WARP_MESH && mMeshCacheFile != NULL)
+    {
+        delete mMeshCacheFile;
+        mMeshCacheFile = NULL;
+    }
+    else
+    {
+        delete[] mPendingVertices[index];
+        delete[] mPendingIndices[index];
+    }
+
+    mPendingVertices[index] = NULL;
+    mPendingIndices[index] = NULL;
+}
+
+void sgct_core::CorrectionMesh::uploadMesh(sgct_core::CorrectionMeshGeometry * geomPtr, const CorrectionMeshVertex * vertices, const unsigned int * indices)
 {
     /*sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Uploading mesh data (type=%d)...\n",
         ClusterManager::instance()->getMeshImplementation());*/
@@ -2240,44 +2478,75 @@ void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * g
         glGenBuffers(2, &(geomPtr->mMeshData[0]));
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Generating VBOs: %d %d\n", geomPtr->mMeshData[0], geomPtr->mMeshData[1]);
 
-        glBindBuffer(GL_ARRAY_BUFFER, geomPtr->mMeshData[Vertex]);
-        glBufferData(GL_ARRAY_BUFFER, geomPtr->mNumberOfVertices * sizeof(CorrectionMeshVertex), &mTempVertices[0], GL_STATIC_DRAW);
+        bool fixedPipeline = sgct::Engine::instance()->isOGLPipelineFixed();
+        geomPtr->mVertexFormat = CorrectionMeshGeometry::FLOAT_VERTEX;
+        if (sgct::SGCTSettings::instance()->getUseWarpingMeshPackedVertices())
+        {
+            if (canPackVertices(vertices, geomPtr->mNumberOfVertices))
+                geomPtr->mVertexFormat = fixedPipeline ? CorrectionMeshGeometry::COLOR_PACKED_VERTEX : CorrectionMeshGeometry::PACKED_VERTEX;
+            else
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Vertices out of range for packing, using floats.\n");
+        }
 
-        if(!sgct::Engine::instance()->isOGLPipelineFixed())
+        glBindBuffer(GL_ARRAY_BUFFER, geomPtr->mMeshData[Vertex]);
+        switch (geomPtr->mVertexFormat)
         {
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(
-                0, // The attribute we want to configure
-                2,                           // size
-                GL_FLOAT,                    // type
-                GL_FALSE,                    // normalized?
-                sizeof(CorrectionMeshVertex),// stride
-                reinterpret_cast<void*>(0)   // array buffer offset
-            );
-
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(
-                1, // The attribute we want to configure
-                2,                           // size
-                GL_FLOAT,                    // type
-                GL_FALSE,                    // normalized?
-                sizeof(CorrectionMeshVertex),// stride
-                reinterpret_cast<void*>(8)   // array buffer offset
-            );
-
-            glEnableVertexAttribArray(2);
-            glVertexAttribPointer(
-                2, // The attribute we want to configure
-                4,                           // size
-                GL_FLOAT,                    // type
-                GL_FALSE,                    // normalized?
-                sizeof(CorrectionMeshVertex),// stride
-                reinterpret_cast<void*>(16)  // array buffer offset
-            );
+        case CorrectionMeshGeometry::PACKED_VERTEX:
+            {
+                std::vector<CorrectionMeshPackedVertex> packedVertices(geomPtr->mNumberOfVertices);
+                for (unsigned int i = 0; i < geomPtr->mNumberOfVertices; i++)
+                {
+                    packedVertices[i].x = static_cast<short>(floorf(vertices[i].x * 32767.0f + 0.5f));
+                    packedVertices[i].y = static_cast<short>(floorf(vertices[i].y * 32767.0f + 0.5f));
+                    packedVertices[i].s = static_cast<unsigned short>(vertices[i].s * 65535.0f + 0.5f);
+                    packedVertices[i].t = static_cast<unsigned short>(vertices[i].t * 65535.0f + 0.5f);
+                    packedVertices[i].r = static_cast<unsigned char>(vertices[i].r * 255.0f + 0.5f);
+                    packedVertices[i].g = static_cast<unsigned char>(vertices[i].g * 255.0f + 0.5f);
+                    packedVertices[i].b = static_cast<unsigned char>(vertices[i].b * 255.0f + 0.5f);
+                    packedVertices[i].a = static_cast<unsigned char>(vertices[i].a * 255.0f + 0.5f);
+                }
+                glBufferData(GL_ARRAY_BUFFER, geomPtr->mNumberOfVertices * sizeof(CorrectionMeshPackedVertex), packedVertices.data(), GL_STATIC_DRAW);
+            }
+            break;
+
+        case CorrectionMeshGeometry::COLOR_PACKED_VERTEX:
+            {
+                std::vector<CorrectionMeshColorPackedVertex> packedVertices(geomPtr->mNumberOfVertices);
+                for (unsigned int i = 0; i < geomPtr->mNumberOfVertices; i++)
+                {
+                    packedVertices[i].x = vertices[i].x;
+                    packedVertices[i].y = vertices[i].y;
+                    packedVertices[i].s = vertices[i].s;
+                    packedVertices[i].t = vertices[i].t;
+                    packedVertices[i].r = static_cast<unsigned char>(vertices[i].r * 255.0f + 0.5f);
+                    packedVertices[i].g = static_cast<unsigned char>(vertices[i].g * 255.0f + 0.5f);
+                    packedVertices[i].b = static_cast<unsigned char>(vertices[i].b * 255.0f + 0.5f);
+                    packedVertices[i].a = static_cast<unsigned char>(vertices[i].a * 255.0f + 0.5f);
+                }
+                glBufferData(GL_ARRAY_BUFFER, geomPtr->mNumberOfVertices * sizeof(CorrectionMeshColorPackedVertex), packedVertices.data(), GL_STATIC_DRAW);
+            }
+            break;
+
+        default:
+            glBufferData(GL_ARRAY_BUFFER, geomPtr->mNumberOfVertices * sizeof(CorrectionMeshVertex), vertices, GL_STATIC_DRAW);
+            break;
         }
 
+        if (!fixedPipeline)
+            setVertexPointers(geomPtr->mVertexFormat, false);
+
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geomPtr->mMeshData[Index]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, geomPtr->mNumberOfIndices * sizeof(unsigned int), &mTempIndices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, geomPtr->mNumberOfIndices * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+
+        std::size_t vertexSize = sizeof(CorrectionMeshVertex);
+        if (geomPtr->mVertexFormat == CorrectionMeshGeometry::PACKED_VERTEX)
+            vertexSize = sizeof(CorrectionMeshPackedVertex);
+        else if (geomPtr->mVertexFormat == CorrectionMeshGeometry::COLOR_PACKED_VERTEX)
+            vertexSize = sizeof(CorrectionMeshColorPackedVertex);
+        if (sgct::SGCTMemoryRegistry::exists())
+            sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::CorrectionMeshes, sgct::SGCTMemoryRegistry::GPU, this,
+                meshNames[geomPtr - mGeometries],
+                geomPtr->mNumberOfVertices * vertexSize + geomPtr->mNumberOfIndices * sizeof(unsigned int));
 
         //unbind
         if(!sgct::Engine::instance()->isOGLPipelineFixed())
@@ -2296,7 +2565,7 @@ void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * g
         
         for (unsigned int i = 0; i < geomPtr->mNumberOfIndices; i++)
         {
-            vertex = mTempVertices[mTempIndices[i]];
+            vertex = vertices[indices[i]];
 
             glColor4f(vertex.r, vertex.g, vertex.b, vertex.a);
             glTexCoord2f(vertex.s, vertex.t);
@@ -2310,6 +2579,94 @@ void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * g
     }
 }
 
+/*!
+\returns true if the vertices are within the ranges of the packed vertex formats
+*/
+bool sgct_core::CorrectionMesh::canPackVertices(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices)
+{
+    for (unsigned int i = 0; i < numberOfVertices; i++)
+    {
+        const CorrectionMeshVertex & v = vertices[i];
+        if (!(v.x >= -1.0f && v.x <= 1.0f && v.y >= -1.0f && v.y <= 1.0f &&
+            v.s >= 0.0f && v.s <= 1.0f && v.t >= 0.0f && v.t <= 1.0f &&
+            v.r >= 0.0f && v.r <= 1.0f && v.g >= 0.0f && v.g <= 1.0f &&
+            v.b >= 0.0f && v.b <= 1.0f && v.a >= 0.0f && v.a <= 1.0f))
+            return false;
+    }
+
+    return true;
+}
+
+/*!
+Setup the vertex attributes (or the client side arrays for the fixed pipeline) for the bound vertex buffer.
+*/
+void sgct_core::CorrectionMesh::setVertexPointers(CorrectionMeshGeometry::VertexFormat format, bool fixedPipeline)
+{
+    GLsizei stride = sizeof(CorrectionMeshVertex);
+    GLenum positionType = GL_FLOAT;
+    GLenum texCoordType = GL_FLOAT;
+    GLenum colorType = GL_FLOAT;
+    std::size_t texCoordOffset = 8;
+    std::size_t colorOffset = 16;
+
+    if (format == CorrectionMeshGeometry::PACKED_VERTEX)
+    {
+        stride = sizeof(CorrectionMeshPackedVertex);
+        positionType = GL_SHORT;
+        texCoordType = GL_UNSIGNED_SHORT;
+        colorType = GL_UNSIGNED_BYTE;
+        texCoordOffset = 4;
+        colorOffset = 8;
+    }
+    else if (format == CorrectionMeshGeometry::COLOR_PACKED_VERTEX)
+    {
+        stride = sizeof(CorrectionMeshColorPackedVertex);
+        colorType = GL_UNSIGNED_BYTE;
+    }
+
+    if (fixedPipeline)
+    {
+        //unsigned byte colors are normalized by the fixed pipeline
+        glVertexPointer(2, positionType, stride, reinterpret_cast<void*>(0));
+        glTexCoordPointer(2, texCoordType, stride, reinterpret_cast<void*>(texCoordOffset));
+        glColorPointer(4, colorType, stride, reinterpret_cast<void*>(colorOffset));
+    }
+    else
+    {
+        GLboolean normalized = format == CorrectionMeshGeometry::PACKED_VERTEX ? GL_TRUE : GL_FALSE;
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(
+            0, // The attribute we want to configure
+            2,                           // size
+            positionType,                // type
+            normalized,                  // normalized?
+            stride,                      // stride
+            reinterpret_cast<void*>(0)   // array buffer offset
+        );
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(
+            1, // The attribute we want to configure
+            2,                           // size
+            texCoordType,                // type
+            normalized,                  // normalized?
+            stride,                      // stride
+            reinterpret_cast<void*>(texCoordOffset) // array buffer offset
+        );
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(
+            2, // The attribute we want to configure
+            4,                           // size
+            colorType,                   // type
+            colorType == GL_UNSIGNED_BYTE ? GL_TRUE : GL_FALSE, // normalized?
+            stride,                      // stride
+            reinterpret_cast<void*>(colorOffset) // array buffer offset
+        );
+    }
+}
+
 void sgct_core::CorrectionMesh::exportMesh(const std::string & exportMeshPath)
 {
     if (mGeometries[WARP_MESH].mGeometryType != GL_TRIANGLES && mGeometries[WARP_MESH].mGeometryType != GL_TRIANGLE_STRIP)
@@ -2375,11 +2732,206 @@ void sgct_core::CorrectionMesh::exportMesh(const std::string & exportMeshPath)
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CorrectionMesh error: Failed to export '%s'!\n", exportMeshPath.c_str());
 }
 
+/*!
+Get the filename of the binary cache for a mesh. The cache is stored beside the source mesh unless a cache directory is set.
+The name contains a hash of the source path, the format and the viewport geometry since the vertices depend on them.
+*/
+std::string sgct_core::CorrectionMesh::getMeshCacheFilename(const std::string & meshPath, Viewport * parent, MeshFormat fmt)
+{
+    std::string dir(sgct::SGCTSettings::instance()->getWarpingMeshCachePath());
+    std::string name(meshPath);
+
+    std::size_t found = meshPath.find_last_of("/\\");
+    if (found != std::string::npos)
+        name = meshPath.substr(found + 1);
+
+    if (dir.empty())
+    {
+        if (found != std::string::npos)
+            dir = meshPath.substr(0, found + 1);
+    }
+    else if (dir[dir.size() - 1] != '/' && dir[dir.size() - 1] != '\\')
+        dir.push_back('/');
+
+    float viewport[4] = { parent->getX(), parent->getY(), parent->getXSize(), parent->getYSize() };
+    uint32_t format = static_cast<uint32_t>(fmt);
+    uint64_t key = hashMeshData(reinterpret_cast<const unsigned char *>(meshPath.c_str()), meshPath.size());
+    key = hashMeshData(reinterpret_cast<const unsigned char *>(&format), sizeof(format), key);
+    key = hashMeshData(reinterpret_cast<const unsigned char *>(viewport), sizeof(viewport), key);
+
+    std::stringstream ss;
+    ss << dir << name << "." << std::hex << std::setw(16) << std::setfill('0') << key << ".sgctmesh";
+    return ss.str();
+}
+
+/*!
+Load the warping mesh from the binary cache. The cache stays memory mapped until generateMesh uploads it to the GPU
+straight from the mapping.
+
+@return false if there is no cache or if it is out of date
+*/
+bool sgct_core::CorrectionMesh::readMeshCache(const std::string & meshPath, Viewport * parent, MeshFormat fmt, const int * resolution)
+{
+    double t0 = sgct::Engine::getTime();
+    std::string cachePath = getMeshCacheFilename(meshPath, parent, fmt);
+
+    sgct_helpers::SGCTMappedFile * file = new sgct_helpers::SGCTMappedFile();
+    if (!file->open(cachePath.c_str()))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: No mesh cache found at '%s'.\n", cachePath.c_str());
+        delete file;
+        return false;
+    }
+
+    MeshCacheHeader header;
+    if (file->getSize() < sizeof(MeshCacheHeader))
+    {
+        delete file;
+        return false;
+    }
+    memcpy(&header, file->getData(), sizeof(MeshCacheHeader));
+
+    float viewport[4] = { parent->getX(), parent->getY(), parent->getXSize(), parent->getYSize() };
+    MeshCacheHeader optimization;
+    setMeshCacheOptimization(optimization, resolution);
+    std::size_t vertexOffset = sizeof(MeshCacheHeader) + header.pathLength;
+    std::size_t indexOffset = vertexOffset + static_cast<std::size_t>(header.numberOfVertices) * sizeof(CorrectionMeshVertex);
+
+    if (memcmp(header.magic, meshCacheMagic, sizeof(meshCacheMagic)) != 0 ||
+        header.version != MESH_CACHE_VERSION ||
+        header.vertexSize != sizeof(CorrectionMeshVertex) ||
+        header.format != static_cast<uint32_t>(fmt) ||
+        memcmp(header.viewport, viewport, sizeof(viewport)) != 0 ||
+        header.simplificationTolerance != optimization.simplificationTolerance ||
+        header.vertexCacheOptimized != optimization.vertexCacheOptimized ||
+        header.resolution[0] != optimization.resolution[0] || header.resolution[1] != optimization.resolution[1] ||
+        header.pathLength % 4 != 0 || header.numberOfVertices == 0 ||
+        file->getSize() != indexOffset + static_cast<std::size_t>(header.numberOfIndices) * sizeof(unsigned int) ||
+        strncmp(reinterpret_cast<const char *>(file->getData() + sizeof(MeshCacheHeader)), meshPath.c_str(), header.pathLength) != 0)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "CorrectionMesh: Mesh cache '%s' is invalid and will be regenerated.\n", cachePath.c_str());
+        delete file;
+        return false;
+    }
+
+    //the content hash is only checked if the modification time differs (for example when copied to another node)
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    uint64_t sourceHash;
+    if (!getMeshSourceInfo(meshPath, sourceSize, sourceModified) || sourceSize != header.sourceSize ||
+        (sourceModified != header.sourceModified && (!hashMeshSource(meshPath, sourceHash) || sourceHash != header.sourceHash)))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "CorrectionMesh: Mesh cache '%s' is out of date and will be regenerated.\n", cachePath.c_str());
+        delete file;
+        return false;
+    }
+
+    const CorrectionMeshVertex * vertices = reinterpret_cast<const CorrectionMeshVertex *>(file->getData() + vertexOffset);
+    const unsigned int * indices = reinterpret_cast<const unsigned int *>(file->getData() + indexOffset);
+
+    for (unsigned int i = 0; i < header.numberOfIndices; i++)
+        if (indices[i] >= header.numberOfVertices)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Mesh cache '%s' is corrupt and will be regenerated.\n", cachePath.c_str());
+            delete file;
+            return false;
+        }
+
+    mGeometries[WARP_MESH].mGeometryType = static_cast<GLenum>(header.geometryType);
+    mGeometries[WARP_MESH].mNumberOfVertices = header.numberOfVertices;
+    mGeometries[WARP_MESH].mNumberOfIndices = header.numberOfIndices;
+
+    releasePendingMesh(WARP_MESH);
+    mPendingVertices[WARP_MESH] = vertices;
+    mPendingIndices[WARP_MESH] = indices;
+    mMeshCacheFile = file;
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "CorrectionMesh: Loaded cached mesh '%s' in %.2f ms. Vertices=%u, Indices=%u.\n",
+        cachePath.c_str(), (sgct::Engine::getTime() - t0)*1000.0, header.numberOfVertices, header.numberOfIndices);
+    return true;
+}
+
+/*!
+Write the parsed warping mesh to the binary cache. The file is written to a temporary file first and then renamed
+so that nodes sharing a cache directory never read a partially written cache.
+*/
+void sgct_core::CorrectionMesh::writeMeshCache(const std::string & meshPath, Viewport * parent, MeshFormat fmt, const int * resolution)
+{
+    if (mTempVertices == NULL || mTempIndices == NULL)
+        return;
+
+    MeshCacheHeader header;
+    memset(&header, 0, sizeof(MeshCacheHeader));
+    memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+    header.version = MESH_CACHE_VERSION;
+    header.vertexSize = sizeof(CorrectionMeshVertex);
+    if (!getMeshSourceInfo(meshPath, header.sourceSize, header.sourceModified) || !hashMeshSource(meshPath, header.sourceHash))
+        return;
+    header.viewport[0] = parent->getX();
+    header.viewport[1] = parent->getY();
+    header.viewport[2] = parent->getXSize();
+    header.viewport[3] = parent->getYSize();
+    header.format = static_cast<uint32_t>(fmt);
+    header.geometryType = static_cast<uint32_t>(mGeometries[WARP_MESH].mGeometryType);
+    header.numberOfVertices = mGeometries[WARP_MESH].mNumberOfVertices;
+    header.numberOfIndices = mGeometries[WARP_MESH].mNumberOfIndices;
+    header.pathLength = static_cast<uint32_t>((meshPath.size() + 4) & ~static_cast<std::size_t>(3)); //null terminated and padded
+    setMeshCacheOptimization(header, resolution);
+
+    std::string cachePath = getMeshCacheFilename(meshPath, parent, fmt);
+    std::stringstream ss;
+    ss << cachePath << ".tmp" << ClusterManager::instance()->getThisNodeId();
+    std::string tmpPath = ss.str();
+
+    FILE * cacheFile = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&cacheFile, tmpPath.c_str(), "wb") != 0)
+        cacheFile = NULL;
+#else
+    cacheFile = fopen(tmpPath.c_str(), "wb");
+#endif
+    if (cacheFile == NULL)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Failed to write mesh cache '%s'!\n", cachePath.c_str());
+        return;
+    }
+
+    std::vector<char> path(header.pathLength, '\0');
+    memcpy(&path[0], meshPath.c_str(), meshPath.size());
+
+    bool success = fwrite(&header, sizeof(MeshCacheHeader), 1, cacheFile) == 1 &&
+        fwrite(&path[0], path.size(), 1, cacheFile) == 1 &&
+        fwrite(mTempVertices, sizeof(CorrectionMeshVertex), header.numberOfVertices, cacheFile) == header.numberOfVertices &&
+        fwrite(mTempIndices, sizeof(unsigned int), header.numberOfIndices, cacheFile) == header.numberOfIndices;
+    success = (fclose(cacheFile) == 0) && success;
+
+    remove(cachePath.c_str());
+    if (!success || rename(tmpPath.c_str(), cachePath.c_str()) != 0)
+    {
+        remove(tmpPath.c_str());
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Failed to write mesh cache '%s'!\n", cachePath.c_str());
+        return;
+    }
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Mesh cache '%s' written.\n", cachePath.c_str());
+}
+
 void sgct_core::CorrectionMesh::cleanUp()
 {
-    delete[] mTempVertices;
+    //data handed over by createMesh is released by generateMesh
+    bool pendingVertices = false;
+    bool pendingIndices = false;
+    for (int i = 0; i < LAST_MESH; i++)
+    {
+        pendingVertices |= (mTempVertices == mPendingVertices[i]);
+        pendingIndices |= (mTempIndices == mPendingIndices[i]);
+    }
+
+    if (!pendingVertices)
+        delete[] mTempVertices;
     mTempVertices = NULL;
-    delete[] mTempIndices;
+    if (!pendingIndices)
+        delete[] mTempIndices;
     mTempIndices = NULL;
 }
 
@@ -2397,6 +2949,8 @@ Render the final mesh where for mapping the frame buffer to the screen
 */
 void sgct_core::CorrectionMesh::render(const MeshType & mt)
 {
+    SGCT_TRACE_SCOPE("CorrectionMesh::render");
+
     //for test
     //glDisable(GL_CULL_FACE);
 
@@ -2419,9 +2973,7 @@ void sgct_core::CorrectionMesh::render(const MeshType & mt)
             glBindBuffer(GL_ARRAY_BUFFER, geomPtr->mMeshData[Vertex]);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geomPtr->mMeshData[Index]);
         
-            glVertexPointer(2, GL_FLOAT, sizeof(CorrectionMeshVertex), reinterpret_cast<void*>(0));        
-            glTexCoordPointer(2, GL_FLOAT, sizeof(CorrectionMeshVertex), reinterpret_cast<void*>(8));
-            glColorPointer(4, GL_FLOAT, sizeof(CorrectionMeshVertex), reinterpret_cast<void*>(16));
+            setVertexPointers(geomPtr->mVertexFormat, true);
 
             glDrawElements(geomPtr->mGeometryType, geomPtr->mNumberOfIndices, GL_UNSIGNED_INT, NULL);
         
@@ -2449,6 +3001,25 @@ void sgct_core::CorrectionMesh::render(const MeshType & mt)
     //glEnable(GL_CULL_FACE);
 }
 
+/*!
+Parse warp map format from string to enum.
+*/
+sgct_core::CorrectionMesh::WarpMapFormat sgct_core::CorrectionMesh::parseWarpMapFormat(const std::string & formatStr)
+{
+    //transform to lowercase
+    std::string str(formatStr);
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+
+    if (str == "rg16" || str == "true")
+        return RG16_WARP_MAP;
+    else if (str == "rg32f")
+        return RG32F_WARP_MAP;
+    else if (str != "none" && str != "false")
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CorrectionMesh: Unknown warp map format '%s'!\n", formatStr.c_str());
+
+    return NO_WARP_MAP;
+}
+
 /*!
 Parse hint from string to enum.
 */
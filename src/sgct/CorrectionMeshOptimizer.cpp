@@ -0,0 +1,733 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/CorrectionMeshOptimizer.h>
+#include <math.h>
+#include <algorithm>
+#include <utility>
+
+//vertex cache size used by the Forsyth optimization and when calculating the ACMR
+#define VERTEX_CACHE_SIZE 32
+#define MAX_SIMPLIFICATION_PASSES 32
+//longest edge in pixels created by simplification, keeps the work per collapse bounded
+#define MAX_EDGE_LENGTH 64.0
+
+/*
+    Vertex score used by Forsyth's vertex cache optimization (see https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html)
+*/
+static float calculateVertexScore(int cachePosition, unsigned int activeTriangles)
+{
+    if (activeTriangles == 0)
+        return -1.0f; //no triangles left using this vertex
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3) //used by the last triangle
+            score = 0.75f;
+        else
+            score = powf(1.0f - static_cast<float>(cachePosition - 3) / static_cast<float>(VERTEX_CACHE_SIZE - 3), 1.5f);
+    }
+
+    //bonus for vertices with few triangles left so that they are finished
+    score += 2.0f / sqrtf(static_cast<float>(activeTriangles));
+    return score;
+}
+
+sgct_core::CorrectionMeshOptimizer::CorrectionMeshOptimizer(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices, const unsigned int * indices, unsigned int numberOfIndices)
+{
+    mVertices.assign(vertices, vertices + numberOfVertices);
+    mIndices.assign(indices, indices + (numberOfIndices - numberOfIndices % 3));
+
+    mScaleX = 1.0;
+    mScaleY = 1.0;
+    mMaxOriginalEdgeLength = 0.0;
+    mTolerance = 0.0f;
+    mColorTolerance = 0.0f;
+    mMaxError = 0.0f;
+}
+
+/*!
+    Simplify the mesh by collapsing edges in regions where the mesh is nearly linear.
+
+    \param pixelTolerance the maximum allowed change of texture coordinates and border positions in pixels
+    \param resolutionX the horizontal resolution of the framebuffer the texture coordinates refer to
+    \param resolutionY the vertical resolution of the framebuffer the texture coordinates refer to
+    \param colorTolerance the maximum allowed change of the blend colors
+*/
+void sgct_core::CorrectionMeshOptimizer::simplify(float pixelTolerance, int resolutionX, int resolutionY, float colorTolerance)
+{
+    if (pixelTolerance <= 0.0f || resolutionX <= 0 || resolutionY <= 0 || mIndices.empty())
+        return;
+
+    //vertex positions are in normalized device coordinates [-1, 1]
+    mScaleX = static_cast<double>(resolutionX) * 0.5;
+    mScaleY = static_cast<double>(resolutionY) * 0.5;
+    mTolerance = pixelTolerance;
+    mColorTolerance = colorTolerance;
+
+    std::size_t numberOfTriangles = mIndices.size() / 3;
+    std::size_t numberOfVertices = mVertices.size();
+
+    mVertexTriangles.assign(numberOfVertices, std::vector<std::size_t>());
+    mTrianglePoints.assign(numberOfTriangles, std::vector<unsigned int>());
+    mPointErrors.assign(numberOfVertices, 0.0f);
+    mTriangleRemoved.assign(numberOfTriangles, 0);
+    mVertexLocked.assign(numberOfVertices, 0);
+    mVertexRemoved.assign(numberOfVertices, 0);
+    mVertexBorder.assign(numberOfVertices, 0);
+    mVertexDirty.assign(numberOfVertices, 1);
+    mMaxError = 0.0f;
+
+    for (std::size_t t = 0; t < numberOfTriangles; t++)
+    {
+        for (std::size_t k = 0; k < 3; k++)
+            mVertexTriangles[mIndices[t * 3 + k]].push_back(t);
+
+        //degenerate triangles can't be used to interpolate
+        if (fabs(signedArea(mIndices[t * 3], mIndices[t * 3 + 1], mIndices[t * 3 + 2])) < 1e-9)
+            for (std::size_t k = 0; k < 3; k++)
+                mVertexLocked[mIndices[t * 3 + k]] = 1;
+    }
+
+    //vertices sharing the same position (seams) are kept so that no cracks appear
+    std::vector<unsigned int> sorted(numberOfVertices);
+    for (unsigned int i = 0; i < numberOfVertices; i++)
+        sorted[i] = i;
+    std::sort(sorted.begin(), sorted.end(), [this](unsigned int a, unsigned int b)
+    {
+        return mVertices[a].x < mVertices[b].x || (mVertices[a].x == mVertices[b].x && mVertices[a].y < mVertices[b].y);
+    });
+    for (std::size_t i = 1; i < numberOfVertices; i++)
+        if (mVertices[sorted[i]].x == mVertices[sorted[i - 1]].x && mVertices[sorted[i]].y == mVertices[sorted[i - 1]].y)
+        {
+            mVertexLocked[sorted[i]] = 1;
+            mVertexLocked[sorted[i - 1]] = 1;
+        }
+
+    //find border and non-manifold vertices and store the edges of the original mesh
+    std::vector<unsigned int> neighbors;
+    std::vector<unsigned int> counts;
+    mOriginalNeighborOffsets.assign(numberOfVertices + 1, 0);
+    mOriginalNeighbors.clear();
+    mMaxOriginalEdgeLength = 0.0;
+    for (unsigned int v = 0; v < numberOfVertices; v++)
+    {
+        mOriginalNeighborOffsets[v] = mOriginalNeighbors.size();
+        if (mVertexTriangles[v].empty())
+        {
+            mVertexRemoved[v] = 1; //not used
+            continue;
+        }
+
+        getNeighbors(v, neighbors, counts);
+        mOriginalNeighbors.insert(mOriginalNeighbors.end(), neighbors.begin(), neighbors.end());
+        for (std::size_t i = 0; i < neighbors.size(); i++)
+            mMaxOriginalEdgeLength = std::max(mMaxOriginalEdgeLength, distanceToEdge(v, neighbors[i], neighbors[i]));
+        unsigned int borderEdges = 0;
+        for (std::size_t i = 0; i < counts.size(); i++)
+        {
+            if (counts[i] == 1)
+                borderEdges++;
+            else if (counts[i] > 2)
+                mVertexLocked[v] = 1;
+        }
+
+        if (borderEdges > 0)
+        {
+            mVertexBorder[v] = 1;
+            if (borderEdges != 2) //corner of several borders
+                mVertexLocked[v] = 1;
+        }
+    }
+    mOriginalNeighborOffsets[numberOfVertices] = mOriginalNeighbors.size();
+
+    //greedy collapses, shortest edges first
+    std::vector< std::pair<double, unsigned int> > candidates;
+    for (int pass = 0; pass < MAX_SIMPLIFICATION_PASSES; pass++)
+    {
+        std::size_t collapses = 0;
+        for (unsigned int u = 0; u < numberOfVertices; u++)
+        {
+            if (mVertexRemoved[u] || mVertexLocked[u] || !mVertexDirty[u])
+                continue;
+
+            //only retried when the surrounding triangles change
+            mVertexDirty[u] = 0;
+
+            getNeighbors(u, neighbors, counts);
+            candidates.clear();
+            for (std::size_t i = 0; i < neighbors.size(); i++)
+            {
+                double dx = (mVertices[neighbors[i]].x - mVertices[u].x) * mScaleX;
+                double dy = (mVertices[neighbors[i]].y - mVertices[u].y) * mScaleY;
+                candidates.push_back(std::make_pair(dx * dx + dy * dy, neighbors[i]));
+            }
+            std::sort(candidates.begin(), candidates.end());
+
+            for (std::size_t i = 0; i < candidates.size(); i++)
+                if (tryCollapse(u, candidates[i].second))
+                {
+                    collapses++;
+                    break;
+                }
+        }
+
+        if (collapses == 0)
+            break;
+    }
+
+    for (std::size_t i = 0; i < numberOfVertices; i++)
+        if (mVertexRemoved[i] && mPointErrors[i] > mMaxError)
+            mMaxError = mPointErrors[i];
+
+    compact();
+
+    //release the simplification state
+    std::vector< std::vector<std::size_t> >().swap(mVertexTriangles);
+    std::vector< std::vector<unsigned int> >().swap(mTrianglePoints);
+    std::vector<float>().swap(mPointErrors);
+    std::vector<unsigned char>().swap(mTriangleRemoved);
+    std::vector<unsigned char>().swap(mVertexLocked);
+    std::vector<unsigned char>().swap(mVertexRemoved);
+    std::vector<unsigned char>().swap(mVertexBorder);
+    std::vector<unsigned char>().swap(mVertexDirty);
+    std::vector<std::size_t>().swap(mOriginalNeighborOffsets);
+    std::vector<unsigned int>().swap(mOriginalNeighbors);
+}
+
+/*!
+    Reorder the triangles for the post-transform vertex cache and the vertices in order of first use.
+*/
+void sgct_core::CorrectionMeshOptimizer::optimizeVertexCache()
+{
+    std::size_t numberOfTriangles = mIndices.size() / 3;
+    std::size_t numberOfVertices = mVertices.size();
+    if (numberOfTriangles == 0)
+        return;
+
+    //triangles using each vertex
+    std::vector<unsigned int> activeTriangles(numberOfVertices, 0);
+    for (std::size_t i = 0; i < mIndices.size(); i++)
+        activeTriangles[mIndices[i]]++;
+
+    std::vector<std::size_t> offsets(numberOfVertices + 1, 0);
+    for (std::size_t v = 0; v < numberOfVertices; v++)
+        offsets[v + 1] = offsets[v] + activeTriangles[v];
+
+    std::vector<std::size_t> vertexTriangles(mIndices.size());
+    std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t t = 0; t < numberOfTriangles; t++)
+        for (std::size_t k = 0; k < 3; k++)
+            vertexTriangles[fill[mIndices[t * 3 + k]]++] = t;
+
+    std::vector<int> cachePositions(numberOfVertices, -1);
+    std::vector<float> vertexScores(numberOfVertices);
+    for (std::size_t v = 0; v < numberOfVertices; v++)
+        vertexScores[v] = calculateVertexScore(-1, activeTriangles[v]);
+
+    std::vector<float> triangleScores(numberOfTriangles);
+    std::vector<unsigned char> triangleAdded(numberOfTriangles, 0);
+    std::size_t bestTriangle = 0;
+    for (std::size_t t = 0; t < numberOfTriangles; t++)
+    {
+        triangleScores[t] = vertexScores[mIndices[t * 3]] + vertexScores[mIndices[t * 3 + 1]] + vertexScores[mIndices[t * 3 + 2]];
+        if (triangleScores[t] > triangleScores[bestTriangle])
+            bestTriangle = t;
+    }
+
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> newCache;
+    std::vector<unsigned int> newIndices;
+    newIndices.reserve(mIndices.size());
+    std::size_t nextUnadded = 0;
+
+    for (std::size_t i = 0; i < numberOfTriangles; i++)
+    {
+        if (bestTriangle == numberOfTriangles) //nothing in the cache, continue with the next triangle not added
+        {
+            while (triangleAdded[nextUnadded])
+                nextUnadded++;
+            bestTriangle = nextUnadded;
+        }
+
+        triangleAdded[bestTriangle] = 1;
+        newCache.clear();
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            unsigned int v = mIndices[bestTriangle * 3 + k];
+            newIndices.push_back(v);
+            activeTriangles[v]--;
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                newCache.push_back(v);
+        }
+
+        for (std::size_t c = 0; c < cache.size(); c++)
+            if (std::find(newCache.begin(), newCache.end(), cache[c]) == newCache.end())
+                newCache.push_back(cache[c]);
+
+        //update vertex scores, vertices pushed out of the cache lose their cache bonus
+        for (std::size_t c = 0; c < newCache.size(); c++)
+        {
+            unsigned int v = newCache[c];
+            cachePositions[v] = c < VERTEX_CACHE_SIZE ? static_cast<int>(c) : -1;
+            vertexScores[v] = calculateVertexScore(cachePositions[v], activeTriangles[v]);
+        }
+
+        //update the triangle scores and find the best triangle using the cached vertices
+        bestTriangle = numberOfTriangles;
+        float bestScore = -1.0f;
+        for (std::size_t c = 0; c < newCache.size(); c++)
+        {
+            unsigned int v = newCache[c];
+            for (std::size_t j = offsets[v]; j < offsets[v + 1]; j++)
+            {
+                std::size_t t = vertexTriangles[j];
+                if (triangleAdded[t])
+                    continue;
+
+                triangleScores[t] = vertexScores[mIndices[t * 3]] + vertexScores[mIndices[t * 3 + 1]] + vertexScores[mIndices[t * 3 + 2]];
+                if (triangleScores[t] > bestScore)
+                {
+                    bestScore = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (newCache.size() > VERTEX_CACHE_SIZE)
+            newCache.resize(VERTEX_CACHE_SIZE);
+        cache.swap(newCache);
+    }
+
+    mIndices.swap(newIndices);
+    compact();
+}
+
+/*!
+    Calculate the average cache miss ratio (vertex shader invocations per triangle) for a FIFO vertex cache.
+    The ratio is between 0.5 (ideal for large grids) and 3.0 (no reuse).
+*/
+float sgct_core::CorrectionMeshOptimizer::calculateACMR(const unsigned int * indices, unsigned int numberOfIndices, unsigned int cacheSize)
+{
+    if (numberOfIndices < 3 || cacheSize == 0)
+        return 0.0f;
+
+    std::vector<unsigned int> cache(cacheSize, 0xFFFFFFFFu);
+    std::size_t head = 0;
+    std::size_t misses = 0;
+    for (unsigned int i = 0; i < numberOfIndices; i++)
+    {
+        if (std::find(cache.begin(), cache.end(), indices[i]) == cache.end())
+        {
+            cache[head] = indices[i];
+            head = (head + 1) % cacheSize;
+            misses++;
+        }
+    }
+
+    return static_cast<float>(misses) / static_cast<float>(numberOfIndices / 3);
+}
+
+/*
+    Collapse the vertex 'from' into its neighbor 'to' if the mesh stays valid and within the tolerance.
+*/
+bool sgct_core::CorrectionMeshOptimizer::tryCollapse(unsigned int from, unsigned int to)
+{
+    const std::vector<std::size_t> & triangles = mVertexTriangles[from];
+
+    std::vector<std::size_t> sharedTriangles;
+    std::vector<std::size_t> changedTriangles;
+    std::vector<unsigned int> opposite;
+    for (std::size_t i = 0; i < triangles.size(); i++)
+    {
+        std::size_t t = triangles[i];
+        unsigned int * tri = &mIndices[t * 3];
+        if (tri[0] == to || tri[1] == to || tri[2] == to)
+        {
+            sharedTriangles.push_back(t);
+            for (std::size_t k = 0; k < 3; k++)
+                if (tri[k] != to && tri[k] != from)
+                    opposite.push_back(tri[k]);
+        }
+        else
+            changedTriangles.push_back(t);
+    }
+
+    //border vertices can only move along the border
+    if (sharedTriangles.size() != (mVertexBorder[from] ? 1u : 2u))
+        return false;
+    if (changedTriangles.empty())
+        return false;
+
+    //the vertices may only share the neighbors of the removed triangles, otherwise the mesh folds
+    std::vector<unsigned int> fromNeighbors;
+    std::vector<unsigned int> toNeighbors;
+    std::vector<unsigned int> counts;
+    getNeighbors(from, fromNeighbors, counts);
+    getNeighbors(to, toNeighbors, counts);
+    for (std::size_t i = 0; i < fromNeighbors.size(); i++)
+        if (fromNeighbors[i] != to &&
+            std::find(toNeighbors.begin(), toNeighbors.end(), fromNeighbors[i]) != toNeighbors.end() &&
+            std::find(opposite.begin(), opposite.end(), fromNeighbors[i]) == opposite.end())
+            return false;
+
+    //move the vertex, no triangle may flip or degenerate
+    std::vector<double> oldAreas(changedTriangles.size());
+    for (std::size_t i = 0; i < changedTriangles.size(); i++)
+    {
+        unsigned int * tri = &mIndices[changedTriangles[i] * 3];
+        oldAreas[i] = signedArea(tri[0], tri[1], tri[2]);
+        for (std::size_t k = 0; k < 3; k++)
+            if (tri[k] == from)
+                tri[k] = to;
+    }
+
+    bool valid = true;
+    for (std::size_t i = 0; i < changedTriangles.size() && valid; i++)
+    {
+        unsigned int * tri = &mIndices[changedTriangles[i] * 3];
+        double area = signedArea(tri[0], tri[1], tri[2]);
+        if (fabs(area) < 1e-9 || (area > 0.0) != (oldAreas[i] > 0.0))
+            valid = false;
+    }
+
+    //new edges can't be too long
+    for (std::size_t i = 0; i < fromNeighbors.size() && valid; i++)
+    {
+        double dx = (mVertices[fromNeighbors[i]].x - mVertices[to].x) * mScaleX;
+        double dy = (mVertices[fromNeighbors[i]].y - mVertices[to].y) * mScaleY;
+        if (dx * dx + dy * dy > MAX_EDGE_LENGTH * MAX_EDGE_LENGTH)
+            valid = false;
+    }
+
+    //all removed vertices covered by the old triangles must be represented within the tolerance by the new ones
+    std::vector<unsigned int> points;
+    std::vector<PointLocation> locations;
+    std::vector<float> errors;
+    if (valid)
+    {
+        points.push_back(from);
+        for (std::size_t i = 0; i < triangles.size(); i++)
+            points.insert(points.end(), mTrianglePoints[triangles[i]].begin(), mTrianglePoints[triangles[i]].end());
+
+        locations.resize(points.size());
+        errors.resize(points.size());
+        for (std::size_t i = 0; i < points.size() && valid; i++)
+        {
+            float colorError;
+            if (!locatePoint(points[i], changedTriangles, locations[i]))
+                valid = false;
+            else
+            {
+                errors[i] = evaluateError(points[i], locations[i], colorError);
+                if (errors[i] > mTolerance || colorError > mColorTolerance)
+                    valid = false;
+            }
+        }
+    }
+
+    /*
+        Both meshes are linear between the original vertices and the points where the new edges cross the original edges,
+        so the error must also be checked at these crossings. The original edges are found from the vertices in the area.
+    */
+    float edgeError = 0.0f;
+    if (valid)
+    {
+        points.push_back(to);
+        points.insert(points.end(), fromNeighbors.begin(), fromNeighbors.end());
+        for (std::size_t i = 0; i < points.size() && valid; i++)
+        {
+            unsigned int a = points[i];
+            for (std::size_t k = 0; k < fromNeighbors.size() && valid; k++)
+            {
+                //only edges starting close to the new edge can cross it
+                if (distanceToEdge(a, to, fromNeighbors[k]) > mMaxOriginalEdgeLength)
+                    continue;
+
+                for (std::size_t j = mOriginalNeighborOffsets[a]; j < mOriginalNeighborOffsets[a + 1] && valid; j++)
+                {
+                    float colorError;
+                    float error = evaluateCrossingError(a, mOriginalNeighbors[j], to, fromNeighbors[k], colorError);
+                    if (error > mTolerance || colorError > mColorTolerance)
+                        valid = false;
+                    edgeError = std::max(edgeError, error);
+                }
+            }
+        }
+        points.resize(points.size() - fromNeighbors.size() - 1);
+    }
+
+    if (!valid)
+    {
+        //restore
+        for (std::size_t i = 0; i < changedTriangles.size(); i++)
+        {
+            unsigned int * tri = &mIndices[changedTriangles[i] * 3];
+            for (std::size_t k = 0; k < 3; k++)
+                if (tri[k] == to)
+                {
+                    tri[k] = from;
+                    break;
+                }
+        }
+        return false;
+    }
+
+    //apply
+    for (std::size_t i = 0; i < sharedTriangles.size(); i++)
+    {
+        std::size_t t = sharedTriangles[i];
+        mTriangleRemoved[t] = 1;
+        mTrianglePoints[t].clear();
+        for (std::size_t k = 0; k < 3; k++)
+            if (mIndices[t * 3 + k] != from)
+                removeVertexTriangle(mIndices[t * 3 + k], t);
+    }
+
+    for (std::size_t i = 0; i < changedTriangles.size(); i++)
+    {
+        mTrianglePoints[changedTriangles[i]].clear();
+        mVertexTriangles[to].push_back(changedTriangles[i]);
+    }
+
+    mVertexTriangles[from].clear();
+    mVertexRemoved[from] = 1;
+    mMaxError = std::max(mMaxError, edgeError);
+
+    //the neighbors of 'to' got new triangles and can be tried again
+    getNeighbors(to, toNeighbors, counts);
+    mVertexDirty[to] = 1;
+    for (std::size_t i = 0; i < toNeighbors.size(); i++)
+        mVertexDirty[toNeighbors[i]] = 1;
+
+    for (std::size_t i = 0; i < points.size(); i++)
+    {
+        mTrianglePoints[locations[i].triangle].push_back(points[i]);
+        mPointErrors[points[i]] = errors[i];
+    }
+
+    return true;
+}
+
+/*
+    Find the triangle containing the original position of a vertex. Points outside all triangles (at straightened borders)
+    are mapped to the closest point if it is within the tolerance.
+*/
+bool sgct_core::CorrectionMeshOptimizer::locatePoint(unsigned int point, const std::vector<std::size_t> & triangles, PointLocation & location)
+{
+    double px = mVertices[point].x * mScaleX;
+    double py = mVertices[point].y * mScaleY;
+
+    location.distance = 1e30;
+    for (std::size_t i = 0; i < triangles.size(); i++)
+    {
+        const unsigned int * tri = &mIndices[triangles[i] * 3];
+        double x[3], y[3];
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            x[k] = mVertices[tri[k]].x * mScaleX;
+            y[k] = mVertices[tri[k]].y * mScaleY;
+        }
+
+        double d = (y[1] - y[2]) * (x[0] - x[2]) + (x[2] - x[1]) * (y[0] - y[2]);
+        double w0 = ((y[1] - y[2]) * (px - x[2]) + (x[2] - x[1]) * (py - y[2])) / d;
+        double w1 = ((y[2] - y[0]) * (px - x[2]) + (x[0] - x[2]) * (py - y[2])) / d;
+        double w2 = 1.0 - w0 - w1;
+
+        if (w0 >= -1e-9 && w1 >= -1e-9 && w2 >= -1e-9)
+        {
+            location.triangle = triangles[i];
+            location.weights[0] = w0;
+            location.weights[1] = w1;
+            location.weights[2] = w2;
+            location.distance = 0.0;
+            return true;
+        }
+
+        //closest point on the edges
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            std::size_t j = (k + 1) % 3;
+            double ex = x[j] - x[k];
+            double ey = y[j] - y[k];
+            double lengthSquared = ex * ex + ey * ey;
+            double s = lengthSquared > 0.0 ? ((px - x[k]) * ex + (py - y[k]) * ey) / lengthSquared : 0.0;
+            s = s < 0.0 ? 0.0 : (s > 1.0 ? 1.0 : s);
+            double dx = x[k] + s * ex - px;
+            double dy = y[k] + s * ey - py;
+            double distance = sqrt(dx * dx + dy * dy);
+            if (distance < location.distance)
+            {
+                location.triangle = triangles[i];
+                location.weights[k] = 1.0 - s;
+                location.weights[j] = s;
+                location.weights[3 - k - j] = 0.0;
+                location.distance = distance;
+            }
+        }
+    }
+
+    return location.distance <= mTolerance;
+}
+
+/*
+    \returns the texture coordinate error in pixels (including the position error for points outside the mesh)
+*/
+float sgct_core::CorrectionMeshOptimizer::evaluateError(unsigned int point, const PointLocation & location, float & colorError)
+{
+    const unsigned int * tri = &mIndices[location.triangle * 3];
+    const CorrectionMeshVertex & v0 = mVertices[tri[0]];
+    const CorrectionMeshVertex & v1 = mVertices[tri[1]];
+    const CorrectionMeshVertex & v2 = mVertices[tri[2]];
+    const CorrectionMeshVertex & p = mVertices[point];
+    const double * w = location.weights;
+
+    double s = w[0] * v0.s + w[1] * v1.s + w[2] * v2.s;
+    double t = w[0] * v0.t + w[1] * v1.t + w[2] * v2.t;
+    double error = std::max(fabs(s - p.s) * mScaleX * 2.0, fabs(t - p.t) * mScaleY * 2.0);
+    error = std::max(error, location.distance);
+
+    colorError = static_cast<float>(std::max(
+        std::max(fabs(w[0] * v0.r + w[1] * v1.r + w[2] * v2.r - p.r), fabs(w[0] * v0.g + w[1] * v1.g + w[2] * v2.g - p.g)),
+        std::max(fabs(w[0] * v0.b + w[1] * v1.b + w[2] * v2.b - p.b), fabs(w[0] * v0.a + w[1] * v1.a + w[2] * v2.a - p.a))));
+
+    return static_cast<float>(error);
+}
+
+/*
+    \returns the texture coordinate error in pixels where the original edge a-b crosses the new edge p-q, 0 if they don't cross
+*/
+float sgct_core::CorrectionMeshOptimizer::evaluateCrossingError(unsigned int a, unsigned int b, unsigned int p, unsigned int q, float & colorError)
+{
+    colorError = 0.0f;
+    if (a == p || a == q || b == p || b == q)
+        return 0.0f;
+
+    const CorrectionMeshVertex & va = mVertices[a];
+    const CorrectionMeshVertex & vb = mVertices[b];
+    const CorrectionMeshVertex & vp = mVertices[p];
+    const CorrectionMeshVertex & vq = mVertices[q];
+
+    double abx = (vb.x - va.x) * mScaleX;
+    double aby = (vb.y - va.y) * mScaleY;
+    double pqx = (vq.x - vp.x) * mScaleX;
+    double pqy = (vq.y - vp.y) * mScaleY;
+    double apx = (vp.x - va.x) * mScaleX;
+    double apy = (vp.y - va.y) * mScaleY;
+
+    double d = abx * pqy - aby * pqx;
+    if (fabs(d) < 1e-12)
+        return 0.0f; //parallel
+
+    double u = (apx * pqy - apy * pqx) / d; //position along a-b
+    double v = (apx * aby - apy * abx) / d; //position along p-q
+    if (u <= 0.0 || u >= 1.0 || v <= 0.0 || v >= 1.0)
+        return 0.0f;
+
+    double error = std::max(
+        fabs((va.s + u * (vb.s - va.s)) - (vp.s + v * (vq.s - vp.s))) * mScaleX * 2.0,
+        fabs((va.t + u * (vb.t - va.t)) - (vp.t + v * (vq.t - vp.t))) * mScaleY * 2.0);
+
+    colorError = static_cast<float>(std::max(
+        std::max(fabs((va.r + u * (vb.r - va.r)) - (vp.r + v * (vq.r - vp.r))), fabs((va.g + u * (vb.g - va.g)) - (vp.g + v * (vq.g - vp.g)))),
+        std::max(fabs((va.b + u * (vb.b - va.b)) - (vp.b + v * (vq.b - vp.b))), fabs((va.a + u * (vb.a - va.a)) - (vp.a + v * (vq.a - vp.a))))));
+
+    return static_cast<float>(error);
+}
+
+//! \returns the distance in pixels from a vertex to the edge p-q
+double sgct_core::CorrectionMeshOptimizer::distanceToEdge(unsigned int vertex, unsigned int p, unsigned int q)
+{
+    double px = (mVertices[vertex].x - mVertices[p].x) * mScaleX;
+    double py = (mVertices[vertex].y - mVertices[p].y) * mScaleY;
+    double ex = (mVertices[q].x - mVertices[p].x) * mScaleX;
+    double ey = (mVertices[q].y - mVertices[p].y) * mScaleY;
+    double lengthSquared = ex * ex + ey * ey;
+    double s = lengthSquared > 0.0 ? (px * ex + py * ey) / lengthSquared : 0.0;
+    s = s < 0.0 ? 0.0 : (s > 1.0 ? 1.0 : s);
+    double dx = px - s * ex;
+    double dy = py - s * ey;
+    return sqrt(dx * dx + dy * dy);
+}
+
+//! \returns the signed area in square pixels
+double sgct_core::CorrectionMeshOptimizer::signedArea(unsigned int v0, unsigned int v1, unsigned int v2)
+{
+    double x0 = mVertices[v0].x * mScaleX;
+    double y0 = mVertices[v0].y * mScaleY;
+    double x1 = mVertices[v1].x * mScaleX;
+    double y1 = mVertices[v1].y * mScaleY;
+    double x2 = mVertices[v2].x * mScaleX;
+    double y2 = mVertices[v2].y * mScaleY;
+    return 0.5 * ((x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0));
+}
+
+/*
+    Get the vertices connected to a vertex and the number of triangles sharing each edge.
+*/
+void sgct_core::CorrectionMeshOptimizer::getNeighbors(unsigned int vertex, std::vector<unsigned int> & neighbors, std::vector<unsigned int> & counts)
+{
+    neighbors.clear();
+    counts.clear();
+
+    const std::vector<std::size_t> & triangles = mVertexTriangles[vertex];
+    for (std::size_t i = 0; i < triangles.size(); i++)
+        for (std::size_t k = 0; k < 3; k++)
+        {
+            unsigned int v = mIndices[triangles[i] * 3 + k];
+            if (v == vertex)
+                continue;
+
+            std::vector<unsigned int>::iterator it = std::find(neighbors.begin(), neighbors.end(), v);
+            if (it == neighbors.end())
+            {
+                neighbors.push_back(v);
+                counts.push_back(1);
+            }
+            else
+                counts[it - neighbors.begin()]++;
+        }
+}
+
+void sgct_core::CorrectionMeshOptimizer::removeVertexTriangle(unsigned int vertex, std::size_t triangle)
+{
+    std::vector<std::size_t> & triangles = mVertexTriangles[vertex];
+    std::vector<std::size_t>::iterator it = std::find(triangles.begin(), triangles.end(), triangle);
+    if (it != triangles.end())
+        triangles.erase(it);
+}
+
+/*
+    Remove collapsed triangles and unused vertices and store the vertices in order of first use.
+*/
+void sgct_core::CorrectionMeshOptimizer::compact()
+{
+    std::vector<unsigned int> indices;
+    indices.reserve(mIndices.size());
+    for (std::size_t t = 0; t < mIndices.size() / 3; t++)
+        if (mTriangleRemoved.empty() || !mTriangleRemoved[t])
+            indices.insert(indices.end(), mIndices.begin() + t * 3, mIndices.begin() + t * 3 + 3);
+
+    std::vector<unsigned int> remap(mVertices.size(), 0xFFFFFFFFu);
+    std::vector<CorrectionMeshVertex> vertices;
+    vertices.reserve(mVertices.size());
+    for (std::size_t i = 0; i < indices.size(); i++)
+    {
+        unsigned int & index = indices[i];
+        if (remap[index] == 0xFFFFFFFFu)
+        {
+            remap[index] = static_cast<unsigned int>(vertices.size());
+            vertices.push_back(mVertices[index]);
+        }
+        index = remap[index];
+    }
+
+    mVertices.swap(vertices);
+    mIndices.swap(indices);
+    mTriangleRemoved.clear();
+}
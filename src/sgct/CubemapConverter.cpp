@@ -0,0 +1,400 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/CubemapConverter.h>
+#include <sgct/SGCTThreadPool.h>
+#include <sgct/MessageHandler.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+//number of rows converted by each task
+#define CUBEMAP_CONVERTER_ROWS_PER_TASK 16
+
+namespace
+{
+    //same constant as in the fisheye shaders
+    const float angle45Factor = 0.7071067812f;
+    const float pi = 3.14159265359f;
+
+    template <class T>
+    void storeRow(const float * src, T * dst, std::size_t count, float maxValue)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            float v = std::min(maxValue, std::max(0.0f, src[i]));
+            dst[i] = static_cast<T>(v + 0.5f);
+        }
+    }
+
+    template <>
+    void storeRow<float>(const float * src, float * dst, std::size_t count, float)
+    {
+        for (std::size_t i = 0; i < count; i++)
+            dst[i] = src[i];
+    }
+}
+
+sgct_core::CubemapConverter::CubemapConverter()
+{
+    mOutputType = Fisheye;
+    mInterpolationMode = NonLinearProjection::Linear;
+    mMethod = FisheyeProjection::FourFaceCube;
+
+    mFOV = 180.0f;
+    mTilt = 0.0f;
+    for (std::size_t i = 0; i < 4; i++)
+        mCropFactors[i] = 0.0f;
+    for (std::size_t i = 0; i < 3; i++)
+        mOffset[i] = 0.0f;
+
+    mBackgroundColor[0] = 0.0f;
+    mBackgroundColor[1] = 0.0f;
+    mBackgroundColor[2] = 0.0f;
+    mBackgroundColor[3] = 1.0f;
+}
+
+/*!
+Set if the cube map is converted to a fisheye (default) or an equirectangular (latitude-longitude) image.
+*/
+void sgct_core::CubemapConverter::setOutputType(OutputType type)
+{
+    mOutputType = type;
+}
+
+/*!
+Set the fisheye field-of-view angle.
+
+@param angle the FOV angle in degrees
+*/
+void sgct_core::CubemapConverter::setFOV(float angle)
+{
+    mFOV = angle;
+}
+
+/*!
+Tilt the dome towards the top of the fisheye image, relative to the orientation the faces were rendered with.
+
+@param angle the tilt angle in degrees
+*/
+void sgct_core::CubemapConverter::setTilt(float angle)
+{
+    mTilt = angle;
+}
+
+/*!
+Set the fisheye crop values, see FisheyeProjection::setCropFactors.
+*/
+void sgct_core::CubemapConverter::setCropFactors(float left, float right, float bottom, float top)
+{
+    mCropFactors[FisheyeProjection::CropLeft] = (left < 1.0f && left > 0.0f) ? left : 0.0f;
+    mCropFactors[FisheyeProjection::CropRight] = (right < 1.0f && right > 0.0f) ? right : 0.0f;
+    mCropFactors[FisheyeProjection::CropBottom] = (bottom < 1.0f && bottom > 0.0f) ? bottom : 0.0f;
+    mCropFactors[FisheyeProjection::CropTop] = (top < 1.0f && top > 0.0f) ? top : 0.0f;
+}
+
+/*!
+Set the fisheye lens offset for off-axis (stereo) fisheyes, see FisheyeProjection::setOffset.
+*/
+void sgct_core::CubemapConverter::setOffset(float x, float y, float z)
+{
+    mOffset[0] = x;
+    mOffset[1] = y;
+    mOffset[2] = z;
+}
+
+/*!
+Set the method the faces were rendered with. The four face method uses a different cube orientation than the five and six face methods.
+Like in FisheyeProjection the five face method is used if the FOV is larger than 180 degrees.
+*/
+void sgct_core::CubemapConverter::setRenderingMethod(FisheyeProjection::FisheyeMethod method)
+{
+    mMethod = method;
+}
+
+/*!
+Set bilinear (default) or bicubic (Catmull-Rom) sampling of the faces.
+*/
+void sgct_core::CubemapConverter::setInterpolationMode(NonLinearProjection::InterpolationMode im)
+{
+    mInterpolationMode = im;
+}
+
+/*!
+Set the color of pixels outside the fisheye circle, in range [0, 1].
+*/
+void sgct_core::CubemapConverter::setBackgroundColor(float red, float green, float blue, float alpha)
+{
+    mBackgroundColor[0] = red;
+    mBackgroundColor[1] = green;
+    mBackgroundColor[2] = blue;
+    mBackgroundColor[3] = alpha;
+}
+
+/*!
+Convert the faces into the output image. The size of the output image must be set before calling this function, the channels
+and the data type are copied from the faces. All faces must have the same size and format. 8-bit, 16-bit and 32-bit float images are supported.
+
+@param faces the faces in FisheyeProjection order, unused faces can be NULL
+@param output the image to write to
+@param numberOfThreads the number of threads converting rows
+@returns true on success
+*/
+bool sgct_core::CubemapConverter::convert(Image * const faces[NumberOfFaces], Image & output, unsigned int numberOfThreads) const
+{
+    const Image * first = NULL;
+    FaceInfo faceInfo[NumberOfFaces];
+    for (std::size_t i = 0; i < NumberOfFaces; i++)
+    {
+        faceInfo[i].image = NULL;
+        faceInfo[i].width = 0;
+        faceInfo[i].height = 0;
+
+        Image * face = faces[i];
+        if (face == NULL || face->getData() == NULL)
+            continue;
+
+        if (first == NULL)
+            first = face;
+        else if (face->getWidth() != first->getWidth() || face->getHeight() != first->getHeight() ||
+            face->getChannels() != first->getChannels() || face->getBytesPerChannel() != first->getBytesPerChannel() ||
+            face->isFloatData() != first->isFloatData())
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+                "CubemapConverter: All cube faces must have the same size and format (face %u differs)!\n", static_cast<unsigned int>(i));
+            return false;
+        }
+
+        faceInfo[i].image = face;
+        faceInfo[i].width = static_cast<int>(face->getWidth());
+        faceInfo[i].height = static_cast<int>(face->getHeight());
+    }
+
+    if (first == NULL)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CubemapConverter: No cube faces to convert!\n");
+        return false;
+    }
+
+    std::size_t bpc = first->getBytesPerChannel();
+    if (!(bpc == 1 || (bpc == 2 && !first->isFloatData()) || (bpc == 4 && first->isFloatData())))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "CubemapConverter: Unsupported image format (%u bytes per channel)!\n", static_cast<unsigned int>(bpc));
+        return false;
+    }
+
+    output.setChannels(first->getChannels());
+    output.setBytesPerChannel(bpc);
+    output.setFloatData(first->isFloatData());
+    output.setPreferBGRExport(first->getPreferBGRImport());
+    if (!output.allocateOrResizeData())
+        return false;
+
+    std::size_t height = output.getHeight();
+    SGCTThreadPool pool;
+    if (numberOfThreads > 1 && height > CUBEMAP_CONVERTER_ROWS_PER_TASK)
+        pool.start(numberOfThreads);
+
+    for (std::size_t row = 0; row < height; row += CUBEMAP_CONVERTER_ROWS_PER_TASK)
+    {
+        std::size_t lastRow = std::min(row + CUBEMAP_CONVERTER_ROWS_PER_TASK, height);
+        pool.addTask([this, &faceInfo, &output, row, lastRow]() { convertRows(faceInfo, output, row, lastRow); });
+    }
+    pool.waitUntilIdle();
+    pool.stop();
+
+    return true;
+}
+
+void sgct_core::CubemapConverter::convertRows(const FaceInfo * faces, Image & output, std::size_t firstRow, std::size_t lastRow) const
+{
+    std::size_t width = output.getWidth();
+    std::size_t height = output.getHeight();
+    std::size_t channels = output.getChannels();
+    std::size_t bpc = output.getBytesPerChannel();
+    float maxValue = bpc == 1 ? 255.0f : (bpc == 2 ? 65535.0f : 1.0f);
+
+    //background color in the channel order of the images
+    float background[4];
+    bool bgr = output.getPreferBGRExport() && channels >= 3;
+    background[0] = mBackgroundColor[bgr ? 2 : 0] * maxValue;
+    background[1] = mBackgroundColor[1] * maxValue;
+    background[2] = mBackgroundColor[bgr ? 0 : 2] * maxValue;
+    background[3] = mBackgroundColor[3] * maxValue;
+    if (channels < 3) //luminance
+        background[0] = mBackgroundColor[0] * maxValue;
+    if (channels == 2)
+        background[1] = mBackgroundColor[3] * maxValue;
+
+    std::vector<int> faceIndices(width);
+    std::vector<float> xs(width);
+    std::vector<float> ys(width);
+    std::vector<float> rowData(width * channels);
+
+    //compacted per face batches
+    std::vector<std::size_t> pixels(width);
+    std::vector<float> batchX(width);
+    std::vector<float> batchY(width);
+    std::vector<float> batchData(width * channels);
+
+    for (std::size_t row = firstRow; row < lastRow; row++)
+    {
+        calculateFaceCoordinates(row, width, height, &faceIndices[0], &xs[0], &ys[0], faces);
+
+        for (std::size_t i = 0; i < width; i++)
+            if (faceIndices[i] < 0)
+                for (std::size_t c = 0; c < channels; c++)
+                    rowData[i * channels + c] = background[std::min<std::size_t>(c, 3)];
+
+        for (int f = 0; f < NumberOfFaces; f++)
+        {
+            if (faces[f].image == NULL)
+                continue;
+
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < width; i++)
+                if (faceIndices[i] == f)
+                {
+                    pixels[count] = i;
+                    batchX[count] = xs[i];
+                    batchY[count] = ys[i];
+                    count++;
+                }
+
+            if (count == 0)
+                continue;
+
+            faces[f].image->sampleBatch(count, &batchX[0], &batchY[0], &batchData[0],
+                mInterpolationMode == NonLinearProjection::Cubic ? Image::SAMPLE_BICUBIC : Image::SAMPLE_BILINEAR);
+
+            for (std::size_t i = 0; i < count; i++)
+                for (std::size_t c = 0; c < channels; c++)
+                    rowData[pixels[i] * channels + c] = batchData[i * channels + c];
+        }
+
+        unsigned char * dst = output.getData() + row * width * channels * bpc;
+        if (bpc == 1)
+            storeRow(&rowData[0], dst, width * channels, maxValue);
+        else if (bpc == 2)
+            storeRow(&rowData[0], reinterpret_cast<unsigned short *>(dst), width * channels, maxValue);
+        else
+            storeRow(&rowData[0], reinterpret_cast<float *>(dst), width * channels, maxValue);
+    }
+}
+
+/*
+    Calculate the cube face and the position on the face (in pixels) for each pixel in a row, using the same math as the
+    fisheye and latlon sample functions in the fisheye shaders. The face index is -1 for the background.
+*/
+void sgct_core::CubemapConverter::calculateFaceCoordinates(std::size_t row, std::size_t width, std::size_t height,
+    int * face, float * x, float * y, const FaceInfo * faces) const
+{
+    float halfFov = mFOV * pi / 360.0f;
+    float sinTilt = sinf(mTilt * pi / 180.0f);
+    float cosTilt = cosf(mTilt * pi / 180.0f);
+    bool fourFaces = mMethod == FisheyeProjection::FourFaceCube && mFOV <= 180.0f;
+
+    //texture coordinates of the fisheye quad, see FisheyeProjection::updateGeomerty
+    float s0 = mCropFactors[FisheyeProjection::CropLeft];
+    float sScale = (1.0f - mCropFactors[FisheyeProjection::CropRight] - s0) / static_cast<float>(width);
+    float t0 = mCropFactors[FisheyeProjection::CropBottom];
+    float tScale = (1.0f - mCropFactors[FisheyeProjection::CropTop] - t0) / static_cast<float>(height);
+    float texT = t0 + (static_cast<float>(row) + 0.5f) * tScale;
+
+    for (std::size_t i = 0; i < width; i++)
+    {
+        float dx, dy, dz;
+        if (mOutputType == Fisheye)
+        {
+            float s = 2.0f * (s0 + (static_cast<float>(i) + 0.5f) * sScale - 0.5f);
+            float t = 2.0f * (texT - 0.5f);
+            float r2 = s * s + t * t;
+            if (r2 > 1.0f)
+            {
+                face[i] = -1;
+                continue;
+            }
+
+            //sin(theta) and cos(theta) of theta = atan(s, t) are s/r and t/r
+            float r = sqrtf(r2);
+            float phi = r * halfFov;
+            float sinPhiOverR = r > 0.0f ? sinf(phi) / r : 0.0f;
+            dx = sinPhiOverR * s - mOffset[0];
+            dy = -sinPhiOverR * t - mOffset[1];
+            dz = cosf(phi) - mOffset[2];
+        }
+        else
+        {
+            float phi = pi * (1.0f - (static_cast<float>(row) + 0.5f) / static_cast<float>(height));
+            float theta = 2.0f * pi * ((static_cast<float>(i) + 0.5f) / static_cast<float>(width) - 0.5f);
+            dx = sinf(phi) * sinf(theta);
+            dy = sinf(phi) * cosf(theta);
+            dz = cosf(phi);
+        }
+
+        //tilt around the x-axis
+        float ty = dy * cosTilt - dz * sinTilt;
+        float tz = dy * sinTilt + dz * cosTilt;
+        dy = ty;
+        dz = tz;
+
+        //into cube space
+        float rx, ry, rz;
+        if (fourFaces)
+        {
+            rx = angle45Factor * dx + angle45Factor * dz;
+            ry = dy;
+            rz = -angle45Factor * dx + angle45Factor * dz;
+        }
+        else
+        {
+            rx = angle45Factor * dx - angle45Factor * dy;
+            ry = angle45Factor * dx + angle45Factor * dy;
+            rz = dz;
+        }
+
+        //select the face like OpenGL cube map lookups
+        float ax = fabsf(rx);
+        float ay = fabsf(ry);
+        float az = fabsf(rz);
+        int f;
+        float sc, tc, ma;
+        if (ax >= ay && ax >= az)
+        {
+            f = rx > 0.0f ? PositiveX : NegativeX;
+            sc = rx > 0.0f ? -rz : rz;
+            tc = -ry;
+            ma = ax;
+        }
+        else if (ay >= az)
+        {
+            f = ry > 0.0f ? PositiveY : NegativeY;
+            sc = rx;
+            tc = ry > 0.0f ? rz : -rz;
+            ma = ay;
+        }
+        else
+        {
+            f = rz > 0.0f ? PositiveZ : NegativeZ;
+            sc = rz > 0.0f ? rx : -rx;
+            tc = -ry;
+            ma = az;
+        }
+
+        if (faces[f].image == NULL || ma <= 0.0f)
+        {
+            face[i] = -1;
+            continue;
+        }
+
+        //images are stored bottom-up like the cube map faces rendered by FisheyeProjection
+        face[i] = f;
+        x[i] = 0.5f * (sc / ma + 1.0f) * static_cast<float>(faces[f].width) - 0.5f;
+        y[i] = 0.5f * (tc / ma + 1.0f) * static_cast<float>(faces[f].height) - 0.5f;
+    }
+}
@@ -26,6 +26,9 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/ogl_headers.h>
 #include <sgct/ShaderManager.h>
+#include <sgct/SGCTThreadPool.h>
+#include <sgct/SGCTTrace.h>
+#include <sgct/SGCTMemoryRegistry.h>
 #include <sgct/helpers/SGCTStringFunctions.h>
 
 #include <glm/gtc/constants.hpp>
@@ -33,6 +36,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <deque>
 
 //#define __SGCT_RENDER_LOOP_DEBUG__
@@ -95,6 +99,8 @@ Parameter     | Description
 --No-FBO | disable frame buffer objects (some stereo modes, Multi-Window rendering, FXAA and fisheye rendering will be disabled)
 --Capture-PNG | use png images for screen capture (default)
 --Capture-TGA | use tga images for screen capture
+--Capture-PFM | use pfm images for screen capture (float precision with floating point frame buffers)
+--Capture-HDR | use hdr (Radiance RGBE) images for screen capture
 -MSAA <integer> | Enable MSAA as default (argument must be a power of two)
 --FXAA | Enable FXAA as default
 --gDebugger | Force textures to be genareted using glTexImage2D instead of glTexStorage2D
@@ -141,6 +147,7 @@ sgct::Engine::Engine( int& argc, char**& argv )
     mFixedOGLPipeline = true;
     mHelpMode = false;
     mInitialized = false;
+    mStartupReportPrinted = false;
 
     mCurrentViewportCoords[0] = 0;
     mCurrentViewportCoords[1] = 0;
@@ -172,6 +179,8 @@ sgct::Engine::Engine( int& argc, char**& argv )
     mShotCounter = 0;
     mTimerID = 0;
     mExitKey = GLFW_KEY_ESCAPE;
+    mTraceKey = GLFW_KEY_F12;
+    mTraceKeyPressed = false;
 
     mPrintSyncMessage = true;
     mSyncTimeout = 60.f;
@@ -252,6 +261,7 @@ sgct::Engine::Engine(std::vector<std::string>& arg) {
     mFixedOGLPipeline = true;
     mHelpMode = false;
     mInitialized = false;
+    mStartupReportPrinted = false;
 
     mCurrentViewportCoords[0] = 0;
     mCurrentViewportCoords[1] = 0;
@@ -283,6 +293,8 @@ sgct::Engine::Engine(std::vector<std::string>& arg) {
     mShotCounter = 0;
     mTimerID = 0;
     mExitKey = GLFW_KEY_ESCAPE;
+    mTraceKey = GLFW_KEY_F12;
+    mTraceKeyPressed = false;
 
     mPrintSyncMessage = true;
     mSyncTimeout = 60.f;
@@ -340,6 +352,13 @@ bool sgct::Engine::init(RunMode rm)
         return false;
     }
 
+    //allocations are only recorded while the registry exists, see Engine::clean()
+    SGCTMemoryRegistry::instance();
+
+    //the time of each phase is reported to the master, see printStartupReport()
+    double startupTime = getTime();
+    double phaseStartTime = startupTime;
+
     mConfig = new sgct_core::ReadConfig( configFilename );
     if( !mConfig->isValid() ) //fatal error
     {
@@ -349,20 +368,33 @@ bool sgct::Engine::init(RunMode rm)
 
         return false;
     }
+    mStartupRecord.mTimes[sgct_core::StartupRecord::ReadConfig] = static_cast<float>(getTime() - phaseStartTime);
+
+#if INCLUDE_SGCT_TRACE
+    //create the trace before any threads are started
+    SGCTTrace::instance()->setBufferSize(SGCTSettings::instance()->getTraceBufferSize());
+    SGCT_TRACE_THREAD_NAME("Main");
+#endif
 
+    phaseStartTime = getTime();
     if( !initNetwork() )
     {
         MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "Network init error. Application will close in 5 seconds.\n");
         sleep( 5.0 );
         return false;
     }
+    mStartupRecord.mTimes[sgct_core::StartupRecord::InitNetwork] = static_cast<float>(getTime() - phaseStartTime);
 
+    phaseStartTime = getTime();
     if( !initWindows() )
     {
         MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "Window init error. Application will close in 5 seconds.\n");
         sleep( 5.0 );
         return false;
     }
+    //the wait for the other nodes is timed separately inside initWindows
+    mStartupRecord.mTimes[sgct_core::StartupRecord::OpenWindows] = static_cast<float>(getTime() - phaseStartTime) -
+        mStartupRecord.mTimes[sgct_core::StartupRecord::WaitForNodes];
 
     //if a single node, skip syncing
     if(sgct_core::ClusterManager::instance()->getNumberOfNodes() == 1)
@@ -388,12 +420,30 @@ bool sgct::Engine::init(RunMode rm)
             glfwSetTouchCallback(getWindowPtr(i)->getWindowHandle(), internal_touch_callback);
     }
 
+    phaseStartTime = getTime();
     initOGL();
+    //shaders, viewport data and the init callback are timed separately inside initOGL
+    mStartupRecord.mTimes[sgct_core::StartupRecord::InitOpenGL] = static_cast<float>(getTime() - phaseStartTime) -
+        mStartupRecord.mTimes[sgct_core::StartupRecord::LoadShaders] -
+        mStartupRecord.mTimes[sgct_core::StartupRecord::InitCallback] -
+        mStartupRecord.mTimes[sgct_core::StartupRecord::LoadViewportData];
 
     //start sampling tracking data
     if(isMaster())
         getTrackingManager()->startSampling();
 
+    mStartupRecord.mTimes[sgct_core::StartupRecord::Total] = static_cast<float>(getTime() - startupTime);
+    mStartupRecord.mNodeId = sgct_core::ClusterManager::instance()->getThisNodeId();
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Engine: Initialized in %.3f s.\n", mStartupRecord.mTimes[sgct_core::StartupRecord::Total]);
+
+    //the master prints the start-up times of all nodes when every slave has sent them
+    for (unsigned int i = 0; i < mNetworkConnections->getSyncConnectionsCount(); i++)
+    {
+        sgct_core::SGCTNetwork * conn = mNetworkConnections->getSyncConnectionByIndex(i);
+        if (!conn->isServer() && conn->isConnected())
+            conn->pushStartupRecord(mStartupRecord);
+    }
+
     mInitialized = true;
     return true;
 }
@@ -453,6 +503,13 @@ bool sgct::Engine::initNetwork()
         MessageHandler::instance()->setLogToFile(true);
     }
 
+#if INCLUDE_SGCT_TRACE
+    //the node id is used as process id so that the traces of all nodes can be merged
+    std::stringstream ss;
+    ss << "Node " << sgct_core::ClusterManager::instance()->getThisNodeId() << (mNetworkConnections->isComputerServer() ? " (master)" : "");
+    SGCTTrace::instance()->setProcessName(ss.str(), sgct_core::ClusterManager::instance()->getThisNodeId());
+#endif
+
     //Set message handler to send messages or not
     //MessageHandler::instance()->setSendFeedbackToServer( !mNetworkConnections->isComputerServer() );
 
@@ -733,7 +790,9 @@ bool sgct::Engine::initWindows()
     }
 
     updateDrawBufferResolutions();//init draw buffer resolution
+    double waitStartTime = getTime();
     waitForAllWindowsInSwapGroupToOpen();
+    mStartupRecord.mTimes[sgct_core::StartupRecord::WaitForNodes] = static_cast<float>(getTime() - waitStartTime);
 
     if( RUN_FRAME_LOCK_CHECK_THREAD )
     {
@@ -819,15 +878,42 @@ void sgct::Engine::initOGL()
     //init window opengl data
     getCurrentWindowPtr()->makeOpenGLContextCurrent( SGCTWindow::Shared_Context );
 
+    double phaseStartTime = getTime();
     loadShaders();
     mStatistics->initVBO(mFixedOGLPipeline);
+    mStartupRecord.mTimes[sgct_core::StartupRecord::LoadShaders] = static_cast<float>(getTime() - phaseStartTime);
 
     if (mInitOGLFnPtr != SGCT_NULL_PTR)
     {
+        phaseStartTime = getTime();
         MessageHandler::instance()->print(MessageHandler::NOTIFY_IMPORTANT, "\n---- Calling init callback ----\n");
         mInitOGLFnPtr();
         MessageHandler::instance()->print(MessageHandler::NOTIFY_IMPORTANT, "-------------------------------\n");
+        mStartupRecord.mTimes[sgct_core::StartupRecord::InitCallback] = static_cast<float>(getTime() - phaseStartTime);
+    }
+
+    //link all users to their viewports, some warping meshes set the user position
+    for (size_t w = 0; w < mThisNode->getNumberOfWindows(); w++)
+    {
+        SGCTWindow * winPtr = mThisNode->getWindowPtr(w);
+        for (unsigned int i = 0; i < winPtr->getNumberOfViewports(); i++)
+            winPtr->getViewport(i)->linkUserName();
+    }
+
+    //decode masks and parse warping meshes of all viewports in parallel, the OpenGL data is created by each window
+    double loadStartTime = getTime();
+    sgct_core::SGCTThreadPool loaderPool;
+    loaderPool.start(std::thread::hardware_concurrency());
+    for (size_t w = 0; w < mThisNode->getNumberOfWindows(); w++)
+    {
+        SGCTWindow * winPtr = mThisNode->getWindowPtr(w);
+        for (unsigned int i = 0; i < winPtr->getNumberOfViewports(); i++)
+            winPtr->getViewport(i)->readData(loaderPool, winPtr);
     }
+    loaderPool.waitUntilIdle();
+    loaderPool.stop();
+    mStartupRecord.mTimes[sgct_core::StartupRecord::LoadViewportData] = static_cast<float>(getTime() - loadStartTime);
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_DEBUG, "Viewport data read in %.2f ms\n", (getTime() - loadStartTime) * 1000.0);
 
     //create all textures, etc
     for(size_t i=0; i < mThisNode->getNumberOfWindows(); i++)
@@ -871,14 +957,6 @@ void sgct::Engine::initOGL()
         }
     }
 
-    //link all users to their viewports
-    for (size_t w = 0; w < mThisNode->getNumberOfWindows(); w++)
-    {
-        SGCTWindow * winPtr = mThisNode->getWindowPtr(w);
-        for (unsigned int i = 0; i < winPtr->getNumberOfViewports(); i++)
-            winPtr->getViewport(i)->linkUserName();
-    }
-
     updateFrustums();
 
     //
@@ -938,7 +1016,7 @@ void sgct::Engine::clean()
     {
         MessageHandler::instance()->print(MessageHandler::NOTIFY_DEBUG, "Waiting for frameLock thread to finish...\n");
 
-        sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::FrameSyncMutex );
+        sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::FrameSyncMutex, SGCT_MUTEX_CALL_SITE );
         sRunUpdateFrameLockLoop = false;
         sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::FrameSyncMutex );
 
@@ -990,6 +1068,17 @@ void sgct::Engine::clean()
     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Destroying texture manager...\n");
     TextureManager::destroy();
 
+#if INCLUDE_SGCT_TRACE
+    //all threads recording events have stopped
+    if( SGCTSettings::instance()->getSaveTraceOnExit() )
+        SGCTTrace::instance()->save(getTraceFilename(false));
+    SGCTTrace::destroy();
+#endif
+
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    SGCTMutexManager::instance()->printReport();
+#endif
+
 #if INCLUDE_SGCT_TEXT
     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Destroying font manager...\n");
     sgct_text::FontManager::destroy();
@@ -1004,6 +1093,9 @@ void sgct::Engine::clean()
     
     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Destroying cluster manager...\n");
     sgct_core::ClusterManager::destroy();
+
+    //all windows, projections and meshes are released
+    SGCTMemoryRegistry::destroy();
     
     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Destroying settings...\n");
     SGCTSettings::destroy();
@@ -1074,6 +1166,8 @@ Sync time from statistics is the time each computer waits for sync.
 */
 bool sgct::Engine::frameLock(sgct::Engine::SyncStage stage)
 {
+    SGCT_TRACE_SCOPE(stage == PreStage ? "Engine::frameLock (pre)" : "Engine::frameLock (post)");
+
     if( stage == PreStage )
     {
         double t0 = glfwGetTime();
@@ -1083,6 +1177,7 @@ bool sgct::Engine::frameLock(sgct::Engine::SyncStage stage)
         //run only on clients/slaves
         if (!sgct_core::ClusterManager::instance()->getIgnoreSync() && !mNetworkConnections->isComputerServer()) //not server
         {
+            SGCT_TRACE_SCOPE("Wait for master");
             t0 = glfwGetTime();
             while(mNetworkConnections->isRunning() && mRunning)
             {
@@ -1144,6 +1239,7 @@ bool sgct::Engine::frameLock(sgct::Engine::SyncStage stage)
             /*localRunningMode == NetworkManager::Remote &&*/
             //!getCurrentWindowPtr()->isBarrierActive() )//post stage
         {
+            SGCT_TRACE_SCOPE("Wait for slaves");
             double t0 = glfwGetTime();
             while(mNetworkConnections->isRunning() &&
                 mRunning &&
@@ -1226,21 +1322,38 @@ void sgct::Engine::render()
 
     while( mRunning )
     {
+        SGCT_TRACE_SCOPE("Frame");
         mRenderingOffScreen = false;
 
+        //timestamps of the shared data rendered in this frame, see getNodeSyncLatencies()
+        sgct_core::SyncLatencyRecord syncLatency;
+
+        if (!mStartupReportPrinted && isMaster())
+            mStartupReportPrinted = printStartupReport();
+
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Updating tracking devices.\n");
 #endif
 
         //update tracking data
         if( isMaster() )
+        {
+            SGCT_TRACE_SCOPE("Update tracking devices");
             sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->updateTrackingDevices();
+        }
 
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Running pre-sync.\n");
 #endif
+        //the age of the shared data is measured from the master's pre-sync
+        if( mNetworkConnections->isComputerServer() )
+            SharedData::instance()->setSyncTime(getTime());
+
         if (mPreSyncFnPtr != SGCT_NULL_PTR)
+        {
+            SGCT_TRACE_SCOPE("Pre sync callback");
             mPreSyncFnPtr();
+        }
 
         if( mNetworkConnections->isComputerServer() )
         {
@@ -1248,6 +1361,8 @@ void sgct::Engine::render()
             MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Encoding data.\n");
 #endif
             SharedData::instance()->encode();
+            //the master's data is ready when it's encoded
+            syncLatency.mTimes[sgct_core::SyncLatencyRecord::Decode] = getTime();
         }
         else
         {
@@ -1264,6 +1379,13 @@ void sgct::Engine::render()
         if( !frameLock(PreStage) )
             break;
 
+        {
+            double decodeTime;
+            SharedData::instance()->getSyncStamp(syncLatency.mFrame, syncLatency.mMasterTime, decodeTime);
+            if( !mNetworkConnections->isComputerServer() )
+                syncLatency.mTimes[sgct_core::SyncLatencyRecord::Decode] = decodeTime;
+        }
+
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: running post-sync-pre-draw\n");
 #endif
@@ -1284,12 +1406,27 @@ void sgct::Engine::render()
         if( mRenderingOffScreen )
             getCurrentWindowPtr()->makeOpenGLContextCurrent( SGCTWindow::Shared_Context );
 
+        //upload asynchronously loaded textures within the per frame budget
+        if( TextureManager::instance()->hasPendingAsyncTextures() )
+        {
+            SGCT_TRACE_SCOPE("Upload textures");
+            if( !mRenderingOffScreen )
+                getCurrentWindowPtr()->makeOpenGLContextCurrent( SGCTWindow::Shared_Context );
+            TextureManager::instance()->processAsyncUploads();
+        }
+
+        syncLatency.mTimes[sgct_core::SyncLatencyRecord::PostSyncPreDraw] = getTime();
+
         //Make sure correct context is current
         if (mPostSyncPreDrawFnPtr != SGCT_NULL_PTR)
+        {
+            SGCT_TRACE_SCOPE("Post sync pre draw callback");
             mPostSyncPreDrawFnPtr();
+        }
 
         double startFrameTime = glfwGetTime();
         calculateFPS(startFrameTime); //measures time between calls
+        syncLatency.mTimes[sgct_core::SyncLatencyRecord::Draw] = startFrameTime;
 
         if (!mFixedOGLPipeline && mShowGraph)
             glQueryCounter(time_queries[0], GL_TIMESTAMP);
@@ -1303,6 +1440,8 @@ void sgct::Engine::render()
         for(size_t i=0; i < mThisNode->getNumberOfWindows(); i++)
         if (mThisNode->getWindowPtr(i)->isVisible() || mThisNode->getWindowPtr(i)->isRenderingWhileHidden())
         {
+            SGCT_TRACE_SCOPE("Render window");
+
             //store the first buffer index for each window
             firstDrawBufferIndexInWindow = mCurrentDrawBufferIndex;
             
@@ -1325,6 +1464,7 @@ void sgct::Engine::render()
                 
                 if (win->getViewport(j)->hasSubViewports())
                 {
+                    SGCT_TRACE_SCOPE("Render cubemap");
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
                     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering sub-viewports\n");
 #endif
@@ -1390,6 +1530,7 @@ void sgct::Engine::render()
 
                     if (win->getViewport(j)->hasSubViewports())
                     {
+                        SGCT_TRACE_SCOPE("Render cubemap");
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
                         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering sub-viewports\n");
 #endif
@@ -1443,7 +1584,10 @@ void sgct::Engine::render()
 
                 mRenderingOffScreen = false;
                 if( SGCTSettings::instance()->useFBO() )
+                {
+                    SGCT_TRACE_SCOPE("Render to screen");
                     (this->*mInternalRenderFBOFn)();
+                }
             }
 
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
@@ -1477,7 +1621,10 @@ void sgct::Engine::render()
 
         //run post frame actions
         if (mPostDrawFnPtr != SGCT_NULL_PTR)
+        {
+            SGCT_TRACE_SCOPE("Post draw callback");
             mPostDrawFnPtr();
+        }
 
         //update stats
         if (mFixedOGLPipeline)
@@ -1489,6 +1636,7 @@ void sgct::Engine::render()
                 //int counter = 0;
 
                 // wait until the query results are available
+                SGCT_TRACE_SCOPE("Wait for GPU timer");
                 GLint done = GL_FALSE;
                 while (!done)
                 {
@@ -1510,6 +1658,8 @@ void sgct::Engine::render()
                 double elapsedTime = static_cast<double>(timerEnd - timerStart) / 1000000000.0;
                 mStatistics->setDrawTime(static_cast<float>(elapsedTime));
             }
+            else //avoid waiting for the GPU, the CPU time still gives percentiles of the draw time
+                mStatistics->setDrawTime(static_cast<float>(endFrameTime - startFrameTime));
         }
 
         if (mShowGraph)
@@ -1517,6 +1667,7 @@ void sgct::Engine::render()
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
             MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: update stats VBOs\n");
 #endif
+            SGCT_TRACE_SCOPE("Update statistics");
             mStatistics->update();
         }
         
@@ -1533,11 +1684,30 @@ void sgct::Engine::render()
         // Swap front and back rendering buffers
         for(size_t i=0; i < mThisNode->getNumberOfWindows(); i++)
         {
+            SGCT_TRACE_SCOPE("Swap buffers");
             mThisNode->setCurrentWindowIndex(i);
             getCurrentWindowPtr()->swap(mTakeScreenshot);
         }
 
-        glfwPollEvents();
+        //slaves send the timestamps with the next acknowledge
+        syncLatency.mTimes[sgct_core::SyncLatencyRecord::Swap] = getTime();
+        if( mNetworkConnections->isComputerServer() )
+            mSyncLatency.addRecord(syncLatency);
+        else
+            mStatistics->setSyncLatencyRecord(syncLatency);
+
+        {
+            SGCT_TRACE_SCOPE("Poll events");
+            glfwPollEvents();
+        }
+
+#if INCLUDE_SGCT_TRACE
+        //save the trace once per key press
+        bool traceKeyPressed = mThisNode->getKeyPressed( mTraceKey );
+        if( traceKeyPressed && !mTraceKeyPressed )
+            saveTrace();
+        mTraceKeyPressed = traceKeyPressed;
+#endif
 
         // Check if ESC key was pressed or window was closed
         mRunning = !(mThisNode->getKeyPressed( mExitKey ) ||
@@ -1561,6 +1731,9 @@ void sgct::Engine::render()
         getCurrentWindowPtr()->makeOpenGLContextCurrent(SGCTWindow::Shared_Context);
         glDeleteQueries(2, time_queries);
     }
+
+    if (isMaster() && sgct_core::ClusterManager::instance()->getNumberOfNodes() > 1)
+        printSyncLatencyReport();
 }
 
 /*!
@@ -1683,6 +1856,50 @@ void sgct::Engine::renderDisplayInfo()
             "Anti-Aliasing: %s",
             mAAInfo.c_str());
 
+        SGCTMemoryRegistry * memoryRegistry = SGCTMemoryRegistry::instance();
+        sgct_text::print(font,
+            sgct_text::TOP_LEFT,
+            xPos,
+            lineHeight * 9.0f + yPos,
+            glm::vec4(0.8f,0.8f,0.8f,1.0f),
+            "Memory estimate: GPU %.1f MB (windows %.1f, non linear %.1f, meshes %.1f, fonts %.1f, textures %.1f), CPU %.1f MB",
+            static_cast<double>(memoryRegistry->getTotalSize(SGCTMemoryRegistry::GPU)) / (1024.0 * 1024.0),
+            static_cast<double>(memoryRegistry->getSize(SGCTMemoryRegistry::WindowBuffers, SGCTMemoryRegistry::GPU)) / (1024.0 * 1024.0),
+            static_cast<double>(memoryRegistry->getSize(SGCTMemoryRegistry::NonLinearProjectionBuffers, SGCTMemoryRegistry::GPU)) / (1024.0 * 1024.0),
+            static_cast<double>(memoryRegistry->getSize(SGCTMemoryRegistry::CorrectionMeshes, SGCTMemoryRegistry::GPU)) / (1024.0 * 1024.0),
+            static_cast<double>(memoryRegistry->getSize(SGCTMemoryRegistry::Fonts, SGCTMemoryRegistry::GPU)) / (1024.0 * 1024.0),
+            static_cast<double>(memoryRegistry->getSize(SGCTMemoryRegistry::Textures, SGCTMemoryRegistry::GPU)) / (1024.0 * 1024.0),
+            static_cast<double>(memoryRegistry->getTotalSize(SGCTMemoryRegistry::CPU)) / (1024.0 * 1024.0));
+
+        //percentiles of this node and, on the master, of all slaves above the stereo info
+        std::vector<std::string> nodeNames;
+        std::vector<sgct_core::StatisticsRecord> records;
+        getNodeStatistics(nodeNames, records);
+
+        float row = 10.0f + static_cast<float>(records.size());
+        sgct_text::print(font,
+            sgct_text::TOP_LEFT,
+            xPos,
+            lineHeight * row + yPos,
+            glm::vec4(0.8f,0.8f,0.8f,1.0f),
+            "Frame, draw & sync time p50/p95/p99/max (ms):");
+
+        for (std::size_t i = 0; i < records.size(); i++)
+        {
+            const float (*v)[sgct_core::StatisticsRecord::NumberOfPercentiles] = records[i].mValues;
+            row -= 1.0f;
+            sgct_text::print(font,
+                sgct_text::TOP_LEFT,
+                xPos,
+                lineHeight * row + yPos,
+                glm::vec4(0.8f,0.8f,0.8f,1.0f),
+                "%s: %.1f/%.1f/%.1f/%.1f | %.1f/%.1f/%.1f/%.1f | %.1f/%.1f/%.1f/%.1f",
+                nodeNames[i].c_str(),
+                v[0][0]*1000.0f, v[0][1]*1000.0f, v[0][2]*1000.0f, v[0][3]*1000.0f,
+                v[1][0]*1000.0f, v[1][1]*1000.0f, v[1][2]*1000.0f, v[1][3]*1000.0f,
+                v[2][0]*1000.0f, v[2][1]*1000.0f, v[2][2]*1000.0f, v[2][3]*1000.0f);
+        }
+
         //if active stereoscopic rendering
         if( mCurrentFrustumMode == sgct_core::Frustum::StereoLeftEye )
         {
@@ -1971,8 +2188,7 @@ void sgct::Engine::renderFBOTexture()
         glUniform1i( mShaderLocs[MonoTex], 0);
         maskShaderSet = true;
 
-        for (std::size_t i = 0; i < numberOfIterations; i++)
-            win->getViewport(i)->renderMesh( mt );
+        renderWarpedViewports(win, mt, xSize, ySize);
 
         //render right eye in active stereo mode
         if( win->getStereoMode() == SGCTWindow::Active_Stereo )
@@ -1984,8 +2200,7 @@ void sgct::Engine::renderFBOTexture()
             setAndClearBuffer(BackBufferBlack);
 
             glBindTexture(GL_TEXTURE_2D, win->getFrameBufferTexture(RightEye));
-            for(std::size_t i=0; i<numberOfIterations; i++)
-                win->getViewport(i)->renderMesh( mt );
+            renderWarpedViewports(win, mt, xSize, ySize);
         }
     }
 
@@ -2047,6 +2262,58 @@ void sgct::Engine::renderFBOTexture()
 }
 
 
+/*!
+    Draw the viewports of a window using the FBO quad shader and the frame buffer texture bound to texture unit 0.
+    Viewports with a warp map baked for the current output size are drawn by a single lookup pass, the others draw
+    their mesh. The FBO quad shader is bound when this function returns.
+*/
+void sgct::Engine::renderWarpedViewports(SGCTWindow * win, sgct_core::CorrectionMesh::MeshType mt, int xSize, int ySize)
+{
+    bool useWarpMaps = mt == sgct_core::CorrectionMesh::WARP_MESH && SGCTSettings::instance()->getUseWarpMaps();
+    bool warpMapShaderSet = false;
+
+    for (std::size_t i = 0; i < win->getNumberOfViewports(); i++)
+    {
+        sgct_core::Viewport * vpPtr = win->getViewport(i);
+        sgct_core::CorrectionMesh * cmPtr = vpPtr->getCorrectionMeshPtr();
+        if (useWarpMaps && cmPtr->hasWarpMap(xSize, ySize))
+        {
+            if (!warpMapShaderSet)
+            {
+                mShaders[WarpMapShader].bind();
+                glUniform1i(mShaderLocs[WarpMapFrameTex], 0);
+                glUniform1i(mShaderLocs[WarpMapTex], 1);
+                warpMapShaderSet = true;
+            }
+
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, cmPtr->getWarpMapTexture());
+            glActiveTexture(GL_TEXTURE0);
+            vpPtr->renderMesh(sgct_core::CorrectionMesh::WARP_MAP_MESH);
+        }
+        else
+        {
+            if (warpMapShaderSet)
+            {
+                mShaders[FBOQuadShader].bind();
+                glUniform1i(mShaderLocs[MonoTex], 0);
+                warpMapShaderSet = false;
+            }
+            vpPtr->renderMesh(mt);
+        }
+    }
+
+    if (warpMapShaderSet)
+    {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, GL_FALSE);
+        glActiveTexture(GL_TEXTURE0);
+
+        mShaders[FBOQuadShader].bind();
+        glUniform1i(mShaderLocs[MonoTex], 0);
+    }
+}
+
 /*!
     Draw geometry and bind FBO as texture in screenspace (ortho mode).
     The geometry can be a simple quad or a geometry correction and blending mesh.
@@ -2197,6 +2464,7 @@ void sgct::Engine::renderFBOTextureFixedPipeline()
 */
 void sgct::Engine::renderViewports(TextureIndexes ti)
 {
+    SGCT_TRACE_SCOPE("Engine::renderViewports");
     prepareBuffer( ti ); //attach FBO
 
     SGCTWindow::StereoMode sm = getCurrentWindowPtr()->getStereoMode();
@@ -2342,6 +2610,7 @@ void sgct::Engine::render2D()
 */
 void sgct::Engine::renderPostFX(TextureIndexes finalTargetIndex)
 {
+    SGCT_TRACE_SCOPE("Engine::renderPostFX");
     glDrawBuffer( GL_COLOR_ATTACHMENT0 );
 
     PostFX * fx = NULL;
@@ -2407,6 +2676,7 @@ void sgct::Engine::renderPostFX(TextureIndexes finalTargetIndex)
 */
 void sgct::Engine::renderPostFXFixedPipeline(TextureIndexes finalTargetIndex)
 {
+    SGCT_TRACE_SCOPE("Engine::renderPostFX");
     glDrawBuffer( GL_COLOR_ATTACHMENT0 );
 
     PostFX * fx = NULL;
@@ -2649,6 +2919,31 @@ void sgct::Engine::loadShaders()
         mShaderLocs[OverlayTex] = mShaders[OverlayShader].getUniformLocation( "Tex" );
         glUniform1i( mShaderLocs[OverlayTex], 0 );
         ShaderProgram::unbind();
+
+        /*!
+            Used for viewports with baked warp maps.
+        */
+        std::string WarpMap_vert_shader;
+        std::string WarpMap_frag_shader;
+        WarpMap_vert_shader = sgct_core::shaders_modern::WarpMap_Vert_Shader;
+        WarpMap_frag_shader = sgct_core::shaders_modern::WarpMap_Frag_Shader;
+
+        //replace glsl version
+        sgct_helpers::findAndReplace(WarpMap_vert_shader, "**glsl_version**", Engine::instance()->getGLSLVersion());
+        sgct_helpers::findAndReplace(WarpMap_frag_shader, "**glsl_version**", Engine::instance()->getGLSLVersion());
+
+        mShaders[WarpMapShader].setName("WarpMapShader");
+        if(!mShaders[WarpMapShader].addShaderSrc(WarpMap_vert_shader, GL_VERTEX_SHADER, ShaderProgram::SHADER_SRC_STRING))
+            MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "Failed to load warp map vertex shader\n");
+        if(!mShaders[WarpMapShader].addShaderSrc(WarpMap_frag_shader, GL_FRAGMENT_SHADER, ShaderProgram::SHADER_SRC_STRING))
+            MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "Failed to load warp map fragment shader\n");
+        mShaders[WarpMapShader].createAndLinkProgram();
+        mShaders[WarpMapShader].bind();
+        mShaderLocs[WarpMapFrameTex] = mShaders[WarpMapShader].getUniformLocation( "Tex" );
+        glUniform1i( mShaderLocs[WarpMapFrameTex], 0 );
+        mShaderLocs[WarpMapTex] = mShaders[WarpMapShader].getUniformLocation( "WarpMap" );
+        glUniform1i( mShaderLocs[WarpMapTex], 1 );
+        ShaderProgram::unbind();
     }
 }
 
@@ -3065,6 +3360,16 @@ void sgct::Engine::parseArguments( std::vector<std::string>& arg )
             SGCTSettings::instance()->setCaptureFormat("JPG");
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "--Capture-PFM")
+        {
+            SGCTSettings::instance()->setCaptureFormat("PFM");
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--Capture-HDR")
+        {
+            SGCTSettings::instance()->setCaptureFormat("HDR");
+            arg.erase(arg.begin() + i);
+        }
         else if( arg[i] == "-numberOfCaptureThreads" && arg.size() > (i+1) )
         {
             int tmpi = -1;
@@ -4003,6 +4308,213 @@ const double sgct::Engine::getSyncTime()
     return mStatistics->getSyncTime();
 }
 
+/*!
+    Get the p50, p95, p99 and maximum frame, draw and sync times of this node. On the master the latest statistics sent
+    by every connected slave are added after the master's own.
+
+    \param nodeNames the names of the nodes, "master", "slave" or "slave <index>" on the master
+    \param records the percentiles in seconds of each node
+*/
+void sgct::Engine::getNodeStatistics(std::vector<std::string> & nodeNames, std::vector<sgct_core::StatisticsRecord> & records)
+{
+    nodeNames.clear();
+    records.clear();
+
+    sgct_core::StatisticsRecord record;
+    mStatistics->getRecord(record);
+    nodeNames.push_back(isMaster() ? "master" : "slave");
+    records.push_back(record);
+
+    if (!isMaster())
+        return;
+
+    for (unsigned int i = 0; i < mNetworkConnections->getSyncConnectionsCount(); i++)
+    {
+        sgct_core::SGCTNetwork * conn = mNetworkConnections->getSyncConnectionByIndex(i);
+        if (conn->isConnected() && conn->getClientStatistics(record))
+        {
+            std::stringstream ss;
+            ss << "slave " << i;
+            nodeNames.push_back(ss.str());
+            records.push_back(record);
+        }
+    }
+}
+
+/*!
+    Get the time in seconds spent in each phase of init on this node. On the master the records sent by the connected
+    slaves are added after the master's own.
+
+    \returns false on the master if a connected slave hasn't sent its start-up times yet
+*/
+bool sgct::Engine::getNodeStartupRecords(std::vector<sgct_core::StartupRecord> & records)
+{
+    records.clear();
+    records.push_back(mStartupRecord);
+
+    if (!isMaster())
+        return true;
+
+    bool complete = true;
+    sgct_core::StartupRecord record;
+    for (unsigned int i = 0; i < mNetworkConnections->getSyncConnectionsCount(); i++)
+    {
+        sgct_core::SGCTNetwork * conn = mNetworkConnections->getSyncConnectionByIndex(i);
+        if (!conn->isConnected())
+            continue;
+
+        if (conn->getClientStartupRecord(record))
+            records.push_back(record);
+        else
+            complete = false;
+    }
+
+    return complete;
+}
+
+/*!
+    Get the age of the shared data at each stage of the frame on every node, measured from the master's pre-sync and
+    converted to the master's clock. The slaves send the timestamps of their frames with every acknowledge so this is
+    only available on the master.
+
+    \param nodeNames the names of the nodes, "master" or "slave <index>"
+    \param summaries the percentiles in seconds of each node
+*/
+void sgct::Engine::getNodeSyncLatencies(std::vector<std::string> & nodeNames, std::vector<sgct_core::SyncLatencySummary> & summaries)
+{
+    nodeNames.clear();
+    summaries.clear();
+
+    if (!isMaster())
+        return;
+
+    sgct_core::SyncLatencySummary summary;
+    mSyncLatency.getSummary(summary);
+    nodeNames.push_back("master");
+    summaries.push_back(summary);
+
+    for (unsigned int i = 0; i < mNetworkConnections->getSyncConnectionsCount(); i++)
+    {
+        sgct_core::SGCTNetwork * conn = mNetworkConnections->getSyncConnectionByIndex(i);
+        if (conn->isConnected() && conn->getClientSyncLatency(summary))
+        {
+            std::stringstream ss;
+            ss << "slave " << i;
+            nodeNames.push_back(ss.str());
+            summaries.push_back(summary);
+        }
+    }
+}
+
+/*!
+    Get a table of the p50/p95/p99/max age of the shared data at each stage of the frame on every node in
+    milliseconds, see getNodeSyncLatencies(). The round trip is the time of the data and acknowledge messages on the
+    network, the clock offset is the slave's clock minus the master's.
+
+    \returns an empty string on the slaves
+*/
+std::string sgct::Engine::getSyncLatencyReport()
+{
+    std::vector<std::string> nodeNames;
+    std::vector<sgct_core::SyncLatencySummary> summaries;
+    getNodeSyncLatencies(nodeNames, summaries);
+    if (summaries.empty())
+        return std::string();
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Shared data age from master pre-sync p50/p95/p99/max (ms):\n";
+    ss << "node, frames, clock offset, round trip";
+    for (std::size_t j = 0; j < sgct_core::SyncLatencyRecord::NumberOfStages; j++)
+        ss << ", " << sgct_core::SyncLatencyRecord::getStageName(static_cast<sgct_core::SyncLatencyRecord::Stage>(j));
+    ss << "\n";
+
+    for (std::size_t i = 0; i < summaries.size(); i++)
+    {
+        const sgct_core::SyncLatencySummary & s = summaries[i];
+        ss << nodeNames[i] << ", " << s.mCount << ", " << s.mClockOffset * 1000.0 << ", ";
+        for (std::size_t k = 0; k < sgct_core::StatisticsRecord::NumberOfPercentiles; k++)
+            ss << (k > 0 ? "/" : "") << s.mRoundTripTimes[k] * 1000.0f;
+
+        for (std::size_t j = 0; j < sgct_core::SyncLatencyRecord::NumberOfStages; j++)
+        {
+            ss << ", ";
+            for (std::size_t k = 0; k < sgct_core::StatisticsRecord::NumberOfPercentiles; k++)
+                ss << (k > 0 ? "/" : "") << s.mValues[j][k] * 1000.0f;
+        }
+        ss << "\n";
+    }
+
+    return ss.str();
+}
+
+/*!
+    Print the sync latency table on the master, see getSyncLatencyReport(). It's also printed at exit when running a cluster.
+*/
+void sgct::Engine::printSyncLatencyReport()
+{
+    std::string report = getSyncLatencyReport();
+    if (!report.empty())
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "%s", report.c_str());
+}
+
+/*!
+    Print a table of the start-up times of all nodes on the master, with the slowest node of each phase marked.
+
+    \returns false if a connected slave hasn't sent its start-up times yet
+*/
+bool sgct::Engine::printStartupReport()
+{
+    std::vector<sgct_core::StartupRecord> records;
+    if (!getNodeStartupRecords(records))
+        return false;
+
+    std::size_t slowest[sgct_core::StartupRecord::NumberOfPhases];
+    for (std::size_t p = 0; p < sgct_core::StartupRecord::NumberOfPhases; p++)
+    {
+        slowest[p] = 0;
+        for (std::size_t i = 1; i < records.size(); i++)
+            if (records[i].mTimes[p] > records[slowest[p]].mTimes[p])
+                slowest[p] = i;
+    }
+
+    //the longest phase of any node, not counting the total
+    std::size_t longestNode = 0;
+    std::size_t longestPhase = 0;
+    for (std::size_t i = 0; i < records.size(); i++)
+        for (std::size_t p = 0; p < sgct_core::StartupRecord::Total; p++)
+            if (records[i].mTimes[p] > records[longestNode].mTimes[longestPhase])
+            {
+                longestNode = i;
+                longestPhase = p;
+            }
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Start-up times (s), * marks the slowest node of each phase:\n" << std::setw(18) << std::left << "node" << std::right;
+    for (std::size_t p = 0; p < sgct_core::StartupRecord::NumberOfPhases; p++)
+        ss << std::setw(15) << sgct_core::StartupRecord::getPhaseName(static_cast<sgct_core::StartupRecord::Phase>(p));
+    ss << "\n";
+
+    for (std::size_t i = 0; i < records.size(); i++)
+    {
+        std::stringstream name;
+        name << records[i].mNodeId << (i == 0 ? " (master)" : "");
+        ss << std::setw(18) << std::left << name.str() << std::right;
+
+        for (std::size_t p = 0; p < sgct_core::StartupRecord::NumberOfPhases; p++)
+            ss << std::setw(14) << records[i].mTimes[p] << (records.size() > 1 && slowest[p] == i ? "*" : " ");
+        ss << "\n";
+    }
+
+    ss << "Slowest node: " << records[slowest[sgct_core::StartupRecord::Total]].mNodeId
+        << ", longest phase: " << sgct_core::StartupRecord::getPhaseName(static_cast<sgct_core::StartupRecord::Phase>(longestPhase))
+        << " on node " << records[longestNode].mNodeId << " (" << records[longestNode].mTimes[longestPhase] << " s)\n";
+
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_IMPORTANT, "%s", ss.str().c_str());
+    return true;
+}
+
 /*!
     Set the near and far clipping planes. This operation recalculates all frustums for all viewports.
 
@@ -4060,6 +4572,43 @@ void sgct::Engine::setExitKey(int key)
     mExitKey = key;
 }
 
+/*!
+Set the key that saves the trace of this node, see saveTrace(). Default value is: SGCT_KEY_F12. Use SGCT_KEY_UNKNOWN to disable.
+\param key can be either an uppercase printable ISO 8859-1 (Latin 1) character (e.g. 'A', '3' or '.'), or
+a special key identifier described in \link setKeyboardCallbackFunction \endlink description.
+*/
+void sgct::Engine::setTraceKey(int key)
+{
+    mTraceKey = key;
+}
+
+/*!
+Save the trace markers recorded on this node as Chrome trace JSON. The file is named after the trace path in the settings,
+the node id and the current frame number. The trace is also saved when SGCT exits unless disabled in the settings.
+Requires SGCT built with the SGCT_TRACE CMake option.
+
+\returns true if the trace was saved
+*/
+bool sgct::Engine::saveTrace()
+{
+#if INCLUDE_SGCT_TRACE
+    return SGCTTrace::instance()->save(getTraceFilename(true));
+#else
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_WARNING, "SGCT is built without trace markers, enable the SGCT_TRACE CMake option.\n");
+    return false;
+#endif
+}
+
+std::string sgct::Engine::getTraceFilename(bool addFrameNumber)
+{
+    std::stringstream ss;
+    ss << SGCTSettings::instance()->getTracePath() << "_node" << sgct_core::ClusterManager::instance()->getThisNodeId();
+    if( addFrameNumber )
+        ss << "_frame" << mFrameCounter;
+    ss << ".json";
+    return ss.str();
+}
+
 /*!
     Add a post effect to all windows
 */
@@ -4253,6 +4802,61 @@ void sgct::Engine::sendMessageToExternalControl(const std::string& msg)
         mNetworkConnections->getExternalControlPtr()->sendData( (void *)msg.c_str(), static_cast<int>(msg.size()) );
 }
 
+/*!
+    Send the percentiles of all nodes to the external control interface, one line per node with the
+    p50, p95, p99 and maximum frame, draw and sync times in milliseconds:
+
+    stats <node> frame <p50> <p95> <p99> <max> draw <p50> <p95> <p99> <max> sync <p50> <p95> <p99> <max>
+
+    On the master the age of the shared data of each node follows, see getNodeSyncLatencies():
+
+    latency <node> decode <p50> <p95> <p99> <max> predraw <p50> <p95> <p99> <max> draw <p50> <p95> <p99> <max> swap <p50> <p95> <p99> <max> rtt <p50> <p95> <p99> <max>
+*/
+void sgct::Engine::sendStatisticsToExternalControl()
+{
+    std::vector<std::string> nodeNames;
+    std::vector<sgct_core::StatisticsRecord> records;
+    getNodeStatistics(nodeNames, records);
+
+    const char * metricNames[sgct_core::StatisticsRecord::NumberOfMetrics] = { "frame", "draw", "sync" };
+
+    std::stringstream ss;
+    ss.setf(std::ios::fixed);
+    ss.precision(3);
+    for (std::size_t i = 0; i < records.size(); i++)
+    {
+        ss << "stats " << nodeNames[i];
+        for (std::size_t j = 0; j < sgct_core::StatisticsRecord::NumberOfMetrics; j++)
+        {
+            ss << " " << metricNames[j];
+            for (std::size_t k = 0; k < sgct_core::StatisticsRecord::NumberOfPercentiles; k++)
+                ss << " " << records[i].mValues[j][k] * 1000.0f;
+        }
+        ss << "\r\n";
+    }
+
+    std::vector<sgct_core::SyncLatencySummary> summaries;
+    getNodeSyncLatencies(nodeNames, summaries);
+
+    const char * stageNames[sgct_core::SyncLatencyRecord::NumberOfStages] = { "decode", "predraw", "draw", "swap" };
+    for (std::size_t i = 0; i < summaries.size(); i++)
+    {
+        ss << "latency " << nodeNames[i];
+        for (std::size_t j = 0; j < sgct_core::SyncLatencyRecord::NumberOfStages; j++)
+        {
+            ss << " " << stageNames[j];
+            for (std::size_t k = 0; k < sgct_core::StatisticsRecord::NumberOfPercentiles; k++)
+                ss << " " << summaries[i].mValues[j][k] * 1000.0f;
+        }
+        ss << " rtt";
+        for (std::size_t k = 0; k < sgct_core::StatisticsRecord::NumberOfPercentiles; k++)
+            ss << " " << summaries[i].mRoundTripTimes[k] * 1000.0f;
+        ss << "\r\n";
+    }
+
+    sendMessageToExternalControl(ss.str());
+}
+
 /*!
     Check if the external control is connected.
 */
@@ -4634,6 +5238,8 @@ void sgct::Engine::outputHelpMessage()
 \n--Capture-PNG                    \n\tUse png images for screen capture (default)\n\
 \n--Capture-JPG                    \n\tUse jpg images for screen capture\n\
 \n--Capture-TGA                    \n\tUse tga images for screen capture\n\
+\n--Capture-PFM                    \n\tUse pfm (float) images for screen capture\n\
+\n--Capture-HDR                    \n\tUse hdr (Radiance RGBE) images for screen capture\n\
 \n-numberOfCaptureThreads <integer>\n\tSet the maximum amount of threads\n\tthat should be used during framecapture (default 8)\n------------------------------------\n\n");
 }
 
@@ -4647,7 +5253,7 @@ void updateFrameLockLoop(void * arg)
 
     while(run)
     {
-        sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::FrameSyncMutex );
+        sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::FrameSyncMutex, SGCT_MUTEX_CALL_SITE );
         run = sRunUpdateFrameLockLoop;
         sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::FrameSyncMutex );
 
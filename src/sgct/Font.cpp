@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/Font.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/SGCTMemoryRegistry.h>
 
 /*!
 Default constructor for font face data.
@@ -33,6 +34,7 @@ sgct_text::Font::Font( const std::string & fontName, float height ) :
 	mListId = GL_FALSE;
 	mVAO = GL_FALSE;
     mVBO = GL_FALSE;
+	mGlyphTextureSize = 0;
 }
 
 /*!
@@ -199,6 +201,10 @@ void sgct_text::Font::clean()
 	
 	mFontFaceDataMap.clear();
 	FT_Done_Face(mFace);
+
+	mGlyphTextureSize = 0;
+	if (sgct::SGCTMemoryRegistry::exists())
+		sgct::SGCTMemoryRegistry::instance()->removeAllocations(this);
 }
 
 sgct_text::FontFaceData * sgct_text::Font::getFontFaceData(wchar_t c)
@@ -255,7 +261,15 @@ bool sgct_text::Font::createGlyph(wchar_t c, FontFaceData * FFDPtr)
 
 	//create texture
 	if (char_index > 0) //skip null
+	{
 		FFDPtr->mTexId = generateTexture(width, height, pixels);
+
+		//the compressed size is up to the driver, estimate the uncompressed size
+		mGlyphTextureSize += sgct::SGCTMemoryRegistry::getTextureSize(width, height, GL_RG8);
+		if (sgct::SGCTMemoryRegistry::exists())
+			sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::Fonts, sgct::SGCTMemoryRegistry::GPU, this,
+				mName + " glyph textures", mGlyphTextureSize);
+	}
 	else
 		FFDPtr->mTexId = GL_FALSE;
 
@@ -12,12 +12,10 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #ifndef SGCT_DONT_USE_EXTERNAL
 #include "../include/external/png.h"
 #include "../include/external/pngpriv.h"
-#include "../include/external/jpeglib.h"
 #include "../include/external/turbojpeg.h"
 #else
 #include <png.h>
 #include <pngpriv.h>
-#include <jpeglib.h>
 #include <turbojpeg.h>
 #endif
 #include <stdlib.h>
@@ -25,47 +23,31 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/Image.h>
 #include <sgct/MessageHandler.h>
 #include <sgct/SGCTSettings.h>
+#include <sgct/SGCTMemoryRegistry.h>
 #include <sgct/Engine.h>
+#include <sgct/helpers/SGCTMappedFile.h>
+#include <sgct/helpers/SGCTHalfFloat.h>
 
 #include <setjmp.h>
+#include <math.h>
+#include <vector>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
 
 #define PNG_BYTES_TO_CHECK 8
 #define TGA_BYTES_TO_CHECK 18
-#define READ_ENTIRE_FILE_TO_MEMORY 0
+#define PFM_BYTES_TO_CHECK 2
+#define HDR_BYTES_TO_CHECK 2
 
 struct PNG_IO_DATA
 {
     size_t memOffset;
+    size_t len;
     unsigned char * data;
 };
 
-//---------------- JPEG helpers -----------------
-struct my_error_mgr
-{
-    struct jpeg_error_mgr pub;    /* "public" fields */
-
-    jmp_buf setjmp_buffer;    /* for return to caller */
-};
-
-typedef struct my_error_mgr * my_error_ptr;
-
-/*
-* Here's the routine that will replace the standard error_exit method:
-*/
-
-METHODDEF(void) my_error_exit(j_common_ptr cinfo)
-{
-    /* cinfo->err really points to a my_error_mgr struct, so coerce pointer */
-    my_error_ptr myerr = (my_error_ptr)cinfo->err;
-
-    /* Always display the message. */
-    /* We could postpone this until after returning, if we chose. */
-    (*cinfo->err->output_message) (cinfo);
-
-    /* Return control to the setjmp point */
-    longjmp(myerr->setjmp_buffer, 1);
-}
-
 void readPNGFromBuffer(png_structp png_ptr, png_bytep outData, png_size_t length)
 {
     if ( length <= 0 )
@@ -89,30 +71,161 @@ void readPNGFromBuffer(png_structp png_ptr, png_bytep outData, png_size_t length
             
     //copy buffer
     PNG_IO_DATA * ioPtr = reinterpret_cast<PNG_IO_DATA*>(png_ptr->io_ptr);
+    if (ioPtr->memOffset + length > ioPtr->len)
+    {
+        png_error(png_ptr, "Image: PNG reading error! Unexpected end of data.");
+        return;
+    }
     memcpy(outData, ioPtr->data + ioPtr->memOffset, length);
     ioPtr->memOffset += length;
 
     //fprintf(stderr, "Lenght: %d\n", length);
 }
 
+static bool isHostLittleEndian()
+{
+    const unsigned int one = 1;
+    return *reinterpret_cast<const unsigned char *>(&one) == 1;
+}
+
+/*
+    Reads one Radiance scanline, either flat or new-style run length encoded where the four components are stored separately.
+*/
+static bool readRGBEScanline(const unsigned char * data, std::size_t len, std::size_t & pos, unsigned char * scanline, std::size_t width)
+{
+    if (width < 8 || width > 0x7fff || pos + 4 > len || data[pos] != 2 || data[pos + 1] != 2 || (data[pos + 2] & 0x80))
+    {
+        //flat
+        if (pos + width * 4 > len)
+            return false;
+        memcpy(scanline, data + pos, width * 4);
+        pos += width * 4;
+        return true;
+    }
+
+    if (((static_cast<std::size_t>(data[pos + 2]) << 8) | data[pos + 3]) != width)
+        return false;
+    pos += 4;
+
+    for (std::size_t c = 0; c < 4; c++)
+    {
+        std::size_t x = 0;
+        while (x < width)
+        {
+            if (pos >= len)
+                return false;
+
+            std::size_t count = data[pos++];
+            if (count > 128) //run
+            {
+                count -= 128;
+                if (x + count > width || pos >= len)
+                    return false;
+                unsigned char val = data[pos++];
+                for (std::size_t i = 0; i < count; i++)
+                    scanline[(x++) * 4 + c] = val;
+            }
+            else //literals
+            {
+                if (count == 0 || x + count > width || pos + count > len)
+                    return false;
+                for (std::size_t i = 0; i < count; i++)
+                    scanline[(x++) * 4 + c] = data[pos++];
+            }
+        }
+    }
+
+    return true;
+}
+
+/*
+    Run length encodes one component of a Radiance scanline.
+*/
+static void writeRGBEComponentRLE(const unsigned char * data, std::size_t count, std::vector<unsigned char> & out)
+{
+    const std::size_t minRunLength = 4;
+    std::size_t cur = 0;
+
+    while (cur < count)
+    {
+        std::size_t begRun = cur;
+        std::size_t runCount = 0;
+        std::size_t oldRunCount = 0;
+
+        //find the next run that is long enough
+        while (runCount < minRunLength && begRun < count)
+        {
+            begRun += runCount;
+            oldRunCount = runCount;
+            runCount = 1;
+            while (begRun + runCount < count && runCount < 127 && data[begRun] == data[begRun + runCount])
+                runCount++;
+        }
+
+        //write a short run preceding the long run as a run
+        if (oldRunCount > 1 && oldRunCount == begRun - cur)
+        {
+            out.push_back(static_cast<unsigned char>(128 + oldRunCount));
+            out.push_back(data[cur]);
+            cur = begRun;
+        }
+
+        //write literals up to the run
+        while (cur < begRun)
+        {
+            std::size_t nonRunCount = begRun - cur;
+            if (nonRunCount > 128)
+                nonRunCount = 128;
+            out.push_back(static_cast<unsigned char>(nonRunCount));
+            out.insert(out.end(), data + cur, data + cur + nonRunCount);
+            cur += nonRunCount;
+        }
+
+        //write the run
+        if (runCount >= minRunLength)
+        {
+            out.push_back(static_cast<unsigned char>(128 + runCount));
+            out.push_back(data[begRun]);
+            cur += runCount;
+        }
+    }
+}
+
 sgct_core::Image::Image()
 {
     mData = NULL;
     mRowPtrs = NULL;
+    mRowPtrsSize = 0;
+    mAllocator = NULL;
     
     mBytesPerChannel = 1;
     mChannels = 0;
     mSize_x = 0;
     mSize_y = 0;
     mDataSize = 0;
+    mBufferSize = 0;
     mExternalData = false;
     mPreferBGRForExport = true;
 	mPreferBGRForImport = true;
+    mHalfFloatImport = false;
+    mFloatData = false;
+
+    mJPEGCompressor = NULL;
+    mJPEGDecompressor = NULL;
+    mJPEGBuffer = NULL;
+    mJPEGBufferSize = 0;
 }
 
 sgct_core::Image::~Image()
 {
     cleanup();
+
+    if (mJPEGCompressor)
+        tjDestroy(mJPEGCompressor);
+    if (mJPEGDecompressor)
+        tjDestroy(mJPEGDecompressor);
+    if (mJPEGBuffer)
+        tjFree(mJPEGBuffer);
 }
 
 sgct_core::Image::FormatType sgct_core::Image::getFormatType(const std::string & filename)
@@ -152,6 +265,20 @@ sgct_core::Image::FormatType sgct_core::Image::getFormatType(const std::string &
         return FORMAT_TGA;
     }
 
+    //if portable float map
+    found = filenameLC.find(".pfm");
+    if (found != std::string::npos)
+    {
+        return FORMAT_PFM;
+    }
+
+    //if radiance rgbe
+    found = filenameLC.find(".hdr");
+    if (found != std::string::npos)
+    {
+        return FORMAT_HDR;
+    }
+
     //no match found
     return UNKNOWN_FORMAT;
 }
@@ -167,25 +294,26 @@ bool sgct_core::Image::load(std::string filename)
     bool res = false;
     double t0 = sgct::Engine::getTime();
 
-#if !READ_ENTIRE_FILE_TO_MEMORY
     switch (getFormatType(filename))
     {
     case FORMAT_PNG:
         res = loadPNG(filename);
-        if(res)
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was loaded successfully (%.2f ms)!\n", filename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
         break;
 
     case FORMAT_JPEG:
         res = loadJPEG(filename);
-        if (res)
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was loaded successfully (%.2f ms)!\n", filename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
         break;
 
     case FORMAT_TGA:
         res = loadTGA(filename);
-        if (res)
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was loaded successfully (%.2f ms)!\n", filename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
+        break;
+
+    case FORMAT_PFM:
+        res = loadPFM(filename);
+        break;
+
+    case FORMAT_HDR:
+        res = loadHDR(filename);
         break;
 
     default:
@@ -193,144 +321,46 @@ bool sgct_core::Image::load(std::string filename)
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Unknown file '%s'\n", filename.c_str());
         break;
     }
-#else
-
-    if (getFormatType(filename) == UNKNOWN_FORMAT)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Unknown file '%s'\n", filename.c_str());
-        return false;
-    }
-
-    //load enitre file into memory
-    std::ifstream file;
-    file.rdbuf()->pubsetbuf(0, 0); 
-    file.open(filename, std::ios::binary | std::ios::ate);
-    if (!file)
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: File '%s' not found!\n", filename.c_str());
-    else
-    {
-        std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
-
-        std::vector<char> buffer(size);
-        if (file.read(buffer.data(), size))
-        {
-            switch (getFormatType(filename))
-            {
-            case FORMAT_PNG:
-                res = loadPNG(reinterpret_cast<unsigned char*>(buffer.data()), static_cast<int>(buffer.size()));
-                if (res)
-                    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was loaded successfully (%.2f ms)!\n", filename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
-                break;
-
-            case FORMAT_JPEG:
-                res = loadJPEG(reinterpret_cast<unsigned char*>(buffer.data()), static_cast<int>(buffer.size()));
-                if (res)
-                    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was loaded successfully (%.2f ms)!\n", filename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
-                break;
-
-            case FORMAT_TGA:
-                res = loadTGA(reinterpret_cast<unsigned char*>(buffer.data()), static_cast<int>(buffer.size()));
-                if (res)
-                    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was loaded successfully (%.2f ms)!\n", filename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
-                break;
-            }
-
-            buffer.clear();
-        }
 
-        file.close();
-    }
-#endif
+    if (res)
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was loaded successfully (%.2f ms)!\n", filename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
 
     return res;
 }
 
-bool sgct_core::Image::loadJPEG(std::string filename)
+/*!
+    Maps the file into memory so that it can be decoded in place without intermediate copies.
+*/
+bool sgct_core::Image::mapFile(sgct_helpers::SGCTMappedFile & file, const char * formatName)
 {
-    if (filename.empty()) //one char + dot and suffix and is 5 char
+    if (!file.open(mFilename.c_str()))
     {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open %s texture file '%s'\n", formatName, mFilename.c_str());
         return false;
     }
 
-    mFilename.assign(filename);
-    
-    struct my_error_mgr jerr;
-    struct jpeg_decompress_struct cinfo;
-    FILE * fp = NULL;
-    JSAMPARRAY buffer;
-    std::size_t row_stride;
+    return true;
+}
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&fp, mFilename.c_str(), "rbS") != 0 || !fp)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open JPEG texture file '%s'\n", mFilename.c_str());
-        return false;
-    }
-#else
-    fp = fopen(mFilename.c_str(), "rb");
-    if (fp == NULL)
+bool sgct_core::Image::loadJPEG(std::string filename)
+{
+    if (filename.empty()) //one char + dot and suffix and is 5 char
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open JPEG texture file '%s'\n", mFilename.c_str());
         return false;
     }
-#endif
 
-    /* Step 1: allocate and initialize JPEG decompression object */
+    mFilename.assign(filename);
 
-    /* We set up the normal JPEG error routines, then override error_exit. */
-    cinfo.err = jpeg_std_error(&jerr.pub);
-    jerr.pub.error_exit = my_error_exit;
-    /* Establish the setjmp return context for my_error_exit to use. */
-    if (setjmp(jerr.setjmp_buffer))
-    {
-        /* If we get here, the JPEG code has signaled an error.
-        * We need to clean up the JPEG object, close the input file, and return.
-        */
-        jpeg_destroy_decompress(&cinfo);
-        fclose(fp);
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open JPEG texture file '%s'\n", mFilename.c_str());
+    sgct_helpers::SGCTMappedFile file;
+    if (!mapFile(file, "JPEG"))
         return false;
-    }
-    
-    jpeg_create_decompress(&cinfo);
-    jpeg_stdio_src(&cinfo, fp);
-    jpeg_read_header(&cinfo, TRUE);
-    jpeg_start_decompress(&cinfo);
-    row_stride = cinfo.output_width * cinfo.output_components;
 
-    //SGCT uses BGR so convert to that
-    cinfo.out_color_space = mPreferBGRForImport ? JCS_EXT_BGR : JCS_EXT_RGB;
-
-    mBytesPerChannel = 1; //only support 8-bit per color depth for jpeg even if the format supports up to 12-bit
-    mChannels = cinfo.output_components;
-    mSize_x = cinfo.output_width;
-    mSize_y = cinfo.output_height;
-    
-    if (!allocateOrResizeData())
+    if (!decodeJPEG(file.getData(), file.getSize()))
     {
-        jpeg_destroy_decompress(&cinfo);
-        fclose(fp);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't decode JPEG texture file '%s'\n", mFilename.c_str());
         return false;
     }
 
-    /* Make a one-row-high sample array that will go away when done with image */
-    buffer = (*cinfo.mem->alloc_sarray)
-        ((j_common_ptr)&cinfo, JPOOL_IMAGE, static_cast<JDIMENSION>(row_stride), 1);
-
-    std::size_t r = mSize_y-1;
-    while (cinfo.output_scanline < cinfo.output_height)
-    {
-        jpeg_read_scanlines(&cinfo, buffer, 1);
-        //flip vertically
-        memcpy(mData + row_stride*r, buffer[0], row_stride);
-        r--;
-    }
-
-    jpeg_finish_decompress(&cinfo);
-    jpeg_destroy_decompress(&cinfo);
-    fclose(fp);
-
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %s (%dx%d).\n", mFilename.c_str(), mSize_x, mSize_y);
 
     return true;
@@ -346,76 +376,81 @@ bool sgct_core::Image::loadJPEG(unsigned char * data, std::size_t len)
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load JPEG from memory. Invalid input data.");
         return false;
     }
-    
-    tjhandle turbo_jpeg_handle = tjInitDecompress();
-    
+
+    if (!decodeJPEG(data, len))
+        return false;
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %dx%d JPEG from memory.\n", mSize_x, mSize_y);
+
+    return true;
+}
+
+/*!
+ Decode a jpeg compressed buffer into the image data using TurboJPEG. The decompressor handle is kept and reused by later calls.
+ */
+bool sgct_core::Image::decodeJPEG(unsigned char * data, std::size_t len)
+{
+    if (mJPEGDecompressor == NULL)
+    {
+        mJPEGDecompressor = tjInitDecompress();
+        if (mJPEGDecompressor == NULL)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to initialize JPEG decompressor. Error: %s!\n", tjGetErrorStr());
+            return false;
+        }
+    }
+
+    int width;
+    int height;
     int jpegsubsamp;
     int pixelformat;
     int colorspace;
 
     mBytesPerChannel = 1; //only support 8-bit per color depth for jpeg even if the format supports up to 12-bit
-    
-    if (tjDecompressHeader3(turbo_jpeg_handle, data, static_cast<unsigned long>(len), reinterpret_cast<int*>(&mSize_x), reinterpret_cast<int*>(&mSize_y), &jpegsubsamp, &colorspace) < 0)
+    mFloatData = false;
+
+    if (tjDecompressHeader3(mJPEGDecompressor, data, static_cast<unsigned long>(len), &width, &height, &jpegsubsamp, &colorspace) < 0)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load JPEG from memory. Error: %s!\n", tjGetErrorStr());
-        tjDestroy(turbo_jpeg_handle);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to decode JPEG header. Error: %s!\n", tjGetErrorStr());
         return false;
     }
-    
+
     switch(jpegsubsamp)
     {
         case TJSAMP_444:
         case TJSAMP_422:
         case TJSAMP_420:
         case TJSAMP_440:
+        case TJSAMP_411:
             mChannels = 3;
             pixelformat = mPreferBGRForImport ? TJPF_BGR : TJPF_RGB;
             break;
-            
+
         case TJSAMP_GRAY:
             mChannels = 1;
             pixelformat = TJPF_GRAY;
             break;
 
         default:
-            mChannels = -1;
-            break;
-    }
-    
-    if(mChannels < 1)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load JPEG from memory. Unsupported chrominance subsampling!\n");
-        tjDestroy(turbo_jpeg_handle);
-        return false;
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to decode JPEG. Unsupported chrominance subsampling!\n");
+            return false;
     }
-    
+
+    mSize_x = static_cast<std::size_t>(width);
+    mSize_y = static_cast<std::size_t>(height);
+
     if (!allocateOrResizeData())
     {
-        tjDestroy(turbo_jpeg_handle);
         return false;
     }
 
-    if( !mData )
-    {
-        tjDestroy(turbo_jpeg_handle);
-        return false;
-
-    }
-    
-    if (tjDecompress2(turbo_jpeg_handle, data, static_cast<unsigned long>(len), mData, static_cast<int>(mSize_x), 0, static_cast<int>(mSize_y), pixelformat, TJFLAG_FASTDCT | TJFLAG_BOTTOMUP) < 0)
+    //SGCT stores images bottom-up so let TurboJPEG flip it while decoding
+    if (tjDecompress2(mJPEGDecompressor, data, static_cast<unsigned long>(len), mData, width, 0, height, pixelformat, TJFLAG_FASTDCT | TJFLAG_BOTTOMUP) < 0)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load JPEG from memory. Error: %s!\n", tjGetErrorStr());
-        tjDestroy(turbo_jpeg_handle);
-        
-        delete [] mData;
-        mData = NULL;
-        
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to decode JPEG. Error: %s!\n", tjGetErrorStr());
         return false;
     }
-    
-    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: Loaded %dx%d JPEG from memory.\n", mSize_x, mSize_y);
-    
-    tjDestroy(turbo_jpeg_handle);
+
     return true;
 }
 
@@ -428,75 +463,96 @@ bool sgct_core::Image::loadPNG(std::string filename)
 
     mFilename.assign(filename);
 
-    png_structp png_ptr;
-    png_infop info_ptr;
-    unsigned char header[PNG_BYTES_TO_CHECK];
-    int color_type, bpp;
+    sgct_helpers::SGCTMappedFile file;
+    if (!mapFile(file, "PNG"))
+        return false;
 
-    FILE *fp = NULL;
-    #if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&fp, mFilename.c_str(), "rbS") != 0 || !fp)
+    if (!decodePNG(file.getData(), file.getSize()))
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open PNG texture file '%s'\n", mFilename.c_str());
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't decode PNG texture file '%s'\n", mFilename.c_str());
         return false;
     }
-    #else
-    fp = fopen(mFilename.c_str(), "rb");
-    if( fp == NULL )
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %s (%dx%d %d-bit).\n", mFilename.c_str(), mSize_x, mSize_y, mBytesPerChannel * 8);
+
+    return true;
+}
+
+bool sgct_core::Image::loadPNG(unsigned char * data, std::size_t len)
+{
+    if(data == NULL || len <= PNG_BYTES_TO_CHECK)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open PNG texture file '%s'\n", mFilename.c_str());
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load PNG from memory. Invalid input data.");
         return false;
     }
-    #endif
 
-    size_t result = fread( header, 1, PNG_BYTES_TO_CHECK, fp );
-    if( result != PNG_BYTES_TO_CHECK || png_sig_cmp( (png_byte*) &header[0], 0, PNG_BYTES_TO_CHECK) )
+    if (!decodePNG(data, len))
+        return false;
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %dx%d %d-bit PNG from memory.\n", mSize_x, mSize_y, mBytesPerChannel*8);
+    
+    return true;
+}
+
+bool sgct_core::Image::decodePNG(unsigned char * data, std::size_t len)
+{
+    png_structp png_ptr;
+    png_infop info_ptr;
+    png_uint_32 width, height;
+    int color_type, bpp;
+    
+    if(len <= PNG_BYTES_TO_CHECK || png_sig_cmp(data, 0, PNG_BYTES_TO_CHECK))
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: file '%s' is not in PNG format\n", mFilename.c_str());
-        fclose(fp);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Invalid PNG file header.\n");
         return false;
     }
-
+    
     png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING, NULL, NULL, NULL );
     if( png_ptr == NULL )
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't initialize PNG file for reading: %s\n", mFilename.c_str());
-        fclose(fp);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't initialize PNG.\n");
         return false;
     }
-
+    
     info_ptr = png_create_info_struct(png_ptr);
     if( info_ptr == NULL )
     {
-        fclose(fp);
         png_destroy_read_struct(&png_ptr, (png_infopp)NULL, (png_infopp)NULL);
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't allocate memory to read PNG file: %s\n", mFilename.c_str());
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't allocate memory to read PNG data.\n");
         return false;
     }
-
+    
+    //set the read position in memory
+    PNG_IO_DATA io;
+    io.memOffset = PNG_BYTES_TO_CHECK;
+    io.data = data;
+    io.len = len;
+    png_set_read_fn(png_ptr, &io, readPNGFromBuffer);
+    
     if( setjmp(png_jmpbuf(png_ptr)) )
     {
         png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
-        fclose(fp);
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Exception occurred while reading PNG file: %s\n", mFilename.c_str());
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Exception occurred while reading PNG data.\n");
         return false;
     }
-
-    png_init_io(png_ptr, fp);
+    
     png_set_sig_bytes(png_ptr, PNG_BYTES_TO_CHECK);
     png_read_info(png_ptr, info_ptr);
     
-    png_get_IHDR(png_ptr, info_ptr, (png_uint_32 *)&mSize_x, (png_uint_32 *)&mSize_y, &bpp, &color_type, NULL, NULL, NULL);
+    png_get_IHDR(png_ptr, info_ptr, &width, &height, &bpp, &color_type, NULL, NULL, NULL);
+    mSize_x = static_cast<std::size_t>(width);
+    mSize_y = static_cast<std::size_t>(height);
     
     //set options
 	if(mPreferBGRForImport)
 		png_set_bgr(png_ptr);
     if (bpp < 8)
         png_set_packing(png_ptr);
-    else if(bpp == 16)
+    else if (bpp == 16)
         png_set_swap(png_ptr); //PNG_TRANSFORM_SWAP_ENDIAN
 
-    mBytesPerChannel = bpp / 8;
+    mBytesPerChannel = bpp == 16 ? 2 : 1;
+    mFloatData = false;
 
     if(color_type == PNG_COLOR_TYPE_GRAY )
     {
@@ -520,230 +576,84 @@ bool sgct_core::Image::loadPNG(std::string filename)
         mChannels = 4;
     else
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Unsupported format '%s'\n", mFilename.c_str());
-        fclose(fp);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Unsupported PNG color type.\n");
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
         return false;
     }
 
     if (!allocateOrResizeData())
     {
-        fclose(fp);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
         return false;
     }
 
     //flip the image
+    std::size_t rowSize = mSize_x * mChannels * mBytesPerChannel;
     std::size_t pos = mDataSize;
     for (std::size_t i = 0; i < mSize_y; i++)
     {
-        pos -= mSize_x * mChannels;
+        pos -= rowSize;
         png_read_row(png_ptr, &mData[pos], NULL);
     }
 
     png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
-    fclose(fp);
-
-    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %s (%dx%d %d-bit).\n", mFilename.c_str(), mSize_x, mSize_y, mBytesPerChannel * 8);
-
+    
     return true;
 }
 
-bool sgct_core::Image::loadPNG(unsigned char * data, std::size_t len)
+bool sgct_core::Image::loadTGA(std::string filename)
 {
-    if(data == NULL || len <= PNG_BYTES_TO_CHECK)
+    if (filename.empty()) //one char + dot and suffix and is 5 char
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load PNG from memory. Invalid input data.");
         return false;
     }
-    
-    png_structp png_ptr;
-    png_infop info_ptr;
-    unsigned char header[PNG_BYTES_TO_CHECK];
-    int color_type, bpp;
-    
-    //get header
-    memcpy( header, data, PNG_BYTES_TO_CHECK);
-    if(!png_check_sig( header, PNG_BYTES_TO_CHECK))
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Invalid PNG file header.\n");
+
+    mFilename.assign(filename);
+
+    sgct_helpers::SGCTMappedFile file;
+    if (!mapFile(file, "TGA"))
         return false;
-    }
-    
-    png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING, NULL, NULL, NULL );
-    if( png_ptr == NULL )
+
+    if (!decodeTGA(file.getData(), file.getSize()))
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't initialize PNG.\n");
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: file '%s' is not a valid TGA file or is corrupted\n", mFilename.c_str());
         return false;
     }
-    
-    info_ptr = png_create_info_struct(png_ptr);
-    if( info_ptr == NULL )
-    {
-        png_destroy_read_struct(&png_ptr, (png_infopp)NULL, (png_infopp)NULL);
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't allocate memory to read PNG data.\n");
-        return false;
-    }
-    
-    //set the read position in memory
-    PNG_IO_DATA io;
-    io.memOffset = PNG_BYTES_TO_CHECK;
-    io.data = data;
-    png_set_read_fn(png_ptr, &io, readPNGFromBuffer);
-    
-    if( setjmp(png_jmpbuf(png_ptr)) )
-    {
-        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Exception occurred while reading PNG data.\n");
-        return false;
-    }
-    
-    png_set_sig_bytes(png_ptr, PNG_BYTES_TO_CHECK);
-    png_read_info(png_ptr, info_ptr);
-    
-    png_get_IHDR(png_ptr, info_ptr, (png_uint_32 *)&mSize_x, (png_uint_32 *)&mSize_y, &bpp, &color_type, NULL, NULL, NULL);
-    
-    //set options
-	if(mPreferBGRForImport)
-		png_set_bgr(png_ptr);
-    if (bpp < 8)
-        png_set_packing(png_ptr);
-    else if (bpp == 16)
-        png_set_swap(png_ptr); //PNG_TRANSFORM_SWAP_ENDIAN
-
-    mBytesPerChannel = bpp / 8;
 
-    if(color_type == PNG_COLOR_TYPE_GRAY )
-    {
-        mChannels = 1;
-        if(bpp < 8)
-        {
-            png_set_expand_gray_1_2_4_to_8(png_ptr);
-            png_read_update_info(png_ptr, info_ptr);
-        }
-    }
-    else if(color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
-        mChannels = 2;
-    else if (color_type == PNG_COLOR_TYPE_PALETTE)
-    {
-        png_set_expand(png_ptr); //expand to RGB -> PNG_TRANSFORM_EXPAND
-        mChannels = 3;
-    }
-    else if(color_type == PNG_COLOR_TYPE_RGB)
-        mChannels = 3;
-    else if(color_type == PNG_COLOR_TYPE_RGB_ALPHA)
-        mChannels = 4;
-    else
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Unsupported format '%s'\n", mFilename.c_str());
-        return false;
-    }
-
-    if (!allocateOrResizeData())
-    {
-        return false;
-    }
-
-    //flip the image
-    std::size_t pos = mDataSize;
-    for (std::size_t i = 0; i < mSize_y; i++)
-    {
-        pos -= mSize_x * mChannels;
-        png_read_row(png_ptr, &mData[pos], NULL);
-    }
-
-    png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
-    
-    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %dx%d %d-bit PNG from memory.\n", mSize_x, mSize_y, mBytesPerChannel*8);
-    
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %s (%dx%d %d-bit).\n", mFilename.c_str(), mSize_x, mSize_y, mBytesPerChannel * 8);
     return true;
 }
 
-bool sgct_core::Image::loadTGA(std::string filename)
+bool sgct_core::Image::loadTGA(unsigned char * data, std::size_t len)
 {
-    if (filename.empty()) //one char + dot and suffix and is 5 char
-    {
-        return false;
-    }
-
-    mFilename.assign(filename);
-
-    unsigned char header[TGA_BYTES_TO_CHECK];
-
-    FILE *fp = NULL;
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&fp, mFilename.c_str(), "rbS") != 0 || !fp)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open TGA texture file '%s'\n", mFilename.c_str());
-        return false;
-    }
-#else
-    fp = fopen(mFilename.c_str(), "rb");
-    if (fp == NULL)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't open TGA texture file '%s'\n", mFilename.c_str());
-        return false;
-    }
-#endif
-
-    size_t result = fread(header, 1, TGA_BYTES_TO_CHECK, fp);
-    if (result != TGA_BYTES_TO_CHECK)
+    if (data == NULL || len <= TGA_BYTES_TO_CHECK)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: file '%s' is not in TGA format\n", mFilename.c_str());
-        fclose(fp);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load TGA from memory. Invalid input data.");
         return false;
     }
 
-    unsigned char data_type = header[2];
-    mSize_x = static_cast<int>(header[12]) + (static_cast<int>(header[13]) << 8);
-    mSize_y = static_cast<int>(header[14]) + (static_cast<int>(header[15]) << 8);
-    mChannels = static_cast<int>(header[16]) / 8;
-
-    if (!allocateOrResizeData())
+    if (!decodeTGA(data, len))
     {
-        fclose(fp);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: data is corrupted or insufficent!\n");
         return false;
     }
-    
-    if (data_type == 10)//RGB rle
-    {
-        if (!decodeTGARLE(fp))
-        {
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: file '%s' is corrupted\n", mFilename.c_str());
-            fclose(fp);
-            return false;
-        }
-    }
-    else
-    {
-        result = fread(mData, 1, mDataSize, fp);
-
-        if (result != mDataSize)
-        {
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: file '%s' is corrupted\n", mFilename.c_str());
-            fclose(fp);
-            return false;
-        }
-
-    }
 
-    //done with the file
-    fclose(fp);
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %dx%d TGA from memory.\n", mSize_x, mSize_y);
 
-    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %s (%dx%d %d-bit).\n", mFilename.c_str(), mSize_x, mSize_y, mBytesPerChannel * 8);
     return true;
 }
 
-bool sgct_core::Image::loadTGA(unsigned char * data, std::size_t len)
+bool sgct_core::Image::decodeTGA(unsigned char * data, std::size_t len)
 {
-    if (data == NULL || len <= TGA_BYTES_TO_CHECK)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load TGA from memory. Invalid input data.");
+    if (len <= TGA_BYTES_TO_CHECK)
         return false;
-    }
 
     unsigned char data_type = data[2];
-    mSize_x = static_cast<int>(data[12]) + (static_cast<int>(data[13]) << 8);
-    mSize_y = static_cast<int>(data[14]) + (static_cast<int>(data[15]) << 8);
-    mChannels = static_cast<int>(data[16]) / 8;
+    mSize_x = static_cast<std::size_t>(data[12]) + (static_cast<std::size_t>(data[13]) << 8);
+    mSize_y = static_cast<std::size_t>(data[14]) + (static_cast<std::size_t>(data[15]) << 8);
+    mChannels = static_cast<std::size_t>(data[16]) / 8;
+    mBytesPerChannel = 1;
+    mFloatData = false;
 
     if (!allocateOrResizeData())
     {
@@ -752,87 +662,13 @@ bool sgct_core::Image::loadTGA(unsigned char * data, std::size_t len)
 
     if (data_type == 10)//RGB rle
     {
-        if (!decodeTGARLE(&data[TGA_BYTES_TO_CHECK], len - TGA_BYTES_TO_CHECK))
-        {
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: data is corrupted or insufficent!\n");
-            return false;
-        }
-    }
-    else
-    {
-        if (len < (mDataSize + TGA_BYTES_TO_CHECK))
-        {
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: data is corrupted or insufficent!\n");
-            return false;
-        }
-        
-        memcpy(mData, &data[TGA_BYTES_TO_CHECK], mDataSize);
+        return decodeTGARLE(&data[TGA_BYTES_TO_CHECK], len - TGA_BYTES_TO_CHECK);
     }
     
-    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %dx%d TGA from memory.\n", mSize_x, mSize_y);
-
-    return true;
-}
-
-bool sgct_core::Image::decodeTGARLE(FILE * fp)
-{
-    std::size_t pixelcount = mSize_x * mSize_y;
-    std::size_t currentpixel = 0;
-    std::size_t currentbyte = 0;
-    unsigned char chunkheader;
-    unsigned char * chunkPtr;
-    std::size_t res;
-
-    do
-    {
-        chunkheader = 0;
-
-        if (fread(&chunkheader, 1, 1, fp) == 0)
-        {
-            return false;
-        }
-
-        if (chunkheader < 128)
-        {
-            chunkheader++;
-            for (unsigned char counter = 0; counter < chunkheader; counter++)
-            {
-                res = fread(&mData[currentbyte], 1, mChannels, fp);
-                if (res != mChannels)
-                    return false;
-
-                currentbyte += mChannels;
-                currentpixel++;
-
-                if (currentpixel > pixelcount)
-                    break;
-            }
-        }
-        else
-        {
-            chunkheader -= 127;
-            res = fread(&mData[currentbyte], 1, mChannels, fp);
-            if (res != mChannels)
-                return false;
-
-            chunkPtr = &mData[currentbyte];
-            currentbyte += mChannels;
-            currentpixel++;
-
-            for (short counter = 1; counter < chunkheader; counter++)
-            {
-                memcpy(&mData[currentbyte], chunkPtr, mChannels);
-
-                currentbyte += mChannels;
-                currentpixel++;
-
-                if (currentpixel > pixelcount)
-                    break;
-            }
-        }
-
-    } while (currentpixel < pixelcount);
-
+    if (len < (mDataSize + TGA_BYTES_TO_CHECK))
+        return false;
+    
+    memcpy(mData, &data[TGA_BYTES_TO_CHECK], mDataSize);
     return true;
 }
 
@@ -903,16 +739,330 @@ bool sgct_core::Image::decodeTGARLE(unsigned char * data, std::size_t len)
                 currentbyte += mChannels;
                 currentpixel++;
 
-                if (currentpixel > pixelcount)
-                {
-                    return false;
-                }
-            }
-        }
+                if (currentpixel > pixelcount)
+                {
+                    return false;
+                }
+            }
+        }
+
+    } while (currentpixel < pixelcount);
+
+    return true;
+}
+
+/*!
+ Load a portable float map (PFM) from file.
+ */
+bool sgct_core::Image::loadPFM(std::string filename)
+{
+    if (filename.empty())
+    {
+        return false;
+    }
+
+    mFilename.assign(filename);
+
+    sgct_helpers::SGCTMappedFile file;
+    if (!mapFile(file, "PFM"))
+        return false;
+
+    if (!decodePFM(file.getData(), file.getSize()))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: file '%s' is not a valid PFM file or is corrupted\n", mFilename.c_str());
+        return false;
+    }
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %s (%dx%d %d-bit float).\n", mFilename.c_str(), mSize_x, mSize_y, mBytesPerChannel * 8);
+    return true;
+}
+
+/*!
+ Load a portable float map (PFM) from memory.
+ */
+bool sgct_core::Image::loadPFM(unsigned char * data, std::size_t len)
+{
+    if (data == NULL || len <= PFM_BYTES_TO_CHECK)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load PFM from memory. Invalid input data.");
+        return false;
+    }
+
+    if (!decodePFM(data, len))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: data is corrupted or insufficent!\n");
+        return false;
+    }
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %dx%d PFM from memory.\n", mSize_x, mSize_y);
+
+    return true;
+}
+
+/*
+    Portable float map: "PF" (RGB) or "Pf" (grayscale), width, height and scale separated by white space
+    followed by raw floats stored bottom to top. A negative scale means little endian data.
+*/
+bool sgct_core::Image::decodePFM(unsigned char * data, std::size_t len)
+{
+    if (len <= PFM_BYTES_TO_CHECK || data[0] != 'P' || (data[1] != 'F' && data[1] != 'f'))
+        return false;
+
+    std::size_t channels = data[1] == 'F' ? 3 : 1;
+    std::size_t pos = PFM_BYTES_TO_CHECK;
+
+    char tokens[3][32];
+    for (std::size_t t = 0; t < 3; t++)
+    {
+        while (pos < len && isspace(data[pos]))
+            pos++;
+
+        std::size_t i = 0;
+        while (pos < len && !isspace(data[pos]) && i < 31)
+            tokens[t][i++] = static_cast<char>(data[pos++]);
+        tokens[t][i] = '\0';
+
+        if (i == 0)
+            return false;
+    }
+
+    //a single white space separates the header from the data
+    if (pos >= len || !isspace(data[pos]))
+        return false;
+    pos++;
+
+    long width = strtol(tokens[0], NULL, 10);
+    long height = strtol(tokens[1], NULL, 10);
+    double scale = strtod(tokens[2], NULL);
+    if (width <= 0 || height <= 0 || scale == 0.0)
+        return false;
+
+    std::size_t rowCount = static_cast<std::size_t>(width) * channels;
+    if ((len - pos) / (rowCount * sizeof(float)) < static_cast<std::size_t>(height))
+        return false;
+
+    mSize_x = static_cast<std::size_t>(width);
+    mSize_y = static_cast<std::size_t>(height);
+    mChannels = channels;
+    mBytesPerChannel = mHalfFloatImport ? 2 : 4;
+    mFloatData = true;
+
+    if (!allocateOrResizeData())
+        return false;
+
+    bool swapBytes = (scale < 0.0) != isHostLittleEndian();
+    std::vector<float> row(rowCount);
+
+    //both the file and the image are stored bottom to top
+    for (std::size_t y = 0; y < mSize_y; y++)
+    {
+        memcpy(&row[0], data + pos + y * rowCount * sizeof(float), rowCount * sizeof(float));
+
+        if (swapBytes)
+        {
+            unsigned char * bytes = reinterpret_cast<unsigned char *>(&row[0]);
+            for (std::size_t i = 0; i < rowCount * sizeof(float); i += 4)
+            {
+                std::swap(bytes[i], bytes[i + 3]);
+                std::swap(bytes[i + 1], bytes[i + 2]);
+            }
+        }
+
+        storeFloatRow(&row[0], y);
+    }
+
+    return true;
+}
+
+/*!
+ Load a Radiance RGBE (HDR) image from file.
+ */
+bool sgct_core::Image::loadHDR(std::string filename)
+{
+    if (filename.empty())
+    {
+        return false;
+    }
+
+    mFilename.assign(filename);
+
+    sgct_helpers::SGCTMappedFile file;
+    if (!mapFile(file, "HDR"))
+        return false;
+
+    if (!decodeHDR(file.getData(), file.getSize()))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: file '%s' is not a valid Radiance HDR file or is corrupted\n", mFilename.c_str());
+        return false;
+    }
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %s (%dx%d %d-bit float).\n", mFilename.c_str(), mSize_x, mSize_y, mBytesPerChannel * 8);
+    return true;
+}
+
+/*!
+ Load a Radiance RGBE (HDR) image from memory.
+ */
+bool sgct_core::Image::loadHDR(unsigned char * data, std::size_t len)
+{
+    if (data == NULL || len <= HDR_BYTES_TO_CHECK)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image: failed to load HDR from memory. Invalid input data.");
+        return false;
+    }
+
+    if (!decodeHDR(data, len))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: data is corrupted or insufficent!\n");
+        return false;
+    }
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Image: Loaded %dx%d HDR from memory.\n", mSize_x, mSize_y);
+
+    return true;
+}
+
+/*
+    Radiance RGBE: text header terminated by an empty line, a resolution line like "-Y 512 +X 768"
+    and scanlines of shared exponent RGBE pixels, usually run length encoded.
+*/
+bool sgct_core::Image::decodeHDR(unsigned char * data, std::size_t len)
+{
+    if (len <= HDR_BYTES_TO_CHECK || data[0] != '#' || data[1] != '?')
+        return false;
+
+    std::size_t pos = 0;
+    std::string line;
+
+    //header
+    while (true)
+    {
+        std::size_t lineStart = pos;
+        while (pos < len && data[pos] != '\n')
+            pos++;
+        if (pos >= len)
+            return false;
+
+        line.assign(reinterpret_cast<const char *>(data + lineStart), pos - lineStart);
+        pos++;
+
+        if (line.empty())
+            break;
+
+        if (line.compare(0, 7, "FORMAT=") == 0 && line.compare("FORMAT=32-bit_rle_rgbe") != 0)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Unsupported HDR format '%s'!\n", line.c_str());
+            return false;
+        }
+    }
+
+    //resolution
+    std::size_t lineStart = pos;
+    while (pos < len && data[pos] != '\n')
+        pos++;
+    if (pos >= len)
+        return false;
+    line.assign(reinterpret_cast<const char *>(data + lineStart), pos - lineStart);
+    pos++;
+
+    const char * str = line.c_str();
+    char * end;
+    if (line.size() < 2 || (str[0] != '-' && str[0] != '+') || str[1] != 'Y')
+        return false;
+    bool topDown = str[0] == '-';
+    long height = strtol(str + 2, &end, 10);
+    while (*end == ' ')
+        end++;
+    if (end[0] != '+' || end[1] != 'X') //mirrored images are not supported
+        return false;
+    long width = strtol(end + 2, NULL, 10);
+    if (width <= 0 || height <= 0)
+        return false;
+
+    mSize_x = static_cast<std::size_t>(width);
+    mSize_y = static_cast<std::size_t>(height);
+    mChannels = 3;
+    mBytesPerChannel = mHalfFloatImport ? 2 : 4;
+    mFloatData = true;
+
+    if (!allocateOrResizeData())
+        return false;
+
+    std::vector<unsigned char> scanline(mSize_x * 4);
+    std::vector<float> row(mSize_x * 3);
+
+    for (std::size_t i = 0; i < mSize_y; i++)
+    {
+        if (!readRGBEScanline(data, len, pos, &scanline[0], mSize_x))
+            return false;
+
+        for (std::size_t x = 0; x < mSize_x; x++)
+        {
+            const unsigned char * rgbe = &scanline[x * 4];
+            if (rgbe[3] == 0)
+            {
+                row[x * 3] = row[x * 3 + 1] = row[x * 3 + 2] = 0.0f;
+            }
+            else
+            {
+                float f = ldexpf(1.0f, static_cast<int>(rgbe[3]) - (128 + 8));
+                row[x * 3] = static_cast<float>(rgbe[0]) * f;
+                row[x * 3 + 1] = static_cast<float>(rgbe[1]) * f;
+                row[x * 3 + 2] = static_cast<float>(rgbe[2]) * f;
+            }
+        }
+
+        storeFloatRow(&row[0], topDown ? mSize_y - 1 - i : i);
+    }
+
+    return true;
+}
+
+/*
+    Stores a row of RGB ordered floats in the image format (float or half float, BGR if preferred).
+*/
+void sgct_core::Image::storeFloatRow(float * src, std::size_t y)
+{
+    std::size_t count = mSize_x * mChannels;
+
+    if (mPreferBGRForImport && mChannels >= 3)
+        for (std::size_t i = 0; i < count; i += mChannels)
+            std::swap(src[i], src[i + 2]);
+
+    unsigned char * dst = mData + y * count * mBytesPerChannel;
+    if (mBytesPerChannel == 2)
+        sgct_helpers::convertFloatToHalf(src, reinterpret_cast<unsigned short *>(dst), count);
+    else
+        memcpy(dst, src, count * sizeof(float));
+}
 
-    } while (currentpixel < pixelcount);
+/*
+    Reads a row of the image as RGB ordered floats. Integer data is normalized to [0, 1].
+*/
+void sgct_core::Image::readFloatRow(std::size_t y, float * dst)
+{
+    std::size_t count = mSize_x * mChannels;
+    const unsigned char * src = mData + y * count * mBytesPerChannel;
 
-    return true;
+    if (mFloatData && mBytesPerChannel == 4)
+        memcpy(dst, src, count * sizeof(float));
+    else if (mFloatData && mBytesPerChannel == 2)
+        sgct_helpers::convertHalfToFloat(reinterpret_cast<const unsigned short *>(src), dst, count);
+    else if (mBytesPerChannel == 2)
+    {
+        const unsigned short * src16 = reinterpret_cast<const unsigned short *>(src);
+        for (std::size_t i = 0; i < count; i++)
+            dst[i] = static_cast<float>(src16[i]) / 65535.0f;
+    }
+    else
+    {
+        for (std::size_t i = 0; i < count; i++)
+            dst[i] = static_cast<float>(src[i]) / 255.0f;
+    }
+
+    if (mPreferBGRForExport && mChannels >= 3)
+        for (std::size_t i = 0; i < count; i += mChannels)
+            std::swap(dst[i], dst[i + 2]);
 }
 
 /*!
@@ -943,6 +1093,14 @@ bool sgct_core::Image::save()
         return true;
         break;
 
+    case FORMAT_PFM:
+        return savePFM();
+        break;
+
+    case FORMAT_HDR:
+        return saveHDR();
+        break;
+
     default:
         //not found
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot save file '%s'\n", mFilename.c_str());
@@ -969,9 +1127,9 @@ bool sgct_core::Image::savePNG(int compressionLevel)
     if( mData == NULL )
         return false;
 
-    if (mBytesPerChannel > 2)
+    if (mBytesPerChannel > 2 || mFloatData)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot save %d-bit PNG.\n", mBytesPerChannel * 8);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot save %d-bit%s PNG.\n", mBytesPerChannel * 8, mFloatData ? " float" : "");
         return false;
     }
 
@@ -1066,6 +1224,9 @@ bool sgct_core::Image::savePNG(int compressionLevel)
     if (mBytesPerChannel == 2)
         png_set_swap(png_ptr);
 
+    if (!allocateRowPtrs())
+        return false;
+
     for (std::size_t y = 0; y<mSize_y; y++)
         mRowPtrs[(mSize_y - 1) - y] = (png_bytep)&mData[y * mSize_x * mChannels * mBytesPerChannel];
     png_write_image(png_ptr, mRowPtrs);
@@ -1085,98 +1246,229 @@ bool sgct_core::Image::savePNG(int compressionLevel)
     return true;
 }
 
+/*!
+    Save the image as a JPEG file using the filename set by setFilename.
+
+    Quality range 1-100 where 100 is best.
+*/
 bool sgct_core::Image::saveJPEG(int quality)
 {
     if (mData == NULL)
         return false;
 
-    if (mBytesPerChannel > 1)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot save %d-bit JPEG.\n", mBytesPerChannel * 8);
+    double t0 = sgct::Engine::getTime();
+
+    unsigned char * jpegBuf = NULL;
+    std::size_t jpegSize = 0;
+    if (!encodeJPEG(&jpegBuf, &jpegSize, quality))
         return false;
-    }
 
-    double t0 = sgct::Engine::getTime();
+    if (!writeBufferToFile(jpegBuf, jpegSize, "JPEG"))
+        return false;
 
-    FILE *fp = NULL;
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&fp, mFilename.c_str(), "wb") != 0 || !fp)
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't create JPEG file '%s'\n", mFilename.c_str());
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was saved successfully (%.2f ms)!\n", mFilename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
+    return true;
+}
+
+/*!
+    Compress the image data to JPEG in memory using TurboJPEG, no file is involved which makes it suitable for network streaming.
+
+    \param jpegBuf will point to the compressed data. The buffer is owned by the image and is reused by the next encode call so copy or send it before encoding again.
+    \param jpegSize will contain the number of compressed bytes
+    \param quality 1-100 where 100 is best
+    \returns true on success
+*/
+bool sgct_core::Image::encodeJPEG(unsigned char ** jpegBuf, std::size_t * jpegSize, int quality)
+{
+    if (mData == NULL || jpegBuf == NULL || jpegSize == NULL)
         return false;
-    }
-#else
-    fp = fopen(mFilename.c_str(), "wb");
-    if (fp == NULL)
+
+    if (mBytesPerChannel > 1)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't create JPEG file '%s'\n", mFilename.c_str());
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot save %d-bit JPEG.\n", mBytesPerChannel * 8);
         return false;
     }
-#endif
-    
-    struct jpeg_compress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    
-    JSAMPROW row_pointer[1]; /* pointer to JSAMPLE row[s] */
-    std::size_t row_stride;    /* physical row width in image buffer */
-
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_compress(&cinfo);
-    jpeg_stdio_dest(&cinfo, fp);
-
-    cinfo.image_width = static_cast<JDIMENSION>(mSize_x);
-    cinfo.image_height = static_cast<JDIMENSION>(mSize_y);
-    cinfo.input_components = static_cast<int>(mChannels);
 
+    int pixelformat;
+    int subsamp = TJSAMP_420;
     switch (mChannels)
     {
     case 4:
-        cinfo.in_color_space = mPreferBGRForExport ? JCS_EXT_BGRA : JCS_EXT_RGBA;
+        pixelformat = mPreferBGRForExport ? TJPF_BGRA : TJPF_RGBA;
         break;
 
     case 3:
     default:
-        cinfo.in_color_space = mPreferBGRForExport ? JCS_EXT_BGR : JCS_RGB;
+        pixelformat = mPreferBGRForExport ? TJPF_BGR : TJPF_RGB;
         break;
 
     case 2:
-        cinfo.in_color_space = JCS_UNKNOWN;
-        break;
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: JPEG doesn't support two channel output!\n");
+        return false;
 
     case 1:
-        cinfo.in_color_space = JCS_GRAYSCALE;
+        pixelformat = TJPF_GRAY;
+        subsamp = TJSAMP_GRAY;
         break;
     }
 
-    if (cinfo.in_color_space == JCS_UNKNOWN)
+    if (!prepareJPEGCompression(subsamp))
+        return false;
+
+    unsigned long size = mJPEGBufferSize;
+    //SGCT stores images bottom-up so let TurboJPEG flip it while encoding
+    if (tjCompress2(mJPEGCompressor, mData, static_cast<int>(mSize_x), 0, static_cast<int>(mSize_y), pixelformat,
+        &mJPEGBuffer, &size, subsamp, quality, TJFLAG_BOTTOMUP | TJFLAG_NOREALLOC) < 0)
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: JPEG doesn't support two channel output!\n");
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Failed to compress JPEG. Error: %s!\n", tjGetErrorStr());
         return false;
     }
 
-    jpeg_set_defaults(&cinfo);
-    jpeg_set_quality(&cinfo, quality, TRUE /* limit to baseline-JPEG values */);
+    *jpegBuf = mJPEGBuffer;
+    *jpegSize = static_cast<std::size_t>(size);
+    return true;
+}
+
+/*!
+    Compress planar YUV 4:2:0 data to JPEG in memory. This skips the RGB to YCbCr conversion on the CPU, for example when the conversion is done in a shader before the capture.
+
+    The planes must be stored contiguously (Y, U and V) using the same bottom-up row order as the rest of SGCT's image data and match the width and height of this image. The buffer size is given by getYUV420Size().
+
+    \param yuvData pointer to the Y plane followed by the U and V planes
+    \param jpegBuf will point to the compressed data. The buffer is owned by the image and is reused by the next encode call.
+    \param jpegSize will contain the number of compressed bytes
+    \param quality 1-100 where 100 is best
+    \returns true on success
+*/
+bool sgct_core::Image::encodeJPEGFromYUV420(unsigned char * yuvData, unsigned char ** jpegBuf, std::size_t * jpegSize, int quality)
+{
+    if (yuvData == NULL || jpegBuf == NULL || jpegSize == NULL || mSize_x == 0 || mSize_y == 0)
+        return false;
 
-    jpeg_start_compress(&cinfo, TRUE);
+    if (!prepareJPEGCompression(TJSAMP_420))
+        return false;
 
-    row_stride = mSize_x * mChannels;    /* JSAMPLEs per row in image_buffer */
+    int width = static_cast<int>(mSize_x);
+    int height = static_cast<int>(mSize_y);
 
-    while (cinfo.next_scanline < cinfo.image_height)
+    unsigned char * planes[3];
+    int strides[3];
+    std::size_t offset = 0;
+    for (int i = 0; i < 3; i++)
     {
-        //flip vertically
-        row_pointer[0] = &mData[(mSize_y - cinfo.next_scanline - 1) * row_stride];
-        jpeg_write_scanlines(&cinfo, row_pointer, 1);
+        int planeWidth = tjPlaneWidth(i, width, TJSAMP_420);
+        int planeHeight = tjPlaneHeight(i, height, TJSAMP_420);
+
+        //start at the last row and walk backwards to flip the bottom-up planes
+        planes[i] = yuvData + offset + static_cast<std::size_t>(planeWidth) * static_cast<std::size_t>(planeHeight - 1);
+        strides[i] = -planeWidth;
+        offset += static_cast<std::size_t>(planeWidth) * static_cast<std::size_t>(planeHeight);
     }
 
-    jpeg_finish_compress(&cinfo);
-    fclose(fp);
+    unsigned long size = mJPEGBufferSize;
+    if (tjCompressFromYUVPlanes(mJPEGCompressor, planes, width, strides, height, TJSAMP_420,
+        &mJPEGBuffer, &size, quality, TJFLAG_NOREALLOC) < 0)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Failed to compress YUV data to JPEG. Error: %s!\n", tjGetErrorStr());
+        return false;
+    }
+
+    *jpegBuf = mJPEGBuffer;
+    *jpegSize = static_cast<std::size_t>(size);
+    return true;
+}
+
+/*!
+    Compress planar YUV 4:2:0 data and save it as a JPEG file using the filename set by setFilename. See encodeJPEGFromYUV420 for the data layout.
+*/
+bool sgct_core::Image::saveJPEGFromYUV420(unsigned char * yuvData, int quality)
+{
+    double t0 = sgct::Engine::getTime();
+
+    unsigned char * jpegBuf = NULL;
+    std::size_t jpegSize = 0;
+    if (!encodeJPEGFromYUV420(yuvData, &jpegBuf, &jpegSize, quality))
+        return false;
 
-    jpeg_destroy_compress(&cinfo);
+    if (!writeBufferToFile(jpegBuf, jpegSize, "JPEG"))
+        return false;
 
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was saved successfully (%.2f ms)!\n", mFilename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
     return true;
 }
 
+/*!
+    Get the number of bytes needed to store planar YUV 4:2:0 data of the given size.
+*/
+std::size_t sgct_core::Image::getYUV420Size(std::size_t width, std::size_t height)
+{
+    return static_cast<std::size_t>(tjBufSizeYUV2(static_cast<int>(width), 1, static_cast<int>(height), TJSAMP_420));
+}
+
+/*!
+    Creates the TurboJPEG compressor and a worst case sized output buffer if needed. Both are kept between calls so that repeated captures of the same size don't allocate.
+*/
+bool sgct_core::Image::prepareJPEGCompression(int subsamp)
+{
+    if (mJPEGCompressor == NULL)
+    {
+        mJPEGCompressor = tjInitCompress();
+        if (mJPEGCompressor == NULL)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Failed to initialize JPEG compressor. Error: %s!\n", tjGetErrorStr());
+            return false;
+        }
+    }
+
+    unsigned long bufSize = tjBufSize(static_cast<int>(mSize_x), static_cast<int>(mSize_y), subsamp);
+    if (mJPEGBuffer == NULL || mJPEGBufferSize < bufSize)
+    {
+        if (mJPEGBuffer)
+            tjFree(mJPEGBuffer);
+
+        mJPEGBuffer = tjAlloc(static_cast<int>(bufSize));
+        if (mJPEGBuffer == NULL)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Failed to allocate %lu bytes for JPEG data.\n", bufSize);
+            mJPEGBufferSize = 0;
+            return false;
+        }
+        mJPEGBufferSize = bufSize;
+    }
+
+    return true;
+}
+
+bool sgct_core::Image::writeBufferToFile(const unsigned char * buffer, std::size_t size, const char * formatName)
+{
+    FILE *fp = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&fp, mFilename.c_str(), "wb") != 0 || !fp)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't create %s file '%s'\n", formatName, mFilename.c_str());
+        return false;
+    }
+#else
+    fp = fopen(mFilename.c_str(), "wb");
+    if (fp == NULL)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Can't create %s file '%s'\n", formatName, mFilename.c_str());
+        return false;
+    }
+#endif
+
+    std::size_t written = fwrite(buffer, 1, size, fp);
+    fclose(fp);
+
+    if (written != size)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Failed to write %s file '%s'\n", formatName, mFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
 bool sgct_core::Image::saveTGA()
 {
     if( mData == NULL )
@@ -1273,50 +1565,235 @@ bool sgct_core::Image::saveTGA()
             }
     }
 
-    //write row-by-row
-    if( data_type != 10 ) //Non RLE compression
-    {
-        fwrite(mData, 1, mDataSize, fp);
+    //write row-by-row
+    if( data_type != 10 ) //Non RLE compression
+    {
+        fwrite(mData, 1, mDataSize, fp);
+
+        /*for(int y=0; y<mSize_y; y++)
+            fwrite(&mData[y * mSize_x * mChannels], mChannels, mSize_x, fp);*/
+    }
+    else //RLE ->only for RBG and minimum size is 3x3
+    {
+        for(std::size_t y=0; y<mSize_y; y++)
+        {
+            std::size_t pos = 0;
+            unsigned char * row;
+            
+            while (pos < mSize_y)
+            {
+                row = &mData[y * mSize_x * mChannels];
+                bool rle = isTGAPackageRLE(row, pos);
+                std::size_t len = getTGAPackageLength(row, pos, rle);
+                
+                unsigned char packetHeader = static_cast<unsigned char>(len) - 1;
+                
+                if (rle)
+                    packetHeader |= (1 << 7);
+                
+                fwrite( &packetHeader, 1, 1, fp);
+                
+                rle ?
+                    fwrite( row + pos * mChannels, mChannels, 1, fp) :
+                    fwrite( row + pos * mChannels, mChannels, len, fp);
+                
+                pos += len;
+
+            }
+        }//end for
+    }//end if RLE
+
+    fwrite(footer, sizeof(char), sizeof(footer), fp);
+
+    fclose(fp);
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was saved successfully (%.2f ms)!\n", mFilename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
+
+    return true;
+}
+
+/*!
+Save the image as a little endian portable float map (PFM). Three and four channel images are saved as RGB (alpha is dropped),
+one and two channel images as grayscale. Integer images are normalized to [0, 1].
+*/
+bool sgct_core::Image::savePFM()
+{
+    if (mData == NULL)
+        return false;
+
+    if (mBytesPerChannel > 4 || (mBytesPerChannel > 2 && !mFloatData))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot save %d-bit PFM.\n", mBytesPerChannel * 8);
+        return false;
+    }
+
+    double t0 = sgct::Engine::getTime();
+
+    std::size_t channels = mChannels >= 3 ? 3 : 1;
+    char header[64];
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    sprintf_s(header, sizeof(header), "%s\n%u %u\n%s\n", channels == 3 ? "PF" : "Pf",
+#else
+    snprintf(header, sizeof(header), "%s\n%u %u\n%s\n", channels == 3 ? "PF" : "Pf",
+#endif
+        static_cast<unsigned int>(mSize_x), static_cast<unsigned int>(mSize_y), isHostLittleEndian() ? "-1.0" : "1.0");
+
+    std::size_t headerSize = strlen(header);
+    std::size_t rowSize = mSize_x * channels * sizeof(float);
+    std::vector<unsigned char> buffer(headerSize + rowSize * mSize_y);
+    memcpy(&buffer[0], header, headerSize);
+
+    std::vector<float> row(mSize_x * mChannels);
+    std::vector<float> outRow(mSize_x * channels);
+    for (std::size_t y = 0; y < mSize_y; y++)
+    {
+        readFloatRow(y, &row[0]);
+
+        if (channels == mChannels)
+            memcpy(&buffer[headerSize + y * rowSize], &row[0], rowSize);
+        else
+        {
+            for (std::size_t x = 0; x < mSize_x; x++)
+                for (std::size_t c = 0; c < channels; c++)
+                    outRow[x * channels + c] = row[x * mChannels + c];
+            memcpy(&buffer[headerSize + y * rowSize], &outRow[0], rowSize);
+        }
+    }
+
+    if (!writeBufferToFile(&buffer[0], buffer.size(), "PFM"))
+        return false;
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was saved successfully (%.2f ms)!\n", mFilename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
+    return true;
+}
+
+/*!
+Save the image as a run length encoded Radiance RGBE file (HDR). Alpha is dropped and one or two channel images are saved as gray.
+*/
+bool sgct_core::Image::saveHDR()
+{
+    if (mData == NULL)
+        return false;
+
+    if (mBytesPerChannel > 4 || (mBytesPerChannel > 2 && !mFloatData))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot save %d-bit HDR.\n", mBytesPerChannel * 8);
+        return false;
+    }
+
+    double t0 = sgct::Engine::getTime();
+
+    char header[128];
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    sprintf_s(header, sizeof(header), "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y %u +X %u\n",
+#else
+    snprintf(header, sizeof(header), "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y %u +X %u\n",
+#endif
+        static_cast<unsigned int>(mSize_y), static_cast<unsigned int>(mSize_x));
+
+    std::vector<unsigned char> buffer(header, header + strlen(header));
+    buffer.reserve(buffer.size() + mSize_x * mSize_y * 4);
+
+    std::vector<float> row(mSize_x * mChannels);
+    std::vector<unsigned char> scanline(mSize_x * 4);
+    std::vector<unsigned char> component(mSize_x);
+    bool rle = mSize_x >= 8 && mSize_x <= 0x7fff;
+
+    //stored top to bottom
+    for (std::size_t i = 0; i < mSize_y; i++)
+    {
+        readFloatRow(mSize_y - 1 - i, &row[0]);
+
+        for (std::size_t x = 0; x < mSize_x; x++)
+        {
+            const float * px = &row[x * mChannels];
+            float r = px[0];
+            float g = mChannels >= 3 ? px[1] : px[0];
+            float b = mChannels >= 3 ? px[2] : px[0];
+            float v = r > g ? r : g;
+            if (b > v)
+                v = b;
+
+            unsigned char * rgbe = &scanline[x * 4];
+            if (v < 1e-32f)
+            {
+                rgbe[0] = rgbe[1] = rgbe[2] = rgbe[3] = 0;
+            }
+            else
+            {
+                int e;
+                float m = frexpf(v, &e) * 256.0f / v;
+                rgbe[0] = static_cast<unsigned char>(r > 0.0f ? r * m : 0.0f);
+                rgbe[1] = static_cast<unsigned char>(g > 0.0f ? g * m : 0.0f);
+                rgbe[2] = static_cast<unsigned char>(b > 0.0f ? b * m : 0.0f);
+                rgbe[3] = static_cast<unsigned char>(e + 128);
+            }
+        }
+
+        if (rle)
+        {
+            buffer.push_back(2);
+            buffer.push_back(2);
+            buffer.push_back(static_cast<unsigned char>(mSize_x >> 8));
+            buffer.push_back(static_cast<unsigned char>(mSize_x & 0xFF));
+
+            for (std::size_t c = 0; c < 4; c++)
+            {
+                for (std::size_t x = 0; x < mSize_x; x++)
+                    component[x] = scanline[x * 4 + c];
+                writeRGBEComponentRLE(&component[0], mSize_x, buffer);
+            }
+        }
+        else
+            buffer.insert(buffer.end(), scanline.begin(), scanline.end());
+    }
+
+    if (!writeBufferToFile(&buffer[0], buffer.size(), "HDR"))
+        return false;
 
-        /*for(int y=0; y<mSize_y; y++)
-            fwrite(&mData[y * mSize_x * mChannels], mChannels, mSize_x, fp);*/
-    }
-    else //RLE ->only for RBG and minimum size is 3x3
-    {
-        for(std::size_t y=0; y<mSize_y; y++)
-        {
-            std::size_t pos = 0;
-            unsigned char * row;
-            
-            while (pos < mSize_y)
-            {
-                row = &mData[y * mSize_x * mChannels];
-                bool rle = isTGAPackageRLE(row, pos);
-                std::size_t len = getTGAPackageLength(row, pos, rle);
-                
-                unsigned char packetHeader = static_cast<unsigned char>(len) - 1;
-                
-                if (rle)
-                    packetHeader |= (1 << 7);
-                
-                fwrite( &packetHeader, 1, 1, fp);
-                
-                rle ?
-                    fwrite( row + pos * mChannels, mChannels, 1, fp) :
-                    fwrite( row + pos * mChannels, mChannels, len, fp);
-                
-                pos += len;
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was saved successfully (%.2f ms)!\n", mFilename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
+    return true;
+}
 
-            }
-        }//end for
-    }//end if RLE
+/*!
+Convert 32-bit float data to half floats in place. The buffer is kept so the image uses half of it afterwards.
+*/
+bool sgct_core::Image::convertToHalfFloat()
+{
+    if (mData == NULL || !mFloatData)
+        return false;
 
-    fwrite(footer, sizeof(char), sizeof(footer), fp);
+    if (mBytesPerChannel == 2) //already half floats
+        return true;
 
-    fclose(fp);
+    std::size_t count = mSize_x * mSize_y * mChannels;
+    sgct_helpers::convertFloatToHalf(reinterpret_cast<float *>(mData), reinterpret_cast<unsigned short *>(mData), count);
+    mBytesPerChannel = 2;
+    mDataSize = count * 2;
 
-    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: '%s' was saved successfully (%.2f ms)!\n", mFilename.c_str(), (sgct::Engine::getTime() - t0)*1000.0);
+    return true;
+}
+
+/*!
+Convert half float data to 32-bit floats. The image buffer is reallocated if needed.
+*/
+bool sgct_core::Image::convertToFloat()
+{
+    if (mData == NULL || !mFloatData)
+        return false;
+
+    if (mBytesPerChannel == 4) //already floats
+        return true;
 
+    std::size_t count = mSize_x * mSize_y * mChannels;
+    std::vector<unsigned short> halfData(count);
+    memcpy(&halfData[0], mData, count * sizeof(unsigned short));
+
+    mBytesPerChannel = 4;
+    if (!allocateOrResizeData())
+        return false;
+
+    sgct_helpers::convertHalfToFloat(&halfData[0], reinterpret_cast<float *>(mData), count);
     return true;
 }
 
@@ -1411,20 +1888,65 @@ bool sgct_core::Image::getPreferBGRImport() const
 	return mPreferBGRForImport;
 }
 
+/*!
+Set if PFM and HDR images should be stored as half floats when loaded, halving the memory and upload size.
+*/
+void sgct_core::Image::setHalfFloatImport(bool state)
+{
+    mHalfFloatImport = state;
+}
+
+bool sgct_core::Image::getHalfFloatImport() const
+{
+    return mHalfFloatImport;
+}
+
+/*!
+Set if the channels are floating point. Two bytes per channel are then interpreted as half floats and four bytes as floats.
+*/
+void sgct_core::Image::setFloatData(bool state)
+{
+    mFloatData = state;
+}
+
+bool sgct_core::Image::isFloatData() const
+{
+    return mFloatData;
+}
+
 void sgct_core::Image::cleanup()
 {
-    if (!mExternalData && mData)
-    {
-        delete [] mData;
-        mData = NULL;
-        mDataSize = 0;
-    }
+    releaseData();
 
     if(mRowPtrs)
     {
         delete [] mRowPtrs;
         mRowPtrs = NULL;
+        mRowPtrsSize = 0;
+    }
+}
+
+/*!
+    Frees the image data if it is owned by the image, external buffers are only detached.
+*/
+void sgct_core::Image::releaseData()
+{
+    if (!mExternalData && mData)
+    {
+        if (mAllocator)
+            mAllocator->deallocate(mData, mBufferSize);
+        else
+            delete [] mData;
+
+        //images can be released after the engine has destroyed the registry
+        if (sgct::SGCTMemoryRegistry::exists())
+            sgct::SGCTMemoryRegistry::instance()->removeAllocations(this);
     }
+
+    mData = NULL;
+    mDataSize = 0;
+    mBufferSize = 0;
+    mExternalData = false;
 }
 
 unsigned char * sgct_core::Image::getData()
@@ -1519,28 +2041,383 @@ float sgct_core::Image::getInterpolatedSampleAt(float x, float y, sgct_core::Ima
     float w3 = fx  * fy;
     
     float p0 = static_cast<float>( getSampleAt(px, py, c) );
-    float p1 = static_cast<float>( getSampleAt(px, py+1, c) );
-    float p2 = static_cast<float>( getSampleAt(px+1, py, c) );
+    float p1 = static_cast<float>( getSampleAt(px+1, py, c) );
+    float p2 = static_cast<float>( getSampleAt(px, py+1, c) );
     float p3 = static_cast<float>( getSampleAt(px+1, py+1, c) );
     
     return p0 * w0 + p1 * w1 + p2 * w2 + p3 * w3;
 }
 
-void sgct_core::Image::setDataPtr(unsigned char * dPtr)
+//texel loaders for the batch sampler
+struct SampleLoaderU8
 {
-    if (!mExternalData && mData)
+    typedef unsigned char Type;
+    static inline float load(const Type * p) { return static_cast<float>(*p); }
+};
+
+struct SampleLoaderU16
+{
+    typedef unsigned short Type;
+    static inline float load(const Type * p) { return static_cast<float>(*p); }
+};
+
+struct SampleLoaderHalf
+{
+    typedef unsigned short Type;
+    static inline float load(const Type * p) { return sgct_helpers::halfToFloat(*p); }
+};
+
+struct SampleLoaderFloat
+{
+    typedef float Type;
+    static inline float load(const Type * p) { return *p; }
+};
+
+/*
+    Bilinear weights for two taps or Catmull-Rom weights for four taps starting at floor(x) - 1.
+*/
+template <int Taps>
+static inline void getSampleWeights(float t, float * w)
+{
+    if (Taps == 2)
     {
-        delete[] mData;
-        mData = NULL;
-        mDataSize = 0;
+        w[0] = 1.0f - t;
+        w[1] = t;
+    }
+    else
+    {
+        w[0] = ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+        w[1] = (1.5f * t - 2.5f) * t * t + 1.0f;
+        w[2] = ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+        w[3] = (0.5f * t - 0.5f) * t * t;
+    }
+}
+
+static inline int clampSampleCoordinate(int c, int size)
+{
+    return c < 0 ? 0 : (c >= size ? size - 1 : c);
+}
+
+template <int Taps, class Loader>
+static void sampleScalar(const unsigned char * data, int width, int height, std::size_t channels,
+    std::size_t count, const float * xs, const float * ys, float * dst, bool border)
+{
+    const typename Loader::Type * texels = reinterpret_cast<const typename Loader::Type *>(data);
+
+    //coordinates further outside don't change the result, this also catches NaN and avoids integer overflow
+    float maxX = static_cast<float>(width + 1);
+    float maxY = static_cast<float>(height + 1);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        float x = xs[i] > -2.0f ? (xs[i] < maxX ? xs[i] : maxX) : -2.0f;
+        float y = ys[i] > -2.0f ? (ys[i] < maxY ? ys[i] : maxY) : -2.0f;
+        float xf = floorf(x);
+        float yf = floorf(y);
+        int x0 = static_cast<int>(xf) - (Taps / 2 - 1);
+        int y0 = static_cast<int>(yf) - (Taps / 2 - 1);
+
+        float wx[Taps];
+        float wy[Taps];
+        getSampleWeights<Taps>(x - xf, wx);
+        getSampleWeights<Taps>(y - yf, wy);
+
+        float * d = dst + i * channels;
+        for (std::size_t c = 0; c < channels; c++)
+            d[c] = 0.0f;
+
+        for (int j = 0; j < Taps; j++)
+        {
+            int yy = y0 + j;
+            if (border && (yy < 0 || yy >= height))
+                continue;
+
+            std::size_t row = static_cast<std::size_t>(clampSampleCoordinate(yy, height)) * static_cast<std::size_t>(width);
+            for (int k = 0; k < Taps; k++)
+            {
+                int xx = x0 + k;
+                if (border && (xx < 0 || xx >= width))
+                    continue;
+
+                const typename Loader::Type * p = texels + (row + clampSampleCoordinate(xx, width)) * channels;
+                float w = wx[k] * wy[j];
+                for (std::size_t c = 0; c < channels; c++)
+                    d[c] += w * Loader::load(p + c);
+            }
+        }
+    }
+}
+
+//no vectorized version, everything is sampled by the scalar loop
+template <int Taps, class Loader>
+static std::size_t sampleVectorized(const Loader &, const unsigned char *, std::size_t, int, int, std::size_t,
+    std::size_t, const float *, const float *, float *, bool)
+{
+    return 0;
+}
+
+#if defined(__AVX2__)
+/*
+    Gathers of 8-bit and 16-bit texels read 32-bit words. Words that would end beyond the image data are read from the last
+    word in the image and shifted into place.
+*/
+static inline __m256i gatherImageWords(const unsigned char * data, __m256i byteOffset, __m256i lastWord)
+{
+    __m256i safeOffset = _mm256_min_epi32(byteOffset, lastWord);
+    __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(byteOffset, safeOffset), 3);
+    return _mm256_srlv_epi32(_mm256_i32gather_epi32(reinterpret_cast<const int *>(data), safeOffset, 1), shift);
+}
+
+struct SampleGatherU8
+{
+    static inline void gather(const unsigned char * data, __m256i lastWord, __m256i texel, std::size_t channels, __m256 * values)
+    {
+        __m256i word = gatherImageWords(data, _mm256_mullo_epi32(texel, _mm256_set1_epi32(static_cast<int>(channels))), lastWord);
+        for (std::size_t c = 0; c < channels; c++)
+            values[c] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(word, _mm_cvtsi32_si128(static_cast<int>(c) * 8)), _mm256_set1_epi32(0xff)));
+    }
+};
+
+struct SampleGatherU16
+{
+    static inline void gather(const unsigned char * data, __m256i lastWord, __m256i texel, std::size_t channels, __m256 * values)
+    {
+        __m256i offset = _mm256_mullo_epi32(texel, _mm256_set1_epi32(static_cast<int>(channels * 2)));
+        __m256i words[2];
+        words[0] = gatherImageWords(data, offset, lastWord);
+        if (channels > 2)
+            words[1] = gatherImageWords(data, _mm256_add_epi32(offset, _mm256_set1_epi32(4)), lastWord);
+
+        for (std::size_t c = 0; c < channels; c++)
+            values[c] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(words[c / 2], _mm_cvtsi32_si128(static_cast<int>(c % 2) * 16)), _mm256_set1_epi32(0xffff)));
+    }
+};
+
+struct SampleGatherFloat
+{
+    static inline void gather(const unsigned char * data, __m256i, __m256i texel, std::size_t channels, __m256 * values)
+    {
+        __m256i index = _mm256_mullo_epi32(texel, _mm256_set1_epi32(static_cast<int>(channels)));
+        for (std::size_t c = 0; c < channels; c++)
+            values[c] = _mm256_i32gather_ps(reinterpret_cast<const float *>(data), _mm256_add_epi32(index, _mm256_set1_epi32(static_cast<int>(c))), 4);
+    }
+};
+
+template <int Taps>
+static inline void getSampleWeights(__m256 t, __m256 * w)
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    if (Taps == 2)
+    {
+        w[0] = _mm256_sub_ps(one, t);
+        w[1] = t;
+    }
+    else
+    {
+        const __m256 half = _mm256_set1_ps(0.5f);
+        __m256 t2 = _mm256_mul_ps(t, t);
+        w[0] = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-0.5f), t), one), t), half), t);
+        w[1] = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(1.5f), t), _mm256_set1_ps(2.5f)), t2), one);
+        w[2] = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.5f), t), _mm256_set1_ps(2.0f)), t), half), t);
+        w[3] = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(half, t), half), t2);
+    }
+}
+
+/*
+    Samples eight positions at a time using AVX2 gathers. Returns the number of samples processed, the rest are left to the scalar loop.
+*/
+template <int Taps, class Gather>
+static std::size_t sampleAVX2(const unsigned char * data, std::size_t dataSize, int width, int height, std::size_t channels,
+    std::size_t count, const float * xs, const float * ys, float * dst, bool border)
+{
+    const __m256i lastWord = _mm256_set1_epi32(static_cast<int>(dataSize - 4));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i widthV = _mm256_set1_epi32(width);
+    const __m256i heightV = _mm256_set1_epi32(height);
+    const __m256i maxXV = _mm256_set1_epi32(width - 1);
+    const __m256i maxYV = _mm256_set1_epi32(height - 1);
+    const __m256 minCoord = _mm256_set1_ps(-2.0f);
+    const __m256 maxXCoord = _mm256_set1_ps(static_cast<float>(width + 1));
+    const __m256 maxYCoord = _mm256_set1_ps(static_cast<float>(height + 1));
+    const __m256i tapOffset = _mm256_set1_epi32(Taps / 2 - 1);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        //max returns the second operand for NaN, like the scalar loop NaN becomes -2
+        __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(xs + i), minCoord), maxXCoord);
+        __m256 y = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(ys + i), minCoord), maxYCoord);
+        __m256 xf = _mm256_floor_ps(x);
+        __m256 yf = _mm256_floor_ps(y);
+        __m256i x0 = _mm256_sub_epi32(_mm256_cvttps_epi32(xf), tapOffset);
+        __m256i y0 = _mm256_sub_epi32(_mm256_cvttps_epi32(yf), tapOffset);
+
+        __m256 wx[Taps];
+        __m256 wy[Taps];
+        getSampleWeights<Taps>(_mm256_sub_ps(x, xf), wx);
+        getSampleWeights<Taps>(_mm256_sub_ps(y, yf), wy);
+
+        __m256i columns[Taps];
+        __m256i insideX[Taps];
+        for (int k = 0; k < Taps; k++)
+        {
+            __m256i xx = _mm256_add_epi32(x0, _mm256_set1_epi32(k));
+            insideX[k] = _mm256_and_si256(_mm256_cmpgt_epi32(xx, minusOne), _mm256_cmpgt_epi32(widthV, xx));
+            columns[k] = _mm256_min_epi32(_mm256_max_epi32(xx, zero), maxXV);
+        }
+
+        __m256 sums[4] = { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps() };
+        __m256 values[4];
+        for (int j = 0; j < Taps; j++)
+        {
+            __m256i yy = _mm256_add_epi32(y0, _mm256_set1_epi32(j));
+            __m256i insideY = _mm256_and_si256(_mm256_cmpgt_epi32(yy, minusOne), _mm256_cmpgt_epi32(heightV, yy));
+            __m256i row = _mm256_mullo_epi32(_mm256_min_epi32(_mm256_max_epi32(yy, zero), maxYV), widthV);
+
+            for (int k = 0; k < Taps; k++)
+            {
+                __m256 w = _mm256_mul_ps(wx[k], wy[j]);
+                if (border)
+                    w = _mm256_and_ps(w, _mm256_castsi256_ps(_mm256_and_si256(insideX[k], insideY)));
+
+                Gather::gather(data, lastWord, _mm256_add_epi32(row, columns[k]), channels, values);
+                for (std::size_t c = 0; c < channels; c++)
+                    sums[c] = _mm256_add_ps(sums[c], _mm256_mul_ps(w, values[c]));
+            }
+        }
+
+        //interleave the channels
+        float results[4][8];
+        for (std::size_t c = 0; c < channels; c++)
+            _mm256_storeu_ps(results[c], sums[c]);
+        float * d = dst + i * channels;
+        for (std::size_t s = 0; s < 8; s++)
+            for (std::size_t c = 0; c < channels; c++)
+                d[s * channels + c] = results[c][s];
+    }
+
+    return i;
+}
+
+template <int Taps>
+static std::size_t sampleVectorized(const SampleLoaderU8 &, const unsigned char * data, std::size_t dataSize, int width, int height, std::size_t channels,
+    std::size_t count, const float * xs, const float * ys, float * dst, bool border)
+{
+    return sampleAVX2<Taps, SampleGatherU8>(data, dataSize, width, height, channels, count, xs, ys, dst, border);
+}
+
+template <int Taps>
+static std::size_t sampleVectorized(const SampleLoaderU16 &, const unsigned char * data, std::size_t dataSize, int width, int height, std::size_t channels,
+    std::size_t count, const float * xs, const float * ys, float * dst, bool border)
+{
+    return sampleAVX2<Taps, SampleGatherU16>(data, dataSize, width, height, channels, count, xs, ys, dst, border);
+}
+
+template <int Taps>
+static std::size_t sampleVectorized(const SampleLoaderFloat &, const unsigned char * data, std::size_t dataSize, int width, int height, std::size_t channels,
+    std::size_t count, const float * xs, const float * ys, float * dst, bool border)
+{
+    return sampleAVX2<Taps, SampleGatherFloat>(data, dataSize, width, height, channels, count, xs, ys, dst, border);
+}
+#endif
+
+template <int Taps, class Loader>
+static void sampleImage(const unsigned char * data, std::size_t dataSize, int width, int height, std::size_t channels,
+    std::size_t count, const float * xs, const float * ys, float * dst, bool border)
+{
+    std::size_t done = 0;
+    //gathers use 32-bit offsets and read whole words
+    if (channels <= 4 && dataSize >= 4 && dataSize <= 0x7fffffff)
+        done = sampleVectorized<Taps>(Loader(), data, dataSize, width, height, channels, count, xs, ys, dst, border);
+
+    sampleScalar<Taps, Loader>(data, width, height, channels, count - done, xs + done, ys + done, dst + done * channels, border);
+}
+
+/*!
+    Sample the image at many positions at once, all channels per position. This is much faster than getInterpolatedSampleAt and
+    uses AVX2 gathers when compiled with AVX2 support. Works with 8-bit, 16-bit, half float and float images.
+
+    Positions are in pixels where integer coordinates are the pixel centers, like in getInterpolatedSampleAt. The results have the same
+    range as the image data (for example [0, 255] for 8-bit images) and are not clamped, bicubic (Catmull-Rom) interpolation can overshoot.
+
+    \param count the number of positions
+    \param x the x coordinates
+    \param y the y coordinates
+    \param dst the destination buffer, must hold count * getChannels() floats
+    \param filter bilinear or bicubic interpolation
+    \param edgeMode SAMPLE_CLAMP_TO_EDGE repeats the edge pixels outside the image, SAMPLE_CLAMP_TO_BORDER samples zero outside the image
+    \returns false if the image has no data
+*/
+bool sgct_core::Image::sampleBatch(std::size_t count, const float * x, const float * y, float * dst, SampleFilter filter, SampleEdgeMode edgeMode) const
+{
+    if (mData == NULL || mSize_x == 0 || mSize_y == 0 || mChannels == 0)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot sample an empty image!\n");
+        return false;
+    }
+
+    std::size_t dataSize = mChannels * mSize_x * mSize_y * mBytesPerChannel;
+    int width = static_cast<int>(mSize_x);
+    int height = static_cast<int>(mSize_y);
+    bool border = edgeMode == SAMPLE_CLAMP_TO_BORDER;
+    bool cubic = filter == SAMPLE_BICUBIC;
+
+    if (mBytesPerChannel == 1)
+        cubic ? sampleImage<4, SampleLoaderU8>(mData, dataSize, width, height, mChannels, count, x, y, dst, border) :
+            sampleImage<2, SampleLoaderU8>(mData, dataSize, width, height, mChannels, count, x, y, dst, border);
+    else if (mBytesPerChannel == 2 && mFloatData)
+        cubic ? sampleImage<4, SampleLoaderHalf>(mData, dataSize, width, height, mChannels, count, x, y, dst, border) :
+            sampleImage<2, SampleLoaderHalf>(mData, dataSize, width, height, mChannels, count, x, y, dst, border);
+    else if (mBytesPerChannel == 2)
+        cubic ? sampleImage<4, SampleLoaderU16>(mData, dataSize, width, height, mChannels, count, x, y, dst, border) :
+            sampleImage<2, SampleLoaderU16>(mData, dataSize, width, height, mChannels, count, x, y, dst, border);
+    else if (mBytesPerChannel == 4)
+        cubic ? sampleImage<4, SampleLoaderFloat>(mData, dataSize, width, height, mChannels, count, x, y, dst, border) :
+            sampleImage<2, SampleLoaderFloat>(mData, dataSize, width, height, mChannels, count, x, y, dst, border);
+    else
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Cannot sample images with %u bytes per channel!\n",
+            static_cast<unsigned int>(mBytesPerChannel));
+        return false;
     }
 
-    allocateRowPtrs();
+    return true;
+}
+
+/*!
+    Use an external buffer for the image data. The buffer is not freed by the image.
+
+    \param dPtr pointer to the buffer
+    \param capacity the size of the buffer in bytes. Loading an image that doesn't fit will fail instead of re-allocating. If set to 0 the caller is responsible for the buffer being large enough.
+*/
+void sgct_core::Image::setDataPtr(unsigned char * dPtr, std::size_t capacity)
+{
+    releaseData();
     
     mData = dPtr;
+    mBufferSize = capacity;
+    mDataSize = mChannels * mSize_x * mSize_y * mBytesPerChannel;
     mExternalData = true;
 }
 
+/*!
+    Set an allocator for the image data, for example a pool shared between images of the same size. The allocator must outlive the image. Set to NULL to use the default heap allocation.
+*/
+void sgct_core::Image::setAllocator(sgct_core::ImageAllocator * allocator)
+{
+    releaseData();
+    mAllocator = allocator;
+}
+
+/*!
+    Get the size of the currently allocated or attached buffer in bytes. This can be larger than the data size since the buffer is reused for smaller images.
+*/
+std::size_t sgct_core::Image::getBufferSize() const
+{
+    return mBufferSize;
+}
+
 void sgct_core::Image::setSize(std::size_t width, std::size_t height)
 {
     mSize_x = width;
@@ -1570,47 +2447,70 @@ bool sgct_core::Image::allocateOrResizeData()
         return false;
     }
 
-    if (mData && mDataSize != dataSize) //re-allocate if needed
+    //reuse the current buffer if the new image fits
+    if (mData && (dataSize <= mBufferSize || (mExternalData && mBufferSize == 0)))
     {
-        cleanup();
+        mDataSize = dataSize;
+        return true;
     }
 
-    if ( !mData )
+    if (mExternalData)
     {
-        try
-        {
-            mData = new unsigned char[dataSize];
-            mDataSize = dataSize;
-            mExternalData = false;
-        }
-        catch (std::bad_alloc& ba)
-        {
-            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Failed to allocate %d bytes of image data (%s).\n", dataSize, ba.what());
-            mData = NULL;
-            mDataSize = 0;
-            return false;
-        }
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: External buffer of %d bytes is too small for %d bytes of image data!\n",
+            mBufferSize, dataSize);
+        return false;
+    }
 
-        if (!allocateRowPtrs())
-            return false;
+    releaseData();
+
+    try
+    {
+        mData = mAllocator ? mAllocator->allocate(dataSize) : new unsigned char[dataSize];
+    }
+    catch (std::bad_alloc& ba)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Image error: Failed to allocate %d bytes of image data (%s).\n", dataSize, ba.what());
+        mData = NULL;
+    }
 
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: Allocated %d bytes for image data (%.2f ms).\n", mDataSize, (sgct::Engine::getTime() - t0)*1000.0);
+    if (mData == NULL)
+    {
+        mDataSize = 0;
+        mBufferSize = 0;
+        return false;
     }
 
+    mDataSize = dataSize;
+    mBufferSize = dataSize;
+    mExternalData = false;
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::Images, sgct::SGCTMemoryRegistry::CPU, this, "image data", mBufferSize);
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Image: Allocated %d bytes for image data (%.2f ms).\n", mDataSize, (sgct::Engine::getTime() - t0)*1000.0);
+
     return true;
 }
 
+/*!
+    Allocates the row pointers used when saving PNGs. The pointers are kept and only re-allocated if the image height grows.
+*/
 bool sgct_core::Image::allocateRowPtrs()
 {
+    if (mRowPtrs && mRowPtrsSize >= mSize_y)
+        return true;
+
     if (mRowPtrs)
     {
         delete[] mRowPtrs;
         mRowPtrs = NULL;
+        mRowPtrsSize = 0;
     }
 
     try
     {
         mRowPtrs = new png_bytep[mSize_y];
+        mRowPtrsSize = mSize_y;
     }
     catch (std::bad_alloc& ba)
     {
@@ -0,0 +1,535 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+#include <sgct/ogl_headers.h>
+#include <sgct/ImageSequencePlayer.h>
+#include <sgct/SGCTThreadPool.h>
+#include <sgct/MessageHandler.h>
+#include <sgct/Engine.h>
+
+sgct::ImageSequencePlayer::FrameSlot::FrameSlot()
+{
+    mFrame = 0;
+    mState = Slot_Free;
+}
+
+sgct::ImageSequencePlayer::ImageSequencePlayer()
+{
+    mDecoderPool = NULL;
+    mReadAhead = 8;
+    mMemoryBudget = 0;
+    mUsableSlots = 0;
+    mFrameSize = 0;
+    mBudgetWarning = false;
+    mCurrentFrame = 0;
+    mLateFrames = 0;
+    mNumberOfThreads = std::thread::hardware_concurrency();
+    mLoop = true;
+    mWaitForFrames = true;
+    mInterpolate = true;
+
+    mTexId = GL_FALSE;
+    mPBO[0] = GL_FALSE;
+    mPBO[1] = GL_FALSE;
+    mPBOSize = 0;
+    mPBOIndex = 0;
+    mTexWidth = 0;
+    mTexHeight = 0;
+    mTexChannels = 0;
+    mTexBytesPerChannel = 0;
+    mTexFloat = false;
+}
+
+sgct::ImageSequencePlayer::~ImageSequencePlayer()
+{
+    close();
+}
+
+/*!
+    Open a sequence of image files. Must be called from a thread with a current openGL context.
+
+    \param filenames the paths to the frames in playback order
+    \returns false if the sequence is empty
+*/
+bool sgct::ImageSequencePlayer::open(const std::vector<std::string> & filenames)
+{
+    close();
+
+    if (filenames.empty())
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ImageSequencePlayer: Empty image sequence!\n");
+        return false;
+    }
+
+    mFilenames = filenames;
+    mCurrentFrame = 0;
+    mLateFrames = 0;
+    mFrameSize = 0;
+    mBudgetWarning = false;
+
+    if (mReadAhead < 1)
+        mReadAhead = 1;
+    for (std::size_t i = 0; i < mReadAhead; i++)
+        mSlots.push_back(new FrameSlot());
+    updateUsableSlots();
+
+    mDecoderPool = new sgct_core::SGCTThreadPool();
+    mDecoderPool->start(mNumberOfThreads);
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ImageSequencePlayer: Opened sequence of %u frames (read ahead: %u frames, decoder threads: %u).\n",
+        static_cast<unsigned int>(mFilenames.size()), static_cast<unsigned int>(mReadAhead), mNumberOfThreads);
+
+    return true;
+}
+
+/*!
+    Open a sequence of numbered image files.
+
+    \param pattern printf style pattern of the filenames, for example "frames/frame_%05d.png"
+    \param first the number of the first frame
+    \param count the number of frames
+    \returns false if the sequence is empty
+*/
+bool sgct::ImageSequencePlayer::open(const std::string & pattern, std::size_t first, std::size_t count)
+{
+    std::vector<std::string> filenames;
+    char buffer[1024];
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+        sprintf_s(buffer, sizeof(buffer), pattern.c_str(), static_cast<int>(first + i));
+#else
+        snprintf(buffer, sizeof(buffer), pattern.c_str(), static_cast<int>(first + i));
+#endif
+        filenames.push_back(std::string(buffer));
+    }
+
+    return open(filenames);
+}
+
+/*!
+    Stop decoding and release all buffers and openGL resources.
+*/
+void sgct::ImageSequencePlayer::close()
+{
+    if (mDecoderPool)
+    {
+        mDecoderPool->stop();
+        delete mDecoderPool;
+        mDecoderPool = NULL;
+    }
+
+    for (std::size_t i = 0; i < mSlots.size(); i++)
+        delete mSlots[i];
+    mSlots.clear();
+    mFilenames.clear();
+
+    releaseGLData();
+}
+
+/*!
+    Show a frame. Decoding of the following frames is scheduled and the requested frame is uploaded to the texture when it's decoded.
+    If waiting for frames is enabled (default) this function blocks until the frame is decoded, otherwise the previous frame is kept.
+    Must be called from a thread with a current openGL context, for example in the post-sync-pre-draw callback.
+
+    \param frameIndex the frame to show, should be synchronized across the cluster
+*/
+void sgct::ImageSequencePlayer::update(std::size_t frameIndex)
+{
+    if (mFilenames.empty())
+        return;
+
+    std::size_t frame = wrapFrame(frameIndex);
+    FrameSlot * slot = NULL;
+
+    {
+        std::unique_lock<std::mutex> lock(mSlotMutex);
+
+        if (frame == mCurrentFrame && mTexId != GL_FALSE)
+        {
+            scheduleFrames(frame + 1);
+            return;
+        }
+
+        while (true)
+        {
+            scheduleFrames(frame);
+            slot = findSlot(frame);
+
+            if (slot != NULL && slot->mState != Slot_Decoding)
+                break;
+
+            if (!mWaitForFrames)
+            {
+                slot = NULL;
+                break;
+            }
+
+            //wait for the frame or for a free slot
+            mSlotCondition.wait(lock);
+        }
+    }
+
+    if (slot == NULL)
+    {
+        mLateFrames++;
+        return;
+    }
+
+    //the slot is not touched by the decoders until it's released
+    if (slot->mState == Slot_Ready)
+        uploadFrame(slot);
+    else
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ImageSequencePlayer: Failed to load frame %u '%s'!\n",
+            static_cast<unsigned int>(frame), mFilenames[frame].c_str());
+
+    mCurrentFrame = frame;
+
+    mSlotMutex.lock();
+    //limit the number of buffers when the frame size is known
+    if (slot->mState == Slot_Ready && slot->mImage.getBufferSize() > 0)
+    {
+        mFrameSize = slot->mImage.getBufferSize();
+        updateUsableSlots();
+    }
+    slot->mState = Slot_Free;
+    scheduleFrames(frame + 1);
+
+    //only exceeded if a single frame doesn't fit or while frames above a reduced budget are decoding
+    std::size_t heldBytes = getHeldBytes();
+    if (mMemoryBudget > 0 && heldBytes > mMemoryBudget && !mBudgetWarning)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ImageSequencePlayer: Decoded frames use %u bytes, the memory budget is %u bytes!\n",
+            static_cast<unsigned int>(heldBytes), static_cast<unsigned int>(mMemoryBudget));
+        mBudgetWarning = true;
+    }
+    mSlotMutex.unlock();
+}
+
+/*!
+    \returns the number of bytes held by the decoded frame buffers
+*/
+std::size_t sgct::ImageSequencePlayer::getMemoryUsage()
+{
+    std::unique_lock<std::mutex> lock(mSlotMutex);
+    return getHeldBytes();
+}
+
+/*!
+    Set the number of frames that are decoded ahead of the current frame. Each frame needs one image buffer. Default is 8. Applied when the sequence is opened.
+*/
+void sgct::ImageSequencePlayer::setReadAhead(std::size_t frames)
+{
+    mReadAhead = frames;
+}
+
+/*!
+    Limit the memory used by the decoded frames. The number of frames read ahead is reduced if the frames don't fit. Only one frame is decoded
+    until the frame size is known and the buffers above the limit are released. Set to 0 (default) for no limit.
+*/
+void sgct::ImageSequencePlayer::setMemoryBudget(std::size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(mSlotMutex);
+    mMemoryBudget = bytes;
+    mBudgetWarning = false;
+    updateUsableSlots();
+}
+
+/*!
+    Set the number of decoder threads. Default is the number of hardware threads. Applied when the sequence is opened.
+*/
+void sgct::ImageSequencePlayer::setNumberOfThreads(unsigned int count)
+{
+    mNumberOfThreads = count;
+}
+
+/*!
+    Set if the frame index should wrap around at the end of the sequence (default) or stop at the last frame.
+*/
+void sgct::ImageSequencePlayer::setLoop(bool state)
+{
+    mLoop = state;
+}
+
+/*!
+    Set if update should block until the requested frame is decoded. This guarantees that all nodes show the same frame. Enabled by default.
+*/
+void sgct::ImageSequencePlayer::setWaitForFrames(bool state)
+{
+    mWaitForFrames = state;
+}
+
+/*!
+    Set if the texture should use bi-linear filtering. Enabled by default.
+*/
+void sgct::ImageSequencePlayer::setInterpolate(bool state)
+{
+    mInterpolate = state;
+}
+
+std::size_t sgct::ImageSequencePlayer::wrapFrame(std::size_t frameIndex) const
+{
+    std::size_t count = mFilenames.size();
+    if (mLoop)
+        return frameIndex % count;
+    else
+        return frameIndex < count ? frameIndex : count - 1;
+}
+
+/*!
+    Set the number of slots that fit in the memory budget. The slot mutex must be locked.
+*/
+void sgct::ImageSequencePlayer::updateUsableSlots()
+{
+    std::size_t slots = mSlots.size();
+    if (mMemoryBudget > 0)
+    {
+        //decode a single frame to get the frame size
+        slots = mFrameSize > 0 ? mMemoryBudget / mFrameSize : 1;
+        if (slots < 1)
+            slots = 1;
+    }
+    mUsableSlots = slots < mSlots.size() ? slots : mSlots.size();
+}
+
+/*!
+    \returns the number of bytes held by the slot images. The slot mutex must be locked.
+*/
+std::size_t sgct::ImageSequencePlayer::getHeldBytes() const
+{
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < mSlots.size(); i++)
+        bytes += mSlots[i]->mImage.getBufferSize();
+    return bytes;
+}
+
+/*!
+    Find the slot holding or decoding a frame. The slot mutex must be locked.
+*/
+sgct::ImageSequencePlayer::FrameSlot * sgct::ImageSequencePlayer::findSlot(std::size_t frame)
+{
+    for (std::size_t i = 0; i < mSlots.size(); i++)
+        if (mSlots[i]->mState != Slot_Free && mSlots[i]->mFrame == frame)
+            return mSlots[i];
+    return NULL;
+}
+
+/*!
+    Release decoded frames outside of the read ahead window and start decoding the missing frames in the window. The slot mutex must be locked.
+*/
+void sgct::ImageSequencePlayer::scheduleFrames(std::size_t frameIndex)
+{
+    std::size_t count = mFilenames.size();
+    if (!mLoop && frameIndex >= count)
+        return;
+    std::size_t first = wrapFrame(frameIndex);
+
+    for (std::size_t i = 0; i < mSlots.size(); i++)
+    {
+        FrameSlot * slot = mSlots[i];
+        if (slot->mState == Slot_Ready || slot->mState == Slot_Failed)
+        {
+            bool inWindow = slot->mFrame >= first ?
+                (slot->mFrame - first) < mReadAhead :
+                mLoop && (slot->mFrame + count - first) < mReadAhead;
+            if (!inWindow)
+                slot->mState = Slot_Free;
+        }
+    }
+
+    //release the buffers of the slots that no longer fit in the memory budget
+    for (std::size_t i = mUsableSlots; i < mSlots.size(); i++)
+        if (mSlots[i]->mState == Slot_Free && mSlots[i]->mImage.getBufferSize() > 0)
+            mSlots[i]->mImage.releaseData();
+
+    for (std::size_t i = 0; i < mReadAhead; i++)
+    {
+        if (!mLoop && first + i >= count)
+            break;
+
+        std::size_t frame = (first + i) % count;
+        if (findSlot(frame) != NULL)
+            continue;
+
+        FrameSlot * slot = NULL;
+        for (std::size_t j = 0; j < mUsableSlots; j++)
+            if (mSlots[j]->mState == Slot_Free)
+            {
+                slot = mSlots[j];
+                break;
+            }
+
+        if (slot == NULL) //all buffers in use
+            break;
+
+        slot->mFrame = frame;
+        slot->mState = Slot_Decoding;
+        mDecoderPool->addTask([this, slot]() { decodeFrame(slot); });
+    }
+}
+
+/*!
+    Decodes a frame into the slot image, called by a worker thread. The image keeps its buffer between frames so no allocations are needed when the frame size is constant.
+*/
+void sgct::ImageSequencePlayer::decodeFrame(FrameSlot * slot)
+{
+    bool success = slot->mImage.load(mFilenames[slot->mFrame]);
+
+    mSlotMutex.lock();
+    slot->mState = success ? Slot_Ready : Slot_Failed;
+    mSlotMutex.unlock();
+
+    mSlotCondition.notify_all();
+}
+
+/*!
+    Stream a decoded frame into the texture through a pixel unpack buffer.
+*/
+bool sgct::ImageSequencePlayer::uploadFrame(FrameSlot * slot)
+{
+    sgct_core::Image & img = slot->mImage;
+    int width = static_cast<int>(img.getWidth());
+    int height = static_cast<int>(img.getHeight());
+    int channels = static_cast<int>(img.getChannels());
+    int bpc = static_cast<int>(img.getBytesPerChannel());
+    std::size_t dataSize = img.getDataSize();
+
+    bool isFloat = img.isFloatData();
+
+    if (channels < 1 || channels > 4 || bpc > 4 || (bpc > 2 && !isFloat) || img.getData() == NULL)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ImageSequencePlayer: Unsupported frame format (%d channels, %d-bit)!\n", channels, bpc * 8);
+        return false;
+    }
+
+    bool isBGR = img.getPreferBGRImport();
+    bool fixed = sgct::Engine::instance()->isOGLPipelineFixed();
+    GLenum type = GL_RGB;
+    GLint internalFormat = GL_RGB8;
+    switch (channels)
+    {
+    case 1:
+        type = fixed ? GL_LUMINANCE : GL_RED;
+        internalFormat = fixed ? (bpc == 1 ? GL_LUMINANCE8 : GL_LUMINANCE16) : (bpc == 1 ? GL_R8 : GL_R16);
+        break;
+    case 2:
+        type = fixed ? GL_LUMINANCE_ALPHA : GL_RG;
+        internalFormat = fixed ? (bpc == 1 ? GL_LUMINANCE8_ALPHA8 : GL_LUMINANCE16_ALPHA16) : (bpc == 1 ? GL_RG8 : GL_RG16);
+        break;
+    case 3:
+        type = isBGR ? GL_BGR : GL_RGB;
+        internalFormat = bpc == 1 ? GL_RGB8 : GL_RGB16;
+        break;
+    case 4:
+        type = isBGR ? GL_BGRA : GL_RGBA;
+        internalFormat = bpc == 1 ? GL_RGBA8 : GL_RGBA16;
+        break;
+    }
+    GLenum format = (bpc == 1 ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT);
+
+    if (isFloat) //PFM or HDR frames as half or full floats
+    {
+        bool half = (bpc == 2);
+        switch (channels)
+        {
+        case 1:
+            internalFormat = fixed ? (half ? GL_LUMINANCE16F_ARB : GL_LUMINANCE32F_ARB) : (half ? GL_R16F : GL_R32F);
+            break;
+        case 2:
+            internalFormat = fixed ? (half ? GL_LUMINANCE_ALPHA16F_ARB : GL_LUMINANCE_ALPHA32F_ARB) : (half ? GL_RG16F : GL_RG32F);
+            break;
+        case 3:
+            internalFormat = half ? GL_RGB16F : GL_RGB32F;
+            break;
+        case 4:
+            internalFormat = half ? GL_RGBA16F : GL_RGBA32F;
+            break;
+        }
+        format = half ? GL_HALF_FLOAT : GL_FLOAT;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    //(re)allocate the texture storage if the frame format has changed
+    if (mTexId == GL_FALSE || width != mTexWidth || height != mTexHeight || channels != mTexChannels || bpc != mTexBytesPerChannel || isFloat != mTexFloat)
+    {
+        if (mTexId == GL_FALSE)
+            glGenTextures(1, &mTexId);
+        glBindTexture(GL_TEXTURE_2D, mTexId);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, type, format, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mInterpolate ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mInterpolate ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        mTexWidth = width;
+        mTexHeight = height;
+        mTexChannels = channels;
+        mTexBytesPerChannel = bpc;
+        mTexFloat = isFloat;
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "ImageSequencePlayer: Created texture %dx%d, %d-channels [id=%d]\n",
+            width, height, channels, mTexId);
+    }
+    else
+        glBindTexture(GL_TEXTURE_2D, mTexId);
+
+    if (mPBO[0] == GL_FALSE)
+        glGenBuffers(2, mPBO);
+    if (dataSize > mPBOSize)
+        mPBOSize = dataSize;
+
+    //alternate between two buffers and orphan the old storage so that the copy doesn't wait for the previous transfer
+    mPBOIndex = (mPBOIndex + 1) % 2;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBO[mPBOIndex]);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(mPBOSize), NULL, GL_STREAM_DRAW);
+
+    GLubyte * ptr = reinterpret_cast<GLubyte*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+    if (ptr)
+    {
+        memcpy(ptr, img.getData(), dataSize);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, type, format, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    else
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, type, format, img.getData());
+    }
+
+    glBindTexture(GL_TEXTURE_2D, GL_FALSE);
+    return true;
+}
+
+void sgct::ImageSequencePlayer::releaseGLData()
+{
+    if (mTexId != GL_FALSE)
+    {
+        glDeleteTextures(1, &mTexId);
+        mTexId = GL_FALSE;
+    }
+
+    if (mPBO[0] != GL_FALSE)
+    {
+        glDeleteBuffers(2, mPBO);
+        mPBO[0] = GL_FALSE;
+        mPBO[1] = GL_FALSE;
+    }
+
+    mPBOSize = 0;
+    mTexWidth = 0;
+    mTexHeight = 0;
+    mTexChannels = 0;
+    mTexBytesPerChannel = 0;
+    mTexFloat = false;
+}
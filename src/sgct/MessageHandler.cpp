@@ -5,31 +5,77 @@ All rights reserved.
 For conditions of distribution and use, see copyright notice in sgct.h
 *************************************************************************/
 
-#include <sgct/NetworkManager.h>
 #include <sgct/MessageHandler.h>
 #include <sgct/ClusterManager.h>
-#include <sgct/SGCTMutexManager.h>
 #include <sgct/helpers/SGCTPortedFunctions.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <signal.h>
 #include <iostream>
 #include <sstream>
 #include <string.h>
 #include <time.h>
+#include <chrono>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define LOG_CONSOLE_BATCH_SIZE 65536
+#define LOG_FULL_QUEUE_RETRIES 100
 
 sgct::MessageHandler * sgct::MessageHandler::mInstance = NULL;
 
+//signals that flush the log before the previous handler is invoked, only installed if enabled by setFlushOnCrash
+static struct CrashSignal
+{
+    int mSignal;
+    void (*mPreviousHandler)(int);
+} crashSignals[] = { { SIGSEGV, SIG_DFL }, { SIGABRT, SIG_DFL }, { SIGFPE, SIG_DFL }, { SIGILL, SIG_DFL } };
+static bool crashHandlersInstalled = false;
+
+//async-signal-safe write to a file descriptor
+static void writeToDescriptor(int fd, const char * buffer, std::size_t length)
+{
+    while (length > 0)
+    {
+#ifdef _WIN32
+        int written = _write(fd, buffer, static_cast<unsigned int>(length));
+#else
+        ssize_t written = write(fd, buffer, length);
+#endif
+        if (written <= 0)
+            return;
+        buffer += written;
+        length -= static_cast<std::size_t>(written);
+    }
+}
+
+/*
+    Format a message into dst without consuming the argument list.
+    Returns the length of the complete message, which is truncated if it doesn't fit, or a negative value on error.
+*/
+static int formatMessage(char * dst, std::size_t size, const char * fmt, va_list ap)
+{
+    va_list argcopy;
+    va_copy(argcopy, ap);
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    int length = _vsnprintf_s(dst, size, _TRUNCATE, fmt, argcopy);
+    if (length < 0) //truncated
+        length = vscprintf(fmt, ap);
+#else
+    int length = vsnprintf(dst, size, fmt, argcopy);
+#endif
+    va_end(argcopy);
+    return length;
+}
+
 sgct::MessageHandler::MessageHandler(void)
 {
-    mMaxMessageSize = 2048;
-    mCombinedMessageSize = mMaxMessageSize + 32;
-    
-    //nothrow makes sure that a null pointer is returned upon failiure
-    mParseBuffer    = new (std::nothrow) char[mMaxMessageSize];
-    mCombinedBuffer = new (std::nothrow) char[mCombinedMessageSize];
-    headerSpace        = new (std::nothrow) unsigned char[ sgct_core::SGCTNetwork::mHeaderSize ];
+    mQueue = new (std::nothrow) Message[ LOG_QUEUE_LENGTH ];
 
-    if( !headerSpace || !mCombinedBuffer || !headerSpace)
+    if( !mQueue )
     {
         fprintf(stderr, "Fatal error while allocating memory for MessageHandler!\n");
         return;
@@ -41,15 +87,8 @@ sgct::MessageHandler::MessageHandler(void)
     mLevel = NOTIFY_WARNING;
 #endif
 
-    mRecBuffer.reserve(mMaxMessageSize);
-    mBuffer.reserve(mMaxMessageSize);
-
-    headerSpace[0] = sgct_core::SGCTNetwork::DataId;
-    
-    //fill rest of header with SGCTNetwork::DefaultId
-    memset(headerSpace+1, sgct_core::SGCTNetwork::DefaultId, sgct_core::SGCTNetwork::mHeaderSize-1);
-    
-    mBuffer.insert(mBuffer.begin(), headerSpace, headerSpace+sgct_core::SGCTNetwork::mHeaderSize);
+    mServerMessageBufferSize = LOG_SERVER_BUFFER_SIZE;
+    mDroppedServerMessages = 0;
 
     mLocal = true;
     mShowTime = true;
@@ -59,133 +98,528 @@ sgct::MessageHandler::MessageHandler(void)
     mMessageCallback = SGCT_NULL_PTR;
 
     setLogPath(NULL);
+
+    //queue
+    for (uint64_t i = 0; i < LOG_QUEUE_LENGTH; i++)
+    {
+        mQueue[i].mSequence = i;
+        mQueue[i].mLongText = NULL;
+    }
+    mEnqueuePos = 0;
+    mDequeuePos = 0;
+    mDroppedMessages = 0;
+    mReportedDroppedMessages = 0;
+    mConsumerLock.clear();
+
+    //log file
+    mFile = NULL;
+    mFileDescriptor = -1;
+    mFileSize = 0;
+    mWriterTime = 0;
+    mWriterTimeBuffer[0] = '\0';
+    mMaxFileSize = 0;
+    mMaxNumberOfFiles = 5;
+
+    //flush the queue if the application exits without destroying the message handler
+    static bool exitHandlerInstalled = false;
+    if (!exitHandlerInstalled)
+    {
+        atexit(flushAtExit);
+        exitHandlerInstalled = true;
+    }
+
+    mRunning = true;
+    mWriterWaiting = false;
+    mWriterThread = new std::thread(writerThreadStarter, this);
+    mWriterThreadId = mWriterThread->get_id();
 }
 
 sgct::MessageHandler::~MessageHandler(void)
 {
-    mMessageCallback = SGCT_NULL_PTR;
+    //let the writer empty the queue
+    mRunning = false;
+    if (mWriterThread != NULL)
+    {
+        mWriterMutex.lock();
+        mWriterCondition.notify_one();
+        mWriterMutex.unlock();
+
+        mWriterThread->join();
+        delete mWriterThread;
+        mWriterThread = NULL;
+    }
 
-    if(mParseBuffer)
-        delete [] mParseBuffer;
-    mParseBuffer = NULL;
+    setFlushOnCrash(false);
 
-    if(mCombinedBuffer)
-        delete [] mCombinedBuffer;
-    mCombinedBuffer = NULL;
+    mCallbackMutex.lock();
+    mMessageCallback = SGCT_NULL_PTR;
+    mCallbackMutex.unlock();
 
-    if(headerSpace)
-        delete [] headerSpace;
-    headerSpace = NULL;
+    if (mQueue)
+    {
+        for (std::size_t i = 0; i < LOG_QUEUE_LENGTH; i++)
+            if (mQueue[i].mLongText != NULL)
+                delete[] mQueue[i].mLongText;
+        delete[] mQueue;
+    }
+    mQueue = NULL;
 
-    mBuffer.clear();
-    mRecBuffer.clear();
+    mServerMessages.clear();
 }
 
+/*!
+    Print messages received from a client. Called by the connection threads on the server.
+*/
 void sgct::MessageHandler::decode(const char * receivedData, int receivedlength, int clientIndex)
 {
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
-        mRecBuffer.clear();
-        mRecBuffer.insert(mRecBuffer.end(), receivedData, receivedData + receivedlength);
-        mRecBuffer.push_back('\0');
-        print("\n[client %d]: %s [end]\n", clientIndex, &mRecBuffer[0]);
-    SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
+    std::string messages(receivedData, receivedlength);
+    print("\n[client %d]: %s [end]\n", clientIndex, messages.c_str());
 }
 
+/*!
+    Formats the message into the queue, the writer thread prints it.
+*/
 void sgct::MessageHandler::printv(const char *fmt, va_list ap)
 {
-    //prevent writing to console simultaneously
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::ConsoleMutex );
+    //claim a message in the queue, a message is free when its sequence number equals the position
+    Message * msg = NULL;
+    unsigned int retries = 0;
+    uint64_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Message * candidate = &mQueue[pos & (LOG_QUEUE_LENGTH - 1)];
+        int64_t diff = static_cast<int64_t>(candidate->mSequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+            if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                msg = candidate;
+                break;
+            }
+        }
+        else if (diff < 0) //full, give the writer a chance to catch up before dropping the message
+        {
+            if (retries++ >= LOG_FULL_QUEUE_RETRIES)
+                break;
+            std::this_thread::yield();
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+        else
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+    }
+
+    char localText[LOG_MESSAGE_SIZE];
+    char * text = msg != NULL ? msg->mText : localText;
+    char * longText = NULL;
 
-    std::size_t size = static_cast<std::size_t>(1 + vscprintf(fmt, ap));
-    if( size > mMaxMessageSize )
+    int length = formatMessage(text, LOG_MESSAGE_SIZE, fmt, ap);
+    if (length < 0)
     {
-        delete [] mParseBuffer;
-        mParseBuffer = new (std::nothrow) char[size];
-        memset(mParseBuffer, 0, size);
-        
-        mMaxMessageSize = size;
-        mCombinedMessageSize = mMaxMessageSize + 32;
-
-        delete [] mCombinedBuffer;
-        mCombinedBuffer = new (std::nothrow) char[mCombinedMessageSize];
-        if (mCombinedBuffer == NULL)
-            return;
+        text[0] = '\0';
+        length = 0;
+    }
+    else if (static_cast<std::size_t>(length) >= LOG_MESSAGE_SIZE)
+    {
+        longText = new (std::nothrow) char[length + 1];
+        if (longText != NULL && formatMessage(longText, length + 1, fmt, ap) >= 0)
+            text = longText;
+        else
+            length = LOG_MESSAGE_SIZE - 1; //keep the truncated message
+    }
+
+    //if client send to server
+    sendMessageToServer(text);
+
+    if (msg != NULL)
+    {
+        msg->mTime = time(NULL);
+        msg->mShowTime = getShowTime();
+        msg->mLength = static_cast<uint32_t>(length);
+        msg->mLongText = text == longText ? longText : NULL;
+        msg->mSequence.store(pos + 1, std::memory_order_release);
+
+        //the writer only needs a signal if it's waiting for messages
+        if (mWriterWaiting.load())
+        {
+            mWriterMutex.lock();
+            mWriterCondition.notify_one();
+            mWriterMutex.unlock();
+        }
+    }
+    else
+    {
+        mDroppedMessages++;
+        if (longText != NULL)
+            delete[] longText;
+    }
+}
+
+void sgct::MessageHandler::writerThreadStarter(void * arg)
+{
+    reinterpret_cast<MessageHandler *>(arg)->writerThread();
+}
+
+void sgct::MessageHandler::writerThread()
+{
+    while (true)
+    {
+        bool running = mRunning.load();
+
+        std::size_t count = 0;
+        if (!mConsumerLock.test_and_set(std::memory_order_acquire))
+        {
+            count = processMessages();
+            mConsumerLock.clear(std::memory_order_release);
+        }
+
+        if (count > 0)
+        {
+            mWriterMutex.lock();
+            mFlushCondition.notify_all();
+            mWriterMutex.unlock();
+            continue;
+        }
+
+        if (!running)
+            break;
+
+        //sleep until a message is added, the timeout catches signals that are missed while the flag is set
+        std::unique_lock<std::mutex> lock(mWriterMutex);
+        mWriterWaiting = true;
+        uint64_t pos = mDequeuePos.load();
+        if (mRunning && mQueue[pos & (LOG_QUEUE_LENGTH - 1)].mSequence.load(std::memory_order_acquire) != pos + 1)
+            mWriterCondition.wait_for(lock, std::chrono::milliseconds(100));
+        mWriterWaiting = false;
+    }
+
+    closeLogFile();
+}
+
+/*!
+    Print all messages in the queue. Must only be called by the thread holding the consumer lock.
+
+    \returns the number of printed messages
+*/
+std::size_t sgct::MessageHandler::processMessages()
+{
+    //open or close the log file if the settings have changed
+    if (mLogToFile)
+        openLogFile();
+    else if (mFile != NULL)
+    {
+        closeLogFile();
+        mOpenFilename.clear();
+    }
 
-        memset(mCombinedBuffer, 0, mCombinedMessageSize);
-        
-        mRecBuffer.resize(mMaxMessageSize);
-        mBuffer.resize(mMaxMessageSize);
+    //take a copy of the callback so that it can be replaced while the batch is written
+    mCallbackMutex.lock();
+    mWriterCallback = mMessageCallback;
+    mCallbackMutex.unlock();
+
+    std::string consoleBatch;
+    std::size_t count = 0;
+
+    while (true)
+    {
+        uint64_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        Message & msg = mQueue[pos & (LOG_QUEUE_LENGTH - 1)];
+        if (msg.mSequence.load(std::memory_order_acquire) != pos + 1)
+            break; //empty or not completely written yet
+
+        writeMessage(msg.mLongText != NULL ? msg.mLongText : msg.mText, msg.mLength, msg.mTime, msg.mShowTime, consoleBatch);
+        if (msg.mLongText != NULL)
+        {
+            delete[] msg.mLongText;
+            msg.mLongText = NULL;
+        }
+
+        //free the message for the next lap
+        msg.mSequence.store(pos + LOG_QUEUE_LENGTH, std::memory_order_release);
+        mDequeuePos.store(pos + 1, std::memory_order_release);
+        count++;
+
+        if (consoleBatch.size() > LOG_CONSOLE_BATCH_SIZE)
+        {
+            std::cerr.write(consoleBatch.c_str(), consoleBatch.size());
+            consoleBatch.clear();
+        }
     }
-        
-    mParseBuffer[0] = '\0';
-    
+
+    uint64_t dropped = mDroppedMessages.load();
+    if (dropped != mReportedDroppedMessages)
+    {
+        char text[128];
 #if (_MSC_VER >= 1400) //visual studio 2005 or later
-    vsprintf_s(mParseBuffer, mMaxMessageSize, fmt, ap);    // And Converts Symbols To Actual Numbers
+        sprintf_s(text, 128, "MessageHandler: %llu messages were dropped because the queue was full!\n",
+            static_cast<unsigned long long>(dropped - mReportedDroppedMessages));
 #else
-    vsprintf(mParseBuffer, fmt, ap);
+        sprintf(text, "MessageHandler: %llu messages were dropped because the queue was full!\n",
+            static_cast<unsigned long long>(dropped - mReportedDroppedMessages));
 #endif
-    va_end(ap);        // Results Are Stored In Text
+        writeMessage(text, strlen(text), time(NULL), getShowTime(), consoleBatch);
+        mReportedDroppedMessages = dropped;
+        count++;
+    }
+
+    if (!consoleBatch.empty())
+    {
+        std::cerr.write(consoleBatch.c_str(), consoleBatch.size());
+        std::cerr.flush();
+    }
+
+    if (count > 0 && mFile != NULL)
+        fflush(mFile);
+
+    return count;
+}
 
-    //print local
-    if( getShowTime() )
+void sgct::MessageHandler::writeMessage(const char * message, std::size_t length, time_t timeStamp, bool showTime, std::string & consoleBatch)
+{
+    std::string & line = mWriterLine;
+    line.clear();
+    if (showTime)
     {
+        //localtime is slow, the string is only updated once per second
+        if (timeStamp != mWriterTime)
+        {
+            mWriterTime = timeStamp;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+            struct tm timeInfo;
+            if (localtime_s(&timeInfo, &timeStamp) == 0)
+                strftime(mWriterTimeBuffer, TIME_BUFFER_SIZE, "%X", &timeInfo);
+#elif defined(_WIN32)
+            //localtime uses thread local storage on windows
+            struct tm * timeInfoPtr = localtime(&timeStamp);
+            if (timeInfoPtr != NULL)
+                strftime(mWriterTimeBuffer, TIME_BUFFER_SIZE, "%X", timeInfoPtr);
+#else
+            struct tm timeInfo;
+            if (localtime_r(&timeStamp, &timeInfo) != NULL)
+                strftime(mWriterTimeBuffer, TIME_BUFFER_SIZE, "%X", &timeInfo);
+#endif
+        }
+        line.append(mWriterTimeBuffer);
+        line.append("| ");
+    }
+    line.append(message, length);
+
+    if (mLogToConsole)
+        consoleBatch.append(line);
+
+    if (mFile != NULL)
+        logToFile(line.c_str(), line.size());
+
+    if (mLogToCallback && mWriterCallback != SGCT_NULL_PTR)
+        mWriterCallback(line.c_str());
+}
+
+void sgct::MessageHandler::logToFile(const char * buffer, std::size_t length)
+{
+    std::size_t maxFileSize = mMaxFileSize.load();
+    if (maxFileSize > 0 && mFileSize > 0 && mFileSize + length > maxFileSize)
+        rotateLogFiles();
+
+    if (mFile == NULL)
+        return;
+
+    fwrite(buffer, 1, length, mFile);
+    mFileSize += length;
+}
+
+/*!
+    Open the log file if it isn't open. The file is kept open by the writer thread.
+*/
+void sgct::MessageHandler::openLogFile()
+{
+    std::string filename;
+    mFilenameMutex.lock();
+    filename = mFilename;
+    mFilenameMutex.unlock();
+
+    //don't retry if the file couldn't be opened
+    if (filename.empty() || filename == mOpenFilename)
+        return;
+
+    closeLogFile();
+    mOpenFilename = filename;
+    mFileSize = 0;
+
 #if (_MSC_VER >= 1400) //visual studio 2005 or later
-        sprintf_s( mCombinedBuffer, mCombinedMessageSize, "%s| %s", getTimeOfDayStr(), mParseBuffer );
+    if (fopen_s(&mFile, mOpenFilename.c_str(), "a") != 0)
+        mFile = NULL;
 #else
-        sprintf( mCombinedBuffer, "%s| %s", getTimeOfDayStr(), mParseBuffer );
+    mFile = fopen(mOpenFilename.c_str(), "a");
 #endif
-        if(mLogToConsole)
-            std::cerr << mCombinedBuffer;
 
-        if(mLogToFile)
-            logToFile( mCombinedBuffer );
-        if (mLogToCallback && mMessageCallback != SGCT_NULL_PTR)
-            mMessageCallback( mCombinedBuffer );
+    if (mFile == NULL)
+    {
+        std::cerr << "Failed to open '" << mOpenFilename << "'!" << std::endl;
+        return;
     }
-    else
+    mFileDescriptor = getDescriptor(mFile);
+
+    //continue an existing file
+    if (fseek(mFile, 0, SEEK_END) == 0)
     {
-        if (mLogToConsole)
-            std::cerr << mParseBuffer;
+        long size = ftell(mFile);
+        mFileSize = size > 0 ? static_cast<std::size_t>(size) : 0;
+    }
+}
 
-        if(mLogToFile)
-            logToFile( mParseBuffer );
-        if (mLogToCallback && mMessageCallback != SGCT_NULL_PTR)
-            mMessageCallback( mParseBuffer );
+/*!
+    Rename the log file to <name>.1.txt, shifting older files up and removing the oldest, and start a new file.
+*/
+void sgct::MessageHandler::rotateLogFiles()
+{
+    closeLogFile();
+    mFileSize = 0;
 
+    unsigned int maxNumberOfFiles = mMaxNumberOfFiles.load();
+    const char * mode = "a";
+    if (maxNumberOfFiles > 1)
+    {
+        remove(getRotatedFilename(maxNumberOfFiles - 1).c_str());
+        for (unsigned int i = maxNumberOfFiles - 2; i > 0; i--)
+            rename(getRotatedFilename(i).c_str(), getRotatedFilename(i + 1).c_str());
+        rename(mOpenFilename.c_str(), getRotatedFilename(1).c_str());
     }
+    else
+        mode = "w"; //no old files are kept
 
-    SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::ConsoleMutex );
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&mFile, mOpenFilename.c_str(), mode) != 0)
+        mFile = NULL;
+#else
+    mFile = fopen(mOpenFilename.c_str(), mode);
+#endif
 
-    //if client send to server
-    sendMessageToServer(mParseBuffer);
+    if (mFile == NULL)
+        std::cerr << "Failed to open '" << mOpenFilename << "'!" << std::endl;
+    else
+        mFileDescriptor = getDescriptor(mFile);
 }
 
-void sgct::MessageHandler::logToFile(const char * buffer)
+void sgct::MessageHandler::closeLogFile()
 {
-    if (mFilename.empty())
-        return;
-    
-    FILE* pFile = NULL;
-    bool error = false;
+    mFileDescriptor = -1;
+    if (mFile != NULL)
+        fclose(mFile);
+    mFile = NULL;
+}
 
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    errno_t err = fopen_s(&pFile, mFilename.c_str(), "a");
-    if( err != 0 || !pFile ) //error
-        error = true;
+int sgct::MessageHandler::getDescriptor(FILE * file)
+{
+#ifdef _WIN32
+    return _fileno(file);
 #else
-    pFile = fopen(mFilename.c_str(), "a");
-    if( pFile == NULL )
-        error = true;
+    return fileno(file);
 #endif
+}
+
+std::string sgct::MessageHandler::getRotatedFilename(unsigned int index)
+{
+    std::stringstream ss;
+    ss << "." << index;
+
+    std::size_t extension = mOpenFilename.find_last_of('.');
+    std::size_t separator = mOpenFilename.find_last_of("/\\");
+    if (extension == std::string::npos || (separator != std::string::npos && extension < separator))
+        return mOpenFilename + ss.str();
+
+    return mOpenFilename.substr(0, extension) + ss.str() + mOpenFilename.substr(extension);
+}
+
+/*!
+    Wait until all messages added before this call have been written. Doesn't wait if called from a log callback.
+*/
+void sgct::MessageHandler::flush()
+{
+    if (mWriterThread == NULL || std::this_thread::get_id() == mWriterThreadId)
+        return;
+
+    uint64_t target = mEnqueuePos.load();
+
+    std::unique_lock<std::mutex> lock(mWriterMutex);
+    mWriterCondition.notify_one();
+    while (mRunning && mDequeuePos.load() < target)
+        mFlushCondition.wait_for(lock, std::chrono::milliseconds(100));
+}
+
+void sgct::MessageHandler::flushAtExit()
+{
+    if (mInstance != NULL)
+        mInstance->flush();
+}
 
-    if( error )
+/*!
+    Writes the messages that are completely formatted in the queue to the console and the log file and invokes the
+    previous signal handler. Only async-signal-safe calls are made, so the messages are written without time stamps,
+    the queue is left untouched and the callback isn't invoked.
+*/
+void sgct::MessageHandler::crashHandler(int sig)
+{
+    MessageHandler * mh = mInstance;
+    if (mh != NULL && mh->mQueue != NULL)
     {
-        std::cerr << "Failed to open '" << mFilename << "'!" << std::endl;
+        int fd = mh->mFileDescriptor.load();
+        bool toConsole = mh->mLogToConsole.load();
+
+        uint64_t end = mh->mEnqueuePos.load();
+        for (uint64_t pos = mh->mDequeuePos.load(); pos < end; pos++)
+        {
+            const Message & msg = mh->mQueue[pos & (LOG_QUEUE_LENGTH - 1)];
+            if (msg.mSequence.load(std::memory_order_acquire) != pos + 1)
+                continue; //being written by the writer or the producer
+
+            const char * text = msg.mLongText != NULL ? msg.mLongText : msg.mText;
+            if (toConsole)
+                writeToDescriptor(2, text, msg.mLength);
+            if (fd >= 0)
+                writeToDescriptor(fd, text, msg.mLength);
+        }
+    }
+
+    for (std::size_t i = 0; i < sizeof(crashSignals) / sizeof(CrashSignal); i++)
+        if (crashSignals[i].mSignal == sig)
+        {
+            signal(sig, crashSignals[i].mPreviousHandler == SIG_IGN ? SIG_DFL : crashSignals[i].mPreviousHandler);
+            break;
+        }
+    raise(sig);
+}
+
+/*!
+    Install signal handlers that write the queued messages if the application crashes. Disabled by default since the
+    handlers replace the ones installed by the application; they are installed on top of them and chain to them after
+    writing. Messages that the writer thread has taken from the queue but not yet flushed may still be lost.
+*/
+void sgct::MessageHandler::setFlushOnCrash(bool state)
+{
+    if (state == crashHandlersInstalled)
         return;
+
+    for (std::size_t i = 0; i < sizeof(crashSignals) / sizeof(CrashSignal); i++)
+    {
+        if (state)
+        {
+            crashSignals[i].mPreviousHandler = signal(crashSignals[i].mSignal, crashHandler);
+            if (crashSignals[i].mPreviousHandler == SIG_ERR)
+                crashSignals[i].mPreviousHandler = SIG_DFL;
+        }
+        else
+            signal(crashSignals[i].mSignal, crashSignals[i].mPreviousHandler);
     }
+    crashHandlersInstalled = state;
+}
 
-    fprintf(pFile, "%s", buffer);
-    fclose(pFile);
+/*!
+ Set the maximum size of the log file in bytes before it is renamed and a new file is started. The renamed files get a number
+ before the extension, 1 being the latest. Older files than maxNumberOfFiles - 1 are removed. A size of zero disables rotation.
+ */
+void sgct::MessageHandler::setLogFileRotation(std::size_t maxFileSize, unsigned int maxNumberOfFiles)
+{
+    mMaxFileSize = maxFileSize;
+    mMaxNumberOfFiles = maxNumberOfFiles > 0 ? maxNumberOfFiles : 1;
 }
 
 /*!
@@ -223,7 +657,9 @@ void sgct::MessageHandler::setLogPath(const char * path, int nodeId)
         ss << tmpBuff << ".txt";
 #endif
 
+    mFilenameMutex.lock();
     mFilename.assign(ss.str());
+    mFilenameMutex.unlock();
 }
 
 /*!
@@ -232,10 +668,7 @@ void sgct::MessageHandler::setLogPath(const char * path, int nodeId)
 void sgct::MessageHandler::print(const char *fmt, ...)
 {
     if ( fmt == NULL )        // If There's No Text
-    {
-        *mParseBuffer=0;    // Do Nothing
-        return;
-    }
+        return;            // Do Nothing
 
     va_list        ap;        // Pointer To List Of Arguments
     va_start(ap, fmt);    // Parses The String For Variables
@@ -251,10 +684,7 @@ void sgct::MessageHandler::print(const char *fmt, ...)
 void sgct::MessageHandler::print(NotifyLevel nl, const char *fmt, ...)
 {
     if (nl > getNotifyLevel() || fmt == NULL)        // If There's No Text
-    {
-        *mParseBuffer=0;    // Do Nothing
-        return;
-    }
+        return;            // Do Nothing
 
     va_list        ap;        // Pointer To List Of Arguments
     va_start(ap, fmt);    // Parses The String For Variables
@@ -262,11 +692,44 @@ void sgct::MessageHandler::print(NotifyLevel nl, const char *fmt, ...)
     va_end(ap);
 }
 
+/*!
+    Discard the messages waiting to be sent to the server.
+*/
 void sgct::MessageHandler::clearBuffer()
 {
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
-    mBuffer.clear();
-    SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
+    mServerMessagesMutex.lock();
+    mServerMessages.clear();
+    mServerMessagesMutex.unlock();
+}
+
+/*!
+    Set the maximum number of bytes of messages waiting to be sent to the server. Messages that don't fit are dropped and counted.
+*/
+void sgct::MessageHandler::setServerMessageBufferSize(std::size_t size)
+{
+    mServerMessagesMutex.lock();
+    mServerMessageBufferSize = size;
+    mServerMessagesMutex.unlock();
+}
+
+/*!
+    Take the messages waiting to be sent to the server.
+
+    \param messages the message text without null termination, the previous content is swapped out
+    \param droppedMessages the number of messages dropped since the last call
+    \returns false if there are no messages or dropped messages to send
+*/
+bool sgct::MessageHandler::getServerMessages(std::vector<char> & messages, uint32_t & droppedMessages)
+{
+    messages.clear();
+
+    mServerMessagesMutex.lock();
+    mServerMessages.swap(messages);
+    droppedMessages = mDroppedServerMessages;
+    mDroppedServerMessages = 0;
+    mServerMessagesMutex.unlock();
+
+    return !messages.empty() || droppedMessages > 0;
 }
 
 /*!
@@ -330,19 +793,25 @@ void sgct::MessageHandler::setLogToCallback( bool state )
 }
 
 /*!
-Set the callback that gets invoked for each log if setLogToCallback is <code>true</code>
+Set the callback that gets invoked for each log if setLogToCallback is <code>true</code>.
+The callback is invoked from the log writer thread.
 */
 void sgct::MessageHandler::setLogCallback(void(*fnPtr)(const char *))
 {
+    mCallbackMutex.lock();
     mMessageCallback = fnPtr;
+    mCallbackMutex.unlock();
 }
 
 /*!
-Set the std callback that gets invoked for each log if setLogToCallback is <code>true</code>
+Set the std callback that gets invoked for each log if setLogToCallback is <code>true</code>.
+The callback is invoked from the log writer thread.
 */
 void sgct::MessageHandler::setLogCallback(sgct_cppxeleven::function<void(const char *)> fn)
 {
+    mCallbackMutex.lock();
     mMessageCallback = fn;
+    mCallbackMutex.unlock();
 }
 
 /*!
@@ -365,19 +834,11 @@ const char * sgct::MessageHandler::getTimeOfDayStr()
     return mTimeBuffer;
 }
 
-char * sgct::MessageHandler::getMessage()
-{
-    return &mBuffer[0];
-}
-
 void sgct::MessageHandler::printDebug(NotifyLevel nl, const char *fmt, ...)
 {
 #ifdef __SGCT_DEBUG__
     if (nl > getNotifyLevel() || fmt == NULL)
-    {
-        *mParseBuffer = 0;
         return;
-    }
 
     va_list ap;
     va_start(ap, fmt);    // Parses The String For Variables
@@ -389,10 +850,7 @@ void sgct::MessageHandler::printDebug(NotifyLevel nl, const char *fmt, ...)
 void sgct::MessageHandler::printIndent(NotifyLevel nl, unsigned int indentation, const char* fmt, ...)
 {
     if (nl > getNotifyLevel() || fmt == NULL)
-    {
-        *mParseBuffer = 0;
         return;
-    }
 
     va_list ap;
 
@@ -423,11 +881,14 @@ void sgct::MessageHandler::sendMessageToServer(const char * str)
     //if client send to server
     if(!mLocal)
     {
-        SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
-        if(mBuffer.empty())
-            mBuffer.insert(mBuffer.begin(), headerSpace, headerSpace+sgct_core::SGCTNetwork::mHeaderSize);
-        mBuffer.insert(mBuffer.end(), str, str + strlen(str));
-        SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
+        std::size_t length = strlen(str);
+
+        mServerMessagesMutex.lock();
+        if (mServerMessages.size() + length <= mServerMessageBufferSize)
+            mServerMessages.insert(mServerMessages.end(), str, str + length);
+        else
+            mDroppedServerMessages++;
+        mServerMessagesMutex.unlock();
     }
 }
 
@@ -16,6 +16,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/ClusterManager.h>
 #include <sgct/SharedData.h>
 #include <sgct/Engine.h>
+#include <sgct/SGCTTrace.h>
 #include <algorithm>
 
 #ifndef SGCT_DONT_USE_EXTERNAL
@@ -284,6 +285,7 @@ void sgct_core::NetworkManager::sync(sgct_core::NetworkManager::SyncMode sm, sgc
 {
     if(sm == SendDataToClients)
     {
+        SGCT_TRACE_SCOPE("NetworkManager::sync (send)");
         double maxTime = -999999.0;
         double minTime = 999999.0;
 
@@ -335,6 +337,20 @@ void sgct_core::NetworkManager::sync(sgct_core::NetworkManager::SyncMode sm, sgc
     }
 
     else if(sm == AcknowledgeData)
+    {
+        SGCT_TRACE_SCOPE("NetworkManager::sync (acknowledge)");
+
+        //the percentiles of this node are sent to the master with the acknowledge
+        StatisticsRecord record;
+        statsPtr->getRecord(record);
+
+        //together with the timestamps of the previous frame and the decode time of the acknowledged data
+        SyncLatencyRecord latency;
+        statsPtr->getSyncLatencyRecord(latency);
+        uint32_t frame;
+        double masterTime;
+        sgct::SharedData::instance()->getSyncStamp(frame, masterTime, latency.mAckDecodeTime);
+
         for(unsigned int i=0; i<mSyncConnections.size(); i++)
         {
             //Client
@@ -344,9 +360,13 @@ void sgct_core::NetworkManager::sync(sgct_core::NetworkManager::SyncMode sm, sgc
                 //The servers's render function is locked until a message starting with the ack-byte is received.
 
                 //send message to server
-                mSyncConnections[i]->pushClientMessage();
+                latency.mAckTime = sgct::Engine::getTime();
+                mSyncConnections[i]->pushClientMessage(&record, &latency);
+                //log messages are sent after the ack so that they don't delay the server
+                mSyncConnections[i]->pushClientLog();
             }
         }
+    }
 }
 
 /*!
@@ -560,7 +580,7 @@ void sgct_core::NetworkManager::setDataTransferCompression(bool state, int level
 unsigned int sgct_core::NetworkManager::getActiveConnectionsCount()
 {
     unsigned int retVal;
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
         retVal = mNumberOfActiveConnections;
     sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
     return retVal;
@@ -569,7 +589,7 @@ unsigned int sgct_core::NetworkManager::getActiveConnectionsCount()
 unsigned int sgct_core::NetworkManager::getActiveSyncConnectionsCount()
 {
     unsigned int retVal;
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
         retVal = mNumberOfActiveSyncConnections;
     sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
     return retVal;
@@ -578,7 +598,7 @@ unsigned int sgct_core::NetworkManager::getActiveSyncConnectionsCount()
 unsigned int sgct_core::NetworkManager::getActiveDataTransferConnectionsCount()
 {
     unsigned int retVal;
-    sgct::SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    sgct::SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     retVal = mNumberOfActiveDataTransferConnections;
     sgct::SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
     return retVal;
@@ -587,7 +607,7 @@ unsigned int sgct_core::NetworkManager::getActiveDataTransferConnectionsCount()
 unsigned int sgct_core::NetworkManager::getConnectionsCount()
 {
     unsigned int retVal;
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     retVal = static_cast<unsigned int>(mNetworkConnections.size());
     sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
     return retVal;
@@ -596,7 +616,7 @@ unsigned int sgct_core::NetworkManager::getConnectionsCount()
 unsigned int sgct_core::NetworkManager::getSyncConnectionsCount()
 {
     unsigned int retVal;
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     retVal = static_cast<unsigned int>(mSyncConnections.size());
     sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
     return retVal;
@@ -605,7 +625,7 @@ unsigned int sgct_core::NetworkManager::getSyncConnectionsCount()
 unsigned int sgct_core::NetworkManager::getDataTransferConnectionsCount()
 {
     unsigned int retVal;
-    sgct::SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    sgct::SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     retVal = static_cast<unsigned int>(mDataTransferConnections.size());
     sgct::SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
     return retVal;
@@ -619,7 +639,7 @@ void sgct_core::NetworkManager::updateConnectionStatus(SGCTNetwork * connection)
     unsigned int numberOfConnectedSyncNodesCounter = 0;
     unsigned int numberOfConnectedDataTransferNodesCounter = 0;
 
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     unsigned int totalNumberOfConnections = static_cast<unsigned int>(mNetworkConnections.size());
     unsigned int totalNumberOfSyncConnections = static_cast<unsigned int>(mSyncConnections.size());
     unsigned int totalNumberOfTransferConnections = static_cast<unsigned int>(mDataTransferConnections.size());
@@ -642,7 +662,7 @@ void sgct_core::NetworkManager::updateConnectionStatus(SGCTNetwork * connection)
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "NetworkManager: Number of connected sync nodes %u of %u\n", numberOfConnectedSyncNodesCounter, totalNumberOfSyncConnections);
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "NetworkManager: Number of connected data transfer nodes %u of %u\n", numberOfConnectedDataTransferNodesCounter,totalNumberOfTransferConnections);
 
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
         mNumberOfActiveConnections                = numberOfConnectionsCounter;
         mNumberOfActiveSyncConnections            = numberOfConnectedSyncNodesCounter;
         mNumberOfActiveDataTransferConnections    = numberOfConnectedDataTransferNodesCounter;
@@ -659,7 +679,7 @@ void sgct_core::NetworkManager::updateConnectionStatus(SGCTNetwork * connection)
     {
         bool allNodesConnectedCopy;
 
-        sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+        sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
         //local copy (thread safe)
         allNodesConnectedCopy = (numberOfConnectedSyncNodesCounter == totalNumberOfSyncConnections) &&
             (numberOfConnectedDataTransferNodesCounter == totalNumberOfTransferConnections);
@@ -726,7 +746,7 @@ void sgct_core::NetworkManager::updateConnectionStatus(SGCTNetwork * connection)
 
 void sgct_core::NetworkManager::setAllNodesConnected()
 {
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
 
     if( !mIsServer )
     {
@@ -937,7 +957,7 @@ bool sgct_core::NetworkManager::matchAddress(const std::string address)
 bool sgct_core::NetworkManager::isComputerServer()
 {
     bool tmpB;
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     tmpB = mIsServer;
     sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
     return tmpB;
@@ -946,7 +966,7 @@ bool sgct_core::NetworkManager::isComputerServer()
 bool sgct_core::NetworkManager::isRunning()
 {
     bool tmpB;
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     tmpB = mIsRunning;
     sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
     return tmpB;
@@ -955,7 +975,7 @@ bool sgct_core::NetworkManager::isRunning()
 bool sgct_core::NetworkManager::areAllNodesConnected()
 {
     bool tmpB;
-    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    sgct::SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     tmpB = mAllNodesConnected;
     sgct::SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
     return tmpB;
@@ -10,8 +10,16 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/SGCTMemoryRegistry.h>
 #include <algorithm>
 
+//names of the textures in the memory report, same order as TextureIndex
+static const char * textureNames[] =
+{
+    "color cubemap", "depth cubemap", "normal cubemap", "position cubemap", "color swap map", "depth swap map",
+    "right face map", "left face map", "bottom face map", "top face map", "front face map", "back face map"
+};
+
 sgct_core::NonLinearProjection::NonLinearProjection()
 {
     mCubemapResolution = 512;
@@ -77,6 +85,9 @@ sgct_core::NonLinearProjection::~NonLinearProjection()
 
     mShader.deleteProgram();
     mDepthCorrectionShader.deleteProgram();
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->removeAllocations(this);
 }
 
 /*!
@@ -300,6 +311,7 @@ void sgct_core::NonLinearProjection::initFBO()
 {
     mCubeMapFBO_Ptr = new sgct_core::OffScreenBuffer();
     mCubeMapFBO_Ptr->setInternalColorFormat(mTextureInternalFormat);
+    mCubeMapFBO_Ptr->setMemorySubsystem(sgct::SGCTMemoryRegistry::NonLinearProjectionBuffers);
     mCubeMapFBO_Ptr->createFBO(mCubemapResolution,
         mCubemapResolution,
         mSamples);
@@ -407,6 +419,10 @@ void sgct_core::NonLinearProjection::generateCubeMap(TextureIndex ti, int intern
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     glDisable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::NonLinearProjectionBuffers, sgct::SGCTMemoryRegistry::GPU, this, textureNames[ti],
+            6 * sgct::SGCTMemoryRegistry::getTextureSize(mCubemapResolution, mCubemapResolution, internalFormat));
 }
 
 void sgct_core::NonLinearProjection::setupViewport(const std::size_t & face)
@@ -475,6 +491,10 @@ void sgct_core::NonLinearProjection::generateMap(TextureIndex ti, int internalFo
     //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::NonLinearProjectionBuffers, sgct::SGCTMemoryRegistry::GPU, this, textureNames[ti],
+            sgct::SGCTMemoryRegistry::getTextureSize(mCubemapResolution, mCubemapResolution, internalFormat));
 }
 
 int sgct_core::NonLinearProjection::getCubemapRes(std::string& quality)
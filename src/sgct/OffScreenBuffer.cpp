@@ -23,6 +23,7 @@ sgct_core::OffScreenBuffer::OffScreenBuffer()
     mPositionBuffer = GL_FALSE;
     mDepthBuffer = GL_FALSE;
     mInternalColorFormat = GL_RGBA8;
+    mMemorySubsystem = sgct::SGCTMemoryRegistry::WindowBuffers;
 
     mWidth = 1;
     mHeight = 1;
@@ -33,6 +34,8 @@ void sgct_core::OffScreenBuffer::createFBO(int width, int height, int samples)
 {
     glGenFramebuffers(1,    &mFrameBuffer);
     glGenRenderbuffers(1,    &mDepthBuffer);
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->removeAllocations(this);
 
     mWidth = width;
     mHeight = height;
@@ -83,6 +86,19 @@ void sgct_core::OffScreenBuffer::createFBO(int width, int height, int samples)
             glBindRenderbuffer(GL_RENDERBUFFER, mPositionBuffer);
             glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, sgct::SGCTSettings::instance()->getBufferFloatPrecisionAsGLint(), width, height);
         }
+
+        if (sgct::SGCTMemoryRegistry::exists())
+        {
+            sgct::SGCTMemoryRegistry * registry = sgct::SGCTMemoryRegistry::instance();
+            registry->setAllocation(mMemorySubsystem, sgct::SGCTMemoryRegistry::GPU, this, "multisample color buffer",
+                sgct::SGCTMemoryRegistry::getTextureSize(width, height, mInternalColorFormat, samples));
+            if (sgct::SGCTSettings::instance()->useNormalTexture())
+                registry->setAllocation(mMemorySubsystem, sgct::SGCTMemoryRegistry::GPU, this, "multisample normal buffer",
+                    sgct::SGCTMemoryRegistry::getTextureSize(width, height, sgct::SGCTSettings::instance()->getBufferFloatPrecisionAsGLint(), samples));
+            if (sgct::SGCTSettings::instance()->usePositionTexture())
+                registry->setAllocation(mMemorySubsystem, sgct::SGCTMemoryRegistry::GPU, this, "multisample position buffer",
+                    sgct::SGCTMemoryRegistry::getTextureSize(width, height, sgct::SGCTSettings::instance()->getBufferFloatPrecisionAsGLint(), samples));
+        }
     }
     else
         glBindFramebuffer(GL_FRAMEBUFFER, mFrameBuffer);
@@ -92,6 +108,9 @@ void sgct_core::OffScreenBuffer::createFBO(int width, int height, int samples)
     mMultiSampled ?
         glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT32, width, height ):
         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32, width, height );
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->setAllocation(mMemorySubsystem, sgct::SGCTMemoryRegistry::GPU, this, "depth buffer",
+            sgct::SGCTMemoryRegistry::getTextureSize(width, height, GL_DEPTH_COMPONENT32, mMultiSampled ? samples : 1));
 
     //It's time to attach the RBs to the FBO
     if (mMultiSampled)
@@ -156,6 +175,14 @@ void sgct_core::OffScreenBuffer::setInternalColorFormat(GLint internalFormat)
     mInternalColorFormat = internalFormat;
 }
 
+/*!
+Set which subsystem the render buffers are accounted to in the SGCTMemoryRegistry, default is the window buffers.
+*/
+void sgct_core::OffScreenBuffer::setMemorySubsystem(sgct::SGCTMemoryRegistry::Subsystem subsystem)
+{
+    mMemorySubsystem = subsystem;
+}
+
 void sgct_core::OffScreenBuffer::setDrawBuffers()
 {
     switch (sgct::SGCTSettings::instance()->getCurrentDrawBufferType())
@@ -343,6 +370,9 @@ void sgct_core::OffScreenBuffer::destroy()
     mDepthBuffer = GL_FALSE;
     mNormalBuffer = GL_FALSE;
     mPositionBuffer = GL_FALSE;
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->removeAllocations(this);
 }
 
 /*!
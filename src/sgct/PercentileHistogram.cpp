@@ -0,0 +1,137 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/PercentileHistogram.h>
+#include <math.h>
+
+#define HISTOGRAM_SUB_BUCKET_BITS 6
+#define HISTOGRAM_SUB_BUCKET_COUNT (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKET_COUNT (HISTOGRAM_SUB_BUCKET_COUNT * (33 - HISTOGRAM_SUB_BUCKET_BITS))
+
+sgct_core::PercentileHistogram::PercentileHistogram(std::size_t windowLength)
+{
+    mCounts.assign(HISTOGRAM_BUCKET_COUNT, 0);
+    mWindow.assign(windowLength > 0 ? windowLength : 1, 0);
+    mHead = 0;
+    mCount = 0;
+}
+
+/*!
+    Set the number of latest values the percentiles are calculated from. Clears the histogram.
+*/
+void sgct_core::PercentileHistogram::setWindowLength(std::size_t windowLength)
+{
+    mWindow.assign(windowLength > 0 ? windowLength : 1, 0);
+    clear();
+}
+
+/*!
+    Add a time in seconds, replacing the oldest value if the window is full.
+*/
+void sgct_core::PercentileHistogram::add(float seconds)
+{
+    double microseconds = static_cast<double>(seconds) * 1000000.0;
+    uint32_t value;
+    if (!(microseconds > 0.0)) //also catches NaN
+        value = 0;
+    else if (microseconds >= 4294967295.0)
+        value = 0xFFFFFFFF;
+    else
+        value = static_cast<uint32_t>(microseconds + 0.5);
+
+    if (mCount == mWindow.size())
+        mCounts[mWindow[mHead]]--;
+    else
+        mCount++;
+
+    std::size_t index = getBucketIndex(value);
+    mCounts[index]++;
+    mWindow[mHead] = static_cast<uint16_t>(index);
+    mHead = (mHead + 1) % mWindow.size();
+}
+
+void sgct_core::PercentileHistogram::clear()
+{
+    mCounts.assign(mCounts.size(), 0);
+    mHead = 0;
+    mCount = 0;
+}
+
+/*!
+    \param percentile in the range 0-100, 100 gives the maximum
+    \returns the time in seconds that the given percentage of the values are less than or equal to, or 0 if empty
+*/
+float sgct_core::PercentileHistogram::getPercentile(float percentile) const
+{
+    float value = 0.0f;
+    getPercentiles(&percentile, &value, 1);
+    return value;
+}
+
+/*!
+    Get several percentiles in a single pass over the buckets.
+
+    \param percentiles in the range 0-100 sorted in ascending order
+    \param values the times in seconds, all zero if the histogram is empty
+*/
+void sgct_core::PercentileHistogram::getPercentiles(const float * percentiles, float * values, std::size_t count) const
+{
+    std::size_t bucket = 0;
+    uint64_t accumulated = 0;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (mCount == 0)
+        {
+            values[i] = 0.0f;
+            continue;
+        }
+
+        //rank of the value, at least one so that p0 gives the minimum
+        double p = percentiles[i] < 0.0f ? 0.0 : (percentiles[i] > 100.0f ? 100.0 : static_cast<double>(percentiles[i]));
+        uint64_t rank = static_cast<uint64_t>(ceil(p / 100.0 * static_cast<double>(mCount)));
+        if (rank < 1)
+            rank = 1;
+
+        while (bucket < mCounts.size() && accumulated + mCounts[bucket] < rank)
+        {
+            accumulated += mCounts[bucket];
+            bucket++;
+        }
+
+        values[i] = getBucketValue(bucket < mCounts.size() ? bucket : mCounts.size() - 1);
+    }
+}
+
+std::size_t sgct_core::PercentileHistogram::getBucketIndex(uint32_t microseconds)
+{
+    if (microseconds < HISTOGRAM_SUB_BUCKET_COUNT)
+        return static_cast<std::size_t>(microseconds);
+
+    //position of the highest set bit
+    unsigned int msb = HISTOGRAM_SUB_BUCKET_BITS;
+    while (msb < 31 && (microseconds >> (msb + 1)) != 0)
+        msb++;
+
+    unsigned int shift = msb - HISTOGRAM_SUB_BUCKET_BITS;
+    std::size_t subBucket = static_cast<std::size_t>(microseconds >> shift) - HISTOGRAM_SUB_BUCKET_COUNT;
+    return HISTOGRAM_SUB_BUCKET_COUNT * (shift + 1) + subBucket;
+}
+
+/*!
+    \returns the highest time in seconds that maps to the bucket
+*/
+float sgct_core::PercentileHistogram::getBucketValue(std::size_t index)
+{
+    if (index < HISTOGRAM_SUB_BUCKET_COUNT)
+        return static_cast<float>(index) / 1000000.0f;
+
+    unsigned int shift = static_cast<unsigned int>(index / HISTOGRAM_SUB_BUCKET_COUNT) - 1;
+    uint64_t subBucket = static_cast<uint64_t>(index % HISTOGRAM_SUB_BUCKET_COUNT) + HISTOGRAM_SUB_BUCKET_COUNT;
+    uint64_t highest = ((subBucket + 1) << shift) - 1;
+    return static_cast<float>(static_cast<double>(highest) / 1000000.0);
+}
@@ -0,0 +1,284 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/ogl_headers.h>
+#include <sgct/SGCTMemoryRegistry.h>
+#include <sgct/MessageHandler.h>
+#include <sstream>
+#include <iomanip>
+
+sgct::SGCTMemoryRegistry * sgct::SGCTMemoryRegistry::mInstance = NULL;
+
+static const char * subsystemNames[sgct::SGCTMemoryRegistry::NumberOfSubsystems] =
+{
+    "Window buffers", "Non linear projections", "Correction meshes", "Screen capture", "Images", "Fonts", "Textures"
+};
+
+sgct::SGCTMemoryRegistry::SGCTMemoryRegistry()
+{
+    for (int i = 0; i < NumberOfSubsystems; i++)
+        for (int j = 0; j < NumberOfMemoryTypes; j++)
+            mSizes[i][j] = 0;
+}
+
+/*!
+    Set the estimated size of an allocation, replacing any previous estimate with the same owner and name.
+
+    \param owner the object holding the allocation, used to remove all its allocations when it's released
+    \param name describes the allocation in the report, unique per owner
+    \param size the estimated size in bytes, 0 removes the allocation
+*/
+void sgct::SGCTMemoryRegistry::setAllocation(Subsystem subsystem, MemoryType type, const void * owner, const std::string & name, std::size_t size)
+{
+    if (size == 0)
+    {
+        removeAllocation(owner, name);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::map< std::pair<const void *, std::string>, Allocation >::iterator it = mAllocations.find(std::make_pair(owner, name));
+    if (it != mAllocations.end())
+    {
+        mSizes[it->second.mSubsystem][it->second.mType] -= it->second.mSize;
+    }
+    else
+    {
+        it = mAllocations.insert(std::make_pair(std::make_pair(owner, name), Allocation())).first;
+        it->second.mOwner = owner;
+        it->second.mName = name;
+    }
+
+    it->second.mSubsystem = subsystem;
+    it->second.mType = type;
+    it->second.mSize = size;
+    mSizes[subsystem][type] += size;
+}
+
+/*!
+    Remove a single allocation of an owner.
+*/
+void sgct::SGCTMemoryRegistry::removeAllocation(const void * owner, const std::string & name)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::map< std::pair<const void *, std::string>, Allocation >::iterator it = mAllocations.find(std::make_pair(owner, name));
+    if (it != mAllocations.end())
+    {
+        mSizes[it->second.mSubsystem][it->second.mType] -= it->second.mSize;
+        mAllocations.erase(it);
+    }
+}
+
+/*!
+    Remove all allocations of an owner, call when the object releases its resources.
+*/
+void sgct::SGCTMemoryRegistry::removeAllocations(const void * owner)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    //the map is sorted by owner first
+    std::map< std::pair<const void *, std::string>, Allocation >::iterator it = mAllocations.lower_bound(std::make_pair(owner, std::string()));
+    while (it != mAllocations.end() && it->first.first == owner)
+    {
+        mSizes[it->second.mSubsystem][it->second.mType] -= it->second.mSize;
+        it = mAllocations.erase(it);
+    }
+}
+
+/*!
+    \returns the estimated number of bytes allocated by a subsystem
+*/
+std::size_t sgct::SGCTMemoryRegistry::getSize(Subsystem subsystem, MemoryType type)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mSizes[subsystem][type];
+}
+
+/*!
+    \returns the estimated number of bytes allocated by all subsystems
+*/
+std::size_t sgct::SGCTMemoryRegistry::getTotalSize(MemoryType type)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::size_t total = 0;
+    for (int i = 0; i < NumberOfSubsystems; i++)
+        total += mSizes[i][type];
+    return total;
+}
+
+/*!
+    Get a copy of all registered allocations sorted by owner.
+*/
+void sgct::SGCTMemoryRegistry::getAllocations(std::vector<Allocation> & allocations)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    allocations.clear();
+    allocations.reserve(mAllocations.size());
+
+    std::map< std::pair<const void *, std::string>, Allocation >::const_iterator it;
+    for (it = mAllocations.begin(); it != mAllocations.end(); ++it)
+        allocations.push_back(it->second);
+}
+
+/*!
+    Get a table of the estimated memory use per subsystem in megabytes.
+
+    \param perObject if true every allocation is listed below the subsystem totals
+*/
+std::string sgct::SGCTMemoryRegistry::getReport(bool perObject)
+{
+    std::vector<Allocation> allocations;
+    if (perObject)
+        getAllocations(allocations);
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+
+    mMutex.lock();
+
+    std::size_t totals[NumberOfMemoryTypes] = { 0, 0 };
+    ss << "Memory estimate (MB):\n";
+    ss << "subsystem, CPU, GPU\n";
+    for (int i = 0; i < NumberOfSubsystems; i++)
+    {
+        ss << subsystemNames[i] << ", "
+            << static_cast<double>(mSizes[i][CPU]) / (1024.0 * 1024.0) << ", "
+            << static_cast<double>(mSizes[i][GPU]) / (1024.0 * 1024.0) << "\n";
+        totals[CPU] += mSizes[i][CPU];
+        totals[GPU] += mSizes[i][GPU];
+    }
+    ss << "Total, " << static_cast<double>(totals[CPU]) / (1024.0 * 1024.0) << ", "
+        << static_cast<double>(totals[GPU]) / (1024.0 * 1024.0) << "\n";
+
+    mMutex.unlock();
+
+    if (perObject)
+    {
+        ss << "subsystem, owner, allocation, type, size\n";
+        for (std::size_t i = 0; i < allocations.size(); i++)
+        {
+            const Allocation & a = allocations[i];
+            ss << subsystemNames[a.mSubsystem] << ", " << a.mOwner << ", " << a.mName << ", "
+                << (a.mType == GPU ? "GPU" : "CPU") << ", " << static_cast<double>(a.mSize) / (1024.0 * 1024.0) << "\n";
+        }
+    }
+
+    return ss.str();
+}
+
+/*!
+    Print the memory estimates, see getReport().
+*/
+void sgct::SGCTMemoryRegistry::printReport(bool perObject)
+{
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "%s", getReport(perObject).c_str());
+}
+
+const char * sgct::SGCTMemoryRegistry::getSubsystemName(Subsystem subsystem)
+{
+    return (subsystem >= 0 && subsystem < NumberOfSubsystems) ? subsystemNames[subsystem] : "Unknown";
+}
+
+/*!
+    Estimate the size of a texture or render buffer.
+
+    \param internalFormat the openGL internal format, unknown formats are estimated as four bytes per texel
+    \param samples the number of samples of multisampled buffers
+    \param mipmaps if true the size of a full mipmap chain is added
+    \returns the estimated size in bytes
+*/
+std::size_t sgct::SGCTMemoryRegistry::getTextureSize(int width, int height, int internalFormat, int samples, bool mipmaps)
+{
+    if (width <= 0 || height <= 0)
+        return 0;
+
+    bool compressed = false;
+    std::size_t bytes = getBytesPerTexel(internalFormat, compressed);
+
+    std::size_t size;
+    if (compressed) //size of 4x4 blocks
+        size = static_cast<std::size_t>((width + 3) / 4) * static_cast<std::size_t>((height + 3) / 4) * bytes;
+    else
+        size = static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * bytes;
+
+    if (samples > 1)
+        size *= static_cast<std::size_t>(samples);
+
+    //the mipmaps add a third of the base level
+    if (mipmaps)
+        size += size / 3;
+
+    return size;
+}
+
+/*!
+    \returns the bytes per texel of an internal format, or the bytes per 4x4 block if the format is compressed
+*/
+std::size_t sgct::SGCTMemoryRegistry::getBytesPerTexel(int internalFormat, bool & compressed)
+{
+    compressed = false;
+
+    switch (internalFormat)
+    {
+    case GL_R8:
+    case GL_ALPHA8:
+    case GL_LUMINANCE8:
+    case GL_COMPRESSED_RED:
+    case GL_COMPRESSED_ALPHA:
+    case GL_COMPRESSED_LUMINANCE:
+        return 1;
+
+    case GL_RG8:
+    case GL_R16:
+    case GL_R16F:
+    case GL_LUMINANCE8_ALPHA8:
+    case GL_ALPHA16:
+    case GL_LUMINANCE16:
+    case GL_ALPHA16F_ARB:
+    case GL_LUMINANCE16F_ARB:
+    case GL_COMPRESSED_RG:
+    case GL_COMPRESSED_LUMINANCE_ALPHA:
+        return 2;
+
+    //three component formats are padded to four by most drivers
+    case GL_RGB16:
+    case GL_RGBA16:
+    case GL_RGB16F:
+    case GL_RGBA16F:
+    case GL_RGBA16I:
+    case GL_RGBA16UI:
+    case GL_RG32F:
+    case GL_LUMINANCE_ALPHA32F_ARB:
+        return 8;
+
+    case GL_RGB32F:
+    case GL_RGBA32F:
+    case GL_RGBA32I:
+    case GL_RGBA32UI:
+        return 16;
+
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RED_RGTC1:
+        compressed = true;
+        return 8;
+
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RG_RGTC2:
+        compressed = true;
+        return 16;
+
+    //GL_RGB8, GL_RGBA8, GL_RGB10_A2, GL_R11F_G11F_B10F, GL_RG16, GL_R32F, depth formats and generic compressed color formats
+    default:
+        return 4;
+    }
+}
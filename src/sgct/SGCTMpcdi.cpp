@@ -12,13 +12,17 @@
 
 #include <sgct/SGCTSettings.h>
 #include <sgct/SGCTMpcdi.h>
+#include <sgct/SGCTThreadPool.h>
+#include <sgct/CorrectionMesh.h>
 #include <algorithm>
 #include <sstream>
+#include <thread>
 #include "unzip.h"
 #include <zip.h>
 
 sgct_core::SGCTMpcdi::SGCTMpcdi(std::string& parentErrorMessage) : mErrorMsg(parentErrorMessage)
 {
+    mHasXmlEntry = false;
 }
 
 sgct_core::SGCTMpcdi::~SGCTMpcdi()
@@ -37,11 +41,10 @@ bool sgct_core::SGCTMpcdi::parseConfiguration(const std::string filenameMpcdi,
     SGCTNode& tmpNode,
     sgct::SGCTWindow& tmpWin)
 {
-    FILE * cfgFile = nullptr;
     unzFile zipfile;
     const int MaxFilenameSize_bytes = 500;
 
-    bool fileOpenSuccess = openZipFile(cfgFile, filenameMpcdi, &zipfile);
+    bool fileOpenSuccess = openZipFile(filenameMpcdi, &zipfile);
     if (!fileOpenSuccess)
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
@@ -92,39 +95,34 @@ bool sgct_core::SGCTMpcdi::parseConfiguration(const std::string filenameMpcdi,
             }
         }
     }
-    unzClose(zipfile);
-    bool hasXmlFile = mMpcdiSubFileContents.hasFound[MpcdiSubFiles::mpcdiXml];
-    bool hasPfmFile = mMpcdiSubFileContents.hasFound[MpcdiSubFiles::mpcdiPfm];
-    if( !hasXmlFile || !hasPfmFile)
+    if( !mHasXmlEntry || mPfmEntries.empty() )
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
             "parseMpcdiConfiguration: mpcdi file %s does not contain xml and/or pfm file\n",
             filenameMpcdi.c_str());
+        unzClose(zipfile);
         return false;
     }
-    if( !readAndParseXMLString(tmpNode, tmpWin) )
+
+    //only the xml file is decompressed here, the warp files are decompressed straight
+    // into their correction grids once the regions they belong to are known
+    std::vector<char> xmlBuffer;
+    bool xmlReadSuccess = readXMLFile(&zipfile, xmlBuffer);
+    unzClose(zipfile);
+    if( !xmlReadSuccess )
+        return false;
+
+    if( !readAndParseXMLString(xmlBuffer, tmpNode, tmpWin) )
         return false;
     else
-        return true;
+        return readWarpFiles(filenameMpcdi);
 }
 
-bool sgct_core::SGCTMpcdi::openZipFile(FILE* cfgFile, const std::string cfgFilePath,
-                                        unzFile* zipfile)
+bool sgct_core::SGCTMpcdi::openZipFile(const std::string cfgFilePath, unzFile* zipfile)
 {
-#if (_MSC_VER >= 1400) //visual studio 2005 or later
-    if (fopen_s(&cfgFile, cfgFilePath.c_str(), "r") != 0 || !cfgFile)
-#else
-    cfgFile = fopen(cfgFilePath.c_str(), "r");
-    if (cfgFile == nullptr)
-#endif
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-            "parseMpcdiConfiguration: Failed to open file %s\n", cfgFilePath.c_str());
-        return false;
-    }
     //Open MPCDI file (zip compressed format)
     *zipfile = unzOpen(cfgFilePath.c_str());
-    if (zipfile == nullptr)
+    if (*zipfile == nullptr)
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
             "parseMpcdiConfiguration: Failed to open compressed mpcdi file %s\n", cfgFilePath.c_str());
@@ -133,80 +131,158 @@ bool sgct_core::SGCTMpcdi::openZipFile(FILE* cfgFile, const std::string cfgFileP
     return true;
 }
 
+/*!
+    Record the location of the xml file and of all pfm warp files in the archive. Nothing is
+    decompressed here.
+*/
 bool sgct_core::SGCTMpcdi::processSubFiles(std::string filename, unzFile* zipfile,
                                                  unz_file_info& file_info)
 {
-    for (int i = 0; i < mMpcdiSubFileContents.mpcdi_nRequiredFiles; ++i)
+    bool isXml = !mHasXmlEntry && doesStringHaveSuffix(filename, "xml");
+    bool isPfm = doesStringHaveSuffix(filename, "pfm");
+    if( !isXml && !isPfm )
+        return true;
+
+    MpcdiZipEntry entry;
+    entry.filename = filename;
+    entry.size = file_info.uncompressed_size;
+    if( unzGetFilePos(*zipfile, &entry.position) != UNZ_OK )
     {
-        if( !mMpcdiSubFileContents.hasFound[i]
-            && doesStringHaveSuffix(filename, mMpcdiSubFileContents.extension[i]))
-        {
-            mMpcdiSubFileContents.hasFound[i] = true;
-            mMpcdiSubFileContents.size[i] = file_info.uncompressed_size;
-            mMpcdiSubFileContents.filename[i] = filename;
-            int openCurrentFile = unzOpenCurrentFile(*zipfile);
-            if( openCurrentFile != UNZ_OK )
-            {
-                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                    "parseMpcdiConfiguration: Unable to open %s\n", filename.c_str());
-                unzClose(*zipfile);
-                return false;
-            }
-            mMpcdiSubFileContents.buffer[i] = new char[file_info.uncompressed_size];
-            if( mMpcdiSubFileContents.buffer[i] != nullptr)
-            {
-                int error = unzReadCurrentFile(*zipfile, mMpcdiSubFileContents.buffer[i],
-                                               file_info.uncompressed_size);
-                if (error < 0)
-                {
-                    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                        "parseMpcdiConfiguration: %s read from %s failed.\n",
-                        mMpcdiSubFileContents.extension[i].c_str(), filename.c_str());
-                    unzClose(*zipfile);
-                    return false;
-                }
-            }
-            else
-            {
-                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
-                    "parseMpcdiConfiguration: Unable to allocate memory for %s\n", filename.c_str());
-                unzClose(*zipfile);
-                return false;
-            }
-        }
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "parseMpcdiConfiguration: Unable to locate %s in archive\n", filename.c_str());
+        return false;
     }
+
+    if( isXml )
+    {
+        mXmlEntry = entry;
+        mHasXmlEntry = true;
+    }
+    else
+        mPfmEntries.push_back(entry);
     return true;
 }
 
-bool sgct_core::SGCTMpcdi::readAndParseXMLString(SGCTNode& tmpNode, sgct::SGCTWindow& tmpWin)
+bool sgct_core::SGCTMpcdi::readXMLFile(unzFile* zipfile, std::vector<char>& buffer)
 {
-    bool mpcdiParseResult = false;
-    if (mMpcdiSubFileContents.buffer[MpcdiSubFiles::mpcdiXml] != nullptr)
+    if( unzGoToFilePos(*zipfile, &mXmlEntry.position) != UNZ_OK ||
+        unzOpenCurrentFile(*zipfile) != UNZ_OK )
     {
-        tinyxml2::XMLDocument xmlDoc;
-        tinyxml2::XMLError result = xmlDoc.Parse(mMpcdiSubFileContents.buffer[MpcdiSubFiles::mpcdiXml],
-            mMpcdiSubFileContents.size[MpcdiSubFiles::mpcdiXml]);
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "parseMpcdiConfiguration: Unable to open %s\n", mXmlEntry.filename.c_str());
+        return false;
+    }
 
-        if (result != tinyxml2::XML_NO_ERROR)
-        {
-            std::stringstream ss;
-            if (xmlDoc.GetErrorStr1() && xmlDoc.GetErrorStr2())
-                ss << "Parsing failed after: " << xmlDoc.GetErrorStr1() << " " << xmlDoc.GetErrorStr2();
-            else if (xmlDoc.GetErrorStr1())
-                ss << "Parsing failed after: " << xmlDoc.GetErrorStr1();
-            else if (xmlDoc.GetErrorStr2())
-                ss << "Parsing failed after: " << xmlDoc.GetErrorStr2();
-            else
-                ss << "File not found";
-            mErrorMsg = ss.str();
-            mpcdiParseResult = false;
-        }
+    buffer.resize(mXmlEntry.size);
+    int bytesRead = buffer.empty() ? 0 : unzReadCurrentFile(*zipfile, buffer.data(),
+        static_cast<unsigned int>(buffer.size()));
+    unzCloseCurrentFile(*zipfile);
+    if( bytesRead != static_cast<int>(buffer.size()) )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "parseMpcdiConfiguration: xml read from %s failed.\n", mXmlEntry.filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+/*!
+    Parse the MPCDI xml document. The buffer is released as soon as tinyxml2 has parsed it.
+*/
+bool sgct_core::SGCTMpcdi::readAndParseXMLString(std::vector<char>& buffer, SGCTNode& tmpNode,
+                                                 sgct::SGCTWindow& tmpWin)
+{
+    tinyxml2::XMLDocument xmlDoc;
+    tinyxml2::XMLError result = xmlDoc.Parse(buffer.data(), buffer.size());
+    std::vector<char>().swap(buffer);
+
+    if (result != tinyxml2::XML_NO_ERROR)
+    {
+        std::stringstream ss;
+        if (xmlDoc.GetErrorStr1() && xmlDoc.GetErrorStr2())
+            ss << "Parsing failed after: " << xmlDoc.GetErrorStr1() << " " << xmlDoc.GetErrorStr2();
+        else if (xmlDoc.GetErrorStr1())
+            ss << "Parsing failed after: " << xmlDoc.GetErrorStr1();
+        else if (xmlDoc.GetErrorStr2())
+            ss << "Parsing failed after: " << xmlDoc.GetErrorStr2();
         else
+            ss << "File not found";
+        mErrorMsg = ss.str();
+        return false;
+    }
+
+    return readAndParseXML_mpcdi(xmlDoc, tmpNode, tmpWin);
+}
+
+/*
+    Decompress a pfm warp file from the archive straight into a correction grid. Each call opens
+    its own handle to the archive so that several warp files can be decompressed in parallel.
+*/
+static bool readMpcdiWarpFile(const std::string& filenameMpcdi, const sgct_core::MpcdiZipEntry& entry,
+                              sgct_core::MpcdiWarpGrid& grid)
+{
+    unzFile zipfile = unzOpen(filenameMpcdi.c_str());
+    if( zipfile == nullptr )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "parseMpcdiConfiguration: Failed to open compressed mpcdi file %s\n", filenameMpcdi.c_str());
+        return false;
+    }
+
+    unz_file_pos position = entry.position;
+    if( unzGoToFilePos(zipfile, &position) != UNZ_OK || unzOpenCurrentFile(zipfile) != UNZ_OK )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "parseMpcdiConfiguration: Unable to open %s\n", entry.filename.c_str());
+        unzClose(zipfile);
+        return false;
+    }
+
+    bool success = sgct_core::CorrectionMesh::readMpcdiWarpGrid([zipfile](void* dst, std::size_t size)
         {
-            mpcdiParseResult = readAndParseXML_mpcdi(xmlDoc, tmpNode, tmpWin);
-        }
+            return unzReadCurrentFile(zipfile, dst, static_cast<unsigned int>(size)) == static_cast<int>(size);
+        }, grid);
+    if( !success )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+            "parseMpcdiConfiguration: pfm read from %s failed.\n", entry.filename.c_str());
     }
-    return mpcdiParseResult;
+
+    unzCloseCurrentFile(zipfile);
+    unzClose(zipfile);
+    return success;
+}
+
+/*!
+    Decompress the warp files of all regions in parallel and hand the correction grids to the viewports.
+*/
+bool sgct_core::SGCTMpcdi::readWarpFiles(const std::string& filenameMpcdi)
+{
+    std::vector<unsigned char> results(mWarpRequests.size(), 0);
+
+    SGCTThreadPool pool;
+    if( mWarpRequests.size() > 1 )
+        pool.start(std::min(std::thread::hardware_concurrency(), static_cast<unsigned int>(mWarpRequests.size())));
+
+    for (std::size_t i = 0; i < mWarpRequests.size(); ++i)
+    {
+        pool.addTask([this, i, &filenameMpcdi, &results]()
+        {
+            MpcdiWarpGrid * grid = new MpcdiWarpGrid();
+            if( readMpcdiWarpFile(filenameMpcdi, mPfmEntries[mWarpRequests[i].pfmEntry], *grid) )
+            {
+                mWarpRequests[i].viewport->setMpcdiWarpMesh(grid);
+                results[i] = 1;
+            }
+            else
+                delete grid;
+        });
+    }
+    pool.waitUntilIdle();
+    pool.stop();
+    mWarpRequests.clear();
+
+    return std::find(results.begin(), results.end(), 0) == results.end();
 }
 
 bool sgct_core::SGCTMpcdi::readAndParseXML_mpcdi(tinyxml2::XMLDocument& xmlDoc,
@@ -380,14 +456,18 @@ bool sgct_core::SGCTMpcdi::readAndParseXML_geoWarpFile(tinyxml2::XMLElement* ele
             if( tmpWindowName.compare(currRegion_warpName) == 0 )
             {
                 std::string currRegion_warpFilename = mWarp.back()->pathWarpFile;
-                std::string matchingMpcdiDataFile
-                    = mMpcdiSubFileContents.filename[MpcdiSubFiles::mpcdiPfm];
-                if( currRegion_warpFilename.compare(matchingMpcdiDataFile) == 0 )
+                for (std::size_t p = 0; p < mPfmEntries.size(); ++p)
                 {
-                    tmpWin.getViewport(r)->setMpcdiWarpMesh(
-                        mMpcdiSubFileContents.buffer[MpcdiSubFiles::mpcdiPfm],
-                        mMpcdiSubFileContents.size[MpcdiSubFiles::mpcdiPfm]);
-                    foundMatchingPfmBuffer = true;
+                    if( currRegion_warpFilename.compare(mPfmEntries[p].filename) == 0 )
+                    {
+                        //decompressed in parallel with the other regions after parsing
+                        MpcdiWarpRequest request;
+                        request.viewport = tmpWin.getViewport(r);
+                        request.pfmEntry = p;
+                        mWarpRequests.push_back(request);
+                        foundMatchingPfmBuffer = true;
+                        break;
+                    }
                 }
             }
         }
@@ -6,12 +6,25 @@ For conditions of distribution and use, see copyright notice in sgct.h
 *************************************************************************/
 
 #include <stdio.h>
+#include <chrono>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 #include <sgct/SGCTMutexManager.h>
+#include <sgct/MessageHandler.h>
 
 //#define __SGCT_MUTEX_DEBUG__
 
+#define MUTEX_PROFILING_WINDOW_LENGTH 4096
+
 sgct::SGCTMutexManager * sgct::SGCTMutexManager::mInstance = NULL;
 
+static const char * mutexNames[SGCT_NUMBER_OF_MUTEXES] =
+{
+    "DataSyncMutex", "FrameSyncMutex", "TrackingMutex", "ConsoleMutex", "TransferMutex", "Mutex5"
+};
+
 sgct::SGCTMutexManager::SGCTMutexManager()
 {
 
@@ -19,15 +32,51 @@ sgct::SGCTMutexManager::SGCTMutexManager()
 
 sgct::SGCTMutexManager::~SGCTMutexManager()
 {
-    
+    std::map< std::pair<const char *, const char *>, LockStatistics * >::iterator it;
+    for (it = mStatistics.begin(); it != mStatistics.end(); ++it)
+        delete it->second;
+    mStatistics.clear();
 }
 
-void sgct::SGCTMutexManager::lockMutex(sgct::SGCTMutexManager::MutexIndexes mi)
+//sorts the call sites with the longest total wait time first
+bool sgct::SGCTMutexManager::compareWaitTime(const LockStatistics * a, const LockStatistics * b)
+{
+    return a->mTotalWaitTime > b->mTotalWaitTime;
+}
+
+sgct::SGCTMutexManager::LockStatistics::LockStatistics() :
+    mMutexName(NULL), mCallSite(NULL), mCount(0), mContendedCount(0), mTotalWaitTime(0.0), mTotalHoldTime(0.0),
+    mWaitTimes(MUTEX_PROFILING_WINDOW_LENGTH), mHoldTimes(MUTEX_PROFILING_WINDOW_LENGTH)
+{
+
+}
+
+/*!
+    Lock one of the mutexes.
+
+    \param callSite identifies the caller in the lock report when SGCT is built with mutex profiling, pass SGCT_MUTEX_CALL_SITE
+*/
+void sgct::SGCTMutexManager::lockMutex(sgct::SGCTMutexManager::MutexIndexes mi, const char * callSite)
 {
 #ifdef __SGCT_MUTEX_DEBUG__
     fprintf(stderr, "Locking mutex %d...\n", mi);
 #endif
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    int64_t startTime = getTime();
+    bool contended = !mInternalMutexes[mi].try_lock();
+    if (contended)
+        mInternalMutexes[mi].lock();
+
+    LockRecord & record = mHolderRecords[mi];
+    record.mCallSite = callSite;
+    record.mContended = contended;
+    record.mWaitTime = contended ? getTime() - startTime : 0;
+    //stamped last so that the bookkeeping isn't counted as hold time
+    record.mLockTime = getTime();
+#else
+    (void)callSite;
     mInternalMutexes[mi].lock();
+#endif
 #ifdef __SGCT_MUTEX_DEBUG__
     fprintf(stderr, "Done [%d]\n", mi);
 #endif
@@ -38,7 +87,16 @@ void sgct::SGCTMutexManager::unlockMutex(sgct::SGCTMutexManager::MutexIndexes mi
 #ifdef __SGCT_MUTEX_DEBUG__
     fprintf(stderr, "Unlocking mutex %u...\n", mi);
 #endif
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    int64_t unlockTime = getTime();
+    LockRecord record = mHolderRecords[mi];
     mInternalMutexes[mi].unlock();
+
+    //recorded after unlocking so that the statistics mutex neither adds to the hold time nor serializes the mutexes
+    addLock(mutexNames[mi], record, unlockTime - record.mLockTime);
+#else
+    mInternalMutexes[mi].unlock();
+#endif
 #ifdef __SGCT_MUTEX_DEBUG__
     fprintf(stderr, "Done [%d]\n", mi);
 #endif
@@ -47,4 +105,183 @@ void sgct::SGCTMutexManager::unlockMutex(sgct::SGCTMutexManager::MutexIndexes mi
 std::mutex * sgct::SGCTMutexManager::getMutexPtr(sgct::SGCTMutexManager::MutexIndexes mi)
 {
     return &mInternalMutexes[mi];
-}
\ No newline at end of file
+}
+
+/*!
+    Get a table of the recorded locks sorted by the total wait time. Times are in milliseconds, the percentiles are
+    calculated from the latest locks of each call site.
+
+    \returns an empty string if SGCT is built without mutex profiling
+*/
+std::string sgct::SGCTMutexManager::getReport()
+{
+    if (!isProfilingEnabled())
+        return std::string();
+
+    std::vector<const LockStatistics *> rows;
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(4);
+
+    mStatisticsMutex.lock();
+
+    std::map< std::pair<const char *, const char *>, LockStatistics * >::const_iterator it;
+    for (it = mStatistics.begin(); it != mStatistics.end(); ++it)
+        rows.push_back(it->second);
+
+    std::sort(rows.begin(), rows.end(), compareWaitTime);
+
+    ss << "Mutex lock statistics (ms):\n";
+    ss << "mutex, call site, locks, contended, total wait, wait p50, wait p99, wait max, total hold, hold p50, hold p99, hold max\n";
+
+    const float percentiles[] = { 50.0f, 99.0f, 100.0f };
+    for (std::size_t i = 0; i < rows.size(); i++)
+    {
+        const LockStatistics * stats = rows[i];
+        float waitTimes[3];
+        float holdTimes[3];
+        stats->mWaitTimes.getPercentiles(percentiles, waitTimes, 3);
+        stats->mHoldTimes.getPercentiles(percentiles, holdTimes, 3);
+
+        ss << stats->mMutexName << ", " << (stats->mCallSite != NULL ? stats->mCallSite : "unknown") << ", "
+            << stats->mCount << ", " << stats->mContendedCount << ", "
+            << stats->mTotalWaitTime * 1000.0 << ", " << waitTimes[0] * 1000.0f << ", " << waitTimes[1] * 1000.0f << ", " << waitTimes[2] * 1000.0f << ", "
+            << stats->mTotalHoldTime * 1000.0 << ", " << holdTimes[0] * 1000.0f << ", " << holdTimes[1] * 1000.0f << ", " << holdTimes[2] * 1000.0f << "\n";
+    }
+
+    mStatisticsMutex.unlock();
+
+    return ss.str();
+}
+
+/*!
+    Print the lock statistics, see getReport().
+*/
+void sgct::SGCTMutexManager::printReport()
+{
+    if (!isProfilingEnabled())
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_WARNING, "SGCT is built without mutex profiling, enable the SGCT_MUTEX_PROFILING CMake option.\n");
+        return;
+    }
+
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "%s", getReport().c_str());
+}
+
+/*!
+    Clear the recorded lock statistics. Call sites are kept but their counts and times are reset.
+*/
+void sgct::SGCTMutexManager::resetStatistics()
+{
+    mStatisticsMutex.lock();
+
+    std::map< std::pair<const char *, const char *>, LockStatistics * >::iterator it;
+    for (it = mStatistics.begin(); it != mStatistics.end(); ++it)
+    {
+        LockStatistics * stats = it->second;
+        stats->mCount = 0;
+        stats->mContendedCount = 0;
+        stats->mTotalWaitTime = 0.0;
+        stats->mTotalHoldTime = 0.0;
+        stats->mWaitTimes.clear();
+        stats->mHoldTimes.clear();
+    }
+
+    mStatisticsMutex.unlock();
+}
+
+/*!
+    Record a lock of a mutex, called after the mutex is unlocked.
+*/
+void sgct::SGCTMutexManager::addLock(const char * mutexName, const LockRecord & record, int64_t holdTime)
+{
+    double waitSeconds = static_cast<double>(record.mWaitTime) / 1000000000.0;
+    double holdSeconds = static_cast<double>(holdTime) / 1000000000.0;
+
+    mStatisticsMutex.lock();
+
+    LockStatistics *& stats = mStatistics[std::make_pair(mutexName, record.mCallSite)];
+    if (stats == NULL)
+    {
+        stats = new LockStatistics();
+        stats->mMutexName = mutexName;
+        stats->mCallSite = record.mCallSite;
+    }
+
+    stats->mCount++;
+    if (record.mContended)
+        stats->mContendedCount++;
+    stats->mTotalWaitTime += waitSeconds;
+    stats->mWaitTimes.add(static_cast<float>(waitSeconds));
+    stats->mTotalHoldTime += holdSeconds;
+    stats->mHoldTimes.add(static_cast<float>(holdSeconds));
+
+    mStatisticsMutex.unlock();
+}
+
+/*!
+    \returns a monotonic time in nanoseconds
+*/
+int64_t sgct::SGCTMutexManager::getTime()
+{
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void sgct::SGCTProfiledMutex::lock()
+{
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    //the shared data types can outlive the SGCTMutexManager, they are only recorded while it exists
+    SGCTMutexManager * manager = SGCTMutexManager::mInstance;
+    if (manager == NULL)
+    {
+        mMutex.lock();
+        mRecorded = false;
+        return;
+    }
+
+    int64_t startTime = SGCTMutexManager::getTime();
+    bool contended = !mMutex.try_lock();
+    if (contended)
+        mMutex.lock();
+
+    mRecord.mContended = contended;
+    mRecord.mWaitTime = contended ? SGCTMutexManager::getTime() - startTime : 0;
+    mRecorded = true;
+    mRecord.mLockTime = SGCTMutexManager::getTime();
+#else
+    mMutex.lock();
+#endif
+}
+
+void sgct::SGCTProfiledMutex::unlock()
+{
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    if (mRecorded)
+    {
+        int64_t unlockTime = SGCTMutexManager::getTime();
+        SGCTMutexManager::LockRecord record = mRecord;
+        mRecorded = false;
+        mMutex.unlock();
+
+        SGCTMutexManager * manager = SGCTMutexManager::mInstance;
+        if (manager != NULL)
+            manager->addLock(mName, record, unlockTime - record.mLockTime);
+        return;
+    }
+#endif
+    mMutex.unlock();
+}
+
+bool sgct::SGCTProfiledMutex::try_lock()
+{
+    if (!mMutex.try_lock())
+        return false;
+
+#if INCLUDE_SGCT_MUTEX_PROFILING
+    mRecord.mContended = false;
+    mRecord.mWaitTime = 0;
+    mRecorded = SGCTMutexManager::mInstance != NULL;
+    mRecord.mLockTime = SGCTMutexManager::getTime();
+#endif
+    return true;
+}
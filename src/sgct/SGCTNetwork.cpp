@@ -39,6 +39,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/MessageHandler.h>
 #include <sgct/ClusterManager.h>
 #include <sgct/Engine.h>
+#include <sgct/SGCTTrace.h>
+#include <sstream>
 
 #ifndef SGCT_DONT_USE_EXTERNAL
 #include "../include/external/zlib.h"
@@ -51,6 +53,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 #define MAX_NUMBER_OF_ATTEMPS 10
 #define SGCT_SOCKET_BUFFER_SIZE 4096
+#define SGCT_CLIENT_LOG_INTERVAL 0.1
+#define SGCT_CLIENT_LOG_COMPRESSION_SIZE 256
 
 sgct_core::SGCTNetwork::SGCTNetwork()
 {
@@ -82,12 +86,23 @@ sgct_core::SGCTNetwork::SGCTNetwork()
     mConnected            = false;
     mTerminate          = false;
     mUseNaglesAlgorithmInDataTransfer = false;
+    mClientLogTime        = 0.0;
+    mClientSyncLatency    = new SyncLatencyStatistics();
+    mAckSendTime        = 0.0;
+    mAckReceiveTime        = 0.0;
+    mAckInSync            = false;
     
     static int id = 0;
     mId = id;
     id++;
 }
 
+sgct_core::SGCTNetwork::~SGCTNetwork()
+{
+    delete mClientSyncLatency;
+    mClientSyncLatency = NULL;
+}
+
 /*!
     Inits this network connection.
 
@@ -218,6 +233,12 @@ void sgct_core::SGCTNetwork::connectionHandlerStarter(void *arg)
 
 void sgct_core::SGCTNetwork::connectionHandler()
 {
+#if INCLUDE_SGCT_TRACE
+    std::stringstream ss;
+    ss << "Connection " << mId << " handler";
+    SGCT_TRACE_THREAD_NAME(ss.str());
+#endif
+
     if( mServer )
     {
         while( !isTerminated() )
@@ -447,9 +468,14 @@ int sgct_core::SGCTNetwork::iterateFrameCounter()
 }
 
 /*!
-    The client sends ack message to server + console messages
+    The client sends ack message to server
+
+    The optional statistics record is sent as the data of the message and its size is stored in the last header field,
+    which is only used for the uncompressed size of the data sent from the server. The sync latency record is only sent
+    after a statistics record. Console messages are sent separately by pushClientLog so that the size of the ack doesn't
+    depend on the amount of logging.
 */
-void sgct_core::SGCTNetwork::pushClientMessage()
+void sgct_core::SGCTNetwork::pushClientMessage(const StatisticsRecord * record, const SyncLatencyRecord * latency)
 {
 #ifdef __SGCT_NETWORK_DEBUG__
     sgct::MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SGCTNetwork::pushClientMessage\n");
@@ -459,63 +485,174 @@ void sgct_core::SGCTNetwork::pushClientMessage()
     int currentFrame = iterateFrameCounter();
     unsigned char *p = (unsigned char *)&currentFrame;
 
-    if(sgct::MessageHandler::instance()->getDataSize() > mHeaderSize)
-    {
-        sgct::SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
-
-        //Don't remove this pointer, somehow the send function doesn't
-        //work during the first call without setting the pointer first!!!
-        char * messageToSend = sgct::MessageHandler::instance()->getMessage();
-        messageToSend[0] = SGCTNetwork::DataId;
-        messageToSend[1] = p[0];
-        messageToSend[2] = p[1];
-        messageToSend[3] = p[2];
-        messageToSend[4] = p[3];
-
-        //crop if needed
-        uint32_t size = mBufferSize;
-        uint32_t currentMessageSize =
-            static_cast<uint32_t>(sgct::MessageHandler::instance()->getDataSize()) > size ?
-            size :
-            static_cast<uint32_t>(sgct::MessageHandler::instance()->getDataSize());
-
-        uint32_t dataSize = currentMessageSize - mHeaderSize;
-        unsigned char *currentMessageSizePtr = reinterpret_cast<unsigned char *>(&dataSize);
-        messageToSend[5] = currentMessageSizePtr[0];
-        messageToSend[6] = currentMessageSizePtr[1];
-        messageToSend[7] = currentMessageSizePtr[2];
-        messageToSend[8] = currentMessageSizePtr[3];
-        
-        //fill rest of header with DefaultId
-        memset(messageToSend+9, DefaultId, 4);
+    char messageToSend[mHeaderSize + StatisticsRecord::mEncodedSize + SyncLatencyRecord::mEncodedSize];
+    uint32_t recordSize = record != NULL ? static_cast<uint32_t>(StatisticsRecord::mEncodedSize) : 0;
+    if (record != NULL && latency != NULL)
+        recordSize += static_cast<uint32_t>(SyncLatencyRecord::mEncodedSize);
+
+    messageToSend[0] = SGCTNetwork::DataId;
+    messageToSend[1] = p[0];
+    messageToSend[2] = p[1];
+    messageToSend[3] = p[2];
+    messageToSend[4] = p[3];
+
+    unsigned char *recordSizePtr = reinterpret_cast<unsigned char *>(&recordSize);
+    messageToSend[5] = recordSizePtr[0];
+    messageToSend[6] = recordSizePtr[1];
+    messageToSend[7] = recordSizePtr[2];
+    messageToSend[8] = recordSizePtr[3];
+    messageToSend[9] = recordSizePtr[0];
+    messageToSend[10] = recordSizePtr[1];
+    messageToSend[11] = recordSizePtr[2];
+    messageToSend[12] = recordSizePtr[3];
+
+    if (record != NULL)
+        record->encode(messageToSend + mHeaderSize);
+    if (record != NULL && latency != NULL)
+        latency->encode(messageToSend + mHeaderSize + StatisticsRecord::mEncodedSize);
+
+    sendData(reinterpret_cast<void*>(messageToSend), static_cast<int>(mHeaderSize + recordSize));
+}
 
-        sendData(reinterpret_cast<void*>(messageToSend), static_cast<int>(currentMessageSize));
+/*!
+    The client sends its console messages to the server, should be called after the ack has been sent.
 
-        sgct::SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    Messages are collected by the MessageHandler and sent in batches at most every SGCT_CLIENT_LOG_INTERVAL seconds,
+    compressed if larger than SGCT_CLIENT_LOG_COMPRESSION_SIZE bytes. The number of messages the MessageHandler dropped
+    since the last batch is sent in place of the frame number.
 
-        sgct::MessageHandler::instance()->clearBuffer(); //clear the buffer
-    }
-    else
+    \param force send the messages even if the interval hasn't passed
+*/
+void sgct_core::SGCTNetwork::pushClientLog(bool force)
+{
+    double now = sgct::Engine::getTime();
+    if (!force && now - mClientLogTime < SGCT_CLIENT_LOG_INTERVAL)
+        return;
+
+    uint32_t droppedMessages = 0;
+    if (!sgct::MessageHandler::instance()->getServerMessages(mClientLog, droppedMessages))
+        return;
+    mClientLogTime = now;
+
+    uint32_t uncompressedSize = 0;
+    const char * data = mClientLog.empty() ? NULL : &mClientLog[0];
+    uint32_t dataSize = static_cast<uint32_t>(mClientLog.size());
+
+    if (dataSize > SGCT_CLIENT_LOG_COMPRESSION_SIZE)
     {
-        char tmpca[mHeaderSize];
-        tmpca[0] = SGCTNetwork::DataId;
-        tmpca[1] = p[0];
-        tmpca[2] = p[1];
-        tmpca[3] = p[2];
-        tmpca[4] = p[3];
-
-        uint32_t localSyncHeaderSize = 0;
-        unsigned char *currentMessageSizePtr = (unsigned char *)&localSyncHeaderSize;
-        tmpca[5] = currentMessageSizePtr[0];
-        tmpca[6] = currentMessageSizePtr[1];
-        tmpca[7] = currentMessageSizePtr[2];
-        tmpca[8] = currentMessageSizePtr[3];
-        
-        //fill rest of header with DefaultId
-        memset(tmpca+9, DefaultId, 4);
+        uLongf compressedSize = compressBound(static_cast<uLong>(dataSize));
+        mClientLogCompressed.resize(mHeaderSize + compressedSize);
+        if (compress2(reinterpret_cast<Bytef*>(&mClientLogCompressed[mHeaderSize]), &compressedSize,
+            reinterpret_cast<const Bytef*>(data), static_cast<uLong>(dataSize), Z_BEST_SPEED) == Z_OK)
+        {
+            uncompressedSize = dataSize;
+            dataSize = static_cast<uint32_t>(compressedSize);
+        }
+    }
 
-        sendData((void *)tmpca, mHeaderSize);
+    //the header and uncompressed data are put in the same buffer to send a single message
+    if (uncompressedSize == 0)
+    {
+        mClientLogCompressed.resize(mHeaderSize + dataSize);
+        if (dataSize > 0)
+            memcpy(&mClientLogCompressed[mHeaderSize], data, dataSize);
     }
+
+    char * messageToSend = &mClientLogCompressed[0];
+    messageToSend[0] = SGCTNetwork::LogId;
+
+    unsigned char *droppedPtr = reinterpret_cast<unsigned char *>(&droppedMessages);
+    messageToSend[1] = droppedPtr[0];
+    messageToSend[2] = droppedPtr[1];
+    messageToSend[3] = droppedPtr[2];
+    messageToSend[4] = droppedPtr[3];
+
+    unsigned char *dataSizePtr = reinterpret_cast<unsigned char *>(&dataSize);
+    messageToSend[5] = dataSizePtr[0];
+    messageToSend[6] = dataSizePtr[1];
+    messageToSend[7] = dataSizePtr[2];
+    messageToSend[8] = dataSizePtr[3];
+
+    unsigned char *uncompressedSizePtr = reinterpret_cast<unsigned char *>(&uncompressedSize);
+    messageToSend[9] = uncompressedSizePtr[0];
+    messageToSend[10] = uncompressedSizePtr[1];
+    messageToSend[11] = uncompressedSizePtr[2];
+    messageToSend[12] = uncompressedSizePtr[3];
+
+    sendData(reinterpret_cast<void*>(messageToSend), static_cast<int>(mHeaderSize + dataSize));
+}
+
+/*!
+    The client sends the time spent in each phase of Engine::init to the server, once after init.
+*/
+void sgct_core::SGCTNetwork::pushStartupRecord(const sgct_core::StartupRecord & record)
+{
+    char messageToSend[mHeaderSize + StartupRecord::mEncodedSize];
+    uint32_t recordSize = static_cast<uint32_t>(StartupRecord::mEncodedSize);
+    uint32_t uncompressedSize = 0;
+
+    messageToSend[0] = SGCTNetwork::StartupId;
+    messageToSend[1] = DefaultId;
+    messageToSend[2] = DefaultId;
+    messageToSend[3] = DefaultId;
+    messageToSend[4] = DefaultId;
+
+    unsigned char *recordSizePtr = reinterpret_cast<unsigned char *>(&recordSize);
+    messageToSend[5] = recordSizePtr[0];
+    messageToSend[6] = recordSizePtr[1];
+    messageToSend[7] = recordSizePtr[2];
+    messageToSend[8] = recordSizePtr[3];
+
+    unsigned char *uncompressedSizePtr = reinterpret_cast<unsigned char *>(&uncompressedSize);
+    messageToSend[9] = uncompressedSizePtr[0];
+    messageToSend[10] = uncompressedSizePtr[1];
+    messageToSend[11] = uncompressedSizePtr[2];
+    messageToSend[12] = uncompressedSizePtr[3];
+
+    record.encode(messageToSend + mHeaderSize);
+    sendData(reinterpret_cast<void*>(messageToSend), static_cast<int>(mHeaderSize + recordSize));
+}
+
+/*!
+    Get the start-up times sent by the client of this connection.
+
+    \returns false if the client hasn't sent them yet
+*/
+bool sgct_core::SGCTNetwork::getClientStartupRecord(sgct_core::StartupRecord & record)
+{
+    std::unique_lock<std::mutex> lock(mClientStatisticsMutex);
+    if (mClientStartupRecord.size() != StartupRecord::mEncodedSize)
+        return false;
+
+    record.decode(&mClientStartupRecord[0]);
+    return true;
+}
+
+/*!
+    Get the latest statistics sent by the client of this connection.
+
+    \returns false if no statistics have been received
+*/
+bool sgct_core::SGCTNetwork::getClientStatistics(sgct_core::StatisticsRecord & record)
+{
+    std::unique_lock<std::mutex> lock(mClientStatisticsMutex);
+    if (mClientStatistics.size() != StatisticsRecord::mEncodedSize)
+        return false;
+
+    record.decode(&mClientStatistics[0]);
+    return true;
+}
+
+/*!
+    Get the age of the shared data at each stage of the frames of the client, in the master's clock.
+
+    \returns false if the client hasn't sent any sync latency records
+*/
+bool sgct_core::SGCTNetwork::getClientSyncLatency(sgct_core::SyncLatencySummary & summary)
+{
+    std::unique_lock<std::mutex> lock(mClientStatisticsMutex);
+    mClientSyncLatency->getSummary(summary);
+    return summary.mCount > 0;
 }
 
 void sgct_core::SGCTNetwork::enableNaglesAlgorithmInDataTransfer()
@@ -684,7 +821,12 @@ void sgct_core::SGCTNetwork::setRecvFrame(int i)
     fprintf(stderr, "Locking mutex for connection %d...\n", mId);
 #endif
     mConnectionMutex.lock();
-    mTimeStamp[Total] = sgct::Engine::getTime() - mTimeStamp[Send];
+    double now = sgct::Engine::getTime();
+    mTimeStamp[Total] = now - mTimeStamp[Send];
+    //only acks of the latest sent frame give a valid clock sample
+    mAckSendTime = mTimeStamp[Send];
+    mAckReceiveTime = now;
+    mAckInSync = (i == mSendFrame[Current].load());
     mConnectionMutex.unlock();
 #ifdef __SGCT_MUTEX_DEBUG__
     fprintf(stderr, "Mutex for connection %d is unlocked.\n", mId);
@@ -817,6 +959,15 @@ int sgct_core::SGCTNetwork::readSyncMessage(char * _header, int32_t & _syncFrame
             fprintf(stderr, "Mutex for connection %d is unlocked.\n", mId);
 #endif
         }
+        else if (mHeaderId == sgct_core::SGCTNetwork::LogId || mHeaderId == sgct_core::SGCTNetwork::StartupId)
+        {
+            //log messages and start-up times from clients are not part of the frame sync, for logs the frame field holds the number of dropped messages
+            _dataSize = sgct_core::SGCTNetwork::parseUInt32(&_header[5]);
+            _uncompressedDataSize = sgct_core::SGCTNetwork::parseUInt32(&_header[9]);
+
+            updateBuffer(&mRecvBuf, _dataSize, mBufferSize);
+            updateBuffer(&mUncompressBuf, _uncompressedDataSize, mUncompressedBufferSize);
+        }
     }
 
 #ifdef __SGCT_NETWORK_DEBUG__
@@ -943,6 +1094,12 @@ void sgct_core::SGCTNetwork::communicationHandler()
     if( isTerminated() )
         return;
 
+#if INCLUDE_SGCT_TRACE
+    std::stringstream ss;
+    ss << "Connection " << mId << " (" << getTypeStr() << ")";
+    SGCT_TRACE_THREAD_NAME(ss.str());
+#endif
+
     //listen for client if server
     if( mServer )
     {
@@ -975,6 +1132,11 @@ void sgct_core::SGCTNetwork::communicationHandler()
     setConnectedStatus(true);
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Connection %d established!\n", mId);
 
+    //a new client has a clock of its own
+    mClientStatisticsMutex.lock();
+    mClientSyncLatency->clear();
+    mClientStatisticsMutex.unlock();
+
     if (mUpdateCallbackFn != SGCT_NULL_PTR)
         mUpdateCallbackFn(this);
 
@@ -1033,6 +1195,7 @@ void sgct_core::SGCTNetwork::communicationHandler()
         */
         if (iResult > 0)
         {
+            SGCT_TRACE_SCOPE("SGCTNetwork::decode");
             if (getType() == sgct_core::SGCTNetwork::SyncConnection)
             {
                 /*
@@ -1067,9 +1230,28 @@ void sgct_core::SGCTNetwork::communicationHandler()
                 if( mHeaderId == sgct_core::SGCTNetwork::DataId &&
                     mDecoderCallbackFn != SGCT_NULL_PTR)
                     {
-                        //decode callback
-                        if(dataSize > 0)
-                            (mDecoderCallbackFn)(mRecvBuf, dataSize, mId);
+                        //messages from clients start with a statistics record, its size is stored in the last header field
+                        uint32_t recordSize = mServer && uncompressedDataSize <= dataSize ? uncompressedDataSize : 0;
+                        if (recordSize == StatisticsRecord::mEncodedSize ||
+                            recordSize == StatisticsRecord::mEncodedSize + SyncLatencyRecord::mEncodedSize)
+                        {
+                            std::unique_lock<std::mutex> lock(mClientStatisticsMutex);
+                            mClientStatistics.assign(mRecvBuf, mRecvBuf + StatisticsRecord::mEncodedSize);
+
+                            //followed by the timestamps of the previous frame of the client
+                            if (recordSize > StatisticsRecord::mEncodedSize)
+                            {
+                                SyncLatencyRecord latency;
+                                latency.decode(mRecvBuf + StatisticsRecord::mEncodedSize);
+                                if (mAckInSync && latency.mAckDecodeTime >= 0.0)
+                                    mClientSyncLatency->addClockSample(mAckSendTime, latency.mAckDecodeTime, latency.mAckTime, mAckReceiveTime);
+                                mClientSyncLatency->addRecord(latency);
+                            }
+                        }
+
+                        //decode callback, clients that don't send their log messages separately append them to the record
+                        if(dataSize > recordSize)
+                            (mDecoderCallbackFn)(mRecvBuf + recordSize, dataSize - recordSize, mId);
 
                         /*if(!mServer)
                         {
@@ -1087,6 +1269,7 @@ void sgct_core::SGCTNetwork::communicationHandler()
                         //decode callback
                         if(dataSize > 0)
                         {
+                            SGCT_TRACE_SCOPE("SGCTNetwork::uncompress");
                             //parse the package id
                             uLongf uncompressedSize = static_cast<uLongf>(uncompressedDataSize);
     
@@ -1113,6 +1296,41 @@ void sgct_core::SGCTNetwork::communicationHandler()
                          }*/
                         sgct_core::NetworkManager::gCond.notify_all();
                     }
+                    else if( mHeaderId == sgct_core::SGCTNetwork::LogId &&
+                        mServer && mDecoderCallbackFn != SGCT_NULL_PTR)
+                    {
+                        uint32_t droppedMessages = sgct_core::SGCTNetwork::parseUInt32(&recvHeader[1]);
+                        if (droppedMessages > 0)
+                            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "Network: Client %d dropped %u log messages.\n", mId, droppedMessages);
+
+                        if (dataSize > 0 && uncompressedDataSize == 0)
+                        {
+                            (mDecoderCallbackFn)(mRecvBuf, dataSize, mId);
+                        }
+                        else if (dataSize > 0)
+                        {
+                            uLongf uncompressedSize = static_cast<uLongf>(uncompressedDataSize);
+
+                            int err = uncompress(
+                                                 reinterpret_cast<Bytef*>(mUncompressBuf),
+                                                 &uncompressedSize,
+                                                 reinterpret_cast<Bytef*>(mRecvBuf),
+                                                 static_cast<uLongf>(dataSize));
+
+                            if(err == Z_OK)
+                                (mDecoderCallbackFn)(mUncompressBuf, static_cast<int>(uncompressedSize), mId);
+                            else
+                                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Network: Failed to uncompress log messages for connection %d! Error: %s\n", mId, getUncompressionErrorAsStr(err).c_str());
+                        }
+                    }
+                    else if (mHeaderId == sgct_core::SGCTNetwork::StartupId && mServer)
+                    {
+                        if (dataSize == StartupRecord::mEncodedSize)
+                        {
+                            std::unique_lock<std::mutex> lock(mClientStatisticsMutex);
+                            mClientStartupRecord.assign(mRecvBuf, mRecvBuf + dataSize);
+                        }
+                    }
                     else if (mHeaderId == sgct_core::SGCTNetwork::ConnectedId &&
                         mConnectedCallbackFn != SGCT_NULL_PTR)
                     {
@@ -1395,6 +1613,7 @@ void sgct_core::SGCTNetwork::communicationHandler()
 
 void sgct_core::SGCTNetwork::sendData(const void * data, int length)
 {
+    SGCT_TRACE_SCOPE("SGCTNetwork::sendData");
     //fprintf(stderr, "Send data size: %d\n", length);
 #ifdef __SGCT_NETWORK_DEBUG__
     for(int i=0; i<length; i++)
@@ -1460,6 +1679,10 @@ void sgct_core::SGCTNetwork::closeNetwork(bool forced)
 
 void sgct_core::SGCTNetwork::initShutdown()
 {
+    //send the last batch of client log messages, which often contains the reason for shutting down
+    if( mConnected && !mServer && mConnectionType == SyncConnection )
+        pushClientLog(true);
+
     if( mConnected )
     {
         char gameOver[9];
@@ -19,6 +19,9 @@ sgct::SGCTSettings::SGCTSettings()
     mJPEGQuality = 100;
 
     mNumberOfCaptureThreads = std::thread::hardware_concurrency();
+    mNumberOfTextureLoadingThreads = 2;
+    mTextureUploadSizeBudget = 16 * 1024 * 1024; //16 MB per frame
+    mTextureUploadTimeBudget = 4.0f;
 
     mCaptureBackBuffer            = false;
     mUseWarping                    = true;
@@ -32,6 +35,14 @@ sgct::SGCTSettings::SGCTSettings()
     mUseRLE                        = false;
     mTryMaintainAspectRatio        = true;
     mExportWarpingMeshes        = false;
+    mUseWarpingMeshCache        = true;
+    mUseWarpingMeshVertexCacheOptimization = true;
+    mUseWarpingMeshPackedVertices = false;
+    mUseWarpMaps = true;
+    mSaveTraceOnExit = true;
+    mTraceBufferSize = 65536;
+    mTracePath.assign("sgct_trace");
+    mWarpingMeshSimplificationTolerance = 0.0f;
 
     mSwapInterval = 1;
     mRefreshRate = 0;
@@ -208,6 +219,126 @@ void sgct::SGCTSettings::configure(tinyxml2::XMLElement * element)
             }
         }
 
+        else if (strcmp("TextureLoading", val) == 0)
+        {
+            int threads = 0;
+            if (subElement->QueryIntAttribute("threads", &threads) == tinyxml2::XML_NO_ERROR)
+            {
+                sgct::SGCTSettings::instance()->setNumberOfTextureLoadingThreads(threads);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting number of texture loading threads to %d\n", threads);
+            }
+
+            unsigned int budget = 0;
+            if (subElement->QueryUnsignedAttribute("uploadBudget", &budget) == tinyxml2::XML_NO_ERROR)
+            {
+                sgct::SGCTSettings::instance()->setTextureUploadSizeBudget(static_cast<std::size_t>(budget) * 1024);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting texture upload budget to %u kB per frame\n", budget);
+            }
+
+            float ms = 0.0f;
+            if (subElement->QueryFloatAttribute("uploadTimeBudget", &ms) == tinyxml2::XML_NO_ERROR)
+            {
+                sgct::SGCTSettings::instance()->setTextureUploadTimeBudget(ms);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting texture upload time budget to %f ms per frame\n", ms);
+            }
+        }
+
+        else if (strcmp("WarpingMeshCache", val) == 0)
+        {
+            if (subElement->Attribute("enabled") != NULL)
+            {
+                bool state = strcmp(subElement->Attribute("enabled"), "true") == 0 ? true : false;
+                sgct::SGCTSettings::instance()->setUseWarpingMeshCache(state);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting warping mesh cache to %s\n", state ? "enabled" : "disabled");
+            }
+
+            if (subElement->Attribute("path") != NULL)
+            {
+                sgct::SGCTSettings::instance()->setWarpingMeshCachePath(subElement->Attribute("path"));
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting warping mesh cache path to '%s'\n", subElement->Attribute("path"));
+            }
+        }
+
+        else if (strcmp("WarpingMeshOptimization", val) == 0)
+        {
+            float tolerance = 0.0f;
+            if (subElement->QueryFloatAttribute("tolerance", &tolerance) == tinyxml2::XML_NO_ERROR)
+            {
+                sgct::SGCTSettings::instance()->setWarpingMeshSimplificationTolerance(tolerance);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting warping mesh simplification tolerance to %f pixels\n", tolerance);
+            }
+
+            if (subElement->Attribute("vertexCache") != NULL)
+            {
+                bool state = strcmp(subElement->Attribute("vertexCache"), "true") == 0 ? true : false;
+                sgct::SGCTSettings::instance()->setUseWarpingMeshVertexCacheOptimization(state);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting warping mesh vertex cache optimization to %s\n", state ? "enabled" : "disabled");
+            }
+
+            if (subElement->Attribute("packedVertices") != NULL)
+            {
+                bool state = strcmp(subElement->Attribute("packedVertices"), "true") == 0 ? true : false;
+                sgct::SGCTSettings::instance()->setUseWarpingMeshPackedVertices(state);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting warping mesh packed vertices to %s\n", state ? "enabled" : "disabled");
+            }
+        }
+
+        else if (strcmp("Trace", val) == 0)
+        {
+            if (subElement->Attribute("path") != NULL)
+            {
+                sgct::SGCTSettings::instance()->setTracePath(subElement->Attribute("path"));
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting trace path to '%s'\n", subElement->Attribute("path"));
+            }
+
+            unsigned int size = 0;
+            if (subElement->QueryUnsignedAttribute("bufferSize", &size) == tinyxml2::XML_NO_ERROR && size > 0)
+            {
+                sgct::SGCTSettings::instance()->setTraceBufferSize(static_cast<std::size_t>(size));
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting trace buffer size to %u events per thread\n", size);
+            }
+
+            if (subElement->Attribute("saveOnExit") != NULL)
+            {
+                bool state = strcmp(subElement->Attribute("saveOnExit"), "true") == 0 ? true : false;
+                sgct::SGCTSettings::instance()->setSaveTraceOnExit(state);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting save trace on exit to %s\n", state ? "enabled" : "disabled");
+            }
+        }
+        else if (strcmp("Logging", val) == 0)
+        {
+            unsigned int maxFileSize = 0;
+            unsigned int maxFiles = 5;
+            if (subElement->QueryUnsignedAttribute("maxFileSize", &maxFileSize) == tinyxml2::XML_NO_ERROR)
+            {
+                subElement->QueryUnsignedAttribute("maxFiles", &maxFiles);
+
+                //size in megabytes
+                sgct::MessageHandler::instance()->setLogFileRotation(static_cast<std::size_t>(maxFileSize) * 1024 * 1024, maxFiles);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting log file rotation to %u MB and %u files\n", maxFileSize, maxFiles);
+            }
+
+            if (subElement->Attribute("flushOnCrash") != NULL)
+            {
+                bool state = strcmp(subElement->Attribute("flushOnCrash"), "true") == 0 ? true : false;
+                sgct::MessageHandler::instance()->setFlushOnCrash(state);
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                    "ReadConfig: Setting log flush on crash to %s\n", state ? "enabled" : "disabled");
+            }
+        }
+
         //iterate
         subElement = subElement->NextSiblingElement();
     }
@@ -323,6 +454,32 @@ void sgct::SGCTSettings::setNumberOfCaptureThreads(int count)
     mNumberOfCaptureThreads = count;
 }
 
+/*!
+Set the number of threads used to decode textures loaded using sgct::TextureManager::loadTextureAsync.
+Must be set before the first asynchronous load.
+*/
+void sgct::SGCTSettings::setNumberOfTextureLoadingThreads(int count)
+{
+    mNumberOfTextureLoadingThreads = count > 0 ? count : 1;
+}
+
+/*!
+Set the maximum number of bytes of asynchronously loaded textures that are uploaded to the GPU each frame.
+Large textures are split over several frames. Default is 16 MB.
+*/
+void sgct::SGCTSettings::setTextureUploadSizeBudget(std::size_t bytes)
+{
+    mTextureUploadSizeBudget = bytes;
+}
+
+/*!
+Set the maximum time in milliseconds that is spent uploading asynchronously loaded textures each frame. Default is 4 ms.
+*/
+void sgct::SGCTSettings::setTextureUploadTimeBudget(float ms)
+{
+    mTextureUploadTimeBudget = ms;
+}
+
 /*!
 Set the zlib compression level used for saving png files
 
@@ -405,6 +562,9 @@ void sgct::SGCTSettings::appendCapturePath(std::string str, sgct::SGCTSettings::
 Set the capture format which can be one of the following:
 -PNG
 -TGA
+-JPG
+-PFM (portable float map, used for floating point frame buffers)
+-HDR (Radiance RGBE)
 */
 void sgct::SGCTSettings::setCaptureFormat(const char * format)
 {
@@ -422,6 +582,14 @@ void sgct::SGCTSettings::setCaptureFormat(const char * format)
     {
         mCaptureFormat = sgct_core::ScreenCapture::JPEG;
     }
+    else if (strcmp("pfm", format) == 0 || strcmp("PFM", format) == 0)
+    {
+        mCaptureFormat = sgct_core::ScreenCapture::PFM;
+    }
+    else if (strcmp("hdr", format) == 0 || strcmp("HDR", format) == 0)
+    {
+        mCaptureFormat = sgct_core::ScreenCapture::HDR;
+    }
 
     mMutex.unlock();
 }
@@ -605,6 +773,84 @@ void sgct::SGCTSettings::setExportWarpingMeshes(bool state)
     mExportWarpingMeshes = state;
 }
 
+/*!
+Set to true if parsed warping meshes should be cached in a binary format. The cache is used at next start-up
+as long as the source mesh and the viewport are unchanged.
+*/
+void sgct::SGCTSettings::setUseWarpingMeshCache(bool state)
+{
+    mUseWarpingMeshCache = state;
+}
+
+/*!
+Set the directory where warping mesh caches are stored. The directory must exist. If empty (default) the caches are stored beside the source meshes.
+*/
+void sgct::SGCTSettings::setWarpingMeshCachePath(std::string path)
+{
+    mWarpingMeshCachePath.assign(path);
+}
+
+/*!
+Set the maximum error in pixels introduced when simplifying nearly linear regions of warping meshes. The error is measured
+as the change of the interpolated texture coordinates (in framebuffer pixels) at the removed vertices. Zero (default) disables simplification.
+*/
+void sgct::SGCTSettings::setWarpingMeshSimplificationTolerance(float pixels)
+{
+    mWarpingMeshSimplificationTolerance = pixels < 0.0f ? 0.0f : pixels;
+}
+
+/*!
+Set to true if the triangles of warping meshes should be reordered for better GPU vertex cache utilization (default true).
+*/
+void sgct::SGCTSettings::setUseWarpingMeshVertexCacheOptimization(bool state)
+{
+    mUseWarpingMeshVertexCacheOptimization = state;
+}
+
+/*!
+Set to true if the vertices of warping and blending meshes should be uploaded using normalized 16-bit positions and texture coordinates
+and 8-bit colors (12 bytes per vertex instead of 32). The fixed pipeline only packs the colors (20 bytes per vertex).
+Meshes with positions outside [-1, 1] or texture coordinates and colors outside [0, 1] are uploaded as floats. Default is false.
+*/
+void sgct::SGCTSettings::setUseWarpingMeshPackedVertices(bool state)
+{
+    mUseWarpingMeshPackedVertices = state;
+}
+
+/*!
+Set to false to warp viewports using their meshes even if warp maps have been baked for them (default true).
+Can be changed at runtime, for example to compare the performance of the two methods.
+*/
+void sgct::SGCTSettings::setUseWarpMaps(bool state)
+{
+    mUseWarpMaps = state;
+}
+
+/*!
+Set the path and base name of saved traces (default "sgct_trace"). Only used when SGCT is built with the SGCT_TRACE CMake option.
+*/
+void sgct::SGCTSettings::setTracePath(std::string path)
+{
+    mTracePath = path;
+}
+
+/*!
+Set the number of trace events stored per thread before the oldest are overwritten (default 65536, 32 bytes each).
+Must be set before Engine::init().
+*/
+void sgct::SGCTSettings::setTraceBufferSize(std::size_t numberOfEvents)
+{
+    mTraceBufferSize = numberOfEvents;
+}
+
+/*!
+Set to false to only save the trace when the trace key is pressed (default true).
+*/
+void sgct::SGCTSettings::setSaveTraceOnExit(bool state)
+{
+    mSaveTraceOnExit = state;
+}
+
 /*!
 Get if run length encoding (RLE) is used in PNG and TGA export.
 */
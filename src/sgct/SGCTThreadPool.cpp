@@ -0,0 +1,138 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/SGCTThreadPool.h>
+#include <sgct/MessageHandler.h>
+#include <sgct/SGCTTrace.h>
+
+sgct_core::SGCTThreadPool::SGCTThreadPool()
+{
+    mActiveTasks = 0;
+    mTerminate = false;
+}
+
+sgct_core::SGCTThreadPool::~SGCTThreadPool()
+{
+    stop();
+}
+
+/*!
+    Start the worker threads. If the pool is already running this call does nothing.
+
+    \param numberOfThreads the number of worker threads, a value of zero will start one thread
+*/
+void sgct_core::SGCTThreadPool::start(unsigned int numberOfThreads)
+{
+    if (!mThreads.empty())
+        return;
+
+    if (numberOfThreads == 0)
+        numberOfThreads = 1;
+
+    mTerminate = false;
+    for (unsigned int i = 0; i < numberOfThreads; i++)
+        mThreads.push_back(new std::thread(&SGCTThreadPool::worker, this));
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "SGCTThreadPool: Started %u worker threads.\n", numberOfThreads);
+}
+
+/*!
+    Join the worker threads. Tasks that are being executed are finished while queued tasks that haven't started are discarded.
+*/
+void sgct_core::SGCTThreadPool::stop()
+{
+    if (mThreads.empty())
+        return;
+
+    mMutex.lock();
+    mTerminate = true;
+    mTasks.clear();
+    mMutex.unlock();
+    mTaskCondition.notify_all();
+    mIdleCondition.notify_all();
+
+    for (std::size_t i = 0; i < mThreads.size(); i++)
+    {
+        if (mThreads[i] != NULL)
+        {
+            mThreads[i]->join();
+            delete mThreads[i];
+        }
+    }
+    mThreads.clear();
+}
+
+/*!
+    Queue a task. If the pool isn't running the task is executed directly by the calling thread.
+*/
+void sgct_core::SGCTThreadPool::addTask(Task task)
+{
+    if (mThreads.empty())
+    {
+        task();
+        return;
+    }
+
+    mMutex.lock();
+    mTasks.push_back(task);
+    mMutex.unlock();
+    mTaskCondition.notify_one();
+}
+
+/*!
+    Block until all queued tasks have been executed.
+*/
+void sgct_core::SGCTThreadPool::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mTasks.empty() || mActiveTasks > 0)
+        mIdleCondition.wait(lock);
+}
+
+/*!
+    \returns the number of tasks that are queued or being executed
+*/
+std::size_t sgct_core::SGCTThreadPool::getNumberOfPendingTasks()
+{
+    std::size_t count;
+    mMutex.lock();
+    count = mTasks.size() + mActiveTasks;
+    mMutex.unlock();
+    return count;
+}
+
+void sgct_core::SGCTThreadPool::worker()
+{
+    SGCT_TRACE_THREAD_NAME("Thread pool worker");
+
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mTasks.empty() && !mTerminate)
+                mTaskCondition.wait(lock);
+
+            if (mTerminate)
+                break;
+
+            task = mTasks.front();
+            mTasks.pop_front();
+            mActiveTasks++;
+        }
+
+        task();
+
+        mMutex.lock();
+        mActiveTasks--;
+        bool idle = mTasks.empty() && mActiveTasks == 0;
+        mMutex.unlock();
+
+        if (idle)
+            mIdleCondition.notify_all();
+    }
+}
@@ -0,0 +1,283 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <stdio.h>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
+#include <sgct/SGCTTrace.h>
+#include <sgct/MessageHandler.h>
+
+#define DEFAULT_TRACE_BUFFER_SIZE 65536
+
+sgct::SGCTTrace * sgct::SGCTTrace::mInstance = NULL;
+
+//incremented when the trace is destroyed so that stale thread handles are ignored
+static std::atomic<unsigned int> traceGeneration(1);
+
+namespace sgct
+{
+    /*
+        Owns the buffer of a thread and hands it back for reuse when the thread exits.
+    */
+    struct SGCTTraceThreadHandle
+    {
+        SGCTTraceThreadHandle() : mBuffer(NULL), mGeneration(0) {}
+        ~SGCTTraceThreadHandle()
+        {
+            if (mBuffer != NULL && mGeneration == traceGeneration.load())
+                mBuffer->mInUse.store(false, std::memory_order_release);
+        }
+
+        SGCTTrace::ThreadBuffer * mBuffer;
+        unsigned int mGeneration;
+    };
+}
+
+static thread_local sgct::SGCTTraceThreadHandle threadHandle;
+
+static void writeJSONString(FILE * file, const std::string & str)
+{
+    fputc('"', file);
+    for (std::size_t i = 0; i < str.size(); i++)
+    {
+        char c = str[i];
+        if (c == '"' || c == '\\')
+        {
+            fputc('\\', file);
+            fputc(c, file);
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+            fprintf(file, "\\u%04x", static_cast<unsigned int>(c));
+        else
+            fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+sgct::SGCTTrace::SGCTTrace()
+{
+    mBufferSize = DEFAULT_TRACE_BUFFER_SIZE;
+    mProcessId = 0;
+    mProcessName.assign("SGCT");
+    mStartTime = getTime();
+}
+
+sgct::SGCTTrace::~SGCTTrace()
+{
+    for (std::size_t i = 0; i < mBuffers.size(); i++)
+        delete mBuffers[i];
+    mBuffers.clear();
+}
+
+void sgct::SGCTTrace::destroy()
+{
+    if( mInstance != NULL )
+    {
+        traceGeneration++;
+        delete mInstance;
+        mInstance = NULL;
+    }
+}
+
+/*!
+    Set the number of events stored per thread before the oldest are overwritten. Only affects threads that haven't recorded any events yet.
+    Each event uses 32 bytes.
+*/
+void sgct::SGCTTrace::setBufferSize(std::size_t numberOfEvents)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBufferSize = numberOfEvents > 0 ? numberOfEvents : 1;
+}
+
+/*!
+    Set the name of the calling thread shown in the trace.
+*/
+void sgct::SGCTTrace::setThreadName(const std::string & name)
+{
+    ThreadBuffer * buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mThreadNames[buffer->mThreadId] = name;
+}
+
+/*!
+    Set the name and id of the process in the trace. Use different ids for the nodes of a cluster so that their traces can be merged.
+*/
+void sgct::SGCTTrace::setProcessName(const std::string & name, int id)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mProcessName = name;
+    mProcessId = id;
+}
+
+/*!
+    Add an event with a duration. Times are in nanoseconds, see getTime().
+*/
+void sgct::SGCTTrace::addCompleteEvent(const char * name, int64_t startTime, int64_t endTime)
+{
+    addEvent(name, startTime, endTime > startTime ? endTime - startTime : 0);
+}
+
+/*!
+    Add an event without a duration at the current time.
+*/
+void sgct::SGCTTrace::addInstantEvent(const char * name)
+{
+    addEvent(name, getTime(), -1);
+}
+
+/*!
+    \returns a monotonic time in nanoseconds used for the events
+*/
+int64_t sgct::SGCTTrace::getTime()
+{
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+sgct::SGCTTrace::ThreadBuffer * sgct::SGCTTrace::getThreadBuffer()
+{
+    unsigned int generation = traceGeneration.load();
+    if (threadHandle.mBuffer != NULL && threadHandle.mGeneration == generation)
+        return threadHandle.mBuffer;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    //reuse the buffer of an exited thread, its events are kept
+    ThreadBuffer * buffer = NULL;
+    for (std::size_t i = 0; i < mBuffers.size() && buffer == NULL; i++)
+        if (!mBuffers[i]->mInUse.load(std::memory_order_acquire))
+            buffer = mBuffers[i];
+
+    if (buffer == NULL)
+    {
+        buffer = new ThreadBuffer();
+        buffer->mEvents.resize(mBufferSize);
+        buffer->mHead.store(0);
+        mBuffers.push_back(buffer);
+    }
+    buffer->mInUse.store(true);
+
+    std::stringstream ss;
+    ss << "Thread " << mThreadNames.size();
+    buffer->mThreadId = static_cast<uint32_t>(mThreadNames.size());
+    mThreadNames.push_back(ss.str());
+
+    threadHandle.mBuffer = buffer;
+    threadHandle.mGeneration = generation;
+    return buffer;
+}
+
+void sgct::SGCTTrace::addEvent(const char * name, int64_t startTime, int64_t duration)
+{
+    ThreadBuffer * buffer = getThreadBuffer();
+
+    //only this thread writes to the buffer, the head is published after the event is written
+    uint64_t head = buffer->mHead.load(std::memory_order_relaxed);
+    Event & e = buffer->mEvents[static_cast<std::size_t>(head % buffer->mEvents.size())];
+    e.mName = name;
+    e.mStartTime = startTime;
+    e.mDuration = duration;
+    e.mThreadId = buffer->mThreadId;
+    buffer->mHead.store(head + 1, std::memory_order_release);
+}
+
+/*!
+    Save the recorded events as Chrome trace JSON. Threads keep recording while saving, events overwritten
+    during the copy are skipped.
+
+    \returns false if the file can't be written
+*/
+bool sgct::SGCTTrace::save(const std::string & filename)
+{
+    std::vector<Event> events;
+    std::vector<std::string> threadNames;
+    std::string processName;
+    int processId;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (std::size_t i = 0; i < mBuffers.size(); i++)
+        {
+            ThreadBuffer * buffer = mBuffers[i];
+            uint64_t size = static_cast<uint64_t>(buffer->mEvents.size());
+            uint64_t head = buffer->mHead.load(std::memory_order_acquire);
+            uint64_t first = head > size ? head - size : 0;
+
+            std::size_t offset = events.size();
+            for (uint64_t j = first; j < head; j++)
+                events.push_back(buffer->mEvents[static_cast<std::size_t>(j % size)]);
+
+            //events that were overwritten while copying might be torn, including the one being written
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t newHead = buffer->mHead.load(std::memory_order_relaxed) + 1;
+            if (newHead > first + size)
+            {
+                std::size_t overwritten = static_cast<std::size_t>(std::min(newHead - size - first, head - first));
+                events.erase(events.begin() + offset, events.begin() + offset + overwritten);
+            }
+        }
+
+        threadNames = mThreadNames;
+        processName = mProcessName;
+        processId = mProcessId;
+    }
+
+    FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&file, filename.c_str(), "wb") != 0)
+        file = NULL;
+#else
+    file = fopen(filename.c_str(), "wb");
+#endif
+    if (file == NULL)
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "SGCTTrace: Failed to save '%s'!\n", filename.c_str());
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":", processId);
+    writeJSONString(file, processName);
+    fprintf(file, "}}");
+
+    for (std::size_t i = 0; i < threadNames.size(); i++)
+    {
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":", processId, static_cast<unsigned int>(i));
+        writeJSONString(file, threadNames[i]);
+        fprintf(file, "}}");
+    }
+
+    for (std::size_t i = 0; i < events.size(); i++)
+    {
+        const Event & e = events[i];
+        fprintf(file, ",\n{\"name\":");
+        writeJSONString(file, e.mName != NULL ? e.mName : "");
+
+        //microseconds since the trace was created
+        double ts = static_cast<double>(e.mStartTime - mStartTime) / 1000.0;
+        if (e.mDuration >= 0)
+            fprintf(file, ",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                processId, e.mThreadId, ts, static_cast<double>(e.mDuration) / 1000.0);
+        else
+            fprintf(file, ",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f}", processId, e.mThreadId, ts);
+    }
+
+    fprintf(file, "\n]}\n");
+    bool success = ferror(file) == 0;
+    fclose(file);
+
+    if (success)
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "SGCTTrace: Saved %u events to '%s'.\n",
+            static_cast<unsigned int>(events.size()), filename.c_str());
+    else
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "SGCTTrace: Failed to save '%s'!\n", filename.c_str());
+
+    return success;
+}
@@ -90,7 +90,7 @@ Set the orientation as quaternion
 */
 void sgct::SGCTTracker::setOrientation(glm::quat q)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
 
     //create inverse rotation matrix
     mOrientation = glm::inverse(glm::mat4_cast(q));
@@ -110,7 +110,7 @@ void sgct::SGCTTracker::setOrientation(float xRot, float yRot, float zRot)
     rotQuat = glm::rotate(rotQuat, glm::radians(yRot), glm::vec3(0.0f, 1.0f, 0.0f));
     rotQuat = glm::rotate(rotQuat, glm::radians(zRot), glm::vec3(0.0f, 0.0f, 1.0f));
     
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
 
     //create inverse rotation matrix
     mOrientation = glm::inverse( glm::mat4_cast(rotQuat) );
@@ -125,7 +125,7 @@ Set the orientation as a quaternion
 void sgct::SGCTTracker::setOrientation(float w, float x, float y, float z)
 {
     glm::quat rotQuat(w, x, y, z);
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     
     //create inverse rotation matrix
     mOrientation = glm::inverse(glm::mat4_cast(rotQuat));
@@ -136,7 +136,7 @@ void sgct::SGCTTracker::setOrientation(float w, float x, float y, float z)
 
 void sgct::SGCTTracker::setOffset(float x, float y, float z)
 {
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         mOffset[0] = x;
         mOffset[1] = y;
         mOffset[2] = z;
@@ -147,7 +147,7 @@ void sgct::SGCTTracker::setOffset(float x, float y, float z)
 
 void sgct::SGCTTracker::setScale(double scaleVal)
 {
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         if( scaleVal > 0.0 )
             mScale = scaleVal;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
@@ -159,7 +159,7 @@ worldTransform = (trackerTransform * sensorMat) * deviceTransformMat
 */
 void sgct::SGCTTracker::setTransform(glm::mat4 mat)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     mXform = mat;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 }
@@ -176,7 +176,7 @@ void sgct::SGCTTracker::calculateTransform()
 glm::mat4 sgct::SGCTTracker::getTransform()
 { 
     glm::mat4 tmpMat;
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     tmpMat = mXform;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
     return tmpMat;
@@ -185,7 +185,7 @@ glm::mat4 sgct::SGCTTracker::getTransform()
 double sgct::SGCTTracker::getScale()
 {
     double tmpD;
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     tmpD = mScale;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
     return tmpD;
@@ -74,7 +74,7 @@ Set if this device is enabled or not
 */
 void sgct::SGCTTrackingDevice::setEnabled(bool state)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     mEnabled = state;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 }
@@ -160,7 +160,7 @@ void sgct::SGCTTrackingDevice::setSensorTransform(glm::dvec3 vec, glm::dquat rot
     glm::mat4 sensorTransMat = glm::translate(glm::mat4(1.0f), sensorPos);
     glm::mat4 sensorRotMat(glm::mat4_cast(sensorRot));
 
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     
     //swap
     mSensorRotation[PREVIOUS] = mSensorRotation[CURRENT];
@@ -193,7 +193,7 @@ void sgct::SGCTTrackingDevice::setButtonVal(const bool val, size_t index)
 {
     if( index < mNumberOfButtons )
     {
-        SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+        SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
         //swap
         mButtons[index + mNumberOfButtons] = mButtons[index];
         mButtons[index] = val;
@@ -205,7 +205,7 @@ void sgct::SGCTTrackingDevice::setButtonVal(const bool val, size_t index)
 
 void sgct::SGCTTrackingDevice::setAnalogVal(const double * array, size_t size)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     for (size_t i = 0; i < size; i++)
     {
         if (i < mNumberOfAxes)
@@ -230,7 +230,7 @@ void sgct::SGCTTrackingDevice::setOrientation(float xRot, float yRot, float zRot
     rotQuat = glm::rotate(rotQuat, glm::radians(yRot), glm::vec3(0.0f, 1.0f, 0.0f));
     rotQuat = glm::rotate(rotQuat, glm::radians(zRot), glm::vec3(0.0f, 0.0f, 1.0f));
 
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     //create inverse rotation matrix
     mOrientation = rotQuat;
 
@@ -245,7 +245,7 @@ void sgct::SGCTTrackingDevice::setOrientation(float w, float x, float y, float z
 {
     glm::quat rotQuat(w, x, y, z);
     
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     //create inverse rotation matrix
     mOrientation = rotQuat;
 
@@ -258,7 +258,7 @@ Set the orientation quaternion used to generate the orientation matrix\n
 */
 void sgct::SGCTTrackingDevice::setOrientation(glm::quat q)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     //create inverse rotation matrix
     mOrientation = q;
 
@@ -271,7 +271,7 @@ Set the offset vector used to generate the offset matrix\n
 */
 void sgct::SGCTTrackingDevice::setOffset(float x, float y, float z)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     mOffset[0] = x;
     mOffset[1] = y;
     mOffset[2] = z;
@@ -292,7 +292,7 @@ void sgct::SGCTTrackingDevice::setTransform(glm::mat4 mat)
         mat[0][2], mat[1][2], mat[2][2], mat[3][2],
         mat[0][3], mat[1][3], mat[2][3], mat[3][3]);*/
 
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     mDeviceTransformMatrix = mat;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 }
@@ -314,7 +314,7 @@ int sgct::SGCTTrackingDevice::getSensorId()
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get sensor id...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mSensorId;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
     return tmpVal;
@@ -329,7 +329,7 @@ bool sgct::SGCTTrackingDevice::getButton(size_t index, DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get button from array...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = index < mNumberOfButtons ? mButtons[index + mNumberOfButtons * i] : false;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
     return tmpVal;
@@ -344,7 +344,7 @@ double sgct::SGCTTrackingDevice::getAnalog(size_t index, DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get analog value...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = index < mNumberOfAxes ? mAxes[index + mNumberOfAxes * i] : 0.0;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
     return tmpVal;
@@ -359,7 +359,7 @@ glm::vec3 sgct::SGCTTrackingDevice::getPosition(DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get position...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         glm::mat4 & matRef = mWorldTransform[i];
         tmpVal[0] = matRef[3][0];
         tmpVal[1] = matRef[3][1];
@@ -377,7 +377,7 @@ glm::vec3 sgct::SGCTTrackingDevice::getEulerAngles(DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get euler angles");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = glm::eulerAngles( glm::quat_cast(mWorldTransform[i]) );
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
     return tmpVal;
@@ -389,7 +389,7 @@ glm::vec3 sgct::SGCTTrackingDevice::getEulerAngles(DataLoc i)
 glm::quat sgct::SGCTTrackingDevice::getRotation(DataLoc i)
 {
     glm::quat tmpQuat;
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     tmpQuat = glm::quat_cast(mWorldTransform[i]);
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
     return tmpQuat;
@@ -404,7 +404,7 @@ glm::mat4 sgct::SGCTTrackingDevice::getWorldTransform(DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get transform matrix...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpMat = mWorldTransform[i];
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
     return tmpMat;
@@ -419,7 +419,7 @@ glm::dquat sgct::SGCTTrackingDevice::getSensorRotation(DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get sensor quaternion...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     tmpQuat = mSensorRotation[i];
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
     return tmpQuat;
@@ -434,7 +434,7 @@ glm::dvec3 sgct::SGCTTrackingDevice::getSensorPosition(DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get sensor position vector...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     tmpVec = mSensorPos[i];
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
     return tmpVec;
@@ -446,7 +446,7 @@ bool sgct::SGCTTrackingDevice::isEnabled()
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Is device enabled...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mEnabled;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -455,7 +455,7 @@ bool sgct::SGCTTrackingDevice::isEnabled()
 
 void sgct::SGCTTrackingDevice::setTrackerTimeStamp()
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     //swap
     mTrackerTime[1] = mTrackerTime[0];
     mTrackerTime[0] = sgct::Engine::getTime();
@@ -464,7 +464,7 @@ void sgct::SGCTTrackingDevice::setTrackerTimeStamp()
 
 void sgct::SGCTTrackingDevice::setAnalogTimeStamp()
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     //swap
     mAnalogTime[1] = mAnalogTime[0];
     mAnalogTime[0] = sgct::Engine::getTime();
@@ -473,7 +473,7 @@ void sgct::SGCTTrackingDevice::setAnalogTimeStamp()
 
 void sgct::SGCTTrackingDevice::setButtonTimeStamp(size_t index)
 {
-    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
+    SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE);
     //swap
     mButtonTime[index + mNumberOfButtons] = mButtonTime[index];
     mButtonTime[index] = sgct::Engine::getTime();
@@ -486,7 +486,7 @@ double sgct::SGCTTrackingDevice::getTrackerTimeStamp(DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get device tracker time stamp...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mTrackerTime[i];
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -499,7 +499,7 @@ double sgct::SGCTTrackingDevice::getAnalogTimeStamp(DataLoc i)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Get device analog time stamp...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mAnalogTime[i];
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -513,7 +513,7 @@ double sgct::SGCTTrackingDevice::getButtonTimeStamp(size_t index, DataLoc i)
     fprintf(stderr, "Get device button time stamp...\n");
 #endif
 
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mButtonTime[index + mNumberOfButtons * i];
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -527,7 +527,7 @@ double sgct::SGCTTrackingDevice::getTrackerDeltaTime()
     fprintf(stderr, "Get device tracker delta time...\n");
 #endif
 
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mTrackerTime[0] - mTrackerTime[1];
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -541,7 +541,7 @@ double sgct::SGCTTrackingDevice::getAnalogDeltaTime()
     fprintf(stderr, "Get device analog delta time...\n");
 #endif
 
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mAnalogTime[0] - mAnalogTime[1];
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -555,7 +555,7 @@ double sgct::SGCTTrackingDevice::getButtonDeltaTime(size_t index)
     fprintf(stderr, "Get device button delta time...\n");
 #endif
 
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mButtonTime[index] - mButtonTime[index + mNumberOfButtons];
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
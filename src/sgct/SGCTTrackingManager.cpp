@@ -56,7 +56,7 @@ bool sgct::SGCTTrackingManager::isRunning()
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Checking if tracking is running...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mRunning;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -70,7 +70,7 @@ sgct::SGCTTrackingManager::~SGCTTrackingManager()
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Destructing, setting running to false...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         mRunning = false;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
@@ -373,7 +373,7 @@ void sgct::SGCTTrackingManager::setSamplingTime(double t)
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
     fprintf(stderr, "Set sampling time for vrpn loop...\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         mSamplingTime = t;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 }
@@ -384,7 +384,7 @@ double sgct::SGCTTrackingManager::getSamplingTime()
     fprintf(stderr, "Get sampling time for vrpn loop...\n");
 #endif
     double tmpVal;
-    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex );
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::TrackingMutex, SGCT_MUTEX_CALL_SITE );
         tmpVal = mSamplingTime;
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::TrackingMutex );
 
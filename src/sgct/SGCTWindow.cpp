@@ -11,6 +11,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/MessageHandler.h>
 #include <sgct/ClusterManager.h>
 #include <sgct/SGCTSettings.h>
+#include <sgct/SGCTMemoryRegistry.h>
 #include <sgct/shaders/SGCTInternalShaders.h>
 #include <sgct/shaders/SGCTInternalShaders_modern.h>
 #include <sgct/helpers/SGCTStringFunctions.h>
@@ -40,6 +41,12 @@ bool sgct::SGCTWindow::mSwapGroupMaster = false;
 GLFWwindow * sgct::SGCTWindow::mCurrentContextOwner = NULL;
 GLFWwindow * sgct::SGCTWindow::mSharedHandle = NULL;
 
+//names of the FBO target textures in the memory report, same order as Engine::TextureIndexes
+static const char * textureNames[NUMBER_OF_TEXTURES] =
+{
+    "left eye texture", "right eye texture", "intermediate texture", "FX1 texture", "FX2 texture", "depth texture", "normal texture", "position texture"
+};
+
 sgct::SGCTWindow::SGCTWindow(int id)
 {
     mId = id;
@@ -252,6 +259,9 @@ void sgct::SGCTWindow::close()
                 mFrameBufferTextures[i] = GL_FALSE;
             }
         }
+
+        if (SGCTMemoryRegistry::exists())
+            SGCTMemoryRegistry::instance()->removeAllocations(this);
     }
 
     if( mVBO )
@@ -1430,6 +1440,15 @@ void sgct::SGCTWindow::generateTexture(unsigned int id, const int xSize, const i
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     //glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    int internalFormat = mInternalColorFormat;
+    if (type == DepthTexture)
+        internalFormat = GL_DEPTH_COMPONENT32;
+    else if (type == NormalTexture || type == PositionTexture)
+        internalFormat = sgct::SGCTSettings::instance()->getBufferFloatPrecisionAsGLint();
+    if (SGCTMemoryRegistry::exists())
+        SGCTMemoryRegistry::instance()->setAllocation(SGCTMemoryRegistry::WindowBuffers, SGCTMemoryRegistry::GPU, this, textureNames[id],
+            SGCTMemoryRegistry::getTextureSize(xSize, ySize, internalFormat));
 }
 
 /*!
@@ -1675,6 +1694,8 @@ void sgct::SGCTWindow::resizeFBOs()
             {
                 glDeleteTextures(1, &mFrameBufferTextures[i]);
                 mFrameBufferTextures[i] = GL_FALSE;
+                if (SGCTMemoryRegistry::exists())
+                    SGCTMemoryRegistry::instance()->removeAllocation(this, textureNames[i]);
             }
         }
         createTextures();
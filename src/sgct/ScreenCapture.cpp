@@ -9,6 +9,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/MessageHandler.h>
 #include <sgct/Engine.h>
 #include <sgct/SGCTSettings.h>
+#include <sgct/SGCTMemoryRegistry.h>
+#include <sgct/SGCTTrace.h>
 #include <sstream>
 #include <string>
 
@@ -90,6 +92,9 @@ sgct_core::ScreenCapture::~ScreenCapture()
         glDeleteBuffers(1, &mPBO);
         mPBO = GL_FALSE;
     }
+
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->removeAllocations(this);
 }
 
 /*!
@@ -156,6 +161,10 @@ void sgct_core::ScreenCapture::initOrResize(int x, int y, int channels, int byte
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     }
 
+    if (sgct::SGCTMemoryRegistry::exists())
+        sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::ScreenCaptureBuffers, sgct::SGCTMemoryRegistry::GPU, this, "PBO",
+            mUsePBO ? static_cast<std::size_t>(mDataSize) : 0);
+
     mMutex.unlock();
     #ifdef __SGCT_MUTEX_DEBUG__
         fprintf(stderr, "Mutex for screencapture is unlocked.\n");
@@ -198,10 +207,12 @@ This function saves the images to disc.
 */
 void sgct_core::ScreenCapture::saveScreenCapture(unsigned int textureId, CaputeSrc CapSrc)
 {
-    addFrameNumberToFilename(sgct::Engine::instance()->getScreenShotNumber());
-
+    SGCT_TRACE_SCOPE("ScreenCapture::saveScreenCapture");
     checkImageBuffer(CapSrc);
 
+    //the file suffix depends on the download type
+    addFrameNumberToFilename(sgct::Engine::instance()->getScreenShotNumber());
+
     int threadIndex = getAvailibleCaptureThread();
     Image * imPtr = prepareImage(threadIndex);
     if (!imPtr)
@@ -245,7 +256,7 @@ void sgct_core::ScreenCapture::saveScreenCapture(unsigned int textureId, CaputeS
 				
 				if (mCaptureCallbackFn1 != SGCT_NULL_PTR)
 					mCaptureCallbackFn1(imPtr, mWindowIndex, mEyeIndex, mDownloadType);
-				else if (mBytesPerColor <= 2)
+				else if (mBytesPerColor <= 2 || isFloatDownload())
 				{
 					//save the image
 					mSCTIPtrs[threadIndex].mRunning = true;
@@ -284,7 +295,7 @@ void sgct_core::ScreenCapture::saveScreenCapture(unsigned int textureId, CaputeS
         
         if (mCaptureCallbackFn1 != SGCT_NULL_PTR)
             mCaptureCallbackFn1(imPtr, mWindowIndex, mEyeIndex, mDownloadType);
-        else if (mBytesPerColor <= 2)
+        else if (mBytesPerColor <= 2 || isFloatDownload())
         {
             //save the image
             mSCTIPtrs[threadIndex].mRunning = true;
@@ -354,10 +365,16 @@ void sgct_core::ScreenCapture::addFrameNumberToFilename( unsigned int frameNumbe
     }
 
     std::string suffix;
-    if(mFormat == PNG)
+    if (isFloatDownload()) //only float formats can store floating point frame buffers
+        suffix.assign(mFormat == HDR ? "hdr" : "pfm");
+    else if(mFormat == PNG)
         suffix.assign("png");
     else if(mFormat == TGA)
         suffix.assign("tga");
+    else if(mFormat == PFM)
+        suffix.assign("pfm");
+    else if(mFormat == HDR)
+        suffix.assign("hdr");
     else
         suffix.assign("jpg");
 
@@ -511,19 +528,32 @@ sgct_core::Image * sgct_core::ScreenCapture::prepareImage(int index)
             return NULL;
         }
     }
+    (*imPtr)->setFloatData(isFloatDownload());
     (*imPtr)->setFilename(mFilename);
 
     return (*imPtr);
 }
 
+/*!
+    \returns true if the frame buffer is downloaded as half or full floats
+*/
+bool sgct_core::ScreenCapture::isFloatDownload() const
+{
+    return mDownloadType == GL_FLOAT || mDownloadType == GL_HALF_FLOAT;
+}
+
 //multi-threaded screenshot saver
 void screenCaptureHandler(void *arg)
 {
     sgct_core::ScreenCaptureThreadInfo * ptr = reinterpret_cast<sgct_core::ScreenCaptureThreadInfo *>(arg);
 
-    if( !ptr->mframeBufferImagePtr->save() )
+    SGCT_TRACE_THREAD_NAME("Screen capture");
     {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Error: Failed to save '%s'!\n", ptr->mframeBufferImagePtr->getFilename());
+        SGCT_TRACE_SCOPE("ScreenCapture::save");
+        if( !ptr->mframeBufferImagePtr->save() )
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Error: Failed to save '%s'!\n", ptr->mframeBufferImagePtr->getFilename());
+        }
     }
 
     #ifdef __SGCT_MUTEX_DEBUG__
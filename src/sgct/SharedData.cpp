@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SharedData.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/SGCTTrace.h>
 #ifndef SGCT_DONT_USE_EXTERNAL
 #include "../include/external/zlib.h"
 #else
@@ -43,6 +44,10 @@ SharedData::SharedData()
     mCompressionRatio = 1.0f;
     mCompressionLevel = Z_BEST_SPEED;
 
+    mSyncFrame = 0;
+    mSyncTime = -1.0;
+    mDecodeTime = -1.0;
+
     if(mUseCompression)
         currentStorage = &dataBlockToCompress;
     else
@@ -83,7 +88,7 @@ SharedData::~SharedData()
  */
 void SharedData::setCompression(bool state, int level)
 {
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     mUseCompression = state;
     mCompressionLevel = level;
 
@@ -134,10 +139,13 @@ This fuction is called internally by SGCT and shouldn't be used by the user.
 */
 void SharedData::decode(const char * receivedData, int receivedlength, int clientIndex)
 {
+    SGCT_TRACE_SCOPE("SharedData::decode");
 #ifdef __SGCT_NETWORK_DEBUG__
     MessageHandler::instance()->printDebug( sgct::MessageHandler::NOTIFY_ALL, "SharedData::decode\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    double decodeTime = Engine::getTime();
+
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
 
     //reset
     pos = 0;
@@ -147,6 +155,15 @@ void SharedData::decode(const char * receivedData, int receivedlength, int clien
         dataBlock.reserve(receivedlength);
     dataBlock.insert(dataBlock.end(), receivedData, receivedData+receivedlength);
 
+    //the sync stamp is read here so that the decode callback starts with the user data
+    if( receivedlength >= static_cast<int>(mSyncStampSize) )
+    {
+        memcpy(&mSyncFrame, &dataBlock[0], sizeof(uint32_t));
+        memcpy(&mSyncTime, &dataBlock[sizeof(uint32_t)], sizeof(double));
+        mDecodeTime = decodeTime;
+        pos = static_cast<unsigned int>(mSyncStampSize);
+    }
+
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
 
     if( mDecodeFn != NULL )
@@ -158,10 +175,11 @@ This fuction is called internally by SGCT and shouldn't be used by the user.
 */
 void SharedData::encode()
 {
+    SGCT_TRACE_SCOPE("SharedData::encode");
 #ifdef __SGCT_NETWORK_DEBUG__
     MessageHandler::instance()->printDebug( sgct::MessageHandler::NOTIFY_ALL, "SharedData::encode\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
 
     dataBlock.clear();
     if(mUseCompression)
@@ -177,6 +195,13 @@ void SharedData::encode()
     //reserve header space
     dataBlock.insert( dataBlock.begin(), headerSpace, headerSpace+sgct_core::SGCTNetwork::mHeaderSize );
 
+    //the sync stamp is compressed with the user data
+    mSyncFrame++;
+    unsigned char *p = reinterpret_cast<unsigned char *>(&mSyncFrame);
+    (*currentStorage).insert( (*currentStorage).end(), p, p+sizeof(uint32_t) );
+    p = reinterpret_cast<unsigned char *>(&mSyncTime);
+    (*currentStorage).insert( (*currentStorage).end(), p, p+sizeof(double) );
+
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
 
     if( mEncodeFn != NULL )
@@ -184,7 +209,8 @@ void SharedData::encode()
 
     if(mUseCompression && dataBlockToCompress.size() > 0)
     {
-        SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+        SGCT_TRACE_SCOPE("SharedData::compress");
+        SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
 
         // re-allocatate if needed
         // use a compression buffer twice as large
@@ -234,6 +260,32 @@ void SharedData::encode()
     }
 }
 
+/*!
+Set the time of the master's pre-sync, sent with the data of the next encode. Called internally by SGCT.
+*/
+void SharedData::setSyncTime(double time)
+{
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
+    mSyncTime = time;
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+}
+
+/*!
+Get the stamp of the latest encoded or decoded data.
+
+\param frame the frame id, incremented by every encode on the master
+\param masterTime the master's pre-sync time of the frame in seconds, -1 if not set
+\param decodeTime the time when the data started to decode on this node, -1 on the master
+*/
+void SharedData::getSyncStamp(uint32_t & frame, double & masterTime, double & decodeTime)
+{
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
+    frame = mSyncFrame;
+    masterTime = mSyncTime;
+    decodeTime = mDecodeTime;
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+}
+
 std::size_t SharedData::getUserDataSize()
 {
     return dataBlock.size()-sgct_core::SGCTNetwork::mHeaderSize;
@@ -246,7 +298,7 @@ void SharedData::writeFloat(SharedFloat * sf)
 #endif
 
     float val = sf->getVal();
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert( (*currentStorage).end(), p, p+4);
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
@@ -259,7 +311,7 @@ void SharedData::writeDouble(SharedDouble * sd)
 #endif
 
     double val = sd->getVal();
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert( (*currentStorage).end(), p, p+8);
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
@@ -272,7 +324,7 @@ void SharedData::writeInt64(SharedInt64 * si)
 #endif
 
     int64_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(int64_t));
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
@@ -285,7 +337,7 @@ void SharedData::writeInt32(SharedInt32 * si)
 #endif
 
     int32_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(int32_t));
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -298,7 +350,7 @@ void SharedData::writeInt16(SharedInt16 * si)
 #endif
 
     int16_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(int16_t));
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -311,7 +363,7 @@ void SharedData::writeInt8(SharedInt8 * si)
 #endif
 
     int8_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(int8_t));
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -324,7 +376,7 @@ void SharedData::writeUInt64(SharedUInt64 * si)
 #endif
 
     uint64_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(uint64_t));
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -337,7 +389,7 @@ void SharedData::writeUInt32(SharedUInt32 * si)
 #endif
 
     uint32_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(uint32_t));
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -350,7 +402,7 @@ void SharedData::writeUInt16(SharedUInt16 * si)
 #endif
 
     uint16_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(uint16_t));
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -363,7 +415,7 @@ void SharedData::writeUInt8(SharedUInt8 * si)
 #endif
 
     uint8_t val = si->getVal();
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     unsigned char *p = reinterpret_cast<unsigned char *>(&val);
     (*currentStorage).insert((*currentStorage).end(), p, p + sizeof(uint8_t));
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -376,7 +428,7 @@ void SharedData::writeUChar(SharedUChar * suc)
 #endif
 
     unsigned char val = suc->getVal();
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     (*currentStorage).push_back(val);
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
 }
@@ -388,7 +440,7 @@ void SharedData::writeBool(SharedBool * sb)
 #endif
     
     bool val = sb->getVal();
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     if( val )
         (*currentStorage).push_back(1);
     else
@@ -403,7 +455,7 @@ void SharedData::writeString(SharedString * ss)
 #endif
     
     std::string tmpStr( ss->getVal() );
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     uint32_t length = static_cast<uint32_t>(tmpStr.size());
     unsigned char *p = reinterpret_cast<unsigned char *>(&length);
     
@@ -420,7 +472,7 @@ void SharedData::writeWString(SharedWString * ss)
 #endif
 
 	std::wstring tmpStr(ss->getVal());
-	SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+	SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
 	uint32_t length = static_cast<uint32_t>(tmpStr.size());
 	unsigned char *p = reinterpret_cast<unsigned char *>(&length);
 	unsigned char *ws = reinterpret_cast<unsigned char *>(&tmpStr[0]);
@@ -436,7 +488,7 @@ void SharedData::writeUCharArray(unsigned char * c, uint32_t length)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::writeUCharArray\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     (*currentStorage).insert( (*currentStorage).end(), c, c+length);
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
 }
@@ -447,7 +499,7 @@ void SharedData::writeSize(uint32_t size)
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::writeSize\n");
 #endif
     
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     unsigned char *p = reinterpret_cast<unsigned char *>(&size);
     (*currentStorage).insert( (*currentStorage).end(), p, p + 4);
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
@@ -458,7 +510,7 @@ void SharedData::readFloat(SharedFloat * sf)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readFloat\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     
     float val = (*(reinterpret_cast<float*>(&dataBlock[pos])));
     pos += sizeof(float);
@@ -476,7 +528,7 @@ void SharedData::readDouble(SharedDouble * sd)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readDouble\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     double val = (*(reinterpret_cast<double*>(&dataBlock[pos])));
     pos += sizeof(double);
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
@@ -493,7 +545,7 @@ void SharedData::readInt64(SharedInt64 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readInt64\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     int64_t val = (*(reinterpret_cast<int64_t*>(&dataBlock[pos])));
     pos += sizeof(int64_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -510,7 +562,7 @@ void SharedData::readInt32(SharedInt32 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readInt32\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     int32_t val = (*(reinterpret_cast<int32_t*>(&dataBlock[pos])));
     pos += sizeof(int32_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -527,7 +579,7 @@ void SharedData::readInt16(SharedInt16 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readInt16\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     int16_t val = (*(reinterpret_cast<int16_t*>(&dataBlock[pos])));
     pos += sizeof(int16_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -544,7 +596,7 @@ void SharedData::readInt8(SharedInt8 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readInt8\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     int8_t val = (*(reinterpret_cast<int8_t*>(&dataBlock[pos])));
     pos += sizeof(int8_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -561,7 +613,7 @@ void SharedData::readUInt64(SharedUInt64 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readUInt64\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     uint64_t val = (*(reinterpret_cast<uint64_t*>(&dataBlock[pos])));
     pos += sizeof(uint64_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -578,7 +630,7 @@ void SharedData::readUInt32(SharedUInt32 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readUInt32\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     uint32_t val = (*(reinterpret_cast<uint32_t*>(&dataBlock[pos])));
     pos += sizeof(uint32_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -595,7 +647,7 @@ void SharedData::readUInt16(SharedUInt16 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readUInt16\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     uint16_t val = (*(reinterpret_cast<uint16_t*>(&dataBlock[pos])));
     pos += sizeof(uint16_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -612,7 +664,7 @@ void SharedData::readUInt8(SharedUInt8 * si)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readUInt8\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+    SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
     uint8_t val = (*(reinterpret_cast<uint8_t*>(&dataBlock[pos])));
     pos += sizeof(uint8_t);
     SGCTMutexManager::instance()->unlockMutex(sgct::SGCTMutexManager::DataSyncMutex);
@@ -629,7 +681,7 @@ void SharedData::readUChar(SharedUChar * suc)
 #ifdef __SGCT_NETWORK_DEBUG__ 
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readUChar\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     unsigned char c;
     c = dataBlock[pos];
     pos += 1;
@@ -646,7 +698,7 @@ void SharedData::readBool(SharedBool * sb)
 #ifdef __SGCT_NETWORK_DEBUG__ 
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readBool\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     bool b;
     b = dataBlock[pos] == 1 ? true : false;
     pos += 1;
@@ -663,7 +715,7 @@ void SharedData::readString(SharedString * ss)
 #ifdef __SGCT_NETWORK_DEBUG__     
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readString\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     
     uint32_t length = (*(reinterpret_cast<uint32_t*>(&dataBlock[pos])));
     pos += sizeof(uint32_t);
@@ -700,7 +752,7 @@ void SharedData::readWString(SharedWString * ss)
 #ifdef __SGCT_NETWORK_DEBUG__     
 	MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readWString\n");
 #endif
-	SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
+	SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE);
 
 	uint32_t length = (*(reinterpret_cast<uint32_t*>(&dataBlock[pos])));
 	pos += sizeof(uint32_t);
@@ -733,7 +785,7 @@ unsigned char * SharedData::readUCharArray(uint32_t length)
 #ifdef __SGCT_NETWORK_DEBUG__ 
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readUCharArray\n");
 #endif
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
 
     unsigned char * p = &dataBlock[pos];
     pos += length;
@@ -749,7 +801,7 @@ uint32_t SharedData::readSize()
     MessageHandler::instance()->printDebug(sgct::MessageHandler::NOTIFY_INFO, "SharedData::readSize\n");
 #endif
 
-    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex, SGCT_MUTEX_CALL_SITE );
     
     uint32_t size = (*(reinterpret_cast<uint32_t*>(&dataBlock[pos])));
     pos += sizeof(uint32_t);
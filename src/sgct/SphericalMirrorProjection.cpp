@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/SGCTThreadPool.h>
 #include <sgct/shaders/SGCTInternalSphericalProjectionShaders.h>
 #include <sgct/shaders/SGCTInternalSphericalProjectionShaders_modern.h>
 #include <sgct/helpers/SGCTStringFunctions.h>
@@ -24,6 +25,7 @@ sgct_core::SphericalMirrorProjection::SphericalMirrorProjection()
     
     mTilt = 0.0f;
     mDiameter = 2.4f;
+    mMeshesRead = false;
     
     mTexLoc = -1;
     mMatrixLoc = -1;
@@ -80,6 +82,16 @@ void sgct_core::SphericalMirrorProjection::setMeshPath(MeshFace mf, const char *
     mMeshPaths[mf].assign(str);
 }
 
+/*!
+Queue parsing of the meshes on a thread pool. The meshes are uploaded when the projection is initialized.
+*/
+void sgct_core::SphericalMirrorProjection::readMeshes(sgct_core::SGCTThreadPool & pool, Viewport * parent, sgct::SGCTWindow * window)
+{
+    for (int i = 0; i < LAST_MESH; i++)
+        pool.addTask([this, i, parent, window]() { mMeshes[i].readMesh(mMeshPaths[i], parent, window); });
+    mMeshesRead = true;
+}
+
 void sgct_core::SphericalMirrorProjection::initTextures()
 {
     if (sgct::Engine::instance()->getRunMode() <= sgct::Engine::OpenGL_Compablity_Profile)
@@ -111,9 +123,15 @@ void sgct_core::SphericalMirrorProjection::initVBO()
     if (Viewport * vp = dynamic_cast<Viewport*>(sgct::Engine::instance()->getCurrentWindowPtr()->getCurrentViewport()))
     {
         for (int i = 0; i < LAST_MESH; i++)
-            mMeshes[i].readAndGenerateMesh(
-                mMeshPaths[i],
-                vp);
+        {
+            if (mMeshesRead)
+                mMeshes[i].generateMesh(vp);
+            else
+                mMeshes[i].readAndGenerateMesh(
+                    mMeshPaths[i],
+                    vp);
+        }
+        mMeshesRead = false;
     }
 }
 
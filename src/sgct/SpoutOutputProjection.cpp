@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/SGCTMemoryRegistry.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders_modern.h>
 #include <sgct/helpers/SGCTStringFunctions.h>
@@ -111,6 +112,11 @@ void sgct_core::SpoutOutputProjection::initTextures() {
 		glTexImage2D(GL_TEXTURE_2D, 0, mTextureInternalFormat, mCubemapResolution, mCubemapResolution, 0, mTextureFormat, mTextureType, NULL);
 	}
 
+	//released by the NonLinearProjection destructor
+	if (sgct::SGCTMemoryRegistry::exists())
+		sgct::SGCTMemoryRegistry::instance()->setAllocation(sgct::SGCTMemoryRegistry::NonLinearProjectionBuffers, sgct::SGCTMemoryRegistry::GPU, this, "spout face textures",
+			6 * sgct::SGCTMemoryRegistry::getTextureSize(mCubemapResolution, mCubemapResolution, mTextureInternalFormat));
+
 	if (sgct::Engine::instance()->getRunMode() <= sgct::Engine::OpenGL_Compablity_Profile)
 		glPopAttrib();
 
@@ -79,6 +79,11 @@ sgct_core::Statistics::Statistics()
     mColLoc = -1;
     mNumberOfLines = 0;
 
+    for (std::size_t i = 0; i < StatisticsRecord::NumberOfMetrics; i++)
+        mHistograms[i].setWindowLength(STATS_PERCENTILE_WINDOW_LENGTH);
+    mPendingSyncTime = 0.0f;
+    mHasPendingSyncTime = false;
+
     mDynamicColors[ FRAME_TIME ]    = glm::vec4( 1.0f,1.0f,0.0f,0.8f );
     mDynamicColors[ DRAW_TIME ]        = glm::vec4( 1.0f,0.0f,1.0f,0.8f );
     mDynamicColors[ SYNC_TIME ]        = glm::vec4( 0.0f,1.0f,1.0f,0.8f );
@@ -312,6 +317,8 @@ void sgct_core::Statistics::setFrameTime(float t)
     
     mAvgFrameTime += mDynamicVertexList[start].y;
     mAvgFrameTime /= static_cast<float>(STATS_AVERAGE_LENGTH);
+
+    mHistograms[StatisticsRecord::FrameTime].add(t);
 }
 
 void sgct_core::Statistics::setDrawTime(float t)
@@ -329,6 +336,8 @@ void sgct_core::Statistics::setDrawTime(float t)
     
     mAvgDrawTime += mDynamicVertexList[start].y;
     mAvgDrawTime /= static_cast<float>(STATS_AVERAGE_LENGTH);
+
+    mHistograms[StatisticsRecord::DrawTime].add(t);
 }
 
 void sgct_core::Statistics::setSyncTime(float t)
@@ -346,6 +355,12 @@ void sgct_core::Statistics::setSyncTime(float t)
     
     mAvgSyncTime += mDynamicVertexList[start].y;
     mAvgSyncTime /= static_cast<float>(STATS_AVERAGE_LENGTH);
+
+    //the previous frame is complete
+    if (mHasPendingSyncTime)
+        mHistograms[StatisticsRecord::SyncTime].add(mPendingSyncTime);
+    mPendingSyncTime = t;
+    mHasPendingSyncTime = true;
 }
 
 /*!
@@ -369,6 +384,187 @@ void sgct_core::Statistics::addSyncTime(float t)
 {
     mDynamicVertexList[SYNC_TIME * STATS_HISTORY_LENGTH].y += t;
     mAvgSyncTime += (t/static_cast<float>(STATS_AVERAGE_LENGTH));
+    mPendingSyncTime += t;
+}
+
+/*!
+    Get the p50, p95, p99 and maximum of the latest frame, draw and sync times.
+*/
+void sgct_core::Statistics::getRecord(sgct_core::StatisticsRecord & record) const
+{
+    const float percentiles[StatisticsRecord::NumberOfPercentiles] = { 50.0f, 95.0f, 99.0f, 100.0f };
+    for (std::size_t i = 0; i < StatisticsRecord::NumberOfMetrics; i++)
+        mHistograms[i].getPercentiles(percentiles, record.mValues[i], StatisticsRecord::NumberOfPercentiles);
+}
+
+/*!
+    \param percentile in the range 0-100
+    \returns the time in seconds of the given percentile of the latest frames
+*/
+float sgct_core::Statistics::getPercentile(sgct_core::StatisticsRecord::Metric metric, float percentile) const
+{
+    return mHistograms[metric].getPercentile(percentile);
+}
+
+/*!
+    Store the timestamps of the latest rendered frame, clients send them to the master with the next acknowledge.
+*/
+void sgct_core::Statistics::setSyncLatencyRecord(const sgct_core::SyncLatencyRecord & record)
+{
+    mSyncLatencyRecord = record;
+}
+
+void sgct_core::Statistics::getSyncLatencyRecord(sgct_core::SyncLatencyRecord & record) const
+{
+    record = mSyncLatencyRecord;
+}
+
+void sgct_core::StatisticsRecord::encode(char * dst) const
+{
+    memcpy(dst, &mValues[0][0], mEncodedSize);
+}
+
+void sgct_core::StatisticsRecord::decode(const char * src)
+{
+    memcpy(&mValues[0][0], src, mEncodedSize);
+}
+
+sgct_core::StartupRecord::StartupRecord()
+{
+    mNodeId = -1;
+    for (std::size_t i = 0; i < NumberOfPhases; i++)
+        mTimes[i] = 0.0f;
+}
+
+void sgct_core::StartupRecord::encode(char * dst) const
+{
+    memcpy(dst, &mNodeId, sizeof(int32_t));
+    memcpy(dst + sizeof(int32_t), &mTimes[0], NumberOfPhases * sizeof(float));
+}
+
+void sgct_core::StartupRecord::decode(const char * src)
+{
+    memcpy(&mNodeId, src, sizeof(int32_t));
+    memcpy(&mTimes[0], src + sizeof(int32_t), NumberOfPhases * sizeof(float));
+}
+
+const char * sgct_core::StartupRecord::getPhaseName(sgct_core::StartupRecord::Phase phase)
+{
+    static const char * names[NumberOfPhases] =
+    {
+        "config", "network", "windows", "wait nodes", "opengl", "shaders", "init callback", "viewport data", "total"
+    };
+    return (phase >= 0 && phase < NumberOfPhases) ? names[phase] : "unknown";
+}
+
+sgct_core::SyncLatencyRecord::SyncLatencyRecord()
+{
+    mFrame = 0;
+    mMasterTime = -1.0;
+    for (std::size_t i = 0; i < NumberOfStages; i++)
+        mTimes[i] = -1.0;
+    mAckDecodeTime = -1.0;
+    mAckTime = -1.0;
+}
+
+void sgct_core::SyncLatencyRecord::encode(char * dst) const
+{
+    memcpy(dst, &mFrame, sizeof(uint32_t));
+    dst += sizeof(uint32_t);
+    memcpy(dst, &mMasterTime, sizeof(double));
+    dst += sizeof(double);
+    memcpy(dst, &mTimes[0], NumberOfStages * sizeof(double));
+    dst += NumberOfStages * sizeof(double);
+    memcpy(dst, &mAckDecodeTime, sizeof(double));
+    dst += sizeof(double);
+    memcpy(dst, &mAckTime, sizeof(double));
+}
+
+void sgct_core::SyncLatencyRecord::decode(const char * src)
+{
+    memcpy(&mFrame, src, sizeof(uint32_t));
+    src += sizeof(uint32_t);
+    memcpy(&mMasterTime, src, sizeof(double));
+    src += sizeof(double);
+    memcpy(&mTimes[0], src, NumberOfStages * sizeof(double));
+    src += NumberOfStages * sizeof(double);
+    memcpy(&mAckDecodeTime, src, sizeof(double));
+    src += sizeof(double);
+    memcpy(&mAckTime, src, sizeof(double));
+}
+
+const char * sgct_core::SyncLatencyRecord::getStageName(sgct_core::SyncLatencyRecord::Stage stage)
+{
+    static const char * names[NumberOfStages] = { "decode", "post sync pre draw", "draw", "swap" };
+    return (stage >= 0 && stage < NumberOfStages) ? names[stage] : "unknown";
+}
+
+sgct_core::SyncLatencyStatistics::SyncLatencyStatistics() :
+    mRoundTripTimes(STATS_PERCENTILE_WINDOW_LENGTH)
+{
+    for (std::size_t i = 0; i < SyncLatencyRecord::NumberOfStages; i++)
+        mHistograms[i].setWindowLength(STATS_PERCENTILE_WINDOW_LENGTH);
+    clear();
+}
+
+/*!
+    Add a clock sample from an acknowledged frame. The sent data is decoded and acknowledged by the client between the
+    send and receive times of the master, the time in between isn't part of the round trip.
+*/
+void sgct_core::SyncLatencyStatistics::addClockSample(double masterSendTime, double clientDecodeTime, double clientAckTime, double masterReceiveTime)
+{
+    double roundTrip = (masterReceiveTime - masterSendTime) - (clientAckTime - clientDecodeTime);
+    if (roundTrip < 0.0)
+        roundTrip = 0.0;
+
+    std::size_t index = mClockSamples % STATS_CLOCK_SAMPLE_WINDOW_LENGTH;
+    mClockOffsets[index] = ((clientDecodeTime - masterSendTime) + (clientAckTime - masterReceiveTime)) * 0.5;
+    mClockRoundTrips[index] = roundTrip;
+    mClockSamples++;
+    mRoundTripTimes.add(static_cast<float>(roundTrip));
+
+    std::size_t count = mClockSamples < STATS_CLOCK_SAMPLE_WINDOW_LENGTH ? mClockSamples : STATS_CLOCK_SAMPLE_WINDOW_LENGTH;
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < count; i++)
+        if (mClockRoundTrips[i] < mClockRoundTrips[best])
+            best = i;
+    mClockOffset = mClockOffsets[best];
+}
+
+/*!
+    Add the age of the shared data at each stage of a frame, converted to the master's clock with the current offset.
+    Records without rendered shared data are ignored.
+*/
+void sgct_core::SyncLatencyStatistics::addRecord(const sgct_core::SyncLatencyRecord & record)
+{
+    if (!record.isValid())
+        return;
+
+    for (std::size_t i = 0; i < SyncLatencyRecord::NumberOfStages; i++)
+        if (record.mTimes[i] >= 0.0)
+            mHistograms[i].add(static_cast<float>(record.mTimes[i] - mClockOffset - record.mMasterTime));
+}
+
+void sgct_core::SyncLatencyStatistics::clear()
+{
+    for (std::size_t i = 0; i < SyncLatencyRecord::NumberOfStages; i++)
+        mHistograms[i].clear();
+    mRoundTripTimes.clear();
+    mClockSamples = 0;
+    mClockOffset = 0.0;
+}
+
+/*!
+    Get the p50, p95, p99 and maximum of the latest frames.
+*/
+void sgct_core::SyncLatencyStatistics::getSummary(sgct_core::SyncLatencySummary & summary) const
+{
+    const float percentiles[StatisticsRecord::NumberOfPercentiles] = { 50.0f, 95.0f, 99.0f, 100.0f };
+    for (std::size_t i = 0; i < SyncLatencyRecord::NumberOfStages; i++)
+        mHistograms[i].getPercentiles(percentiles, summary.mValues[i], StatisticsRecord::NumberOfPercentiles);
+    mRoundTripTimes.getPercentiles(percentiles, summary.mRoundTripTimes, StatisticsRecord::NumberOfPercentiles);
+    summary.mClockOffset = mClockOffset;
+    summary.mCount = mHistograms[SyncLatencyRecord::Swap].getCount();
 }
 
 void sgct_core::Statistics::update()
@@ -11,9 +11,58 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/TextureManager.h>
 #include <sgct/MessageHandler.h>
 #include <sgct/Engine.h>
+#include <sgct/SGCTSettings.h>
+#include <sgct/SGCTThreadPool.h>
+#include <sgct/SGCTMemoryRegistry.h>
+#include <string.h>
 
 sgct::TextureManager * sgct::TextureManager::mInstance = NULL;
 
+namespace sgct_core
+{
+/*!
+    Internal state of a texture loaded by TextureManager::loadTextureAsync.
+*/
+class AsyncTextureRequest
+{
+public:
+    AsyncTextureRequest()
+    {
+        mHandle = 0;
+        mState = sgct::TextureManager::Async_Decoding;
+        mInterpolate = true;
+        mMipmapLevels = 8;
+        mImgPtr = NULL;
+        mTexId = 0;
+        mTextureType = 0;
+        mFormat = 0;
+        mUploadedRows = 0;
+        mMemorySize = 0;
+    }
+
+    ~AsyncTextureRequest()
+    {
+        if (mImgPtr)
+            delete mImgPtr;
+    }
+
+    std::string mName;
+    std::string mFilename;
+    unsigned int mHandle;
+    sgct::TextureManager::AsyncTextureState mState; //only changed by the render thread
+    bool mInterpolate;
+    int mMipmapLevels;
+    sgct::TextureManager::AsyncTextureCallbackFn mCallback;
+
+    Image * mImgPtr; //NULL if decoding failed
+    unsigned int mTexId;
+    int mTextureType;
+    unsigned int mFormat;
+    std::size_t mUploadedRows;
+    std::size_t mMemorySize; //estimated size of the texture on the GPU
+};
+}
+
 sgct_core::TextureData::TextureData()
 {
     reset();
@@ -45,6 +94,12 @@ sgct::TextureManager::TextureManager()
     mInterpolate = true;
     mMipmapLevels = 8;
 
+    mLoaderPool = NULL;
+    mCurrentUpload = NULL;
+    mNextAsyncHandle = 1;
+    mUploadPBO = GL_FALSE;
+    mUploadPBOSize = 0;
+
     //add empty texture
     sgct_core::TextureData tmpTexture;
     mTextures["NOTSET"] = tmpTexture;
@@ -52,7 +107,33 @@ sgct::TextureManager::TextureManager()
 
 sgct::TextureManager::~TextureManager()
 {
+    //make sure that no worker is decoding when the requests are deleted
+    if (mLoaderPool)
+    {
+        mLoaderPool->stop();
+        delete mLoaderPool;
+        mLoaderPool = NULL;
+    }
+
+    for (auto it = mAsyncRequests.begin(); it != mAsyncRequests.end(); ++it)
+    {
+        if (it->second->mTexId)
+            glDeleteTextures(1, &(it->second->mTexId));
+        delete it->second;
+    }
+    mAsyncRequests.clear();
+    mDecodedTextures.clear();
+    mCurrentUpload = NULL;
+
+    if (mUploadPBO)
+    {
+        glDeleteBuffers(1, &mUploadPBO);
+        mUploadPBO = GL_FALSE;
+    }
+
     freeTextureData();
+    if (SGCTMemoryRegistry::exists())
+        SGCTMemoryRegistry::instance()->removeAllocations(this);
 }
 
 /*!
@@ -187,7 +268,8 @@ bool sgct::TextureManager::loadTexture(const std::string name, const std::string
     
     if (img.getData() != NULL)
     {
-        if (!uploadImage(&img, &texID))
+        std::size_t memorySize = 0;
+        if (!uploadImage(&img, &texID, &memorySize))
             return false;
 
         tmpTexture.mId = texID;
@@ -200,6 +282,8 @@ bool sgct::TextureManager::loadTexture(const std::string name, const std::string
         {
             mTextures[name] = tmpTexture;
         }
+        if (SGCTMemoryRegistry::exists())
+            SGCTMemoryRegistry::instance()->setAllocation(SGCTMemoryRegistry::Textures, SGCTMemoryRegistry::GPU, this, name, memorySize);
 
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Texture created from '%s' [id=%d]\n", filename.c_str(), texID );
     }
@@ -241,7 +325,8 @@ bool sgct::TextureManager::loadTexture(const std::string name, sgct_core::Image
 
     if (imgPtr->getData() != NULL)
     {
-        if (!uploadImage(imgPtr, &texID))
+        std::size_t memorySize = 0;
+        if (!uploadImage(imgPtr, &texID, &memorySize))
             return false;
 
         tmpTexture.mId = texID;
@@ -254,6 +339,8 @@ bool sgct::TextureManager::loadTexture(const std::string name, sgct_core::Image
         {
             mTextures[name] = tmpTexture;
         }
+        if (SGCTMemoryRegistry::exists())
+            SGCTMemoryRegistry::instance()->setAllocation(SGCTMemoryRegistry::Textures, SGCTMemoryRegistry::GPU, this, name, memorySize);
 
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Texture created from image [id=%d]\n", texID);
     }
@@ -275,10 +362,6 @@ Load a unmanged texture. Note that this type of textures doesn't auto destruct.
 */
 bool sgct::TextureManager::loadUnManagedTexture(unsigned int & texID, const std::string filename, bool interpolate, int mipmapLevels)
 {
-    unsigned int tmpTexID = GL_FALSE;
-    mInterpolate = interpolate;
-    mMipmapLevels = mipmapLevels;
-
     if (texID != GL_FALSE)
     {
         glDeleteTextures(1, &texID);
@@ -292,22 +375,324 @@ bool sgct::TextureManager::loadUnManagedTexture(unsigned int & texID, const std:
         return false;
     }
 
-    if (img.getData() != NULL)
+    if (!loadUnManagedTexture(texID, &img, interpolate, mipmapLevels))
+        return false;
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Unmanaged texture created from '%s' [id=%d]\n", filename.c_str(), texID);
+    return true;
+}
+
+/*!
+Load a unmanged texture from an image that is already decoded. Note that this type of textures doesn't auto destruct.
+\param texID the openGL texture id
+\param imgPtr pointer to image object
+\param interpolate set to true for using interpolation (bi-linear filtering)
+\param mipmapLevels is the number of mipmap levels that will be generated, setting this value to 1 or less disables mipmaps
+\return true if texture loaded successfully
+*/
+bool sgct::TextureManager::loadUnManagedTexture(unsigned int & texID, sgct_core::Image * imgPtr, bool interpolate, int mipmapLevels)
+{
+    unsigned int tmpTexID = GL_FALSE;
+    mInterpolate = interpolate;
+    mMipmapLevels = mipmapLevels;
+
+    if (texID != GL_FALSE)
     {
-        if (!uploadImage(&img, &tmpTexID))
-            return false;
+        glDeleteTextures(1, &texID);
+        texID = GL_FALSE;
+    }
 
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Unmanaged texture created from '%s' [id=%d]\n", filename.c_str(), tmpTexID);
+    if (imgPtr == NULL || imgPtr->getData() == NULL) //image data not valid
+        return false;
+
+    if (!uploadImage(imgPtr, &tmpTexID))
+        return false;
+
+    texID = tmpTexID;
+    return true;
+}
+
+/*!
+Load a texture asynchronously. The image is decoded by a pool of worker threads and uploaded to the GPU
+by processAsyncUploads(), which is called by the Engine every frame, using a limited amount of data and time
+per frame (see SGCTSettings::setTextureUploadSizeBudget and SGCTSettings::setTextureUploadTimeBudget).
+The texture id returned by getTextureId is 0 until the upload is done (or the previous texture if reloading).
+
+\param name the name of the texture
+\param filename the filename or path to the texture
+\param interpolate set to true for using interpolation (bi-linear filtering)
+\param mipmapLevels is the number of mipmap levels that will be generated, setting this value to 1 or less disables mipmaps
+\param callback optional function that is called from the render thread when the texture is ready or has failed
+\return a handle that can be used to query the state of the load using getAsyncTextureState
+*/
+unsigned int sgct::TextureManager::loadTextureAsync(const std::string name, const std::string filename, bool interpolate, int mipmapLevels, AsyncTextureCallbackFn callback)
+{
+    sgct_core::AsyncTextureRequest * request = new sgct_core::AsyncTextureRequest();
+    request->mName = name;
+    request->mFilename = filename;
+    request->mHandle = mNextAsyncHandle++;
+    request->mInterpolate = interpolate;
+    request->mMipmapLevels = mipmapLevels;
+    request->mCallback = callback;
+
+    mAsyncRequests[request->mHandle] = request;
+
+    if (mLoaderPool == NULL)
+    {
+        mLoaderPool = new sgct_core::SGCTThreadPool();
+        mLoaderPool->start(static_cast<unsigned int>(SGCTSettings::instance()->getNumberOfTextureLoadingThreads()));
     }
-    else //image data not valid
+
+    mLoaderPool->addTask([this, request]() { decodeAsyncTexture(request); });
+
+    return request->mHandle;
+}
+
+/*!
+\returns the state of an asynchronous texture load. The final state (Async_Ready or Async_Failed) of a load without
+a callback is only kept until it has been returned once, the state of a finished load with a callback is only reported
+to the callback. Async_Not_Found is returned after that.
+*/
+sgct::TextureManager::AsyncTextureState sgct::TextureManager::getAsyncTextureState(unsigned int handle)
+{
+    sgct_cppxeleven::unordered_map<unsigned int, sgct_core::AsyncTextureRequest *>::iterator request = mAsyncRequests.find(handle);
+    if (request != mAsyncRequests.end())
+        return request->second->mState;
+
+    sgct_cppxeleven::unordered_map<unsigned int, AsyncTextureState>::iterator it = mFinishedAsyncStates.find(handle);
+    if (it == mFinishedAsyncStates.end())
+        return Async_Not_Found;
+
+    AsyncTextureState state = it->second;
+    mFinishedAsyncStates.erase(it);
+    return state;
+}
+
+/*!
+Upload decoded asynchronous textures to the GPU. Large textures are split in rows and uploaded over several frames
+so that the data and time budgets set in SGCTSettings are kept. At least one row is uploaded each call to guarantee progress.
+This function is called by the Engine every frame and must be called from a thread with a current openGL context.
+*/
+void sgct::TextureManager::processAsyncUploads()
+{
+    if (mAsyncRequests.empty())
+        return;
+
+    std::size_t sizeBudget = SGCTSettings::instance()->getTextureUploadSizeBudget();
+    double timeBudget = static_cast<double>(SGCTSettings::instance()->getTextureUploadTimeBudget()) / 1000.0;
+    double startTime = sgct::Engine::getTime();
+    std::size_t uploadedBytes = 0;
+
+    while (true)
+    {
+        if (mCurrentUpload == NULL)
+        {
+            mDecodedMutex.lock();
+            if (!mDecodedTextures.empty())
+            {
+                mCurrentUpload = mDecodedTextures.front();
+                mDecodedTextures.pop_front();
+            }
+            mDecodedMutex.unlock();
+
+            if (mCurrentUpload == NULL) //nothing decoded yet
+                break;
+
+            if (!beginAsyncUpload(mCurrentUpload))
+            {
+                finishAsyncUpload(mCurrentUpload, false);
+                continue;
+            }
+        }
+
+        std::size_t maxBytes = uploadedBytes < sizeBudget ? sizeBudget - uploadedBytes : 0;
+        uploadedBytes += uploadAsyncRows(mCurrentUpload, maxBytes);
+
+        if (mCurrentUpload->mUploadedRows >= mCurrentUpload->mImgPtr->getHeight())
+            finishAsyncUpload(mCurrentUpload, true);
+
+        if (uploadedBytes >= sizeBudget || (sgct::Engine::getTime() - startTime) >= timeBudget)
+            break;
+    }
+}
+
+/*!
+Decodes the image, called by a worker thread.
+*/
+void sgct::TextureManager::decodeAsyncTexture(sgct_core::AsyncTextureRequest * request)
+{
+    sgct_core::Image * imgPtr = new sgct_core::Image();
+    if (!imgPtr->load(request->mFilename) || imgPtr->getData() == NULL)
     {
+        delete imgPtr;
+        imgPtr = NULL;
+    }
+
+    request->mImgPtr = imgPtr;
+
+    mDecodedMutex.lock();
+    mDecodedTextures.push_back(request);
+    mDecodedMutex.unlock();
+}
+
+/*!
+Allocates the texture storage of a decoded request. Compressed textures are uploaded at once since the driver needs the whole image.
+*/
+bool sgct::TextureManager::beginAsyncUpload(sgct_core::AsyncTextureRequest * request)
+{
+    if (request->mImgPtr == NULL)
+        return false;
+
+    if (mTextures.count(request->mName) > 0 && !mOverWriteMode)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "TextureManager: '%s' exists already! [id=%d]\n", request->mName.c_str(), mTextures[request->mName].mId);
         return false;
     }
 
-    texID = tmpTexID;
+    int internalFormat;
+    if (!getTextureFormats(request->mImgPtr, request->mTextureType, internalFormat, request->mFormat))
+        return false;
+
+    request->mState = Async_Uploading;
+
+    glGenTextures(1, &(request->mTexId));
+    glBindTexture(GL_TEXTURE_2D, request->mTexId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    GLsizei width = static_cast<GLsizei>(request->mImgPtr->getWidth());
+    GLsizei height = static_cast<GLsizei>(request->mImgPtr->getHeight());
+    request->mMemorySize = SGCTMemoryRegistry::getTextureSize(width, height, internalFormat, 1, request->mMipmapLevels > 1);
+
+    if (mCompression == No_Compression)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, request->mTextureType, request->mFormat, NULL);
+    }
+    else
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, request->mTextureType, request->mFormat, request->mImgPtr->getData());
+        request->mUploadedRows = request->mImgPtr->getHeight();
+    }
+
+    glBindTexture(GL_TEXTURE_2D, GL_FALSE);
     return true;
 }
 
+/*!
+Uploads the next rows of a texture through a pixel unpack buffer.
+
+\param request the texture being uploaded
+\param maxBytes maximum number of bytes to upload, at least one row is always uploaded
+\return the number of bytes uploaded
+*/
+std::size_t sgct::TextureManager::uploadAsyncRows(sgct_core::AsyncTextureRequest * request, std::size_t maxBytes)
+{
+    sgct_core::Image * imgPtr = request->mImgPtr;
+    std::size_t height = imgPtr->getHeight();
+    if (request->mUploadedRows >= height)
+        return 0;
+
+    std::size_t rowSize = imgPtr->getWidth() * imgPtr->getChannels() * imgPtr->getBytesPerChannel();
+    std::size_t rows = maxBytes / rowSize;
+    if (rows < 1)
+        rows = 1;
+    if (rows > height - request->mUploadedRows)
+        rows = height - request->mUploadedRows;
+    std::size_t dataSize = rows * rowSize;
+    const unsigned char * src = imgPtr->getData() + request->mUploadedRows * rowSize;
+
+    glBindTexture(GL_TEXTURE_2D, request->mTexId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    bool usePBO = SGCTSettings::instance()->getUsePBO();
+    if (usePBO)
+    {
+        if (mUploadPBO == GL_FALSE)
+            glGenBuffers(1, &mUploadPBO);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mUploadPBO);
+
+        //orphan the previous storage so that the driver doesn't have to wait for the last transfer
+        if (dataSize > mUploadPBOSize)
+        {
+            mUploadPBOSize = dataSize;
+            if (SGCTMemoryRegistry::exists())
+                SGCTMemoryRegistry::instance()->setAllocation(SGCTMemoryRegistry::Textures, SGCTMemoryRegistry::GPU, this, "upload buffer", mUploadPBOSize);
+        }
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(mUploadPBOSize), NULL, GL_STREAM_DRAW);
+
+        GLubyte * ptr = reinterpret_cast<GLubyte*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+        if (ptr)
+        {
+            memcpy(ptr, src, dataSize);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(request->mUploadedRows), static_cast<GLsizei>(imgPtr->getWidth()), static_cast<GLsizei>(rows), request->mTextureType, request->mFormat, 0);
+        }
+        else
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "TextureManager: Failed to map texture upload buffer!\n");
+            usePBO = false;
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    if (!usePBO)
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(request->mUploadedRows), static_cast<GLsizei>(imgPtr->getWidth()), static_cast<GLsizei>(rows), request->mTextureType, request->mFormat, src);
+
+    glBindTexture(GL_TEXTURE_2D, GL_FALSE);
+
+    request->mUploadedRows += rows;
+    return dataSize;
+}
+
+/*!
+Registers the uploaded texture, calls the callback and releases the request.
+*/
+void sgct::TextureManager::finishAsyncUpload(sgct_core::AsyncTextureRequest * request, bool success)
+{
+    if (success)
+    {
+        glBindTexture(GL_TEXTURE_2D, request->mTexId);
+        setTextureParameters(request->mInterpolate, request->mMipmapLevels);
+        glBindTexture(GL_TEXTURE_2D, GL_FALSE);
+
+        //replace the previous texture first when it's done so that it can be used while loading
+        sgct_cppxeleven::unordered_map<std::string, sgct_core::TextureData>::iterator textureItem = mTextures.find(request->mName);
+        if (textureItem != mTextures.end() && textureItem->second.mId)
+            glDeleteTextures(1, &(textureItem->second.mId));
+
+        sgct_core::TextureData & texData = mTextures[request->mName];
+        texData.mId = request->mTexId;
+        texData.mPath.assign(request->mFilename);
+        texData.mWidth = static_cast<int>(request->mImgPtr->getWidth());
+        texData.mHeight = static_cast<int>(request->mImgPtr->getHeight());
+        texData.mChannels = static_cast<int>(request->mImgPtr->getChannels());
+        if (SGCTMemoryRegistry::exists())
+            SGCTMemoryRegistry::instance()->setAllocation(SGCTMemoryRegistry::Textures, SGCTMemoryRegistry::GPU, this, request->mName, request->mMemorySize);
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Texture created asynchronously from '%s' [id=%d]\n", request->mFilename.c_str(), request->mTexId);
+    }
+    else
+    {
+        if (request->mTexId)
+            glDeleteTextures(1, &(request->mTexId));
+        request->mTexId = 0;
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "TextureManager: Failed to load texture '%s' asynchronously!\n", request->mFilename.c_str());
+    }
+
+    //the callback gets the result, otherwise it's kept until getAsyncTextureState has returned it
+    if (!request->mCallback)
+        mFinishedAsyncStates[request->mHandle] = success ? Async_Ready : Async_Failed;
+    mAsyncRequests.erase(request->mHandle);
+    if (mCurrentUpload == request)
+        mCurrentUpload = NULL;
+
+    if (request->mCallback)
+        request->mCallback(request->mName, request->mTexId, success);
+
+    delete request;
+}
+
 /*!
 returns true if texture will be uploaded
 */
@@ -331,6 +716,8 @@ bool sgct::TextureManager::updateTexture(const std::string & name, unsigned int
                 glDeleteTextures(1, texPtr);
             (*texPtr) = 0;
             (*reload) = true;
+            if (SGCTMemoryRegistry::exists())
+                SGCTMemoryRegistry::instance()->removeAllocation(this, name);
         }
         else
         {
@@ -342,15 +729,44 @@ bool sgct::TextureManager::updateTexture(const std::string & name, unsigned int
     return true;
 }
 
-bool sgct::TextureManager::uploadImage(sgct_core::Image * imgPtr, unsigned int * texPtr)
+/*!
+    Upload an image to a new texture using the current settings.
+
+    \param memorySize if not NULL it's set to the estimated size of the texture on the GPU
+*/
+bool sgct::TextureManager::uploadImage(sgct_core::Image * imgPtr, unsigned int * texPtr, std::size_t * memorySize)
 {
+    int textureType;
+    int internalFormat;
+    unsigned int format;
+
+    if (!getTextureFormats(imgPtr, textureType, internalFormat, format))
+        return false;
+
     glGenTextures(1, texPtr);
     glBindTexture(GL_TEXTURE_2D, *texPtr);
 
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, static_cast<GLsizei>(imgPtr->getWidth()), static_cast<GLsizei>(imgPtr->getHeight()), 0, textureType, format, imgPtr->getData());
+    setTextureParameters(mInterpolate, mMipmapLevels);
+
+    if (memorySize != NULL)
+        *memorySize = SGCTMemoryRegistry::getTextureSize(static_cast<int>(imgPtr->getWidth()), static_cast<int>(imgPtr->getHeight()), internalFormat, 1, mMipmapLevels > 1);
+
+    return true;
+}
+
+/*!
+    Get the openGL texture type, internal format and pixel data type for an image using the current compression and alpha mode.
+*/
+bool sgct::TextureManager::getTextureFormats(sgct_core::Image * imgPtr, int & textureType, int & internalFormat, unsigned int & format)
+{
 	bool isBGR = imgPtr->getPreferBGRImport();
 
 	//if three channels
-    int textureType = isBGR ? GL_BGR : GL_RGB;
+    textureType = isBGR ? GL_BGR : GL_RGB;
 
     //if OpenGL 1-2
     if (Engine::instance()->isOGLPipelineFixed())
@@ -366,15 +782,17 @@ bool sgct::TextureManager::uploadImage(sgct_core::Image * imgPtr, unsigned int *
         else if (imgPtr->getChannels() == 2)    textureType = GL_RG;
     }
 
-    GLint internalFormat;
+    internalFormat = GL_RGB8;
     unsigned int bpc = static_cast<unsigned int>(imgPtr->getBytesPerChannel());
 
-    if (bpc > 2)
+    bool isFloat = imgPtr->isFloatData();
+
+    if (bpc > 4 || (bpc > 2 && !isFloat))
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "TextureManager: %d-bit per channel is not supported!\n", bpc * 8);
         return false;
     }
-    else if (bpc == 2) //turn of compression if 16-bit per color
+    else if (bpc >= 2) //turn of compression if 16-bit per color or floating point
     {
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "TextureManager: Compression is not supported for bit depths higher than 16-bit per channel!\n");
         mCompression = No_Compression;
@@ -440,6 +858,32 @@ bool sgct::TextureManager::uploadImage(sgct_core::Image * imgPtr, unsigned int *
         break;
     }
 
+    if (isFloat) //half (16-bit) or full (32-bit) floating point data
+    {
+        bool half = (bpc == 2);
+        switch (imgPtr->getChannels())
+        {
+        case 4:
+            internalFormat = (half ? GL_RGBA16F : GL_RGBA32F);
+            break;
+        case 3:
+            internalFormat = (half ? GL_RGB16F : GL_RGB32F);
+            break;
+        case 2:
+            if (Engine::instance()->isOGLPipelineFixed())
+                internalFormat = (half ? GL_LUMINANCE_ALPHA16F_ARB : GL_LUMINANCE_ALPHA32F_ARB);
+            else
+                internalFormat = (half ? GL_RG16F : GL_RG32F);
+            break;
+        case 1:
+            if (Engine::instance()->isOGLPipelineFixed())
+                internalFormat = mAlphaMode ? (half ? GL_ALPHA16F_ARB : GL_ALPHA32F_ARB) : (half ? GL_LUMINANCE16F_ARB : GL_LUMINANCE32F_ARB);
+            else
+                internalFormat = (half ? GL_R16F : GL_R32F);
+            break;
+        }
+    }
+
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Creating texture... size: %dx%d, %d-channels, compression: %s, Type: %#04x, Format: %#04x\n",
         imgPtr->getWidth(),
         imgPtr->getHeight(),
@@ -448,18 +892,26 @@ bool sgct::TextureManager::uploadImage(sgct_core::Image * imgPtr, unsigned int *
 		textureType,
 		internalFormat);
 
-    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (isFloat)
+        format = (bpc == 2 ? GL_HALF_FLOAT : GL_FLOAT);
+    else
+        format = (bpc == 1 ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT);
+    return true;
+}
 
-    if (mMipmapLevels <= 1)
-        mMipmapLevels = 1;
+/*!
+    Set filtering, mipmap and warping parameters of the bound texture. The anisotropic filter size and
+    warping mode are taken from the current settings.
+*/
+void sgct::TextureManager::setTextureParameters(bool interpolate, int mipmapLevels)
+{
+    if (mipmapLevels <= 1)
+        mipmapLevels = 1;
 
-    GLenum format = (bpc == 1 ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT);
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, static_cast<GLsizei>(imgPtr->getWidth()), static_cast<GLsizei>(imgPtr->getHeight()), 0, textureType, format, imgPtr->getData());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mMipmapLevels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapLevels - 1);
 
-    if (mMipmapLevels > 1)
+    if (mipmapLevels > 1)
     {
         glGenerateMipmap(GL_TEXTURE_2D); //allocate the mipmaps
 
@@ -467,20 +919,18 @@ bool sgct::TextureManager::uploadImage(sgct_core::Image * imgPtr, unsigned int *
         glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAni);
         //sgct::MessageHandler::instance()->print("Max anisotropy: %f\n", maxAni);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mInterpolate ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mInterpolate ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, interpolate ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, interpolate ? GL_LINEAR : GL_NEAREST);
         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, mAnisotropicFilterSize > maxAni ? maxAni : mAnisotropicFilterSize);
     }
     else
     {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mInterpolate ? GL_LINEAR : GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mInterpolate ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, interpolate ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, interpolate ? GL_LINEAR : GL_NEAREST);
     }
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, mWarpMode[0]);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, mWarpMode[1]);
-
-    return true;
 }
 
 void sgct::TextureManager::freeTextureData()
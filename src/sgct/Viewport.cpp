@@ -9,6 +9,9 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/Viewport.h>
 #include <sgct/TextureManager.h>
 #include <sgct/ClusterManager.h>
+#include <sgct/Engine.h>
+#include <sgct/Image.h>
+#include <sgct/SGCTThreadPool.h>
 #include <sgct/MessageHandler.h>
 #include <sgct/ReadConfig.h>
 #include <sgct/FisheyeProjection.h>
@@ -20,6 +23,12 @@ For conditions of distribution and use, see copyright notice in sgct.h
 sgct_core::Viewport::Viewport()
 {
     mNonLinearProjection = NULL;
+    mOverlayImage = NULL;
+    mBlendMaskImage = NULL;
+    mBlackLevelMaskImage = NULL;
+    mDataRead = false;
+    mMpcdiWarpGrid = NULL;
+    mWarpMapFormat = CorrectionMesh::NO_WARP_MAP;
     reset(0.0f, 0.0f, 1.0f, 1.0f);
 }
 
@@ -29,6 +38,12 @@ sgct_core::Viewport::Viewport()
 sgct_core::Viewport::Viewport(float x, float y, float xSize, float ySize)
 {
     mNonLinearProjection = NULL;
+    mOverlayImage = NULL;
+    mBlendMaskImage = NULL;
+    mBlackLevelMaskImage = NULL;
+    mDataRead = false;
+    mMpcdiWarpGrid = NULL;
+    mWarpMapFormat = CorrectionMesh::NO_WARP_MAP;
     reset(x, y, xSize, ySize);
 }
 
@@ -52,7 +67,11 @@ sgct_core::Viewport::~Viewport()
     if (mBlackLevelMaskTextureIndex)
         glDeleteTextures(1, &mBlackLevelMaskTextureIndex);
 
-    delete mMpcdiWarpMeshData;
+    delete mOverlayImage;
+    delete mBlendMaskImage;
+    delete mBlackLevelMaskImage;
+
+    delete mMpcdiWarpGrid;
 }
 
 void sgct_core::Viewport::configure(tinyxml2::XMLElement * element)
@@ -82,6 +101,9 @@ void sgct_core::Viewport::configure(tinyxml2::XMLElement * element)
     if (element->Attribute("hint") != NULL)
         mMeshHint.assign(element->Attribute("hint"));
 
+    if (element->Attribute("warpMap") != NULL)
+        setWarpMapFormat(CorrectionMesh::parseWarpMapFormat(element->Attribute("warpMap")));
+
     if (element->Attribute("tracked") != NULL)
         setTracked(strcmp(element->Attribute("tracked"), "true") == 0 ? true : false);
 
@@ -635,11 +657,23 @@ void sgct_core::Viewport::setCorrectionMesh(const char * meshPath)
     mMeshFilename.assign(meshPath);
 }
 
-void sgct_core::Viewport::setMpcdiWarpMesh(const char* meshData, size_t size)
+/*!
+    Set the decoded MPCDI correction grid for this viewport. The viewport takes ownership of the grid and
+    frees it as soon as the correction mesh is generated.
+*/
+void sgct_core::Viewport::setMpcdiWarpMesh(MpcdiWarpGrid * grid)
+{
+    delete mMpcdiWarpGrid;
+    mMpcdiWarpGrid = grid;
+}
+
+/*!
+    Bake the correction mesh into a lookup map of the given format at startup and apply it with a single
+    texture lookup pass instead of drawing the mesh. Useful for very dense meshes.
+*/
+void sgct_core::Viewport::setWarpMapFormat(CorrectionMesh::WarpMapFormat format)
 {
-    mMpcdiWarpMeshData = new char[size];
-    memcpy(mMpcdiWarpMeshData, meshData, size);
-    mMpcdiWarpMeshSize = size;
+    mWarpMapFormat = format;
 }
 
 void sgct_core::Viewport::setTracked(bool state)
@@ -647,30 +681,97 @@ void sgct_core::Viewport::setTracked(bool state)
     mTracked = state;
 }
 
+/*!
+Queue the parts of loading the viewport data that don't need an OpenGL context on a thread pool. This includes decoding
+the overlay and mask images and parsing the warping meshes (also the meshes of a spherical mirror projection).
+The OpenGL data is created by loadData which must be called once the pool is idle.
+
+\param pool the thread pool executing the tasks
+\param window the window containing this viewport
+*/
+void sgct_core::Viewport::readData(sgct_core::SGCTThreadPool & pool, sgct::SGCTWindow * window)
+{
+    mDataRead = true;
+
+    if (!mOverlayFilename.empty())
+        pool.addTask([this]() { mOverlayImage = readTexture(mOverlayFilename); });
+
+    if (!mBlendMaskFilename.empty())
+        pool.addTask([this]() { mBlendMaskImage = readTexture(mBlendMaskFilename); });
+
+    if (!mBlackLevelMaskFilename.empty())
+        pool.addTask([this]() { mBlackLevelMaskImage = readTexture(mBlackLevelMaskFilename); });
+
+    pool.addTask([this, window]() { readCorrectionMesh(window); });
+
+    if (SphericalMirrorProjection * sphericalMirrorProj = dynamic_cast<SphericalMirrorProjection *>(mNonLinearProjection))
+        sphericalMirrorProj->readMeshes(pool, this, window);
+}
+
+/*!
+Load the overlay and mask textures and the warping mesh to the GPU. If readData hasn't been called the data is read first.
+*/
 void sgct_core::Viewport::loadData()
 {
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Viewport: loading GPU data for '%s'\n", mName.c_str());
-        
-    if( mOverlayFilename.size() > 0 )
-        sgct::TextureManager::instance()->loadUnManagedTexture(mOverlayTextureIndex, mOverlayFilename, true, 1);
+    
+    if (!mDataRead)
+    {
+        mOverlayImage = readTexture(mOverlayFilename);
+        mBlendMaskImage = readTexture(mBlendMaskFilename);
+        mBlackLevelMaskImage = readTexture(mBlackLevelMaskFilename);
+        readCorrectionMesh(sgct::Engine::instance()->getCurrentWindowPtr());
+    }
+    mDataRead = false;
 
-    if ( mBlendMaskFilename.size() > 0 )
-        sgct::TextureManager::instance()->loadUnManagedTexture(mBlendMaskTextureIndex, mBlendMaskFilename, true, 1);
+    uploadTexture(mOverlayTextureIndex, mOverlayImage, mOverlayFilename);
+    uploadTexture(mBlendMaskTextureIndex, mBlendMaskImage, mBlendMaskFilename);
+    uploadTexture(mBlackLevelMaskTextureIndex, mBlackLevelMaskImage, mBlackLevelMaskFilename);
 
-    if ( mBlackLevelMaskFilename.size() > 0)
-        sgct::TextureManager::instance()->loadUnManagedTexture(mBlackLevelMaskTextureIndex, mBlackLevelMaskFilename, true, 1);
+    mCM.generateMesh(this);
+}
 
-    if ( mMpcdiWarpMeshData != nullptr )
+void sgct_core::Viewport::readCorrectionMesh(sgct::SGCTWindow * window)
+{
+    if ( mMpcdiWarpGrid != NULL )
     {
-        mCorrectionMesh = mCM.readAndGenerateMesh("mesh.mpcdi", this, CorrectionMesh::parseHint("mpcdi"));
+        mCorrectionMesh = mCM.readMesh("mesh.mpcdi", this, window, CorrectionMesh::parseHint("mpcdi"));
+        delete mMpcdiWarpGrid;
+        mMpcdiWarpGrid = NULL;
     }
     else
     {
         //load default if mMeshFilename is empty
-        mCorrectionMesh = mCM.readAndGenerateMesh(mMeshFilename, this, CorrectionMesh::parseHint(mMeshHint));
+        mCorrectionMesh = mCM.readMesh(mMeshFilename, this, window, CorrectionMesh::parseHint(mMeshHint));
     }
 }
 
+sgct_core::Image * sgct_core::Viewport::readTexture(const std::string & filename)
+{
+    if (filename.empty())
+        return NULL;
+
+    Image * img = new Image();
+    if (!img->load(filename))
+    {
+        delete img;
+        return NULL;
+    }
+    return img;
+}
+
+void sgct_core::Viewport::uploadTexture(unsigned int & texID, sgct_core::Image * & imgPtr, const std::string & filename)
+{
+    if (imgPtr == NULL)
+        return;
+
+    if (sgct::TextureManager::instance()->loadUnManagedTexture(texID, imgPtr, true, 1))
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Viewport: Texture created from '%s' [id=%d]\n", filename.c_str(), texID);
+
+    delete imgPtr;
+    imgPtr = NULL;
+}
+
 /*!
 Render the viewport mesh which the framebuffer texture is attached to
 \param type of mesh; quad, warped or mask
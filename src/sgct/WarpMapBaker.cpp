@@ -0,0 +1,225 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/WarpMapBaker.h>
+#include <sgct/SGCTThreadPool.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+//tile size in pixels, each tile is rasterized by one task
+#define WARP_MAP_TILE_SIZE 64
+//barycentric tolerance that avoids gaps between triangles sharing an edge
+#define WARP_MAP_EDGE_EPSILON 1e-7
+
+/*!
+    The mesh data must be valid until bake() returns.
+*/
+sgct_core::WarpMapBaker::WarpMapBaker(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices, const unsigned int * indices, unsigned int numberOfIndices)
+{
+    mVertices = vertices;
+    mIndices = indices;
+    mNumberOfVertices = numberOfVertices;
+    mNumberOfIndices = numberOfIndices;
+
+    mNumberOfTiles[0] = 0;
+    mNumberOfTiles[1] = 0;
+    mFormat = CorrectionMesh::RG16_WARP_MAP;
+    mResolution[0] = 0;
+    mResolution[1] = 0;
+    for (int i = 0; i < 4; i++)
+        mRect[i] = 0;
+}
+
+/*!
+    The map only stores a single blend intensity, so the vertex colors must be gray and opaque.
+    \returns true if the mesh can be represented by a warp map
+*/
+bool sgct_core::WarpMapBaker::canBake(const CorrectionMeshVertex * vertices, unsigned int numberOfVertices)
+{
+    for (unsigned int i = 0; i < numberOfVertices; i++)
+    {
+        const CorrectionMeshVertex & v = vertices[i];
+        if (v.r != v.g || v.r != v.b || v.a != 1.0f)
+            return false;
+    }
+
+    return true;
+}
+
+/*!
+    Rasterize the mesh (a triangle list in normalized device coordinates) for a window of the given resolution.
+
+    \param resolutionX the width of the window in pixels
+    \param resolutionY the height of the window in pixels
+    \param format the texel format of the map
+    \param numberOfThreads the number of threads rasterizing tiles
+    \returns false if the mesh doesn't cover any pixels
+*/
+bool sgct_core::WarpMapBaker::bake(int resolutionX, int resolutionY, CorrectionMesh::WarpMapFormat format, unsigned int numberOfThreads)
+{
+    mResolution[0] = resolutionX;
+    mResolution[1] = resolutionY;
+    mFormat = format;
+    mData.clear();
+
+    if (mNumberOfIndices < 3 || resolutionX <= 0 || resolutionY <= 0)
+        return false;
+
+    //transform to window pixels and find the covered area
+    mPositions.resize(static_cast<std::size_t>(mNumberOfVertices) * 2);
+    double minX = static_cast<double>(resolutionX);
+    double minY = static_cast<double>(resolutionY);
+    double maxX = 0.0;
+    double maxY = 0.0;
+    bool uvInRange = true;
+    for (unsigned int i = 0; i < mNumberOfVertices; i++)
+    {
+        const CorrectionMeshVertex & v = mVertices[i];
+        double x = (static_cast<double>(v.x) + 1.0) * 0.5 * static_cast<double>(resolutionX);
+        double y = (static_cast<double>(v.y) + 1.0) * 0.5 * static_cast<double>(resolutionY);
+        mPositions[i * 2] = x;
+        mPositions[i * 2 + 1] = y;
+
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+        uvInRange &= (v.s >= 0.0f && v.s <= 1.0f && v.t >= 0.0f && v.t <= 1.0f);
+    }
+
+    if (mFormat == CorrectionMesh::RG16_WARP_MAP && !uvInRange)
+        mFormat = CorrectionMesh::RG32F_WARP_MAP;
+
+    mRect[0] = std::max(0, static_cast<int>(floor(minX)));
+    mRect[1] = std::max(0, static_cast<int>(floor(minY)));
+    mRect[2] = std::min(resolutionX, static_cast<int>(ceil(maxX))) - mRect[0];
+    mRect[3] = std::min(resolutionY, static_cast<int>(ceil(maxY))) - mRect[1];
+    if (mRect[2] <= 0 || mRect[3] <= 0)
+        return false;
+
+    //bin the triangles into tiles by the pixel centers they might cover
+    mNumberOfTiles[0] = (mRect[2] + WARP_MAP_TILE_SIZE - 1) / WARP_MAP_TILE_SIZE;
+    mNumberOfTiles[1] = (mRect[3] + WARP_MAP_TILE_SIZE - 1) / WARP_MAP_TILE_SIZE;
+    mTileTriangles.assign(mNumberOfTiles[0] * mNumberOfTiles[1], std::vector<unsigned int>());
+
+    for (unsigned int t = 0; t < mNumberOfIndices / 3; t++)
+    {
+        const double * a = &mPositions[mIndices[t * 3] * 2];
+        const double * b = &mPositions[mIndices[t * 3 + 1] * 2];
+        const double * c = &mPositions[mIndices[t * 3 + 2] * 2];
+
+        int x0 = std::max(0, static_cast<int>(ceil(std::min(a[0], std::min(b[0], c[0])) - 0.5)) - mRect[0]);
+        int x1 = std::min(mRect[2] - 1, static_cast<int>(floor(std::max(a[0], std::max(b[0], c[0])) - 0.5)) - mRect[0]);
+        int y0 = std::max(0, static_cast<int>(ceil(std::min(a[1], std::min(b[1], c[1])) - 0.5)) - mRect[1]);
+        int y1 = std::min(mRect[3] - 1, static_cast<int>(floor(std::max(a[1], std::max(b[1], c[1])) - 0.5)) - mRect[1]);
+        if (x0 > x1 || y0 > y1)
+            continue;
+
+        for (int ty = y0 / WARP_MAP_TILE_SIZE; ty <= y1 / WARP_MAP_TILE_SIZE; ty++)
+            for (int tx = x0 / WARP_MAP_TILE_SIZE; tx <= x1 / WARP_MAP_TILE_SIZE; tx++)
+                mTileTriangles[ty * mNumberOfTiles[0] + tx].push_back(t);
+    }
+
+    //uncovered texels stay zero
+    std::size_t texelSize = mFormat == CorrectionMesh::RG16_WARP_MAP ? 4 * sizeof(unsigned short) : 4 * sizeof(float);
+    mData.assign(static_cast<std::size_t>(mRect[2]) * static_cast<std::size_t>(mRect[3]) * texelSize, 0);
+
+    SGCTThreadPool pool;
+    if (numberOfThreads > 1 && mTileTriangles.size() > 1)
+        pool.start(std::min(numberOfThreads, static_cast<unsigned int>(mTileTriangles.size())));
+
+    for (std::size_t ty = 0; ty < mNumberOfTiles[1]; ty++)
+        for (std::size_t tx = 0; tx < mNumberOfTiles[0]; tx++)
+            pool.addTask([this, tx, ty]() { rasterizeTile(tx, ty); });
+    pool.waitUntilIdle();
+    pool.stop();
+
+    //release the working data, the mesh might be freed after baking
+    std::vector<double>().swap(mPositions);
+    std::vector< std::vector<unsigned int> >().swap(mTileTriangles);
+    mVertices = NULL;
+    mIndices = NULL;
+
+    return true;
+}
+
+void sgct_core::WarpMapBaker::rasterizeTile(std::size_t tileX, std::size_t tileY)
+{
+    const std::vector<unsigned int> & triangles = mTileTriangles[tileY * mNumberOfTiles[0] + tileX];
+
+    int tileX0 = static_cast<int>(tileX) * WARP_MAP_TILE_SIZE;
+    int tileY0 = static_cast<int>(tileY) * WARP_MAP_TILE_SIZE;
+    int tileX1 = std::min(tileX0 + WARP_MAP_TILE_SIZE, mRect[2]) - 1;
+    int tileY1 = std::min(tileY0 + WARP_MAP_TILE_SIZE, mRect[3]) - 1;
+
+    //triangles are processed in draw order so that later triangles overwrite earlier ones in folded meshes
+    for (std::size_t i = 0; i < triangles.size(); i++)
+    {
+        unsigned int t = triangles[i];
+        const CorrectionMeshVertex & va = mVertices[mIndices[t * 3]];
+        const CorrectionMeshVertex & vb = mVertices[mIndices[t * 3 + 1]];
+        const CorrectionMeshVertex & vc = mVertices[mIndices[t * 3 + 2]];
+
+        //positions relative to the map origin
+        double ax = mPositions[mIndices[t * 3] * 2] - mRect[0];
+        double ay = mPositions[mIndices[t * 3] * 2 + 1] - mRect[1];
+        double bx = mPositions[mIndices[t * 3 + 1] * 2] - mRect[0];
+        double by = mPositions[mIndices[t * 3 + 1] * 2 + 1] - mRect[1];
+        double cx = mPositions[mIndices[t * 3 + 2] * 2] - mRect[0];
+        double cy = mPositions[mIndices[t * 3 + 2] * 2 + 1] - mRect[1];
+
+        double area = (bx - ax) * (cy - ay) - (cx - ax) * (by - ay);
+        if (area == 0.0)
+            continue;
+        double invArea = 1.0 / area;
+
+        int x0 = std::max(tileX0, static_cast<int>(ceil(std::min(ax, std::min(bx, cx)) - 0.5)));
+        int x1 = std::min(tileX1, static_cast<int>(floor(std::max(ax, std::max(bx, cx)) - 0.5)));
+        int y0 = std::max(tileY0, static_cast<int>(ceil(std::min(ay, std::min(by, cy)) - 0.5)));
+        int y1 = std::min(tileY1, static_cast<int>(floor(std::max(ay, std::max(by, cy)) - 0.5)));
+
+        for (int y = y0; y <= y1; y++)
+        {
+            double py = static_cast<double>(y) + 0.5;
+            for (int x = x0; x <= x1; x++)
+            {
+                double px = static_cast<double>(x) + 0.5;
+                double w0 = ((bx - px) * (cy - py) - (cx - px) * (by - py)) * invArea;
+                double w1 = ((cx - px) * (ay - py) - (ax - px) * (cy - py)) * invArea;
+                double w2 = 1.0 - w0 - w1;
+                if (w0 < -WARP_MAP_EDGE_EPSILON || w1 < -WARP_MAP_EDGE_EPSILON || w2 < -WARP_MAP_EDGE_EPSILON)
+                    continue;
+
+                float s = static_cast<float>(w0 * va.s + w1 * vb.s + w2 * vc.s);
+                float tc = static_cast<float>(w0 * va.t + w1 * vb.t + w2 * vc.t);
+                float intensity = static_cast<float>(w0 * va.r + w1 * vb.r + w2 * vc.r);
+                storeTexel(static_cast<std::size_t>(y) * mRect[2] + x, s, tc, intensity);
+            }
+        }
+    }
+}
+
+void sgct_core::WarpMapBaker::storeTexel(std::size_t index, float s, float t, float intensity)
+{
+    intensity = std::min(1.0f, std::max(0.0f, intensity));
+
+    if (mFormat == CorrectionMesh::RG16_WARP_MAP)
+    {
+        unsigned short texel[4];
+        texel[0] = static_cast<unsigned short>(std::min(1.0f, std::max(0.0f, s)) * 65535.0f + 0.5f);
+        texel[1] = static_cast<unsigned short>(std::min(1.0f, std::max(0.0f, t)) * 65535.0f + 0.5f);
+        texel[2] = static_cast<unsigned short>(intensity * 65535.0f + 0.5f);
+        texel[3] = 65535; //covered
+        memcpy(&mData[index * sizeof(texel)], texel, sizeof(texel));
+    }
+    else
+    {
+        float texel[4] = { s, t, intensity, 1.0f };
+        memcpy(&mData[index * sizeof(texel)], texel, sizeof(texel));
+    }
+}